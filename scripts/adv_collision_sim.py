@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""Estimate advertisement delivery ratio against tag density.
+
+Simulates co-located tags advertising on channels 37, 38 and 39 and a single
+gateway scanning one channel at a time. A packet is lost if the gateway is
+not listening on its channel or if another packet overlaps it on the same
+channel. A heartbeat is delivered if any advertisement carrying its data is
+received.
+
+Per-device interval offset uses the same hash as src/app_jitter.c, so results
+correspond to APP_ADV_INTERVAL_OFFSET_MAX_MS and APP_HEARTBEAT_JITTER_MAX_MS
+of firmware.
+
+Usage:
+    ./scripts/adv_collision_sim.py --tags 10 50 100 200 500
+    ./scripts/adv_collision_sim.py --interval 1285 --repeats 2 --offset-max 20 \\
+        --jitter-max 500 --duration 600
+"""
+
+import argparse
+import bisect
+import random
+
+ADV_CHANNELS = (37, 38, 39)
+ADV_DELAY_MAX_MS = 10.0     # Random delay added to each event by link layer.
+PDU_AIR_TIME_MS = 0.376     # 47 bytes at 1 Mbit/s, 31-byte advertising data.
+CHANNEL_PITCH_MS = 0.5      # Start of PDU on next channel of same event.
+U32 = 0xFFFFFFFF
+
+
+def mix32(x):
+    """Same avalanche as mix32 of app_jitter.c."""
+    x ^= x >> 16
+    x = (x * 0x7FEB352D) & U32
+    x ^= x >> 15
+    x = (x * 0x846CA68B) & U32
+    x ^= x >> 16
+    return x
+
+
+def offset_ms(address, max_ms):
+    """Same offset as app_jitter_offset_ms."""
+    folded = (address & U32) ^ (address >> 32)
+    return mix32(folded) % (max_ms + 1)
+
+
+def tag_packets(rng, address, args, offset, jitter):
+    """Return packets (start_ms, channel, heartbeat) and heartbeat count of one tag."""
+    interval = args.interval + (offset_ms(address, args.offset_max) if offset else 0)
+    heartbeat_interval = args.interval * args.repeats
+    # Heartbeat boundaries with random initial phase, jitter is added to the
+    # nominal schedule and does not accumulate.
+    boundaries = []
+    nominal = rng.uniform(0.0, heartbeat_interval)
+    while nominal < args.duration_ms:
+        t = nominal + (rng.uniform(0.0, args.jitter_max) if jitter else 0.0)
+        boundaries.append(t)
+        nominal += heartbeat_interval
+    packets = []
+    t = rng.uniform(0.0, interval)
+    while t < args.duration_ms:
+        heartbeat = bisect.bisect_right(boundaries, t)
+        for index, channel in enumerate(ADV_CHANNELS):
+            packets.append((t + index * CHANNEL_PITCH_MS, channel, heartbeat))
+        t += interval + rng.uniform(0.0, ADV_DELAY_MAX_MS)
+    return packets, len(boundaries) + 1
+
+
+def scanned_channel(start_ms, scan_ms):
+    return ADV_CHANNELS[int(start_ms // scan_ms) % len(ADV_CHANNELS)]
+
+
+def simulate(tag_count, args, offset, jitter):
+    """Return (packet reception ratio, heartbeat delivery ratio)."""
+    rng = random.Random(args.seed + tag_count)
+    by_channel = {channel: [] for channel in ADV_CHANNELS}
+    heartbeats_sent = 0
+    for tag in range(tag_count):
+        address = rng.getrandbits(48)
+        packets, heartbeats = tag_packets(rng, address, args, offset, jitter)
+        heartbeats_sent += heartbeats
+        for start, channel, heartbeat in packets:
+            by_channel[channel].append((start, tag, heartbeat))
+    sent = 0
+    received = 0
+    delivered = set()
+    for channel, packets in by_channel.items():
+        packets.sort()
+        for index, (start, tag, heartbeat) in enumerate(packets):
+            end = start + PDU_AIR_TIME_MS
+            sent += 1
+            collided = ((index > 0 and packets[index - 1][0] + PDU_AIR_TIME_MS > start)
+                        or (index + 1 < len(packets) and packets[index + 1][0] < end))
+            # Gateway must listen to the channel for the whole packet.
+            listening = (scanned_channel(start, args.scan) == channel
+                         and scanned_channel(end, args.scan) == channel)
+            if listening and not collided:
+                received += 1
+                delivered.add((tag, heartbeat))
+    return received / max(sent, 1), len(delivered) / max(heartbeats_sent, 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--tags", type=int, nargs="+", default=[10, 50, 100, 200, 500],
+                        help="Tag counts to simulate.")
+    parser.add_argument("--interval", type=int, default=1285,
+                        help="APP_BLE_INTERVAL_MS.")
+    parser.add_argument("--repeats", type=int, default=2, help="APP_NUM_REPEATS.")
+    parser.add_argument("--offset-max", type=int, default=20,
+                        help="APP_ADV_INTERVAL_OFFSET_MAX_MS.")
+    parser.add_argument("--jitter-max", type=float, default=500.0,
+                        help="APP_HEARTBEAT_JITTER_MAX_MS.")
+    parser.add_argument("--scan", type=float, default=100.0,
+                        help="Gateway scan window per channel, ms.")
+    parser.add_argument("--duration", type=float, default=300.0,
+                        help="Simulated time, s.")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+    args.duration_ms = args.duration * 1000.0
+
+    configs = (("fixed", False, False), ("offset", True, False),
+               ("offset+jitter", True, True))
+    header = "tags " + "".join(" {:>18s} {:>18s}".format(name + " pkt", name + " hb")
+                                 for name, _, _ in configs)
+    print(header)
+    for tag_count in args.tags:
+        row = "{:4d}".format(tag_count)
+        for _, offset, jitter in configs:
+            packet_ratio, heartbeat_ratio = simulate(tag_count, args, offset, jitter)
+            row += " {:18.1%} {:18.1%}".format(packet_ratio, heartbeat_ratio)
+        print(row)
+
+
+if __name__ == "__main__":
+    main()
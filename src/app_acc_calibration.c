@@ -0,0 +1,244 @@
+/**
+ * @addtogroup app_acc_calibration
+ */
+/** @{ */
+/**
+ * @file app_acc_calibration.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Accelerometer activity threshold calibration.
+ */
+#include "app_config.h"
+#include "app_acc_calibration.h"
+#include "app_comms.h"
+#include "app_sensor.h"
+#include "app_testing.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_endpoints.h"
+#include "ruuvi_interface_log.h"
+#include "ruuvi_interface_rtc.h"
+#include "ruuvi_task_flash.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define AXIS_COUNT (3U)
+
+static inline void LOG (const char * const msg)
+{
+    ri_log (RI_LOG_LEVEL_INFO, msg);
+}
+
+static bool m_learning;
+static float m_threshold_g = NAN; //!< Threshold in use, NAN if not known.
+static uint64_t m_start_ms;     //!< Time of first sample of learning period.
+static uint32_t m_count;        //!< Samples in learning period.
+static float m_mean[AXIS_COUNT]; //!< Running mean of each axis.
+static float m_m2[AXIS_COUNT];   //!< Running sum of squared deviations of each axis.
+
+/** @brief Threshold from noisiest axis of learning period. */
+TESTABLE_STATIC float calibration_threshold (void)
+{
+    float noise_g = 0.0F;
+
+    for (size_t ii = 0; ii < AXIS_COUNT; ii++)
+    {
+        const float deviation = sqrtf (m_m2[ii] / m_count);
+        noise_g = (deviation > noise_g) ? deviation : noise_g;
+    }
+
+    float threshold_g = noise_g * APP_ACC_CALIBRATION_MULTIPLIER;
+
+    if (threshold_g < APP_ACC_CALIBRATION_MIN_G)
+    {
+        threshold_g = APP_ACC_CALIBRATION_MIN_G;
+    }
+    else if (threshold_g > APP_ACC_CALIBRATION_MAX_G)
+    {
+        threshold_g = APP_ACC_CALIBRATION_MAX_G;
+    }
+    else
+    {
+        // Threshold is within limits.
+    }
+
+    return threshold_g;
+}
+
+static void calibration_complete (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    float threshold_g = calibration_threshold();
+    char msg[64];
+    m_learning = false;
+    snprintf (msg, sizeof (msg), "Activity threshold %d mg\r\n",
+              (int) (threshold_g * 1000.0F));
+    LOG (msg);
+    err_code |= app_sensor_acc_thr_set (&threshold_g);
+
+    // Do not store threshold which could not be applied.
+    if (RD_SUCCESS == err_code)
+    {
+        m_threshold_g = threshold_g;
+        err_code |= rt_flash_store (APP_FLASH_SENSOR_FILE,
+                                    APP_FLASH_SENSOR_ACC_THR_RECORD,
+                                    &threshold_g, sizeof (threshold_g));
+    }
+
+    RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+}
+
+TESTABLE_STATIC void calibration_sample (const float x_g, const float y_g,
+        const float z_g, const uint64_t now_ms)
+{
+    const float sample[AXIS_COUNT] = { x_g, y_g, z_g };
+
+    if (m_learning && !isnan (x_g) && !isnan (y_g) && !isnan (z_g))
+    {
+        if (0U == m_count)
+        {
+            m_start_ms = now_ms;
+        }
+
+        m_count++;
+
+        // Welford's algorithm, stable with small variance on top of gravity.
+        for (size_t ii = 0; ii < AXIS_COUNT; ii++)
+        {
+            const float delta = sample[ii] - m_mean[ii];
+            m_mean[ii] += delta / m_count;
+            m_m2[ii] += delta * (sample[ii] - m_mean[ii]);
+        }
+
+        if ( (APP_ACC_CALIBRATION_MIN_SAMPLES <= m_count)
+                && ( (now_ms - m_start_ms) >= APP_ACC_CALIBRATION_PERIOD_MS))
+        {
+            calibration_complete();
+        }
+    }
+}
+
+rd_status_t app_acc_calibration_init (float * const threshold_g)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    float stored_g = 0.0F;
+
+    if (NULL == threshold_g)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (RD_SUCCESS == rt_flash_load (APP_FLASH_SENSOR_FILE,
+                                            APP_FLASH_SENSOR_ACC_THR_RECORD,
+                                            &stored_g, sizeof (stored_g)))
+              && (stored_g >= APP_ACC_CALIBRATION_MIN_G)
+              && (stored_g <= APP_ACC_CALIBRATION_MAX_G))
+    {
+        *threshold_g = stored_g;
+        m_threshold_g = stored_g;
+        m_learning = false;
+    }
+    else
+    {
+        // Not calibrated or no flash, use given threshold while learning.
+        m_threshold_g = *threshold_g;
+        app_acc_calibration_start();
+    }
+
+    return err_code;
+}
+
+void app_acc_calibration_start (void)
+{
+    m_count = 0U;
+    memset (m_mean, 0, sizeof (m_mean));
+    memset (m_m2, 0, sizeof (m_m2));
+    m_learning = true;
+}
+
+bool app_acc_calibration_is_learning (void)
+{
+    return m_learning;
+}
+
+void app_acc_calibration_sample_push (const float x_g, const float y_g,
+                                      const float z_g)
+{
+    if (m_learning)
+    {
+        calibration_sample (x_g, y_g, z_g, ri_rtc_millis());
+    }
+}
+
+static uint16_t threshold_mg (void)
+{
+    uint16_t mg = UINT16_MAX;
+
+    if (!isnan (m_threshold_g))
+    {
+        mg = (uint16_t) lrintf (m_threshold_g * 1000.0F);
+    }
+
+    return mg;
+}
+
+rd_status_t app_acc_calibration_handle (const ri_comm_xfer_fp_t reply_fp,
+                                        const uint8_t * const raw_message,
+                                        const uint16_t data_len)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == raw_message)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (data_len < RE_STANDARD_MESSAGE_LENGTH)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        const re_op_t op = (re_op_t) raw_message[RE_STANDARD_OPERATION_INDEX];
+        ri_comm_message_t msg = {0};
+
+        if (RE_STANDARD_VALUE_WRITE == op)
+        {
+            LOG ("Activity threshold learning restarted\r\n");
+            app_acc_calibration_start();
+        }
+        else
+        {
+            // Read replies current state.
+        }
+
+        uint8_t * const p_reply = &msg.data[RE_STANDARD_PAYLOAD_START_INDEX];
+        const uint16_t mg = threshold_mg();
+        msg.repeat_count = 1;
+        msg.data_length = RE_STANDARD_MESSAGE_LENGTH;
+        msg.data[RE_STANDARD_DESTINATION_INDEX] = raw_message[RE_STANDARD_SOURCE_INDEX];
+        msg.data[RE_STANDARD_SOURCE_INDEX] = raw_message[RE_STANDARD_DESTINATION_INDEX];
+        msg.data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+        p_reply[APP_ACC_CALIBRATION_REPLY_LEARNING] = m_learning ? 1U : 0U;
+        p_reply[APP_ACC_CALIBRATION_REPLY_THR] = (uint8_t) (mg >> 8U);
+        p_reply[APP_ACC_CALIBRATION_REPLY_THR + 1U] = (uint8_t) (mg & 0xFFU);
+        p_reply[APP_ACC_CALIBRATION_REPLY_STATUS] = 0U;
+        err_code |= app_comms_blocking_send (reply_fp, &msg);
+    }
+
+    return err_code;
+}
+
+#ifdef CEEDLING
+void app_acc_calibration_reset (void)
+{
+    m_learning = false;
+    m_threshold_g = NAN;
+    m_count = 0U;
+    memset (m_mean, 0, sizeof (m_mean));
+    memset (m_m2, 0, sizeof (m_m2));
+}
+#endif
+
+/** @} */
@@ -0,0 +1,125 @@
+#ifndef APP_ACC_CALIBRATION_H
+#define APP_ACC_CALIBRATION_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_acc_calibration Accelerometer threshold calibration
+ * @brief Learn activity interrupt threshold from noise floor of the mounting.
+ */
+/** @} */
+/**
+ * @addtogroup app_acc_calibration
+ */
+/** @{ */
+/**
+ * @file app_acc_calibration.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * A fixed activity threshold is too low for tags mounted on vibrating
+ * equipment and too high for tags resting on a shelf. During the learning
+ * period the standard deviation of each acceleration axis is tracked, and
+ * at the end of the period the threshold is set to
+ * APP_ACC_CALIBRATION_MULTIPLIER times the noisiest axis through
+ * @ref app_sensor_acc_thr_set. Threshold is stored to flash and
+ * loaded on following boots.
+ *
+ * Noise floor is learned from accelerometer FIFO samples drained by
+ * @ref app_vibration_sample, one read per heartbeat is too slow to see
+ * vibration of the mounting. Learning is restarted from
+ * APP_ENDPOINT_ACC_CALIBRATION, for example after the tag is moved to another
+ * machine.
+ *
+ * Typical usage:
+ * @code{.c}
+ * float threshold = APP_MOTION_THRESHOLD;
+ * err_code |= app_acc_calibration_init (&threshold);
+ * err_code |= app_sensor_acc_thr_set (&threshold);
+ * // Called by app_vibration_sample for each FIFO sample.
+ * app_acc_calibration_sample_push (x_g, y_g, z_g);
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if APP_ACC_CALIBRATION_ENABLED && !APP_VIBRATION_ENABLED
+#   error "APP_ACC_CALIBRATION_ENABLED needs accelerometer FIFO of APP_VIBRATION_ENABLED."
+#endif
+
+#define APP_ACC_CALIBRATION_REPLY_LEARNING (0U) //!< 1 if learning, 0 otherwise.
+#define APP_ACC_CALIBRATION_REPLY_THR      (1U) //!< Threshold, uint16, mg.
+#define APP_ACC_CALIBRATION_REPLY_STATUS   (3U) //!< 0 on success, 0xFF on error.
+
+/**
+ * @brief Load calibrated threshold, start learning if there is none.
+ *
+ * @param[in,out] threshold_g Stored threshold if found, unchanged otherwise.
+ *
+ * @retval RD_SUCCESS Threshold was loaded or learning was started.
+ * @retval RD_ERROR_NULL Threshold was NULL.
+ */
+rd_status_t app_acc_calibration_init (float * const threshold_g);
+
+/**
+ * @brief Discard current samples and start a new learning period.
+ */
+void app_acc_calibration_start (void);
+
+/**
+ * @brief Check if learning period is in progress.
+ *
+ * @retval true Threshold is being learned.
+ * @retval false Threshold is calibrated or calibration was not started.
+ */
+bool app_acc_calibration_is_learning (void);
+
+/**
+ * @brief Add one accelerometer FIFO sample to learning period.
+ *
+ * Applies and stores threshold once learning period has elapsed.
+ * Does nothing if not learning.
+ *
+ * @param[in] x_g Acceleration along X, G.
+ * @param[in] y_g Acceleration along Y, G.
+ * @param[in] z_g Acceleration along Z, G.
+ */
+void app_acc_calibration_sample_push (const float x_g, const float y_g,
+                                      const float z_g);
+
+/**
+ * @brief Handle calibration request from APP_ENDPOINT_ACC_CALIBRATION.
+ *
+ * Write starts a new learning period, current threshold stays active until
+ * the period completes. Both read and write reply learning state and
+ * current threshold at APP_ACC_CALIBRATION_REPLY_x offsets of payload.
+ *
+ * @param[in] reply_fp Function used to send reply.
+ * @param[in] raw_message Standard message to endpoint.
+ * @param[in] data_len Length of raw_message.
+ *
+ * @retval RD_SUCCESS Reply was sent.
+ * @retval RD_ERROR_NULL Message was NULL.
+ * @retval RD_ERROR_DATA_SIZE Message is shorter than standard message.
+ * @return Error code from reply_fp.
+ */
+rd_status_t app_acc_calibration_handle (const ri_comm_xfer_fp_t reply_fp,
+                                        const uint8_t * const raw_message,
+                                        const uint16_t data_len);
+
+#ifdef CEEDLING
+void calibration_sample (const float x_g, const float y_g, const float z_g,
+                         const uint64_t now_ms);
+float calibration_threshold (void);
+void app_acc_calibration_reset (void);
+#endif
+
+/** @} */
+#endif // APP_ACC_CALIBRATION_H
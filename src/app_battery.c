@@ -0,0 +1,267 @@
+/**
+ * @addtogroup app_battery
+ */
+/** @{ */
+/**
+ * @file app_battery.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+#include "app_config.h"
+#include "app_battery.h"
+#include "app_testing.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_log.h"
+#include "ruuvi_interface_rtc.h"
+#include "ruuvi_interface_scheduler.h"
+#include "ruuvi_task_adc.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MS_PER_DAY (24ULL * 60ULL * 60ULL * 1000ULL)
+
+static inline void LOG (const char * const msg)
+{
+    ri_log (RI_LOG_LEVEL_INFO, msg);
+}
+
+/** @brief Samples of a radio event passed from interrupt to scheduler. */
+typedef struct
+{
+    float idle_v;      //!< Latched rest sample.
+    uint64_t idle_ms;  //!< Time of rest sample.
+    float load_v;      //!< Sample under load.
+    uint64_t load_ms;  //!< Time of sample under load.
+    bool idle_latched; //!< Rest sample was latched since previous load sample.
+} battery_sample_t;
+
+static app_battery_state_t m_state = { .remaining_days = NAN };
+static float m_idle_sample_v;     //!< Latest rest sample waiting for its pair.
+static uint64_t m_idle_sample_ms; //!< Time of latest rest sample.
+static bool m_idle_pending;       //!< Rest sample waiting for its pair.
+static float m_load_sample_v;     //!< Latest sample under load.
+static bool m_load_valid;         //!< At least one sample under load taken.
+static float m_trend_ref_v;       //!< Idle voltage at start of trend period.
+static uint64_t m_trend_ref_ms;   //!< Start of trend period.
+static uint32_t m_trend_periods;  //!< Number of completed trend periods.
+static volatile float m_latched_v;     //!< Rest sample latched in radio interrupt.
+static volatile uint64_t m_latched_ms; //!< Time of latched rest sample.
+static volatile bool m_latched;        //!< Rest sample waits for sample under load.
+
+static float filter (const float state, const float sample, const bool first)
+{
+    return first ? sample : (state + ( (sample - state) / APP_BATTERY_FILTER_DIVISOR));
+}
+
+static void state_log (void)
+{
+    char msg[128];
+    snprintf (msg, sizeof (msg),
+              "Battery: idle %d mV, load %d mV, R %d mOhm, trend %d uV/day, %d days\r\n",
+              (int) (m_state.idle_v * 1000.0F), (int) (m_state.load_v * 1000.0F),
+              (int) (m_state.resistance_ohm * 1000.0F),
+              (int) (m_state.trend_v_per_day * 1000000.0F),
+              isnan (m_state.remaining_days) ? -1 : (int) m_state.remaining_days);
+    LOG (msg);
+}
+
+/**
+ * @brief Predict days until battery cannot sustain worst seen radio load.
+ */
+static float remaining_days_predict (void)
+{
+    const float margin_v = m_state.idle_v - m_state.droop_max_v - APP_BATTERY_CUTOFF_V;
+    float days = NAN;
+
+    if (0.0F >= margin_v)
+    {
+        days = 0.0F;
+    }
+    else if (0.0F > m_state.trend_v_per_day)
+    {
+        days = margin_v / (-m_state.trend_v_per_day);
+    }
+    else
+    {
+        // Not discharging measurably.
+    }
+
+    return days;
+}
+
+static void trend_update (const uint64_t now_ms)
+{
+    if (1U == m_state.pairs)
+    {
+        m_trend_ref_v = m_state.idle_v;
+        m_trend_ref_ms = now_ms;
+    }
+    else if ( (now_ms - m_trend_ref_ms) >= APP_BATTERY_TREND_PERIOD_MS)
+    {
+        const float days = (float) (now_ms - m_trend_ref_ms) / (float) MS_PER_DAY;
+        const float slope = (m_state.idle_v - m_trend_ref_v) / days;
+        m_state.trend_v_per_day = filter (m_state.trend_v_per_day, slope,
+                                          (0U == m_trend_periods));
+        m_trend_periods++;
+        m_trend_ref_v = m_state.idle_v;
+        m_trend_ref_ms = now_ms;
+        m_state.remaining_days = remaining_days_predict();
+        state_log();
+    }
+    else
+    {
+        // Wait for trend period to complete.
+    }
+}
+
+static void pair_update (const float idle_v, const float load_v, const uint64_t now_ms)
+{
+    const bool first = (0U == m_state.pairs);
+    const float droop_v = idle_v - load_v;
+    m_state.idle_v = filter (m_state.idle_v, idle_v, first);
+    m_state.load_v = filter (m_state.load_v, load_v, first);
+    m_state.droop_v = m_state.idle_v - m_state.load_v;
+
+    if (first || (droop_v > m_state.droop_max_v))
+    {
+        m_state.droop_max_v = droop_v;
+    }
+    else
+    {
+        // Forget a transient droop slowly, so that cold nights are still covered.
+        m_state.droop_max_v += (droop_v - m_state.droop_max_v)
+                               / APP_BATTERY_DROOP_DECAY_DIVISOR;
+    }
+
+    m_state.resistance_ohm = (0.0F < m_state.droop_v) ?
+                             (m_state.droop_v / APP_BATTERY_TX_CURRENT_A) : 0.0F;
+    m_state.pairs++;
+    trend_update (now_ms);
+}
+
+TESTABLE_STATIC void battery_process (const float vdd, const bool under_load,
+                                      const uint64_t now_ms)
+{
+    if (!under_load)
+    {
+        m_idle_sample_v = vdd;
+        m_idle_sample_ms = now_ms;
+        m_idle_pending = true;
+    }
+    else
+    {
+        m_load_sample_v = vdd;
+        m_load_valid = true;
+
+        // Pair only samples of the same radio event.
+        if (m_idle_pending
+                && ( (now_ms - m_idle_sample_ms) <= APP_BATTERY_PAIR_WINDOW_MS))
+        {
+            pair_update (m_idle_sample_v, vdd, now_ms);
+        }
+
+        m_idle_pending = false;
+    }
+}
+
+TESTABLE_STATIC void battery_sample_handler (void * p_event, uint16_t event_size)
+{
+    if ( (NULL != p_event) && (sizeof (battery_sample_t) == event_size))
+    {
+        const battery_sample_t * const p_sample = (battery_sample_t *) p_event;
+
+        if (p_sample->idle_latched)
+        {
+            battery_process (p_sample->idle_v, false, p_sample->idle_ms);
+        }
+
+        battery_process (p_sample->load_v, true, p_sample->load_ms);
+    }
+}
+
+void app_battery_sample_isr (const float vdd, const bool under_load)
+{
+    const uint64_t now_ms = ri_rtc_millis();
+
+    if (!under_load)
+    {
+        // Latch only, rest sample is processed with its pair.
+        m_latched_v = vdd;
+        m_latched_ms = now_ms;
+        m_latched = true;
+    }
+    else
+    {
+        battery_sample_t sample =
+        {
+            .idle_v = m_latched_v,
+            .idle_ms = m_latched_ms,
+            .load_v = vdd,
+            .load_ms = now_ms,
+            .idle_latched = m_latched
+        };
+        m_latched = false;
+        rd_status_t err_code = ri_scheduler_event_put (&sample, sizeof (sample),
+                               &battery_sample_handler);
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    }
+}
+
+rd_status_t app_battery_vdd_get (float * const vdd)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == vdd)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (m_load_valid)
+    {
+        *vdd = m_load_sample_v;
+    }
+    else
+    {
+        err_code |= rt_adc_vdd_get (vdd);
+    }
+
+    return err_code;
+}
+
+rd_status_t app_battery_state_get (app_battery_state_t * const state)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == state)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (0U == m_state.pairs)
+    {
+        memset (state, 0, sizeof (app_battery_state_t));
+        state->remaining_days = NAN;
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        *state = m_state;
+    }
+
+    return err_code;
+}
+
+#ifdef CEEDLING
+void app_battery_reset (void)
+{
+    memset (&m_state, 0, sizeof (m_state));
+    m_state.remaining_days = NAN;
+    m_idle_pending = false;
+    m_load_valid = false;
+    m_trend_periods = 0;
+    m_latched = false;
+}
+#endif
+
+/** @} */
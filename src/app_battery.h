@@ -0,0 +1,106 @@
+#ifndef APP_BATTERY_H
+#define APP_BATTERY_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_battery Battery monitoring
+ * @brief Estimate battery condition from voltage at rest and under radio load.
+ */
+/** @} */
+/**
+ * @addtogroup app_battery
+ */
+/** @{ */
+/**
+ * @file app_battery.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Battery voltage is sampled at rest in a radio idle window and at the end of
+ * the following radio TX. The difference of a pair is the voltage droop
+ * caused by the TX current,
+ * which gives internal resistance of the battery. Internal resistance of
+ * a coin cell rises at end of life and in cold, so the worst droop seen
+ * is subtracted from the rest voltage when predicting remaining life. Worst
+ * droop follows a deeper droop at once and decays towards smaller ones over
+ * APP_BATTERY_DROOP_DECAY_DIVISOR pairs.
+ *
+ * Typical usage:
+ * @code{.c}
+ * // In radio idle window or radio interrupt, after sampling VDD.
+ * app_battery_sample_isr (vdd, under_load);
+ * // In application.
+ * app_battery_state_t state;
+ * err_code |= app_battery_state_get (&state);
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Estimated battery condition. */
+typedef struct
+{
+    float idle_v;          //!< Filtered voltage at rest.
+    float load_v;          //!< Filtered voltage at the end of radio TX.
+    float droop_v;         //!< Filtered droop, idle_v - load_v.
+    float droop_max_v;     //!< Largest recent droop of a single pair, decays.
+    float resistance_ohm;  //!< Internal resistance estimated from filtered droop.
+    float trend_v_per_day; //!< Change of idle_v, negative while discharging.
+    float remaining_days;  //!< Days until worst case load hits cutoff, NAN if unknown.
+    uint32_t pairs;        //!< Number of rest and load sample pairs.
+} app_battery_state_t;
+
+/**
+ * @brief Pass a VDD sample to battery monitoring.
+ *
+ * Safe to call from interrupt context. Rest sample is only latched, and it is
+ * processed in scheduler together with the following sample under load.
+ *
+ * @param[in] vdd Sampled voltage.
+ * @param[in] under_load True if sample was taken at the end of radio TX,
+ *                       false if radio was idle.
+ */
+void app_battery_sample_isr (const float vdd, const bool under_load);
+
+/**
+ * @brief Get battery voltage to report.
+ *
+ * Voltage is latest voltage under radio load, as that is what the battery
+ * must sustain. If there are no samples under load yet, latest VDD sample
+ * of ADC task is returned.
+ *
+ * @param[out] vdd Battery voltage.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if vdd is NULL.
+ * @return Error code from ADC task if there are no samples under load.
+ */
+rd_status_t app_battery_vdd_get (float * const vdd);
+
+/**
+ * @brief Get estimated battery condition.
+ *
+ * @param[out] state Battery condition.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if state is NULL.
+ * @retval RD_ERROR_INVALID_STATE if there are no sample pairs yet,
+ *                                state is zeroed.
+ */
+rd_status_t app_battery_state_get (app_battery_state_t * const state);
+
+#ifdef CEEDLING
+void battery_process (const float vdd, const bool under_load, const uint64_t now_ms);
+void battery_sample_handler (void * p_event, uint16_t event_size);
+void app_battery_reset (void);
+#endif
+
+/** @} */
+#endif // APP_BATTERY_H
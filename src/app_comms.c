@@ -1,7 +1,13 @@
 #include "app_config.h"
+#include "app_acc_calibration.h"
 #include "app_comms.h"
+#include "app_dataformat_ext.h"
+#include "app_dataformats.h"
 #include "app_heartbeat.h"
+#include "app_jitter.h"
 #include "app_led.h"
+#include "app_profile.h"
+#include "app_radio.h"
 #include "app_sensor.h"
 #include "app_testing.h"
 #include "ruuvi_boards.h"
@@ -42,6 +48,15 @@
 #define CONN_PARAM_UPDATE_DELAY_MS (30U * 1000U) //!< Delay before switching to faster conn params in long ops.
 #define RUUVI_SERVICE_UUID (0xFC98U)
 
+#if APP_ADV_EXTENDED_ENABLED
+#   if !(defined(S140) || defined(CEEDLING))
+#       error "Extended advertising requires S140 softdevice."
+#   endif
+#   if (RI_COMM_MESSAGE_MAX_LENGTH < APP_DF_EXT_DATA_LENGTH)
+#       error "Extended data format does not fit RI_COMM_MESSAGE_MAX_LENGTH."
+#   endif
+#endif
+
 #if APP_COMMS_BIDIR_ENABLED
 TESTABLE_STATIC bool
 m_config_enabled_on_curr_conn; //!< This connection has config enabled.
@@ -58,10 +73,26 @@ typedef struct
 #endif
 
 static volatile bool m_tx_done; //!< Flag for data transfer done
+static volatile bool m_nfc_connected;   //!< NFC reader is in field.
 static uint8_t m_bleadv_repeat_count; //!< Number of times to repeat advertisement.
 TESTABLE_STATIC ri_timer_id_t m_comm_timer;    //!< Timer for communication mode changes.
 TESTABLE_STATIC mode_changes_t m_mode_ops;     //!< Pending mode changes.
 
+bool app_comms_gatt_subscribed (void)
+{
+#if APP_GATT_ENABLED
+    // NUS follows CCCD of its TX characteristic, connection alone is not enough.
+    return rt_gatt_nus_is_connected();
+#else
+    return false;
+#endif
+}
+
+bool app_comms_nfc_connected (void)
+{
+    return m_nfc_connected;
+}
+
 uint8_t app_comms_bleadv_send_count_get (void)
 {
     return m_bleadv_repeat_count;
@@ -261,6 +292,48 @@ static rd_status_t password_check (const ri_comm_xfer_fp_t reply_fp,
     return  err_code;
 }
 
+/**
+ * @brief Route messages to application endpoints not allocated in ruuvi.endpoints.
+ */
+static rd_status_t handle_app_endpoint (const ri_comm_xfer_fp_t reply_fp,
+                                        const uint8_t * const raw_message,
+                                        const size_t data_len)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    switch (raw_message[RE_STANDARD_DESTINATION_INDEX])
+    {
+        case APP_ENDPOINT_SENSOR_STATS:
+            err_code |= app_sensor_stats_handle (reply_fp, raw_message,
+                                                 (uint16_t) data_len);
+            break;
+
+        case APP_ENDPOINT_HEARTBEAT_PROFILE:
+            err_code |= app_profile_handle (reply_fp, raw_message, (uint16_t) data_len);
+            break;
+
+        case APP_ENDPOINT_DATAFORMAT_KEY:
+            err_code |= app_dataformat_key_handle (reply_fp, raw_message,
+                                                   (uint16_t) data_len);
+            break;
+
+        case APP_ENDPOINT_DATAFORMAT_WEIGHTS:
+            err_code |= app_dataformat_weights_handle (reply_fp, raw_message,
+                        (uint16_t) data_len);
+            break;
+
+        case APP_ENDPOINT_ACC_CALIBRATION:
+            err_code |= app_acc_calibration_handle (reply_fp, raw_message,
+                                                    (uint16_t) data_len);
+            break;
+
+        default:
+            break;
+    }
+
+    return err_code;
+}
+
 TESTABLE_STATIC void handle_comms (const ri_comm_xfer_fp_t reply_fp, void * p_data,
                                    size_t data_len)
 {
@@ -313,6 +386,7 @@ TESTABLE_STATIC void handle_comms (const ri_comm_xfer_fp_t reply_fp, void * p_da
                 break;
 
             default:
+                err_code |= handle_app_endpoint (reply_fp, raw_message, data_len);
                 break;
         }
 
@@ -348,6 +422,8 @@ static void config_cleanup_on_disconnect (void)
     m_config_enabled_on_curr_conn = false;
     err_code |= enable_config_on_next_conn (false);
     m_mode_ops.disable_config = 0; // No need to disable config again.
+    // Key chunks of this connection must not be completed by the next one.
+    app_dataformat_key_stage_clear();
     RD_ERROR_CHECK (err_code, RD_SUCCESS);
 }
 
@@ -369,6 +445,9 @@ TESTABLE_STATIC void handle_gatt_connected (void * p_data, uint16_t data_len)
     RD_ERROR_CHECK (err_code, RD_SUCCESS);
     err_code |= app_comms_ble_adv_init ();
     config_setup_on_this_conn ();
+#if APP_HEARTBEAT_SUBSCRIBED_ONLY_ENABLED
+    err_code |= app_heartbeat_live_set (true);
+#endif
     RD_ERROR_CHECK (err_code, RD_SUCCESS);
 }
 
@@ -389,6 +468,9 @@ TESTABLE_STATIC void handle_gatt_disconnected (void * p_data, uint16_t data_len)
 {
     rd_status_t err_code = RD_SUCCESS;
     config_cleanup_on_disconnect();
+#if APP_HEARTBEAT_SUBSCRIBED_ONLY_ENABLED
+    err_code |= app_heartbeat_live_set (false);
+#endif
     RD_ERROR_CHECK (err_code, RD_SUCCESS);
 }
 
@@ -450,6 +532,7 @@ TESTABLE_STATIC void handle_nfc_connected (void * p_data, uint16_t data_len)
 TESTABLE_STATIC void on_nfc_connected_isr (void * p_data, size_t data_len)
 {
     rd_status_t err_code = RD_SUCCESS;
+    m_nfc_connected = true;
     err_code |= ri_scheduler_event_put (p_data, (uint16_t) data_len, &handle_nfc_connected);
     RD_ERROR_CHECK (err_code, RD_SUCCESS);
 }
@@ -466,6 +549,7 @@ TESTABLE_STATIC void handle_nfc_disconnected (void * p_data, uint16_t data_len)
 TESTABLE_STATIC void on_nfc_disconnected_isr (void * p_data, size_t data_len)
 {
     rd_status_t err_code = RD_SUCCESS;
+    m_nfc_connected = false;
     err_code |= ri_scheduler_event_put (p_data, (uint16_t) data_len,
                                         &handle_nfc_disconnected);
     RD_ERROR_CHECK (err_code, RD_SUCCESS);
@@ -577,6 +661,26 @@ static rd_status_t nfc_init (ri_comm_dis_init_t * const p_dis)
     return err_code;
 }
 
+/**
+ * @brief Advertising interval of this device.
+ *
+ * @return APP_BLE_INTERVAL_MS with offset derived from radio address if enabled.
+ */
+static uint32_t adv_interval_ms (void)
+{
+    uint32_t interval_ms = APP_BLE_INTERVAL_MS;
+#if APP_ADV_INTERVAL_OFFSET_ENABLED
+    uint64_t address = 0;
+
+    if (RD_SUCCESS == ri_radio_address_get (&address))
+    {
+        interval_ms += app_jitter_offset_ms (address, APP_ADV_INTERVAL_OFFSET_MAX_MS);
+    }
+
+#endif
+    return interval_ms;
+}
+
 TESTABLE_STATIC void comm_mode_change_isr (void * const p_context)
 {
     mode_changes_t * const p_change = (mode_changes_t *) p_context;
@@ -584,7 +688,7 @@ TESTABLE_STATIC void comm_mode_change_isr (void * const p_context)
     if (p_change->switch_to_normal)
     {
         app_comms_bleadv_send_count_set (APP_NUM_REPEATS);
-        ri_adv_tx_interval_set (APP_BLE_INTERVAL_MS);
+        ri_adv_tx_interval_set (adv_interval_ms());
         p_change->switch_to_normal = 0;
     }
 
@@ -615,6 +719,7 @@ static rd_status_t adv_init (void)
     err_code |= rt_adv_init (&adv_settings);
     ri_adv_set_service_uuid (RUUVI_SERVICE_UUID);
     RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    // PDU type is up to drivers, longer payloads need a build with extended PDUs.
     err_code |= ri_adv_type_set (NONCONNECTABLE_NONSCANNABLE);
     RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
     app_comms_bleadv_send_count_set (initial_adv_send_count());
@@ -669,7 +774,7 @@ rd_status_t app_comms_init (const bool secure)
         err_code |= adv_init();
         err_code |= dis_init (&dis, secure);
         err_code |= gatt_init (&dis, secure);
-        ri_radio_activity_callback_set (&app_sensor_vdd_measure_isr);
+        ri_radio_activity_callback_set (&app_radio_activity_isr);
     }
 
     return err_code;
@@ -685,7 +790,7 @@ rd_status_t app_comms_ble_init (const bool secure)
     RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
     err_code |= gatt_init (&dis, secure);
     RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
-    ri_radio_activity_callback_set (&app_sensor_vdd_measure_isr);
+    ri_radio_activity_callback_set (&app_radio_activity_isr);
     return err_code;
 }
 
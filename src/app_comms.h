@@ -165,6 +165,25 @@ rd_status_t app_comms_ble_uninit (void);
 rd_status_t app_comms_blocking_send (const ri_comm_xfer_fp_t reply_fp,
                                      ri_comm_message_t * const msg);
 
+/**
+ * @brief Check if a GATT client is subscribed to data.
+ *
+ * Follows notification state of Nordic UART Service, which is set when client
+ * writes CCCD of TX characteristic and cleared on disconnection.
+ *
+ * @retval true GATT client receives heartbeat data.
+ * @retval false No GATT client is subscribed.
+ */
+bool app_comms_gatt_subscribed (void);
+
+/**
+ * @brief Check if NFC reader is in field.
+ *
+ * @retval true NFC reader is connected.
+ * @retval false No NFC reader is connected.
+ */
+bool app_comms_nfc_connected (void);
+
 #ifdef CEEDLING
 /** Handles for unit test framework */
 typedef struct
@@ -0,0 +1,468 @@
+/**
+ * @addtogroup app_dataformat_decoder
+ */
+/** @{ */
+/**
+ * @file app_dataformat_decoder.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Batch decoder of data formats.
+ */
+#include "app_dataformat_decoder.h"
+#include "app_dataformat_official.h"
+#include "ruuvi_endpoint_7.h"
+#include "ruuvi_endpoint_8.h"
+#include "ruuvi_endpoint_fa.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @brief Decode records of one format.
+ *
+ * @param[in] raw First record of batch.
+ * @param[in] stride Bytes between records.
+ * @param[in] base Index of first record of chunk.
+ * @param[in] index Records of this format, relative to base.
+ * @param[in] num Number of records in index.
+ * @param[out] p_out Output arrays.
+ */
+typedef void (*format_decoder_t) (const uint8_t * const raw, const size_t stride,
+                                  const size_t base, const uint8_t * const index,
+                                  const size_t num,
+                                  const app_dataformat_decoded_t * const p_out);
+
+/** @brief Recognised format. */
+typedef struct
+{
+    uint8_t id;               //!< First byte of record.
+    size_t length;            //!< Length of record.
+    app_dataformat_t format;  //!< Format in firmware.
+    format_decoder_t decode;  //!< NULL if fields can't be decoded.
+} format_t;
+
+static void decode_3 (const uint8_t * const raw, const size_t stride, const size_t base,
+                      const uint8_t * const index, const size_t num,
+                      const app_dataformat_decoded_t * const p_out);
+static void decode_5 (const uint8_t * const raw, const size_t stride, const size_t base,
+                      const uint8_t * const index, const size_t num,
+                      const app_dataformat_decoded_t * const p_out);
+static void decode_c5 (const uint8_t * const raw, const size_t stride, const size_t base,
+                       const uint8_t * const index, const size_t num,
+                       const app_dataformat_decoded_t * const p_out);
+static void decode_history (const uint8_t * const raw, const size_t stride,
+                            const size_t base, const uint8_t * const index,
+                            const size_t num,
+                            const app_dataformat_decoded_t * const p_out);
+static void decode_ext (const uint8_t * const raw, const size_t stride,
+                        const size_t base, const uint8_t * const index,
+                        const size_t num,
+                        const app_dataformat_decoded_t * const p_out);
+
+static const format_t m_formats[] =
+{
+    { APP_DF_3_ID, RE_3_DATA_LENGTH, DF_3, &decode_3 },
+    { APP_DF_5_ID, RE_5_DATA_LENGTH, DF_5, &decode_5 },
+    { APP_DF_7_ID, RE_7_DATA_LENGTH, DF_7, NULL },
+    { APP_DF_8_ID, RE_8_DATA_LENGTH, DF_8, NULL },
+    { APP_DF_C5_ID, RE_C5_DATA_LENGTH, DF_C5, &decode_c5 },
+    { APP_DF_FA_ID, RE_FA_DATA_LENGTH, DF_FA, NULL },
+    { APP_DF_HISTORY_ID, APP_DF_HISTORY_DATA_LENGTH, DF_HISTORY, &decode_history },
+    { APP_DF_EXT_ID, APP_DF_EXT_DATA_LENGTH, DF_EXT, &decode_ext }
+};
+
+#define FORMAT_COUNT (sizeof (m_formats) / sizeof (m_formats[0]))
+
+/** @brief Index in m_formats + 1 by format byte, 0 if not recognised. */
+static const uint8_t m_format_lookup[UINT8_MAX + 1U] =
+{
+    [APP_DF_3_ID] = 1U,
+    [APP_DF_5_ID] = 2U,
+    [APP_DF_7_ID] = 3U,
+    [APP_DF_8_ID] = 4U,
+    [APP_DF_C5_ID] = 5U,
+    [APP_DF_FA_ID] = 6U,
+    [APP_DF_HISTORY_ID] = 7U,
+    [APP_DF_EXT_ID] = 8U
+};
+
+static inline uint16_t u16_read (const uint8_t * const p_raw)
+{
+    return (uint16_t) ( (p_raw[0] << 8U) | p_raw[1]);
+}
+
+/** @brief Signed value, invalid at INT16_MIN. */
+static inline float s16_value (const uint8_t * const p_raw, const float scale)
+{
+    const int16_t raw = (int16_t) u16_read (p_raw);
+    return (INT16_MIN == raw) ? NAN : ( (float) raw * scale);
+}
+
+/** @brief Signed value of format 3, which has no invalid values. */
+static inline float s16_plain_value (const uint8_t * const p_raw, const float scale)
+{
+    return (float) (int16_t) u16_read (p_raw) * scale;
+}
+
+/** @brief Unsigned value, invalid at UINT16_MAX. */
+static inline float u16_value (const uint8_t * const p_raw, const float offset,
+                               const float scale)
+{
+    const uint16_t raw = u16_read (p_raw);
+    return (UINT16_MAX == raw) ? NAN : ( ( (float) raw * scale) + offset);
+}
+
+static inline uint64_t address_read (const uint8_t * const p_raw)
+{
+    uint64_t address = 0U;
+
+    for (size_t ii = 0; ii < APP_DF_ADDRESS_LENGTH; ii++)
+    {
+        address = (address << 8U) | p_raw[ii];
+    }
+
+    return address;
+}
+
+/** @brief Battery and TX power packed into 11 + 5 bits in formats 5 and C5. */
+static inline void power_decode (const uint8_t * const p_raw, const size_t rr,
+                                 const app_dataformat_decoded_t * const p_out)
+{
+    const uint16_t power = u16_read (p_raw);
+    const uint16_t battery = power >> APP_DF_5_TX_BITS;
+    const uint16_t tx = power & APP_DF_5_TX_MASK;
+    const float battery_v = ( (float) battery * (1.0F / APP_DF_5_BATT_RATIO))
+                            + APP_DF_5_BATT_OFFSET;
+    p_out->battery_v[rr] = (APP_DF_5_BATT_INVALID == battery) ? NAN : battery_v;
+    p_out->tx_power_dbm[rr] = (APP_DF_5_TX_INVALID == tx) ? NAN :
+                              ( ( (float) tx * APP_DF_5_TX_STEP) + APP_DF_5_TX_OFFSET);
+}
+
+static void decode_3 (const uint8_t * const raw, const size_t stride, const size_t base,
+                      const uint8_t * const index, const size_t num,
+                      const app_dataformat_decoded_t * const p_out)
+{
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        const size_t rr = base + index[ii];
+        const uint8_t * const p_raw = raw + (rr * stride);
+        const uint8_t temp_int = p_raw[APP_DF_3_OFFSET_TEMP];
+        const float fraction = (float) p_raw[APP_DF_3_OFFSET_TEMP + 1U]
+                               * (1.0F / APP_DF_3_TEMP_RATIO);
+        const float temperature = (float) (temp_int & APP_DF_3_TEMP_INT_MASK) + fraction;
+        p_out->temperature_c[rr] = (0U != (temp_int & APP_DF_3_TEMP_SIGN)) ?
+                                   -temperature : temperature;
+        p_out->humidity_rh[rr] = (float) p_raw[APP_DF_3_OFFSET_HUMI]
+                                 * (1.0F / APP_DF_3_HUMI_RATIO);
+        p_out->pressure_pa[rr] = (float) u16_read (&p_raw[APP_DF_3_OFFSET_PRES])
+                                 + APP_DF_5_PRES_OFFSET;
+        p_out->acceleration_x_g[rr] = s16_plain_value (&p_raw[APP_DF_3_OFFSET_ACC_X],
+                                      1.0F / APP_DF_5_ACC_RATIO);
+        p_out->acceleration_y_g[rr] = s16_plain_value (&p_raw[APP_DF_3_OFFSET_ACC_Y],
+                                      1.0F / APP_DF_5_ACC_RATIO);
+        p_out->acceleration_z_g[rr] = s16_plain_value (&p_raw[APP_DF_3_OFFSET_ACC_Z],
+                                      1.0F / APP_DF_5_ACC_RATIO);
+        p_out->battery_v[rr] = (float) u16_read (&p_raw[APP_DF_3_OFFSET_BATTERY])
+                               * (1.0F / APP_DF_5_BATT_RATIO);
+    }
+}
+
+static void decode_5 (const uint8_t * const raw, const size_t stride, const size_t base,
+                      const uint8_t * const index, const size_t num,
+                      const app_dataformat_decoded_t * const p_out)
+{
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        const size_t rr = base + index[ii];
+        const uint8_t * const p_raw = raw + (rr * stride);
+        const uint8_t movement = p_raw[APP_DF_5_OFFSET_MOVEMENT];
+        const uint16_t sequence = u16_read (&p_raw[APP_DF_5_OFFSET_SEQUENCE]);
+        p_out->temperature_c[rr] = s16_value (&p_raw[APP_DF_5_OFFSET_TEMP],
+                                              1.0F / APP_DF_5_TEMP_RATIO);
+        p_out->humidity_rh[rr] = u16_value (&p_raw[APP_DF_5_OFFSET_HUMI], 0.0F,
+                                            1.0F / APP_DF_5_HUMI_RATIO);
+        p_out->pressure_pa[rr] = u16_value (&p_raw[APP_DF_5_OFFSET_PRES],
+                                            APP_DF_5_PRES_OFFSET, 1.0F);
+        p_out->acceleration_x_g[rr] = s16_value (&p_raw[APP_DF_5_OFFSET_ACC_X],
+                                      1.0F / APP_DF_5_ACC_RATIO);
+        p_out->acceleration_y_g[rr] = s16_value (&p_raw[APP_DF_5_OFFSET_ACC_Y],
+                                      1.0F / APP_DF_5_ACC_RATIO);
+        p_out->acceleration_z_g[rr] = s16_value (&p_raw[APP_DF_5_OFFSET_ACC_Z],
+                                      1.0F / APP_DF_5_ACC_RATIO);
+        power_decode (&p_raw[APP_DF_5_OFFSET_POWER], rr, p_out);
+        p_out->movement_count[rr] = (APP_DF_5_MOVEMENT_INVALID == movement) ?
+                                    APP_DF_DECODER_COUNT_INVALID : movement;
+        p_out->sequence[rr] = (APP_DF_5_SEQUENCE_INVALID == sequence) ?
+                              APP_DF_DECODER_COUNT_INVALID : sequence;
+        p_out->address[rr] = address_read (&p_raw[APP_DF_5_OFFSET_ADDRESS]);
+    }
+}
+
+static void decode_c5 (const uint8_t * const raw, const size_t stride, const size_t base,
+                       const uint8_t * const index, const size_t num,
+                       const app_dataformat_decoded_t * const p_out)
+{
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        const size_t rr = base + index[ii];
+        const uint8_t * const p_raw = raw + (rr * stride);
+        const uint8_t movement = p_raw[APP_DF_C5_OFFSET_MOVEMENT];
+        const uint16_t sequence = u16_read (&p_raw[APP_DF_C5_OFFSET_SEQUENCE]);
+        p_out->temperature_c[rr] = s16_value (&p_raw[APP_DF_C5_OFFSET_TEMP],
+                                              1.0F / APP_DF_5_TEMP_RATIO);
+        p_out->humidity_rh[rr] = u16_value (&p_raw[APP_DF_C5_OFFSET_HUMI], 0.0F,
+                                            1.0F / APP_DF_5_HUMI_RATIO);
+        p_out->pressure_pa[rr] = u16_value (&p_raw[APP_DF_C5_OFFSET_PRES],
+                                            APP_DF_5_PRES_OFFSET, 1.0F);
+        power_decode (&p_raw[APP_DF_C5_OFFSET_POWER], rr, p_out);
+        p_out->movement_count[rr] = (APP_DF_C5_MOVEMENT_INVALID == movement) ?
+                                    APP_DF_DECODER_COUNT_INVALID : movement;
+        p_out->sequence[rr] = (APP_DF_C5_SEQUENCE_INVALID == sequence) ?
+                              APP_DF_DECODER_COUNT_INVALID : sequence;
+        p_out->address[rr] = address_read (&p_raw[APP_DF_C5_OFFSET_ADDRESS]);
+    }
+}
+
+/** @brief Logged value, invalid if delta or latest reading is invalid. */
+static inline float logged_value (const float latest, const uint8_t delta,
+                                  const float scale, const bool valid)
+{
+    return (valid && (APP_DF_HISTORY_DELTA_INVALID != delta)) ?
+           (latest + ( (float) (int8_t) delta * scale)) : NAN;
+}
+
+static void decode_history (const uint8_t * const raw, const size_t stride,
+                            const size_t base, const uint8_t * const index,
+                            const size_t num,
+                            const app_dataformat_decoded_t * const p_out)
+{
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        const size_t rr = base + index[ii];
+        const uint8_t * const p_raw = raw + (rr * stride);
+        const uint8_t samples = p_raw[APP_DF_HISTORY_OFFSET_COUNT];
+        const float temperature = s16_value (&p_raw[APP_DF_HISTORY_OFFSET_TEMP],
+                                             1.0F / APP_DF_HISTORY_TEMP_RATIO);
+        const float humidity = u16_value (&p_raw[APP_DF_HISTORY_OFFSET_HUMI], 0.0F,
+                                          1.0F / APP_DF_HISTORY_HUMI_RATIO);
+        const float pressure = u16_value (&p_raw[APP_DF_HISTORY_OFFSET_PRES],
+                                          APP_DF_HISTORY_PRES_OFFSET, 1.0F);
+        p_out->temperature_c[rr] = temperature;
+        p_out->humidity_rh[rr] = humidity;
+        p_out->pressure_pa[rr] = pressure;
+        p_out->log_sequence[rr] = (0U < samples) ?
+                                  u16_read (&p_raw[APP_DF_HISTORY_OFFSET_SEQUENCE]) :
+                                  APP_DF_DECODER_COUNT_INVALID;
+        p_out->log_interval_s[rr] =
+            (0U < samples) ? u16_read (&p_raw[APP_DF_HISTORY_OFFSET_INTERVAL]) : 0U;
+
+        // All slots are decoded and masked by count to keep the loop branch-free.
+        for (size_t ss = 0; ss < APP_DF_HISTORY_SAMPLES; ss++)
+        {
+            const uint8_t * const p_delta = &p_raw[APP_DF_HISTORY_OFFSET_DELTAS
+                                                   + (ss * APP_DF_HISTORY_DELTA_SIZE)];
+            const size_t oo = (rr * APP_DF_HISTORY_SAMPLES) + ss;
+            const bool valid = (ss < samples);
+            p_out->logged_temperature_c[oo] =
+                logged_value (temperature, p_delta[0], 1.0F / APP_DF_HISTORY_DTEMP_RATIO,
+                              valid);
+            p_out->logged_humidity_rh[oo] =
+                logged_value (humidity, p_delta[1], 1.0F / APP_DF_HISTORY_DHUMI_RATIO,
+                              valid);
+            p_out->logged_pressure_pa[oo] =
+                logged_value (pressure, p_delta[2], 1.0F / APP_DF_HISTORY_DPRES_RATIO,
+                              valid);
+        }
+    }
+}
+
+static void decode_ext (const uint8_t * const raw, const size_t stride,
+                        const size_t base, const uint8_t * const index,
+                        const size_t num,
+                        const app_dataformat_decoded_t * const p_out)
+{
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        const size_t rr = base + index[ii];
+        const uint8_t * const p_raw = raw + (rr * stride);
+        const uint8_t flags = p_raw[APP_DF_EXT_OFFSET_FLAGS];
+        const bool log = (0U != (flags & APP_DF_EXT_FLAG_LOG));
+        const uint8_t crest = p_raw[APP_DF_EXT_OFFSET_VIB_CREST];
+        p_out->temperature_c[rr] = s16_value (&p_raw[APP_DF_EXT_OFFSET_TEMP],
+                                              1.0F / APP_DF_EXT_TEMP_RATIO);
+        p_out->humidity_rh[rr] = u16_value (&p_raw[APP_DF_EXT_OFFSET_HUMI], 0.0F,
+                                            1.0F / APP_DF_EXT_HUMI_RATIO);
+        p_out->pressure_pa[rr] = u16_value (&p_raw[APP_DF_EXT_OFFSET_PRES],
+                                            APP_DF_EXT_PRES_OFFSET, 1.0F);
+        p_out->acceleration_x_g[rr] = s16_value (&p_raw[APP_DF_EXT_OFFSET_ACC_X],
+                                      1.0F / APP_DF_EXT_ACC_RATIO);
+        p_out->acceleration_y_g[rr] = s16_value (&p_raw[APP_DF_EXT_OFFSET_ACC_Y],
+                                      1.0F / APP_DF_EXT_ACC_RATIO);
+        p_out->acceleration_z_g[rr] = s16_value (&p_raw[APP_DF_EXT_OFFSET_ACC_Z],
+                                      1.0F / APP_DF_EXT_ACC_RATIO);
+        p_out->battery_v[rr] = u16_value (&p_raw[APP_DF_EXT_OFFSET_BATTERY], 0.0F,
+                                          1.0F / APP_DF_EXT_BATT_RATIO);
+        p_out->tx_power_dbm[rr] = (float) (int8_t) p_raw[APP_DF_EXT_OFFSET_TX_POWER];
+        p_out->flags[rr] = flags;
+        p_out->sequence[rr] = u16_read (&p_raw[APP_DF_EXT_OFFSET_SEQUENCE]);
+        p_out->movement_count[rr] = u16_read (&p_raw[APP_DF_EXT_OFFSET_MOVEMENT]);
+        p_out->log_sequence[rr] = log ? u16_read (&p_raw[APP_DF_EXT_OFFSET_LOG_SEQUENCE])
+                                  : APP_DF_DECODER_COUNT_INVALID;
+        p_out->log_interval_s[rr] =
+            log ? u16_read (&p_raw[APP_DF_EXT_OFFSET_LOG_INTERVAL]) : 0U;
+        p_out->address[rr] = address_read (&p_raw[APP_DF_EXT_OFFSET_ADDRESS]);
+        p_out->battery_resistance_ohm[rr] =
+            u16_value (&p_raw[APP_DF_EXT_OFFSET_RESISTANCE], 0.0F,
+                       1.0F / APP_DF_EXT_RES_RATIO);
+        p_out->battery_remaining_days[rr] =
+            u16_value (&p_raw[APP_DF_EXT_OFFSET_REMAINING], 0.0F, 1.0F);
+        p_out->vibration_rms_g[rr] = u16_value (&p_raw[APP_DF_EXT_OFFSET_VIB_RMS], 0.0F,
+                                                1.0F / APP_DF_EXT_ACC_RATIO);
+        p_out->vibration_peak_g[rr] = u16_value (&p_raw[APP_DF_EXT_OFFSET_VIB_PEAK], 0.0F,
+                                      1.0F / APP_DF_EXT_ACC_RATIO);
+        p_out->vibration_crest[rr] = (APP_DF_EXT_U8_INVALID == crest) ? NAN :
+                                     ( (float) crest * (1.0F / APP_DF_EXT_CREST_RATIO));
+        p_out->vibration_hz[rr] = u16_value (&p_raw[APP_DF_EXT_OFFSET_VIB_FREQ], 0.0F,
+                                             1.0F / APP_DF_EXT_FREQ_RATIO);
+        p_out->temperature_min_c[rr] = s16_value (&p_raw[APP_DF_EXT_OFFSET_TEMP_MIN],
+                                       1.0F / APP_DF_EXT_TEMP_RATIO);
+        p_out->temperature_max_c[rr] = s16_value (&p_raw[APP_DF_EXT_OFFSET_TEMP_MAX],
+                                       1.0F / APP_DF_EXT_TEMP_RATIO);
+        p_out->presence_count[rr] = u16_read (&p_raw[APP_DF_EXT_OFFSET_PRESENCE]);
+    }
+}
+
+static void floats_invalidate (float * const p_values, const size_t num)
+{
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        p_values[ii] = NAN;
+    }
+}
+
+static void counts_invalidate (int32_t * const p_counts, const size_t num)
+{
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        p_counts[ii] = APP_DF_DECODER_COUNT_INVALID;
+    }
+}
+
+/**
+ * @brief Mark all fields of records invalid, formats overwrite what they have.
+ *
+ * One array at a time, as a store to a byte array could alias pointers of
+ * p_out and force a reload of each pointer per record.
+ */
+static void records_invalidate (const size_t base, const size_t num,
+                                const app_dataformat_decoded_t * const p_out)
+{
+    const size_t logged_base = base * APP_DF_HISTORY_SAMPLES;
+    const size_t logged_num = num * APP_DF_HISTORY_SAMPLES;
+    uint64_t * const p_address = &p_out->address[base];
+
+    for (size_t ii = 0; ii < num; ii++)
+    {
+        p_out->format[base + ii] = DF_INVALID;
+        p_address[ii] = APP_DF_DECODER_ADDRESS_INVALID;
+    }
+
+    floats_invalidate (&p_out->temperature_c[base], num);
+    floats_invalidate (&p_out->humidity_rh[base], num);
+    floats_invalidate (&p_out->pressure_pa[base], num);
+    floats_invalidate (&p_out->acceleration_x_g[base], num);
+    floats_invalidate (&p_out->acceleration_y_g[base], num);
+    floats_invalidate (&p_out->acceleration_z_g[base], num);
+    floats_invalidate (&p_out->battery_v[base], num);
+    floats_invalidate (&p_out->tx_power_dbm[base], num);
+    floats_invalidate (&p_out->battery_resistance_ohm[base], num);
+    floats_invalidate (&p_out->battery_remaining_days[base], num);
+    floats_invalidate (&p_out->vibration_rms_g[base], num);
+    floats_invalidate (&p_out->vibration_peak_g[base], num);
+    floats_invalidate (&p_out->vibration_crest[base], num);
+    floats_invalidate (&p_out->vibration_hz[base], num);
+    floats_invalidate (&p_out->temperature_min_c[base], num);
+    floats_invalidate (&p_out->temperature_max_c[base], num);
+    floats_invalidate (&p_out->logged_temperature_c[logged_base], logged_num);
+    floats_invalidate (&p_out->logged_humidity_rh[logged_base], logged_num);
+    floats_invalidate (&p_out->logged_pressure_pa[logged_base], logged_num);
+    counts_invalidate (&p_out->movement_count[base], num);
+    counts_invalidate (&p_out->presence_count[base], num);
+    counts_invalidate (&p_out->sequence[base], num);
+    counts_invalidate (&p_out->log_sequence[base], num);
+    memset (&p_out->flags[base], 0, num * sizeof (p_out->flags[0]));
+    memset (&p_out->log_interval_s[base], 0, num * sizeof (p_out->log_interval_s[0]));
+}
+
+static bool outputs_valid (const app_dataformat_decoded_t * const p_out)
+{
+    return (NULL != p_out)
+           && (NULL != p_out->format) && (NULL != p_out->temperature_c)
+           && (NULL != p_out->humidity_rh) && (NULL != p_out->pressure_pa)
+           && (NULL != p_out->acceleration_x_g) && (NULL != p_out->acceleration_y_g)
+           && (NULL != p_out->acceleration_z_g) && (NULL != p_out->battery_v)
+           && (NULL != p_out->tx_power_dbm) && (NULL != p_out->battery_resistance_ohm)
+           && (NULL != p_out->battery_remaining_days) && (NULL != p_out->vibration_rms_g)
+           && (NULL != p_out->vibration_peak_g) && (NULL != p_out->vibration_crest)
+           && (NULL != p_out->vibration_hz) && (NULL != p_out->temperature_min_c)
+           && (NULL != p_out->temperature_max_c) && (NULL != p_out->movement_count)
+           && (NULL != p_out->presence_count)
+           && (NULL != p_out->sequence) && (NULL != p_out->address)
+           && (NULL != p_out->flags) && (NULL != p_out->log_sequence)
+           && (NULL != p_out->log_interval_s) && (NULL != p_out->logged_temperature_c)
+           && (NULL != p_out->logged_humidity_rh) && (NULL != p_out->logged_pressure_pa);
+}
+
+rd_status_t app_dataformat_decode (const uint8_t * const raw, const size_t stride,
+                                   const uint8_t * const lengths, const size_t count,
+                                   const app_dataformat_decoded_t * const p_out)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == raw) || (NULL == lengths) || (!outputs_valid (p_out)))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        for (size_t base = 0; base < count; base += APP_DF_DECODER_CHUNK)
+        {
+            const size_t chunk = ( (count - base) < APP_DF_DECODER_CHUNK) ?
+                                 (count - base) : APP_DF_DECODER_CHUNK;
+            uint8_t index[FORMAT_COUNT][APP_DF_DECODER_CHUNK];
+            size_t found[FORMAT_COUNT] = {0};
+            records_invalidate (base, chunk, p_out);
+
+            // Sort records by format so each format is decoded by a tight loop.
+            for (size_t ii = 0; ii < chunk; ii++)
+            {
+                const size_t rr = base + ii;
+                const uint8_t lookup = (0U < lengths[rr]) ?
+                                       m_format_lookup[raw[rr * stride]] : 0U;
+
+                if ( (0U < lookup) && (m_formats[lookup - 1U].length == lengths[rr]))
+                {
+                    const size_t ff = lookup - 1U;
+                    index[ff][found[ff]] = (uint8_t) ii;
+                    found[ff]++;
+                    p_out->format[rr] = m_formats[ff].format;
+                }
+            }
+
+            for (size_t ff = 0; ff < FORMAT_COUNT; ff++)
+            {
+                if ( (NULL != m_formats[ff].decode) && (0U < found[ff]))
+                {
+                    m_formats[ff].decode (raw, stride, base, index[ff], found[ff], p_out);
+                }
+            }
+        }
+    }
+
+    return err_code;
+}
+
+/** @} */
@@ -0,0 +1,126 @@
+#ifndef APP_DATAFORMAT_DECODER_H
+#define APP_DATAFORMAT_DECODER_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_dataformat_decoder Data format decoder
+ * @brief Batch decoder of advertisements for gateways.
+ */
+/** @} */
+/**
+ * @addtogroup app_dataformat_decoder
+ */
+/** @{ */
+/**
+ * @file app_dataformat_decoder.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Portable decoder of data formats produced by @ref app_dataformats.c, for
+ * gateways which decode tens of thousands of advertisements per second. Not
+ * linked into firmware.
+ *
+ * Raw records are decoded in batches into struct-of-arrays output. Records
+ * are first sorted by format one chunk at a time, then each format is decoded
+ * by its own loop. Invalid values are selected rather than branched on, so
+ * the loops have no data-dependent branches, and output is reset by plain
+ * fills of each array which compiler vectorises.
+ *
+ * Layouts come from the same headers the encoders use, so encoder and
+ * decoder don't drift apart: @ref app_dataformat_official.h for formats 3, 5
+ * and C5, @ref app_dataformat_history.h and @ref app_dataformat_ext.h for the
+ * in-tree formats. Formats 7, 8 and FA are identified but their fields are
+ * left invalid until a follow-up change: 7 needs the layout of
+ * ruuvi_endpoint_7.c mirrored in @ref app_dataformat_official.h, and 8 and
+ * FA need a table of keys, as provisioned with @ref app_dataformat_key_set,
+ * passed to the decoder to decrypt them.
+ *
+ * Typical usage:
+ * @code{.c}
+ * // Manufacturer specific data, after company ID, in fixed size slots.
+ * static uint8_t raw[COUNT][APP_DF_DECODER_RECORD_MAX];
+ * static uint8_t lengths[COUNT];
+ * static float temperature_c[COUNT];
+ * // ... other output arrays ...
+ * app_dataformat_decoded_t out = { .temperature_c = temperature_c, ... };
+ * err_code |= app_dataformat_decode (&raw[0][0], sizeof (raw[0]), lengths, COUNT,
+ *                                    &out);
+ * @endcode
+ */
+
+#include "app_dataformats.h"
+#include "app_dataformat_ext.h"
+#include "app_dataformat_history.h"
+#include "ruuvi_driver_error.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define APP_DF_DECODER_RECORD_MAX (APP_DF_EXT_DATA_LENGTH) //!< Longest decoded record.
+#define APP_DF_DECODER_CHUNK      (64U) //!< Records sorted by format at a time.
+#define APP_DF_DECODER_COUNT_INVALID   (-1) //!< Counter not in record or invalid.
+#define APP_DF_DECODER_ADDRESS_INVALID (0xFFFFFFFFFFFFULL) //!< Address not in record.
+
+/**
+ * @brief Decoded records, one element per record in each array.
+ *
+ * Caller provides all arrays, logged_ arrays have APP_DF_HISTORY_SAMPLES
+ * elements per record, newest first. Values which are not in the record or
+ * are invalid are NAN, counters are APP_DF_DECODER_COUNT_INVALID.
+ */
+typedef struct
+{
+    app_dataformat_t * format; //!< Format of record, DF_INVALID if not recognised.
+    float * temperature_c;     //!< Temperature, C.
+    float * humidity_rh;       //!< Relative humidity, %.
+    float * pressure_pa;       //!< Pressure, Pa.
+    float * acceleration_x_g;  //!< Acceleration along X, g.
+    float * acceleration_y_g;  //!< Acceleration along Y, g.
+    float * acceleration_z_g;  //!< Acceleration along Z, g.
+    float * battery_v;         //!< Battery voltage, V.
+    float * tx_power_dbm;      //!< Advertising TX power, dBm.
+    float * battery_resistance_ohm; //!< Battery internal resistance, Ohm.
+    float * battery_remaining_days; //!< Battery remaining life, days.
+    float * vibration_rms_g;   //!< RMS of vibration, g.
+    float * vibration_peak_g;  //!< Peak of vibration, g.
+    float * vibration_crest;   //!< Crest factor of vibration, peak / RMS.
+    float * vibration_hz;      //!< Dominant frequency of vibration, Hz.
+    float * temperature_min_c; //!< Smallest temperature over heartbeat, C.
+    float * temperature_max_c; //!< Largest temperature over heartbeat, C.
+    int32_t * movement_count;  //!< Motion events counted by tag.
+    int32_t * presence_count;  //!< Presences counted by tag.
+    int32_t * sequence;        //!< Measurement sequence number.
+    uint64_t * address;        //!< MAC address, APP_DF_DECODER_ADDRESS_INVALID if none.
+    uint8_t * flags;           //!< APP_DF_EXT_FLAG_ bits of extended format, else 0.
+    int32_t * log_sequence;    //!< Sequence number of newest logged sample.
+    uint16_t * log_interval_s; //!< Interval of logged samples, 0 if not known.
+    float * logged_temperature_c; //!< Logged temperatures of history format.
+    float * logged_humidity_rh;   //!< Logged humidities of history format.
+    float * logged_pressure_pa;   //!< Logged pressures of history format.
+} app_dataformat_decoded_t;
+
+/**
+ * @brief Decode a batch of raw records.
+ *
+ * Record ii starts at raw + (ii * stride) and has lengths[ii] bytes, starting
+ * with format byte. A record with unknown format byte or a length which does
+ * not match its format is DF_INVALID with all fields invalid.
+ *
+ * @param[in] raw First record.
+ * @param[in] stride Bytes from start of one record to the next.
+ * @param[in] lengths Length of each record.
+ * @param[in] count Number of records.
+ * @param[out] p_out Arrays to decode into, at least count elements each.
+ *
+ * @retval RD_SUCCESS on success, even if some records were not recognised.
+ * @retval RD_ERROR_NULL if any pointer, including arrays of p_out, is NULL.
+ */
+rd_status_t app_dataformat_decode (const uint8_t * const raw, const size_t stride,
+                                   const uint8_t * const lengths, const size_t count,
+                                   const app_dataformat_decoded_t * const p_out);
+
+/** @} */
+#endif // APP_DATAFORMAT_DECODER_H
@@ -0,0 +1,139 @@
+/**
+ * @addtogroup app_dataformat_ext
+ */
+/** @{ */
+/**
+ * @file app_dataformat_ext.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Encoder of extended data format.
+ */
+#include "app_dataformat_ext.h"
+
+#include <math.h>
+#include <stddef.h>
+
+static void u16_write (uint8_t * const p_dst, const uint16_t value)
+{
+    p_dst[0] = (uint8_t) (value >> 8U);
+    p_dst[1] = (uint8_t) (value & 0xFFU);
+}
+
+/** @brief Scale and offset value, invalid if it does not fit in [min, max]. */
+static float value_scale (const float value, const float offset, const float ratio,
+                          const float min, const float max)
+{
+    const float scaled = roundf ( (value - offset) * ratio);
+    return ( (scaled >= min) && (scaled <= max)) ? scaled : NAN;
+}
+
+/** @brief Encode signed value, invalid at INT16_MIN. */
+static uint16_t signed_encode (const float value, const float ratio)
+{
+    const float scaled = value_scale (value, 0.0F, ratio, (float) -INT16_MAX,
+                                      (float) INT16_MAX);
+    return isnan (scaled) ? APP_DF_EXT_S16_INVALID : (uint16_t) (int16_t) scaled;
+}
+
+/** @brief Encode unsigned byte, invalid at UINT8_MAX. */
+static uint8_t u8_encode (const float value, const float ratio)
+{
+    const float scaled = value_scale (value, 0.0F, ratio, 0.0F, (float) (UINT8_MAX - 1U));
+    return isnan (scaled) ? APP_DF_EXT_U8_INVALID : (uint8_t) scaled;
+}
+
+/** @brief Encode unsigned value, invalid at UINT16_MAX. */
+static uint16_t unsigned_encode (const float value, const float offset,
+                                 const float ratio)
+{
+    const float scaled = value_scale (value, offset, ratio, 0.0F,
+                                      (float) (UINT16_MAX - 1U));
+    return isnan (scaled) ? APP_DF_EXT_U16_INVALID : (uint16_t) scaled;
+}
+
+rd_status_t app_dataformat_ext_encode (uint8_t * const buffer,
+                                       const app_dataformat_ext_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == buffer) || (NULL == p_data))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        uint8_t flags = 0U;
+        buffer[APP_DF_EXT_OFFSET_HEADER] = APP_DF_EXT_ID;
+        u16_write (&buffer[APP_DF_EXT_OFFSET_TEMP],
+                   signed_encode (p_data->temperature_c, APP_DF_EXT_TEMP_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_HUMI],
+                   unsigned_encode (p_data->humidity_rh, 0.0F, APP_DF_EXT_HUMI_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_PRES],
+                   unsigned_encode (p_data->pressure_pa, APP_DF_EXT_PRES_OFFSET, 1.0F));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_ACC_X],
+                   signed_encode (p_data->acceleration_x_g, APP_DF_EXT_ACC_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_ACC_Y],
+                   signed_encode (p_data->acceleration_y_g, APP_DF_EXT_ACC_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_ACC_Z],
+                   signed_encode (p_data->acceleration_z_g, APP_DF_EXT_ACC_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_BATTERY],
+                   unsigned_encode (p_data->battery_v, 0.0F, APP_DF_EXT_BATT_RATIO));
+        buffer[APP_DF_EXT_OFFSET_TX_POWER] = (uint8_t) p_data->tx_power;
+
+        if (p_data->motion)
+        {
+            flags |= APP_DF_EXT_FLAG_MOTION;
+        }
+
+        if (p_data->presence)
+        {
+            flags |= APP_DF_EXT_FLAG_PRESENCE;
+        }
+
+        if (p_data->log)
+        {
+            flags |= APP_DF_EXT_FLAG_LOG;
+        }
+
+        buffer[APP_DF_EXT_OFFSET_FLAGS] = flags;
+        u16_write (&buffer[APP_DF_EXT_OFFSET_SEQUENCE], p_data->sequence);
+        u16_write (&buffer[APP_DF_EXT_OFFSET_MOVEMENT], p_data->movement_count);
+        // Log fields are zeroed rather than left stale when log is not valid.
+        u16_write (&buffer[APP_DF_EXT_OFFSET_LOG_SEQUENCE],
+                   p_data->log ? p_data->log_sequence : 0U);
+        u16_write (&buffer[APP_DF_EXT_OFFSET_LOG_INTERVAL],
+                   p_data->log ? p_data->log_interval_s : 0U);
+
+        for (size_t ii = 0; ii < 6U; ii++)
+        {
+            buffer[APP_DF_EXT_OFFSET_ADDRESS + ii] =
+                (uint8_t) (p_data->address >> (8U * (5U - ii)));
+        }
+
+        u16_write (&buffer[APP_DF_EXT_OFFSET_RESISTANCE],
+                   unsigned_encode (p_data->resistance_ohm, 0.0F, APP_DF_EXT_RES_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_REMAINING],
+                   unsigned_encode (p_data->remaining_days, 0.0F, 1.0F));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_VIB_RMS],
+                   unsigned_encode (p_data->vibration_rms_g, 0.0F,
+                                   APP_DF_EXT_ACC_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_VIB_PEAK],
+                   unsigned_encode (p_data->vibration_peak_g, 0.0F,
+                                   APP_DF_EXT_ACC_RATIO));
+        buffer[APP_DF_EXT_OFFSET_VIB_CREST] = u8_encode (p_data->vibration_crest,
+                                              APP_DF_EXT_CREST_RATIO);
+        u16_write (&buffer[APP_DF_EXT_OFFSET_VIB_FREQ],
+                   unsigned_encode (p_data->vibration_hz, 0.0F, APP_DF_EXT_FREQ_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_TEMP_MIN],
+                   signed_encode (p_data->temperature_min_c, APP_DF_EXT_TEMP_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_TEMP_MAX],
+                   signed_encode (p_data->temperature_max_c, APP_DF_EXT_TEMP_RATIO));
+        u16_write (&buffer[APP_DF_EXT_OFFSET_PRESENCE], p_data->presence_count);
+    }
+
+    return err_code;
+}
+
+/** @} */
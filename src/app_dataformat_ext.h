@@ -0,0 +1,168 @@
+#ifndef APP_DATAFORMAT_EXT_H
+#define APP_DATAFORMAT_EXT_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_dataformat_ext Extended data format
+ * @brief All measurements and device state in one payload over legacy length.
+ */
+/** @} */
+/**
+ * @addtogroup app_dataformat_ext
+ */
+/** @{ */
+/**
+ * @file app_dataformat_ext.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Legacy advertisements have room for 24 bytes of data, so environmental,
+ * acceleration and device state are split over a rotation of formats and a
+ * gateway needs several packets for a complete picture. This format has all of
+ * them in one payload of APP_DF_EXT_DATA_LENGTH bytes, which fits only if
+ * ruuvi.drivers.c is built with extended advertising and a matching
+ * RI_COMM_MESSAGE_MAX_LENGTH, see APP_ADV_EXTENDED_ENABLED. Application does not
+ * select PDU type or PHY, the driver build does. With legacy message length
+ * encoding fails and heartbeat leaves this format out of rotation.
+ *
+ * | Offset | Size | Content                                              |
+ * |--------|------|------------------------------------------------------|
+ * | 0      | 1    | Format, APP_DF_EXT_ID                                |
+ * | 1      | 2    | Temperature, int16, 0.005 C                          |
+ * | 3      | 2    | Humidity, uint16, 0.0025 %RH                         |
+ * | 5      | 2    | Pressure, uint16, Pa - 50000                         |
+ * | 7      | 6    | Acceleration X, Y, Z, int16, mg                      |
+ * | 13     | 2    | Battery voltage, uint16, mV                          |
+ * | 15     | 1    | TX power, int8, dBm                                  |
+ * | 16     | 1    | Flags, APP_DF_EXT_FLAG_x                             |
+ * | 17     | 2    | Measurement sequence number, uint16                  |
+ * | 19     | 2    | Movement count, uint16                               |
+ * | 21     | 2    | Sequence number of newest logged sample, uint16      |
+ * | 23     | 2    | Logging interval, uint16, s                          |
+ * | 25     | 6    | MAC address                                          |
+ * | 31     | 2    | Battery internal resistance, uint16, 0.01 Ohm        |
+ * | 33     | 2    | Battery remaining life, uint16, days                 |
+ * | 35     | 2    | Vibration RMS, uint16, mg                            |
+ * | 37     | 2    | Vibration peak, uint16, mg                           |
+ * | 39     | 1    | Vibration crest factor, uint8, 0.1                   |
+ * | 40     | 2    | Vibration dominant frequency, uint16, 0.1 Hz         |
+ * | 42     | 2    | Minimum temperature of heartbeat, int16, 0.005 C     |
+ * | 44     | 2    | Maximum temperature of heartbeat, int16, 0.005 C     |
+ * | 46     | 2    | Presence count, uint16                               |
+ *
+ * Multibyte values are big-endian. Invalid values are 0x8000 for signed and
+ * 0xFFFF for unsigned 16-bit values. Log fields are valid only if
+ * APP_DF_EXT_FLAG_LOG is set. Scaling of environmental values is the same as
+ * in @ref app_dataformat_history. Battery fields are from
+ * @ref app_battery_state_get, remaining life is invalid until discharge trend
+ * is known. Vibration fields are features of the loudest axis from
+ * @ref app_vibration, invalid until a window is complete. Invalid crest factor
+ * is 0xFF. Temperature range is over the reads of @ref app_oversample, invalid
+ * without oversampling.
+ *
+ * Typical usage:
+ * @code{.c}
+ * app_dataformat_ext_t data = {0};
+ * data.temperature_c = 24.3F;
+ * data.motion = true;
+ * err_code |= app_dataformat_ext_encode (buffer, &data);
+ * @endcode
+ */
+
+#include "ruuvi_driver_error.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_DF_EXT_ID          (0xC8U) //!< Not allocated in ruuvi.endpoints.
+#define APP_DF_EXT_DATA_LENGTH (48U)   //!< Over 31 byte legacy limit.
+
+#define APP_DF_EXT_OFFSET_HEADER       (0U)
+#define APP_DF_EXT_OFFSET_TEMP         (1U)
+#define APP_DF_EXT_OFFSET_HUMI         (3U)
+#define APP_DF_EXT_OFFSET_PRES         (5U)
+#define APP_DF_EXT_OFFSET_ACC_X        (7U)
+#define APP_DF_EXT_OFFSET_ACC_Y        (9U)
+#define APP_DF_EXT_OFFSET_ACC_Z        (11U)
+#define APP_DF_EXT_OFFSET_BATTERY      (13U)
+#define APP_DF_EXT_OFFSET_TX_POWER     (15U)
+#define APP_DF_EXT_OFFSET_FLAGS        (16U)
+#define APP_DF_EXT_OFFSET_SEQUENCE     (17U)
+#define APP_DF_EXT_OFFSET_MOVEMENT     (19U)
+#define APP_DF_EXT_OFFSET_LOG_SEQUENCE (21U)
+#define APP_DF_EXT_OFFSET_LOG_INTERVAL (23U)
+#define APP_DF_EXT_OFFSET_ADDRESS      (25U)
+#define APP_DF_EXT_OFFSET_RESISTANCE   (31U)
+#define APP_DF_EXT_OFFSET_REMAINING    (33U)
+#define APP_DF_EXT_OFFSET_VIB_RMS      (35U)
+#define APP_DF_EXT_OFFSET_VIB_PEAK     (37U)
+#define APP_DF_EXT_OFFSET_VIB_CREST    (39U)
+#define APP_DF_EXT_OFFSET_VIB_FREQ     (40U)
+#define APP_DF_EXT_OFFSET_TEMP_MIN     (42U)
+#define APP_DF_EXT_OFFSET_TEMP_MAX     (44U)
+#define APP_DF_EXT_OFFSET_PRESENCE     (46U)
+
+#define APP_DF_EXT_TEMP_RATIO   (200.0F)   //!< 0.005 C per bit.
+#define APP_DF_EXT_HUMI_RATIO   (400.0F)   //!< 0.0025 %RH per bit.
+#define APP_DF_EXT_PRES_OFFSET  (50000.0F) //!< Pa at 0.
+#define APP_DF_EXT_ACC_RATIO    (1000.0F)  //!< 1 mg per bit.
+#define APP_DF_EXT_BATT_RATIO   (1000.0F)  //!< 1 mV per bit.
+#define APP_DF_EXT_RES_RATIO    (100.0F)   //!< 0.01 Ohm per bit.
+#define APP_DF_EXT_CREST_RATIO  (10.0F)    //!< 0.1 per bit.
+#define APP_DF_EXT_FREQ_RATIO   (10.0F)    //!< 0.1 Hz per bit.
+
+#define APP_DF_EXT_FLAG_MOTION   (1U << 0U) //!< Motion detected.
+#define APP_DF_EXT_FLAG_PRESENCE (1U << 1U) //!< Presence detected.
+#define APP_DF_EXT_FLAG_LOG      (1U << 2U) //!< Log fields are valid.
+
+#define APP_DF_EXT_S16_INVALID (0x8000U)
+#define APP_DF_EXT_U16_INVALID (0xFFFFU)
+#define APP_DF_EXT_U8_INVALID  (0xFFU)
+
+/** @brief Data of one extended packet. */
+typedef struct
+{
+    float temperature_c;     //!< Temperature, C.
+    float humidity_rh;       //!< Relative humidity, %.
+    float pressure_pa;       //!< Pressure, Pa.
+    float acceleration_x_g;  //!< Acceleration along X, g.
+    float acceleration_y_g;  //!< Acceleration along Y, g.
+    float acceleration_z_g;  //!< Acceleration along Z, g.
+    float battery_v;         //!< Battery voltage, V.
+    float resistance_ohm;    //!< Battery internal resistance, Ohm.
+    float remaining_days;    //!< Battery remaining life, days.
+    float vibration_rms_g;   //!< RMS of vibration, g.
+    float vibration_peak_g;  //!< Peak of vibration, g.
+    float vibration_crest;   //!< Crest factor of vibration, peak / RMS.
+    float vibration_hz;      //!< Dominant frequency of vibration, Hz.
+    float temperature_min_c; //!< Smallest temperature read over heartbeat, C.
+    float temperature_max_c; //!< Largest temperature read over heartbeat, C.
+    uint64_t address;        //!< Radio address, 48 lowest bits are sent.
+    uint16_t sequence;       //!< Measurement sequence number.
+    uint16_t movement_count; //!< Motion event count.
+    uint16_t presence_count; //!< Presence event count.
+    uint16_t log_sequence;   //!< Sequence number of newest logged sample.
+    uint16_t log_interval_s; //!< Interval of logged samples.
+    int8_t tx_power;         //!< Advertising TX power, dBm.
+    bool motion;             //!< Motion detected.
+    bool presence;           //!< Presence detected.
+    bool log;                //!< Log fields are valid.
+} app_dataformat_ext_t;
+
+/**
+ * @brief Encode extended packet.
+ *
+ * @param[out] buffer Buffer of at least APP_DF_EXT_DATA_LENGTH bytes.
+ * @param[in] p_data Data to encode.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if either parameter is NULL.
+ */
+rd_status_t app_dataformat_ext_encode (uint8_t * const buffer,
+                                       const app_dataformat_ext_t * const p_data);
+
+/** @} */
+#endif // APP_DATAFORMAT_EXT_H
@@ -0,0 +1,118 @@
+/**
+ * @addtogroup app_dataformat_history
+ */
+/** @{ */
+/**
+ * @file app_dataformat_history.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Encoder of history data format.
+ */
+#include "app_dataformat_history.h"
+
+#include <math.h>
+#include <string.h>
+
+#define DELTA_MAX (127.0F) //!< Largest delta, -127 is smallest as -128 is invalid.
+
+static void u16_write (uint8_t * const p_dst, const uint16_t value)
+{
+    p_dst[0] = (uint8_t) (value >> 8U);
+    p_dst[1] = (uint8_t) (value & 0xFFU);
+}
+
+/** @brief Scale and offset value, invalid if it does not fit in [min, max]. */
+static float value_scale (const float value, const float offset, const float ratio,
+                          const float min, const float max)
+{
+    const float scaled = roundf ( (value - offset) * ratio);
+    return ( (scaled >= min) && (scaled <= max)) ? scaled : NAN;
+}
+
+static uint16_t temperature_encode (const float temperature_c)
+{
+    const float scaled = value_scale (temperature_c, 0.0F, APP_DF_HISTORY_TEMP_RATIO,
+                                      (float) -INT16_MAX, (float) INT16_MAX);
+    return isnan (scaled) ? APP_DF_HISTORY_TEMP_INVALID
+           : (uint16_t) (int16_t) scaled;
+}
+
+/** @brief Encode humidity or pressure, both are invalid at UINT16_MAX. */
+static uint16_t unsigned_encode (const float value, const float offset,
+                                 const float ratio)
+{
+    const float scaled = value_scale (value, offset, ratio, 0.0F,
+                                      (float) (UINT16_MAX - 1U));
+    return isnan (scaled) ? UINT16_MAX : (uint16_t) scaled;
+}
+
+static uint8_t delta_encode (const float latest, const float logged, const float ratio)
+{
+    const float scaled = value_scale (logged, latest, ratio, -DELTA_MAX, DELTA_MAX);
+    return isnan (scaled) ? APP_DF_HISTORY_DELTA_INVALID : (uint8_t) (int8_t) scaled;
+}
+
+rd_status_t app_dataformat_history_encode (uint8_t * const buffer,
+        const app_dataformat_history_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == buffer) || (NULL == p_data))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (APP_DF_HISTORY_SAMPLES < p_data->num_samples)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        const uint16_t temperature = temperature_encode (p_data->temperature_c);
+        const uint16_t humidity = unsigned_encode (p_data->humidity_rh, 0.0F,
+                                  APP_DF_HISTORY_HUMI_RATIO);
+        const uint16_t pressure = unsigned_encode (p_data->pressure_pa,
+                                  APP_DF_HISTORY_PRES_OFFSET, 1.0F);
+        buffer[APP_DF_HISTORY_OFFSET_HEADER] = APP_DF_HISTORY_ID;
+        u16_write (&buffer[APP_DF_HISTORY_OFFSET_TEMP], temperature);
+        u16_write (&buffer[APP_DF_HISTORY_OFFSET_HUMI], humidity);
+        u16_write (&buffer[APP_DF_HISTORY_OFFSET_PRES], pressure);
+        u16_write (&buffer[APP_DF_HISTORY_OFFSET_SEQUENCE], p_data->sequence);
+        u16_write (&buffer[APP_DF_HISTORY_OFFSET_INTERVAL], p_data->interval_s);
+        buffer[APP_DF_HISTORY_OFFSET_COUNT] = p_data->num_samples;
+        memset (&buffer[APP_DF_HISTORY_OFFSET_DELTAS], APP_DF_HISTORY_DELTA_INVALID,
+                APP_DF_HISTORY_SAMPLES * APP_DF_HISTORY_DELTA_SIZE);
+
+        // Deltas are to latest reading, a lost delta does not corrupt others.
+        // Delta to a latest reading which was not sent can not be decoded.
+        for (size_t ii = 0; ii < p_data->num_samples; ii++)
+        {
+            const app_dataformat_history_sample_t * const p_sample = &p_data->samples[ii];
+            uint8_t * const p_delta = &buffer[APP_DF_HISTORY_OFFSET_DELTAS
+                                              + (ii * APP_DF_HISTORY_DELTA_SIZE)];
+
+            if (APP_DF_HISTORY_TEMP_INVALID != temperature)
+            {
+                p_delta[0] = delta_encode (p_data->temperature_c, p_sample->temperature_c,
+                                           APP_DF_HISTORY_DTEMP_RATIO);
+            }
+
+            if (APP_DF_HISTORY_HUMI_INVALID != humidity)
+            {
+                p_delta[1] = delta_encode (p_data->humidity_rh, p_sample->humidity_rh,
+                                           APP_DF_HISTORY_DHUMI_RATIO);
+            }
+
+            if (APP_DF_HISTORY_PRES_INVALID != pressure)
+            {
+                p_delta[2] = delta_encode (p_data->pressure_pa, p_sample->pressure_pa,
+                                           APP_DF_HISTORY_DPRES_RATIO);
+            }
+        }
+    }
+
+    return err_code;
+}
+
+/** @} */
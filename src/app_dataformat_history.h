@@ -0,0 +1,120 @@
+#ifndef APP_DATAFORMAT_HISTORY_H
+#define APP_DATAFORMAT_HISTORY_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_dataformat_history History data format
+ * @brief Latest reading and deltas of recently logged samples.
+ */
+/** @} */
+/**
+ * @addtogroup app_dataformat_history
+ */
+/** @{ */
+/**
+ * @file app_dataformat_history.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * A gateway which misses advertisements loses those samples unless the log
+ * is downloaded over GATT. This format carries the latest reading and the
+ * previous APP_DF_HISTORY_SAMPLES logged samples, so a gateway which hears
+ * only every few packets can still fill in a continuous series.
+ *
+ * Logged samples are sent as int8 deltas to the latest reading. Newest
+ * logged sample has sequence number of the packet, older samples count down
+ * from it, and interval of logging tells how far apart samples are.
+ *
+ * | Offset | Size | Content                                              |
+ * |--------|------|------------------------------------------------------|
+ * | 0      | 1    | Format, APP_DF_HISTORY_ID                            |
+ * | 1      | 2    | Temperature, int16, 0.005 C                          |
+ * | 3      | 2    | Humidity, uint16, 0.0025 %RH                         |
+ * | 5      | 2    | Pressure, uint16, Pa - 50000                         |
+ * | 7      | 2    | Sequence number of newest logged sample, uint16      |
+ * | 9      | 2    | Logging interval, uint16, s                          |
+ * | 11     | 1    | Number of logged samples                             |
+ * | 12     | 3 x 4| Temperature 0.1 C, humidity 0.5 %RH, pressure 10 Pa  |
+ *
+ * Multibyte values are big-endian. Invalid values are 0x8000 for
+ * temperature, 0xFFFF for humidity and pressure and 0x80 for deltas,
+ * deltas out of range are invalid too.
+ *
+ * Typical usage:
+ * @code{.c}
+ * app_dataformat_history_t data = {0};
+ * data.temperature_c = 24.3F;
+ * data.num_samples = 1U;
+ * data.samples[0].temperature_c = 24.1F;
+ * err_code |= app_dataformat_history_encode (buffer, &data);
+ * @endcode
+ */
+
+#include "ruuvi_driver_error.h"
+
+#include <stdint.h>
+
+#define APP_DF_HISTORY_ID          (0xC7U) //!< Not allocated in ruuvi.endpoints.
+#define APP_DF_HISTORY_DATA_LENGTH (24U)   //!< Fits legacy advertisement with flags.
+#define APP_DF_HISTORY_SAMPLES     (4U)    //!< Logged samples in one packet.
+
+#define APP_DF_HISTORY_OFFSET_HEADER   (0U)
+#define APP_DF_HISTORY_OFFSET_TEMP     (1U)
+#define APP_DF_HISTORY_OFFSET_HUMI     (3U)
+#define APP_DF_HISTORY_OFFSET_PRES     (5U)
+#define APP_DF_HISTORY_OFFSET_SEQUENCE (7U)
+#define APP_DF_HISTORY_OFFSET_INTERVAL (9U)
+#define APP_DF_HISTORY_OFFSET_COUNT    (11U)
+#define APP_DF_HISTORY_OFFSET_DELTAS   (12U)
+#define APP_DF_HISTORY_DELTA_SIZE      (3U) //!< Bytes per logged sample.
+
+#define APP_DF_HISTORY_TEMP_RATIO   (200.0F)   //!< 0.005 C per bit.
+#define APP_DF_HISTORY_HUMI_RATIO   (400.0F)   //!< 0.0025 %RH per bit.
+#define APP_DF_HISTORY_PRES_OFFSET  (50000.0F) //!< Pa at 0.
+#define APP_DF_HISTORY_DTEMP_RATIO  (10.0F)    //!< 0.1 C per bit.
+#define APP_DF_HISTORY_DHUMI_RATIO  (2.0F)     //!< 0.5 %RH per bit.
+#define APP_DF_HISTORY_DPRES_RATIO  (0.1F)     //!< 10 Pa per bit.
+
+#define APP_DF_HISTORY_TEMP_INVALID  (0x8000U)
+#define APP_DF_HISTORY_HUMI_INVALID  (0xFFFFU)
+#define APP_DF_HISTORY_PRES_INVALID  (0xFFFFU)
+#define APP_DF_HISTORY_DELTA_INVALID (0x80U)
+
+/** @brief Environmental values of one sample. */
+typedef struct
+{
+    float temperature_c; //!< Temperature, C.
+    float humidity_rh;   //!< Relative humidity, %.
+    float pressure_pa;   //!< Pressure, Pa.
+} app_dataformat_history_sample_t;
+
+/** @brief Data of one history packet. */
+typedef struct
+{
+    float temperature_c;  //!< Latest temperature, C.
+    float humidity_rh;    //!< Latest relative humidity, %.
+    float pressure_pa;    //!< Latest pressure, Pa.
+    uint16_t sequence;    //!< Sequence number of newest logged sample.
+    uint16_t interval_s;  //!< Interval of logged samples.
+    uint8_t num_samples;  //!< Number of valid logged samples.
+    app_dataformat_history_sample_t samples[APP_DF_HISTORY_SAMPLES]; //!< Newest first.
+} app_dataformat_history_t;
+
+/**
+ * @brief Encode history packet.
+ *
+ * @param[out] buffer Buffer of at least APP_DF_HISTORY_DATA_LENGTH bytes.
+ * @param[in] p_data Data to encode.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if either parameter is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if num_samples is over APP_DF_HISTORY_SAMPLES.
+ */
+rd_status_t app_dataformat_history_encode (uint8_t * const buffer,
+        const app_dataformat_history_t * const p_data);
+
+/** @} */
+#endif // APP_DATAFORMAT_HISTORY_H
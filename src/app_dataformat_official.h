@@ -0,0 +1,112 @@
+#ifndef APP_DATAFORMAT_OFFICIAL_H
+#define APP_DATAFORMAT_OFFICIAL_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_dataformat_official Official data format layouts
+ * @brief Byte layouts of formats encoded by ruuvi.endpoints.
+ */
+/** @} */
+/**
+ * @addtogroup app_dataformat_official
+ */
+/** @{ */
+/**
+ * @file app_dataformat_official.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Formats 3, 5 and C5 are encoded by ruuvi.endpoints, which does not export
+ * their offsets or scaling. They are collected here from docs.ruuvi.com so
+ * that @ref app_dataformats.c and @ref app_dataformat_decoder.c share one
+ * copy. Lengths and counter ranges come from the endpoint headers, and the
+ * layouts below are checked against those lengths at compile time.
+ *
+ * Only format byte of formats 7, 8 and FA is here for now. Layout of 7 is
+ * defined by ruuvi_endpoint_7.c, and 8 and FA are encrypted with keys of
+ * @ref app_dataformat_key_set. Their layouts are added with their decoders.
+ *
+ * Multibyte values are big-endian. In formats 5 and C5 signed values are
+ * invalid at 0x8000 and unsigned at 0xFFFF, format 3 has no invalid values.
+ */
+
+#include "ruuvi_endpoint_3.h"
+#include "ruuvi_endpoint_5.h"
+#include "ruuvi_endpoint_c5.h"
+
+#define APP_DF_3_ID  (0x03U)
+#define APP_DF_5_ID  (0x05U)
+#define APP_DF_7_ID  (0x07U)
+#define APP_DF_8_ID  (0x08U)
+#define APP_DF_C5_ID (0xC5U)
+#define APP_DF_FA_ID (0xFAU)
+
+#define APP_DF_ADDRESS_LENGTH (6U) //!< MAC address, MSB first.
+
+#define APP_DF_3_OFFSET_HUMI    (1U)  //!< uint8, 0.5 %RH.
+#define APP_DF_3_OFFSET_TEMP    (2U)  //!< Sign and integer C, then 0.01 C.
+#define APP_DF_3_OFFSET_PRES    (4U)  //!< uint16, Pa - 50000.
+#define APP_DF_3_OFFSET_ACC_X   (6U)  //!< int16, mg.
+#define APP_DF_3_OFFSET_ACC_Y   (8U)  //!< int16, mg.
+#define APP_DF_3_OFFSET_ACC_Z   (10U) //!< int16, mg.
+#define APP_DF_3_OFFSET_BATTERY (12U) //!< uint16, mV.
+
+#define APP_DF_3_HUMI_RATIO     (2.0F)   //!< 0.5 %RH per bit.
+#define APP_DF_3_TEMP_RATIO     (100.0F) //!< 0.01 C per bit of fraction.
+#define APP_DF_3_TEMP_SIGN      (0x80U)  //!< Set if temperature is negative.
+#define APP_DF_3_TEMP_INT_MASK  (0x7FU)  //!< Integer part of temperature.
+
+#define APP_DF_5_OFFSET_TEMP     (1U)  //!< int16, 0.005 C.
+#define APP_DF_5_OFFSET_HUMI     (3U)  //!< uint16, 0.0025 %RH.
+#define APP_DF_5_OFFSET_PRES     (5U)  //!< uint16, Pa - 50000.
+#define APP_DF_5_OFFSET_ACC_X    (7U)  //!< int16, mg.
+#define APP_DF_5_OFFSET_ACC_Y    (9U)  //!< int16, mg.
+#define APP_DF_5_OFFSET_ACC_Z    (11U) //!< int16, mg.
+#define APP_DF_5_OFFSET_POWER    (13U) //!< 11 bits battery, 5 bits TX power.
+#define APP_DF_5_OFFSET_MOVEMENT (15U) //!< uint8.
+#define APP_DF_5_OFFSET_SEQUENCE (16U) //!< uint16.
+#define APP_DF_5_OFFSET_ADDRESS  (18U)
+
+#define APP_DF_C5_OFFSET_TEMP     (1U)
+#define APP_DF_C5_OFFSET_HUMI     (3U)
+#define APP_DF_C5_OFFSET_PRES     (5U)
+#define APP_DF_C5_OFFSET_POWER    (7U)
+#define APP_DF_C5_OFFSET_MOVEMENT (9U)
+#define APP_DF_C5_OFFSET_SEQUENCE (10U)
+#define APP_DF_C5_OFFSET_ADDRESS  (12U)
+
+// Formats 5 and C5 share scaling and invalid values, pressure and acceleration
+// of format 3 are scaled as in format 5.
+#define APP_DF_5_TEMP_RATIO   (200.0F)   //!< 0.005 C per bit.
+#define APP_DF_5_HUMI_RATIO   (400.0F)   //!< 0.0025 %RH per bit.
+#define APP_DF_5_PRES_OFFSET  (50000.0F) //!< Pa at 0.
+#define APP_DF_5_ACC_RATIO    (1000.0F)  //!< 1 mg per bit.
+#define APP_DF_5_BATT_RATIO   (1000.0F)  //!< 1 mV per bit.
+#define APP_DF_5_BATT_OFFSET  (1.6F)     //!< V at 0.
+#define APP_DF_5_BATT_INVALID (0x7FFU)
+#define APP_DF_5_TX_BITS      (5U)       //!< TX power in lowest bits of power.
+#define APP_DF_5_TX_MASK      (0x1FU)
+#define APP_DF_5_TX_INVALID   (0x1FU)
+#define APP_DF_5_TX_STEP      (2.0F)     //!< 2 dBm per bit.
+#define APP_DF_5_TX_OFFSET    (-40.0F)   //!< dBm at 0.
+
+#define APP_DF_5_MOVEMENT_INVALID  (RE_5_MVTCTR_MAX + 1U)
+#define APP_DF_5_SEQUENCE_INVALID  (RE_5_SEQCTR_MAX + 1U)
+#define APP_DF_C5_MOVEMENT_INVALID (RE_C5_MVTCTR_MAX + 1U)
+#define APP_DF_C5_SEQUENCE_INVALID (RE_C5_SEQCTR_MAX + 1U)
+
+#if ((APP_DF_3_OFFSET_BATTERY + 2U) != RE_3_DATA_LENGTH)
+#   error "Layout of format 3 does not match ruuvi.endpoints."
+#endif
+#if ((APP_DF_5_OFFSET_ADDRESS + APP_DF_ADDRESS_LENGTH) != RE_5_DATA_LENGTH)
+#   error "Layout of format 5 does not match ruuvi.endpoints."
+#endif
+#if ((APP_DF_C5_OFFSET_ADDRESS + APP_DF_ADDRESS_LENGTH) != RE_C5_DATA_LENGTH)
+#   error "Layout of format C5 does not match ruuvi.endpoints."
+#endif
+
+/** @} */
+#endif // APP_DATAFORMAT_OFFICIAL_H
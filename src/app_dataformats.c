@@ -1,5 +1,13 @@
 #include "app_dataformats.h"
+#include "app_battery.h"
+#include "app_comms.h"
+#include "app_dataformat_ext.h"
+#include "app_dataformat_history.h"
+#include "app_dataformat_official.h"
+#include "app_log.h"
+#include "app_oversample.h"
 #include "app_sensor.h"
+#include "app_vibration.h"
 #include "ruuvi_endpoints.h"
 #include "ruuvi_endpoint_3.h"
 #include "ruuvi_endpoint_5.h"
@@ -11,8 +19,9 @@
 #include "ruuvi_interface_communication_ble_advertising.h"
 #include "ruuvi_interface_communication_radio.h"
 #include "ruuvi_interface_communication.h"
-#include "ruuvi_task_adc.h"
+#include "ruuvi_task_flash.h"
 
+#include <limits.h>
 #include <math.h>
 #include <string.h>
 
@@ -22,6 +31,9 @@
 #   define TESTABLE_STATIC static
 #endif
 
+#define FNV_OFFSET_BASIS (2166136261UL)
+#define FNV_PRIME (16777619UL)
+
 #if (RE_8_ENABLED || RE_FA_ENABLED)
 uint32_t app_data_encrypt (const uint8_t * const cleartext,
                            uint8_t * const ciphertext,
@@ -52,69 +64,322 @@ uint32_t app_data_encrypt (const uint8_t * const cleartext,
     RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
     return ret_code;
 }
+
+/** @brief Key of an encrypted format. */
+typedef struct
+{
+    app_dataformat_t format;                   //!< Format using the key.
+    uint16_t record;                           //!< Flash record of provisioned key.
+    const uint8_t * p_default;                 //!< Compile-time key.
+    uint8_t key[APP_DATAFORMAT_KEY_LENGTH];    //!< Key given to encoder.
+    bool provisioned;                          //!< Key was provisioned at runtime.
+} crypto_key_t;
 #endif
 
-app_dataformat_t app_dataformat_next (const app_dataformats_t formats,
-                                      const app_dataformat_t state)
+#if RE_8_ENABLED
+#ifndef APP_8_KEY
+// "RuuviComRuuviTag"
+#define APP_8_KEY { 0x52, 0x75, 0x75, 0x76, 0x69, 0x43, 0x6F, 0x6D, 0x52, 0x75, 0x75, 0x76, 0x69, 0x54, 0x61, 0x67}
+#endif
+static const uint8_t ep_8_key[RE_8_CIPHERTEXT_LENGTH] = APP_8_KEY;
+
+TESTABLE_STATIC rd_status_t
+ep_8_key_generate (uint8_t * const key)
 {
-    app_dataformat_t nextState = DF_INVALID;
+    rd_status_t err_code = RD_SUCCESS;
+    memcpy (key, ep_8_key, RE_8_CIPHERTEXT_LENGTH);
+    uint64_t device_id = 0;
+    err_code |= ri_comm_id_get (&device_id);
 
-    if (DF_INVALID != formats.formats)
+    for (uint8_t ii = 0U; ii < 8; ii++)
     {
-        nextState = state;
+        key[ii] = key[ii] ^ ( (device_id >> (ii * 8U)) & 0xFFU);
+    }
 
-        do
+    return err_code;
+}
+#endif
+
+#if RE_FA_ENABLED
+#ifndef APP_FA_KEY
+#define APP_FA_KEY {00, 11, 22, 33, 44, 55, 66, 77, 88, 99, 11, 12, 13, 14, 15, 16}
+#endif
+static const uint8_t ep_fa_key[RE_FA_CIPHERTEXT_LENGTH] = APP_FA_KEY;
+#endif
+
+#if (RE_8_ENABLED || RE_FA_ENABLED)
+static crypto_key_t m_keys[] =
+{
+#if RE_8_ENABLED
+    { DF_8, APP_FLASH_DATAFORMAT_8_KEY_RECORD, ep_8_key, { 0 }, false },
+#endif
+#if RE_FA_ENABLED
+    { DF_FA, APP_FLASH_DATAFORMAT_FA_KEY_RECORD, ep_fa_key, { 0 }, false },
+#endif
+};
+
+#define CRYPTO_KEY_COUNT (sizeof (m_keys) / sizeof (m_keys[0]))
+
+static bool m_crypto_init; //!< Keys are derived.
+
+static crypto_key_t * crypto_key_find (const app_dataformat_t format)
+{
+    crypto_key_t * p_key = NULL;
+
+    for (size_t ii = 0; (ii < CRYPTO_KEY_COUNT) && (NULL == p_key); ii++)
+    {
+        if (format == m_keys[ii].format)
         {
-            switch (nextState)
-            {
-                case DF_3:
-                    nextState = DF_5;
-                    break;
-
-                case DF_5:
-                    nextState = DF_7;
-                    break;
-
-                case DF_7:
-                    nextState = DF_8;
-                    break;
-
-                case DF_8:
-                    nextState = DF_C5;
-                    break;
-
-                case DF_C5:
-                    nextState = DF_FA;
-                    break;
-
-                case DF_FA:
-                default:
-                    nextState = DF_3;
-                    break;
-            }
-        } while (! (nextState & formats.formats));
+            p_key = &m_keys[ii];
+        }
     }
 
-    ri_adv_enable_uuid ( (nextState == DF_C5) || (nextState == DF_8) || (nextState == DF_7));
-    return nextState;
+    return p_key;
+}
+
+/** @brief Derive key from flash or from compile-time key. */
+static rd_status_t crypto_key_derive (crypto_key_t * const p_key)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    // Missing record or flash is not an error, compile-time key is used then.
+    p_key->provisioned = (RD_SUCCESS == rt_flash_load (APP_FLASH_DATAFORMAT_FILE,
+                          p_key->record, p_key->key, sizeof (p_key->key)));
+
+    if (p_key->provisioned)
+    {
+        // Provisioned keys are used as is.
+    }
+#if RE_8_ENABLED
+    else if (DF_8 == p_key->format)
+    {
+        err_code |= ep_8_key_generate (p_key->key);
+    }
+#endif
+    else
+    {
+        memcpy (p_key->key, p_key->p_default, sizeof (p_key->key));
+    }
+
+    return err_code;
+}
+
+/** @brief Key of format, derived on first use if init was not called. */
+static const uint8_t * crypto_key_get (const app_dataformat_t format)
+{
+    if (!m_crypto_init)
+    {
+        rd_status_t err_code = app_dataformat_crypto_init();
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    }
+
+    return crypto_key_find (format)->key;
+}
+#endif
+
+rd_status_t app_dataformat_crypto_init (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+#if (RE_8_ENABLED || RE_FA_ENABLED)
+
+    for (size_t ii = 0; ii < CRYPTO_KEY_COUNT; ii++)
+    {
+        err_code |= crypto_key_derive (&m_keys[ii]);
+    }
+
+    m_crypto_init = true;
+#endif
+    return err_code;
+}
+
+rd_status_t app_dataformat_key_set (const app_dataformat_t format,
+                                    const uint8_t * const key, const size_t key_size)
+{
+    rd_status_t err_code = RD_SUCCESS;
+#if (RE_8_ENABLED || RE_FA_ENABLED)
+    crypto_key_t * const p_key = crypto_key_find (format);
+
+    if (NULL == p_key)
+    {
+        err_code |= RD_ERROR_NOT_FOUND;
+    }
+    else if ( (NULL != key) && (APP_DATAFORMAT_KEY_LENGTH != key_size))
+    {
+        err_code |= RD_ERROR_INVALID_LENGTH;
+    }
+    else if (NULL == key)
+    {
+        // Free may fail if there is no provisioned key, compile-time key is used anyway.
+        (void) rt_flash_free (APP_FLASH_DATAFORMAT_FILE, p_key->record);
+        err_code |= crypto_key_derive (p_key);
+    }
+    else
+    {
+        err_code |= rt_flash_store (APP_FLASH_DATAFORMAT_FILE, p_key->record, key,
+                                    APP_DATAFORMAT_KEY_LENGTH);
+
+        // Key which does not survive reboot would make data undecryptable later.
+        if (RD_SUCCESS == err_code)
+        {
+            memcpy (p_key->key, key, APP_DATAFORMAT_KEY_LENGTH);
+            p_key->provisioned = true;
+        }
+    }
+
+#else
+    (void) format;
+    (void) key;
+    (void) key_size;
+    err_code |= RD_ERROR_NOT_FOUND;
+#endif
+    return err_code;
+}
+
+bool app_dataformat_key_is_provisioned (const app_dataformat_t format)
+{
+    bool provisioned = false;
+#if (RE_8_ENABLED || RE_FA_ENABLED)
+    const crypto_key_t * const p_key = crypto_key_find (format);
+    provisioned = (NULL != p_key) && p_key->provisioned;
+#else
+    (void) format;
+#endif
+    return provisioned;
+}
+
+#define KEY_CHUNK_LENGTH (6U)    //!< Key bytes after format and offset in payload.
+#define KEY_CHUNK_COUNT ((APP_DATAFORMAT_KEY_LENGTH + KEY_CHUNK_LENGTH - 1U) \
+                         / KEY_CHUNK_LENGTH)
+#define KEY_CHUNKS_ALL ((1U << KEY_CHUNK_COUNT) - 1U)
+#define KEY_OFFSET_CLEAR (0xFFU) //!< Offset which reverts to compile-time key.
+
+static uint8_t m_key_stage[APP_DATAFORMAT_KEY_LENGTH]; //!< Key being received.
+static uint8_t m_key_stage_format;                     //!< Format of staged key.
+static uint8_t m_key_stage_chunks;                     //!< Bitmask of received chunks.
+
+void app_dataformat_key_stage_clear (void)
+{
+    memset (m_key_stage, 0, sizeof (m_key_stage));
+    m_key_stage_format = DF_INVALID;
+    m_key_stage_chunks = 0U;
+}
+
+/** @brief Stage a chunk of key, set key once all chunks are received. */
+static rd_status_t key_chunk_write (const uint8_t format, const uint8_t offset,
+                                    const uint8_t * const p_chunk)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (KEY_OFFSET_CLEAR == offset)
+    {
+        app_dataformat_key_stage_clear();
+        err_code |= app_dataformat_key_set ( (app_dataformat_t) format, NULL, 0U);
+    }
+    else if ( (0U != (offset % KEY_CHUNK_LENGTH))
+              || (APP_DATAFORMAT_KEY_LENGTH <= offset))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        const size_t remaining = APP_DATAFORMAT_KEY_LENGTH - offset;
+        const size_t length = (remaining < KEY_CHUNK_LENGTH) ? remaining
+                              : KEY_CHUNK_LENGTH;
+
+        // Chunks of another format would mix two keys.
+        if (format != m_key_stage_format)
+        {
+            app_dataformat_key_stage_clear();
+            m_key_stage_format = format;
+        }
+
+        memcpy (&m_key_stage[offset], p_chunk, length);
+        m_key_stage_chunks |= (uint8_t) (1U << (offset / KEY_CHUNK_LENGTH));
+
+        if (KEY_CHUNKS_ALL == m_key_stage_chunks)
+        {
+            err_code |= app_dataformat_key_set ( (app_dataformat_t) format, m_key_stage,
+                                                 sizeof (m_key_stage));
+            app_dataformat_key_stage_clear();
+        }
+    }
+
+    return err_code;
+}
+
+/** @brief Reply to a data format endpoint with given payload bytes. */
+static rd_status_t endpoint_reply (const ri_comm_xfer_fp_t reply_fp,
+                                   const uint8_t * const raw_message,
+                                   const uint8_t * const p_reply, const size_t reply_len)
+{
+    ri_comm_message_t msg = {0};
+    msg.repeat_count = 1;
+    msg.data_length = RE_STANDARD_MESSAGE_LENGTH;
+    msg.data[RE_STANDARD_DESTINATION_INDEX] = raw_message[RE_STANDARD_SOURCE_INDEX];
+    msg.data[RE_STANDARD_SOURCE_INDEX] = raw_message[RE_STANDARD_DESTINATION_INDEX];
+    msg.data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    memcpy (&msg.data[RE_STANDARD_PAYLOAD_START_INDEX], p_reply, reply_len);
+    return app_comms_blocking_send (reply_fp, &msg);
+}
+
+rd_status_t app_dataformat_key_handle (const ri_comm_xfer_fp_t reply_fp,
+                                       const uint8_t * const raw_message,
+                                       const uint16_t data_len)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == raw_message)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (data_len < RE_STANDARD_MESSAGE_LENGTH)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        const uint8_t * const p_payload = &raw_message[RE_STANDARD_PAYLOAD_START_INDEX];
+        const re_op_t op = (re_op_t) raw_message[RE_STANDARD_OPERATION_INDEX];
+        const uint8_t format = p_payload[0];
+        rd_status_t op_code = RD_SUCCESS;
+
+        if (RE_STANDARD_VALUE_WRITE == op)
+        {
+            op_code |= key_chunk_write (format, p_payload[1], &p_payload[2]);
+        }
+        else
+        {
+            // Read replies status only, keys are never sent out.
+        }
+
+        const uint8_t reply[] =
+        {
+            format, p_payload[1],
+            app_dataformat_key_is_provisioned ( (app_dataformat_t) format) ? 1U : 0U,
+            (RD_SUCCESS == op_code) ? 0U : 0xFFU
+        };
+        err_code |= endpoint_reply (reply_fp, raw_message, reply, sizeof (reply));
+        err_code |= op_code;
+    }
+
+    return err_code;
 }
 
 #if RE_3_ENABLED
 TESTABLE_STATIC rd_status_t
 encode_to_3 (uint8_t * const output,
              size_t * const output_length,
-             const rd_sensor_data_t * const data)
+             const app_dataformat_snapshot_t * const p_snapshot)
 {
     rd_status_t err_code = RD_SUCCESS;
     re_status_t enc_code = RE_SUCCESS;
     re_3_data_t ep_data = {0};
-    ep_data.accelerationx_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_X_FIELD);
-    ep_data.accelerationy_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_Y_FIELD);
-    ep_data.accelerationz_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_Z_FIELD);
-    ep_data.humidity_rh       = rd_sensor_data_parse (data, RD_SENSOR_HUMI_FIELD);
-    ep_data.pressure_pa       = rd_sensor_data_parse (data, RD_SENSOR_PRES_FIELD);
-    ep_data.temperature_c     = rd_sensor_data_parse (data, RD_SENSOR_TEMP_FIELD);
-    err_code |= rt_adc_vdd_get (&ep_data.battery_v);
+    ep_data.accelerationx_g   = p_snapshot->acceleration_x_g;
+    ep_data.accelerationy_g   = p_snapshot->acceleration_y_g;
+    ep_data.accelerationz_g   = p_snapshot->acceleration_z_g;
+    ep_data.humidity_rh       = p_snapshot->humidity_rh;
+    ep_data.pressure_pa       = p_snapshot->pressure_pa;
+    ep_data.temperature_c     = p_snapshot->temperature_c;
+    ep_data.battery_v         = p_snapshot->battery_v;
     enc_code |= re_3_encode (output, &ep_data, RD_FLOAT_INVALID);
 
     if (RE_SUCCESS != enc_code)
@@ -131,34 +396,34 @@ encode_to_3 (uint8_t * const output,
 TESTABLE_STATIC rd_status_t
 encode_to_5 (uint8_t * const output,
              size_t * const output_length,
-             const rd_sensor_data_t * const data)
+             const app_dataformat_snapshot_t * const p_snapshot)
 {
     static uint16_t ep_5_measurement_count = 0;
     rd_status_t err_code = RD_SUCCESS;
     re_status_t enc_code = RE_SUCCESS;
     re_5_data_t ep_data = {0};
     ep_5_measurement_count++;
-    ep_5_measurement_count %= (RE_5_SEQCTR_MAX + 1);
-    ep_data.accelerationx_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_X_FIELD);
-    ep_data.accelerationy_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_Y_FIELD);
-    ep_data.accelerationz_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_Z_FIELD);
-    ep_data.humidity_rh       = rd_sensor_data_parse (data, RD_SENSOR_HUMI_FIELD);
-    ep_data.pressure_pa       = rd_sensor_data_parse (data, RD_SENSOR_PRES_FIELD);
-    ep_data.temperature_c     = rd_sensor_data_parse (data, RD_SENSOR_TEMP_FIELD);
+    // Counters wrap before the values reserved as invalid.
+    ep_5_measurement_count %= APP_DF_5_SEQUENCE_INVALID;
+    ep_data.accelerationx_g   = p_snapshot->acceleration_x_g;
+    ep_data.accelerationy_g   = p_snapshot->acceleration_y_g;
+    ep_data.accelerationz_g   = p_snapshot->acceleration_z_g;
+    ep_data.humidity_rh       = p_snapshot->humidity_rh;
+    ep_data.pressure_pa       = p_snapshot->pressure_pa;
+    ep_data.temperature_c     = p_snapshot->temperature_c;
     ep_data.measurement_count = ep_5_measurement_count;
-    uint8_t mvtctr = (uint8_t) (app_sensor_event_count_get() % (RE_5_MVTCTR_MAX + 1));
+    uint8_t mvtctr = (uint8_t) (p_snapshot->event_count % APP_DF_5_MOVEMENT_INVALID);
     ep_data.movement_count    = mvtctr;
-    err_code |= ri_radio_address_get (&ep_data.address);
+    ep_data.address           = p_snapshot->address;
 #if APP_DATAFORMAT_FLAGS_IN_TX
     // Hack motion/presense data into tx power for testing
-    ep_data.tx_power = (int8_t) ( ( (rd_sensor_data_parse (data,
-                                     RD_SENSOR_MOTION_FIELD) > 0.5f) ? 2 : 0)
-                                  + ( (rd_sensor_data_parse (data, RD_SENSOR_PRESENCE_FIELD) > 0.5f) ? 4 : 0)
-                                  + ( (rd_sensor_data_parse (data, RD_SENSOR_DEBUG_TAMB_FIELD) > 0.5f) ? 8 : 0));
+    ep_data.tx_power = (int8_t) ( ( (p_snapshot->motion > 0.5f) ? 2 : 0)
+                                  + ( (p_snapshot->presence > 0.5f) ? 4 : 0)
+                                  + ( (p_snapshot->debug_tamb > 0.5f) ? 8 : 0));
 #else
-    err_code |= ri_adv_tx_power_get (&ep_data.tx_power);
+    ep_data.tx_power          = p_snapshot->tx_power;
 #endif
-    err_code |= rt_adc_vdd_get (&ep_data.battery_v);
+    ep_data.battery_v         = p_snapshot->battery_v;
     enc_code |= re_5_encode (output, &ep_data);
 
     if (RE_SUCCESS != enc_code)
@@ -175,7 +440,7 @@ encode_to_5 (uint8_t * const output,
 TESTABLE_STATIC rd_status_t
 encode_to_7 (uint8_t * const output,
              size_t * const output_length,
-             const rd_sensor_data_t * const data)
+             const app_dataformat_snapshot_t * const p_snapshot)
 {
     static uint16_t ep_7_measurement_count = 0;
     rd_status_t err_code = RD_SUCCESS;
@@ -183,17 +448,16 @@ encode_to_7 (uint8_t * const output,
     re_7_data_t ep_data = {0};
     ep_7_measurement_count++;
     ep_7_measurement_count %= (RE_7_SEQCTR_MAX + 1);
-    ep_data.humidity_rh       = rd_sensor_data_parse (data, RD_SENSOR_HUMI_FIELD);
-    ep_data.pressure_pa       = rd_sensor_data_parse (data, RD_SENSOR_PRES_FIELD);
-    ep_data.temperature_c     = rd_sensor_data_parse (data, RD_SENSOR_TEMP_FIELD);
+    ep_data.humidity_rh       = p_snapshot->humidity_rh;
+    ep_data.pressure_pa       = p_snapshot->pressure_pa;
+    ep_data.temperature_c     = p_snapshot->temperature_c;
     ep_data.sequence_counter  = ep_7_measurement_count;
-    uint8_t mvtctr = (uint8_t) (app_sensor_event_count_get() % (RE_7_MOTION_CNT_MAX + 1));
+    uint8_t mvtctr = (uint8_t) (p_snapshot->event_count % (RE_7_MOTION_CNT_MAX + 1));
     ep_data.motion_count      = mvtctr;
-    ep_data.motion_detected   = (rd_sensor_data_parse (data, RD_SENSOR_MOTION_FIELD) > 0.5f);
-    ep_data.presence_detected = (rd_sensor_data_parse (data,
-                                 RD_SENSOR_PRESENCE_FIELD) > 0.5f);
-    err_code |= ri_radio_address_get (&ep_data.address);
-    err_code |= rt_adc_vdd_get (&ep_data.battery_v);
+    ep_data.motion_detected   = (p_snapshot->motion > 0.5f);
+    ep_data.presence_detected = (p_snapshot->presence > 0.5f);
+    ep_data.address           = p_snapshot->address;
+    ep_data.battery_v         = p_snapshot->battery_v;
     enc_code |= re_7_encode (output, &ep_data);
 
     if (RE_SUCCESS != enc_code)
@@ -207,54 +471,30 @@ encode_to_7 (uint8_t * const output,
 #endif
 
 #if RE_8_ENABLED
-#ifndef APP_8_KEY
-// "RuuviComRuuviTag"
-#define APP_8_KEY { 0x52, 0x75, 0x75, 0x76, 0x69, 0x43, 0x6F, 0x6D, 0x52, 0x75, 0x75, 0x76, 0x69, 0x54, 0x61, 0x67}
-#endif
-static const uint8_t ep_8_key[RE_8_CIPHERTEXT_LENGTH] = APP_8_KEY;
-
-TESTABLE_STATIC rd_status_t
-ep_8_key_generate (uint8_t * const key)
-{
-    rd_status_t err_code = RD_SUCCESS;
-    memcpy (key, ep_8_key, RE_8_CIPHERTEXT_LENGTH);
-    uint64_t device_id = 0;
-    err_code |= ri_comm_id_get (&device_id);
-
-    for (uint8_t ii = 0U; ii < 8; ii++)
-    {
-        key[ii] = key[ii] ^ ( (device_id >> (ii * 8U)) & 0xFFU);
-    }
-
-    return err_code;
-}
-
 TESTABLE_STATIC rd_status_t
 encode_to_8 (uint8_t * const output,
              size_t * const output_length,
-             const rd_sensor_data_t * const data)
+             const app_dataformat_snapshot_t * const p_snapshot)
 {
     static uint16_t ep_8_measurement_count = 0;
-    uint8_t final_key[RE_8_CIPHERTEXT_LENGTH] = { 0 };
     rd_status_t err_code = RD_SUCCESS;
     re_status_t enc_code = RE_SUCCESS;
     re_8_data_t ep_data = {0};
     ep_8_measurement_count++;
     ep_8_measurement_count %= (RE_8_SEQCTR_MAX + 1);
-    ep_data.humidity_rh       = rd_sensor_data_parse (data, RD_SENSOR_HUMI_FIELD);
-    ep_data.pressure_pa       = rd_sensor_data_parse (data, RD_SENSOR_PRES_FIELD);
-    ep_data.temperature_c     = rd_sensor_data_parse (data, RD_SENSOR_TEMP_FIELD);
+    ep_data.humidity_rh       = p_snapshot->humidity_rh;
+    ep_data.pressure_pa       = p_snapshot->pressure_pa;
+    ep_data.temperature_c     = p_snapshot->temperature_c;
     ep_data.message_counter = ep_8_measurement_count;
-    uint8_t mvtctr = (uint8_t) (app_sensor_event_count_get() % (RE_8_MVTCTR_MAX + 1));
+    uint8_t mvtctr = (uint8_t) (p_snapshot->event_count % (RE_8_MVTCTR_MAX + 1));
     ep_data.movement_count    = mvtctr;
-    err_code |= ep_8_key_generate (final_key);
-    err_code |= ri_radio_address_get (&ep_data.address);
-    err_code |= ri_adv_tx_power_get (&ep_data.tx_power);
-    err_code |= rt_adc_vdd_get (&ep_data.battery_v);
+    ep_data.address           = p_snapshot->address;
+    ep_data.tx_power          = p_snapshot->tx_power;
+    ep_data.battery_v         = p_snapshot->battery_v;
     enc_code |= re_8_encode (output,
                              &ep_data,
                              &app_data_encrypt,
-                             final_key,
+                             crypto_key_get (DF_8),
                              RE_8_CIPHERTEXT_LENGTH);
 
     if (RE_SUCCESS != enc_code)
@@ -271,23 +511,24 @@ encode_to_8 (uint8_t * const output,
 TESTABLE_STATIC rd_status_t
 encode_to_c5 (uint8_t * const output,
               size_t * const output_length,
-              const rd_sensor_data_t * const data)
+              const app_dataformat_snapshot_t * const p_snapshot)
 {
     static uint16_t ep_c5_measurement_count = 0;
     rd_status_t err_code = RD_SUCCESS;
     re_status_t enc_code = RE_SUCCESS;
     re_c5_data_t ep_data = {0};
     ep_c5_measurement_count++;
-    ep_c5_measurement_count %= (RE_C5_SEQCTR_MAX + 1);
-    ep_data.humidity_rh       = rd_sensor_data_parse (data, RD_SENSOR_HUMI_FIELD);
-    ep_data.pressure_pa       = rd_sensor_data_parse (data, RD_SENSOR_PRES_FIELD);
-    ep_data.temperature_c     = rd_sensor_data_parse (data, RD_SENSOR_TEMP_FIELD);
+    // Counters wrap before the values reserved as invalid.
+    ep_c5_measurement_count %= APP_DF_C5_SEQUENCE_INVALID;
+    ep_data.humidity_rh       = p_snapshot->humidity_rh;
+    ep_data.pressure_pa       = p_snapshot->pressure_pa;
+    ep_data.temperature_c     = p_snapshot->temperature_c;
     ep_data.measurement_count = ep_c5_measurement_count;
-    uint8_t mvtctr = (uint8_t) (app_sensor_event_count_get() % (RE_C5_MVTCTR_MAX + 1));
+    uint8_t mvtctr = (uint8_t) (p_snapshot->event_count % APP_DF_C5_MOVEMENT_INVALID);
     ep_data.movement_count    = mvtctr;
-    err_code |= ri_radio_address_get (&ep_data.address);
-    err_code |= ri_adv_tx_power_get (&ep_data.tx_power);
-    err_code |= rt_adc_vdd_get (&ep_data.battery_v);
+    ep_data.address           = p_snapshot->address;
+    ep_data.tx_power          = p_snapshot->tx_power;
+    ep_data.battery_v         = p_snapshot->battery_v;
     enc_code |= re_c5_encode (output, &ep_data);
 
     if (RE_SUCCESS != enc_code)
@@ -301,15 +542,10 @@ encode_to_c5 (uint8_t * const output,
 #endif
 
 #if RE_FA_ENABLED
-#ifndef APP_FA_KEY
-#define APP_FA_KEY {00, 11, 22, 33, 44, 55, 66, 77, 88, 99, 11, 12, 13, 14, 15, 16}
-#endif
-static const uint8_t ep_fa_key[RE_FA_CIPHERTEXT_LENGTH] = APP_FA_KEY;
-
 TESTABLE_STATIC rd_status_t
 encode_to_fa (uint8_t * const output,
               size_t * const output_length,
-              const rd_sensor_data_t * const data)
+              const app_dataformat_snapshot_t * const p_snapshot)
 {
     static uint8_t ep_fa_measurement_count = 0;
     rd_status_t err_code = RD_SUCCESS;
@@ -317,19 +553,19 @@ encode_to_fa (uint8_t * const output,
     re_fa_data_t ep_data = {0};
     ep_fa_measurement_count++;
     ep_fa_measurement_count %= 0xFFU;
-    ep_data.accelerationx_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_X_FIELD);
-    ep_data.accelerationy_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_Y_FIELD);
-    ep_data.accelerationz_g   = rd_sensor_data_parse (data, RD_SENSOR_ACC_Z_FIELD);
-    ep_data.humidity_rh       = rd_sensor_data_parse (data, RD_SENSOR_HUMI_FIELD);
-    ep_data.pressure_pa       = rd_sensor_data_parse (data, RD_SENSOR_PRES_FIELD);
-    ep_data.temperature_c     = rd_sensor_data_parse (data, RD_SENSOR_TEMP_FIELD);
+    ep_data.accelerationx_g   = p_snapshot->acceleration_x_g;
+    ep_data.accelerationy_g   = p_snapshot->acceleration_y_g;
+    ep_data.accelerationz_g   = p_snapshot->acceleration_z_g;
+    ep_data.humidity_rh       = p_snapshot->humidity_rh;
+    ep_data.pressure_pa       = p_snapshot->pressure_pa;
+    ep_data.temperature_c     = p_snapshot->temperature_c;
     ep_data.message_counter   = ep_fa_measurement_count;
-    err_code |= rt_adc_vdd_get (&ep_data.battery_v);
-    err_code |= ri_radio_address_get (&ep_data.address);
+    ep_data.battery_v         = p_snapshot->battery_v;
+    ep_data.address           = p_snapshot->address;
     enc_code |= re_fa_encode (output,
                               &ep_data,
                               &app_data_encrypt,
-                              ep_fa_key,
+                              crypto_key_get (DF_FA),
                               RE_FA_CIPHERTEXT_LENGTH); //!< Cipher length == key lenght
 
     if (RE_SUCCESS != enc_code)
@@ -342,54 +578,581 @@ encode_to_fa (uint8_t * const output,
 }
 #endif
 
+#if APP_DF_HISTORY_ENABLED
+TESTABLE_STATIC rd_status_t
+encode_to_history (uint8_t * const output,
+                   size_t * const output_length,
+                   const app_dataformat_snapshot_t * const p_snapshot)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    app_log_history_t history = {0};
+    app_dataformat_history_t ep_data = {0};
+    ep_data.temperature_c     = p_snapshot->temperature_c;
+    ep_data.humidity_rh       = p_snapshot->humidity_rh;
+    ep_data.pressure_pa       = p_snapshot->pressure_pa;
+
+    // Latest reading is sent alone if nothing is logged.
+    if (RD_SUCCESS == app_log_history_get (&history))
+    {
+        ep_data.sequence      = (uint16_t) history.sequence;
+        ep_data.interval_s    = history.interval_s;
+
+        for (size_t ii = 0; (ii < history.num_samples) && (ii < APP_DF_HISTORY_SAMPLES);
+                ii++)
+        {
+            ep_data.samples[ii].temperature_c = history.samples[ii].temperature_c;
+            ep_data.samples[ii].humidity_rh   = history.samples[ii].humidity_rh;
+            ep_data.samples[ii].pressure_pa   = history.samples[ii].pressure_pa;
+            ep_data.num_samples++;
+        }
+    }
+
+    err_code |= app_dataformat_history_encode (output, &ep_data);
+    *output_length = APP_DF_HISTORY_DATA_LENGTH;
+    return err_code;
+}
+#endif
+
+#if APP_DF_EXT_ENABLED
+/** @brief Fill vibration features of loudest axis, invalid if there are none. */
+static void vibration_fill (app_dataformat_ext_t * const p_ext)
+{
+    p_ext->vibration_rms_g = NAN;
+    p_ext->vibration_peak_g = NAN;
+    p_ext->vibration_crest = NAN;
+    p_ext->vibration_hz = NAN;
+#if APP_VIBRATION_ENABLED
+    app_vibration_features_t features = {0};
+
+    if (RD_SUCCESS == app_vibration_loudest_get (&features))
+    {
+        p_ext->vibration_rms_g = (float) features.rms_mg / 1000.0F;
+        p_ext->vibration_peak_g = (float) features.peak_mg / 1000.0F;
+        p_ext->vibration_crest = (float) features.crest_x10 / 10.0F;
+        p_ext->vibration_hz = (float) features.dominant_dhz / 10.0F;
+    }
+
+#endif
+}
+
+/** @brief Fill temperature range of heartbeat, invalid without oversampling. */
+static void temperature_range_fill (app_dataformat_ext_t * const p_ext)
+{
+    p_ext->temperature_min_c = NAN;
+    p_ext->temperature_max_c = NAN;
+#if APP_OVERSAMPLE_ENABLED
+    app_oversample_stats_t stats = {0};
+
+    if (RD_SUCCESS == app_oversample_stats_get (RD_SENSOR_TEMP_FIELD, &stats))
+    {
+        p_ext->temperature_min_c = stats.min;
+        p_ext->temperature_max_c = stats.max;
+    }
+
+#endif
+}
+
+TESTABLE_STATIC rd_status_t
+encode_to_ext (uint8_t * const output,
+               size_t * const output_length,
+               const app_dataformat_snapshot_t * const p_snapshot)
+{
+    static uint16_t ep_ext_measurement_count = 0;
+    rd_status_t err_code = RD_SUCCESS;
+    app_log_history_t history = {0};
+    app_battery_state_t battery = {0};
+    app_dataformat_ext_t ep_data = {0};
+
+    // Legacy sized buffers can't hold the format.
+    if (APP_DF_EXT_DATA_LENGTH > *output_length)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        ep_ext_measurement_count++;
+        ep_data.temperature_c     = p_snapshot->temperature_c;
+        ep_data.humidity_rh       = p_snapshot->humidity_rh;
+        ep_data.pressure_pa       = p_snapshot->pressure_pa;
+        ep_data.acceleration_x_g  = p_snapshot->acceleration_x_g;
+        ep_data.acceleration_y_g  = p_snapshot->acceleration_y_g;
+        ep_data.acceleration_z_g  = p_snapshot->acceleration_z_g;
+        ep_data.battery_v         = p_snapshot->battery_v;
+        ep_data.address           = p_snapshot->address;
+        ep_data.tx_power          = p_snapshot->tx_power;
+        ep_data.sequence          = ep_ext_measurement_count;
+        ep_data.movement_count    = (uint16_t) p_snapshot->event_count;
+        ep_data.presence_count    = (uint16_t) p_snapshot->presence_count;
+        ep_data.motion            = (p_snapshot->motion > 0.5f);
+        ep_data.presence          = (p_snapshot->presence > 0.5f);
+
+        // Log status is left out if nothing is logged.
+        if (RD_SUCCESS == app_log_history_get (&history))
+        {
+            ep_data.log            = true;
+            ep_data.log_sequence   = (uint16_t) history.sequence;
+            ep_data.log_interval_s = history.interval_s;
+        }
+
+        // Battery health is invalid until first rest and load pair.
+        if (RD_SUCCESS == app_battery_state_get (&battery))
+        {
+            ep_data.resistance_ohm = battery.resistance_ohm;
+            ep_data.remaining_days = battery.remaining_days;
+        }
+        else
+        {
+            ep_data.resistance_ohm = NAN;
+            ep_data.remaining_days = NAN;
+        }
+
+        vibration_fill (&ep_data);
+        temperature_range_fill (&ep_data);
+
+        err_code |= app_dataformat_ext_encode (output, &ep_data);
+        *output_length = APP_DF_EXT_DATA_LENGTH;
+    }
+
+    return err_code;
+}
+#endif
+
+#define DF_ENV_FIELDS .temperature_c = 1, .humidity_rh = 1, .pressure_pa = 1
+#define DF_ACC_FIELDS .acceleration_x_g = 1, .acceleration_y_g = 1, .acceleration_z_g = 1
+#define DF_FLAG_FIELDS .motion = 1, .presence = 1, .debug_tamb = 1
+
+/** @brief Compiled-in formats in rotation order, terminated by DF_INVALID. */
+static const app_dataformat_desc_t m_registry[] =
+{
+#if RE_3_ENABLED
+    {
+        DF_3, &encode_to_3, false, APP_DF_3_WEIGHT,
+        { .datas = { DF_ENV_FIELDS, DF_ACC_FIELDS } }
+    },
+#endif
+#if RE_5_ENABLED
+    {
+        DF_5, &encode_to_5, false, APP_DF_5_WEIGHT,
+#if APP_DATAFORMAT_FLAGS_IN_TX
+        // Debug flags are sent in place of TX power.
+        { .datas = { DF_ENV_FIELDS, DF_ACC_FIELDS, DF_FLAG_FIELDS } }
+#else
+        { .datas = { DF_ENV_FIELDS, DF_ACC_FIELDS } }
+#endif
+    },
+#endif
+#if RE_7_ENABLED
+    {
+        DF_7, &encode_to_7, true, APP_DF_7_WEIGHT,
+        { .datas = { DF_ENV_FIELDS, .motion = 1, .presence = 1 } }
+    },
+#endif
+#if RE_8_ENABLED
+    { DF_8, &encode_to_8, true, APP_DF_8_WEIGHT, { .datas = { DF_ENV_FIELDS } } },
+#endif
+#if RE_C5_ENABLED
+    { DF_C5, &encode_to_c5, true, APP_DF_C5_WEIGHT, { .datas = { DF_ENV_FIELDS } } },
+#endif
+#if RE_FA_ENABLED
+    {
+        DF_FA, &encode_to_fa, false, APP_DF_FA_WEIGHT,
+        { .datas = { DF_ENV_FIELDS, DF_ACC_FIELDS } }
+    },
+#endif
+#if APP_DF_HISTORY_ENABLED
+    {
+        DF_HISTORY, &encode_to_history, false, APP_DF_HISTORY_WEIGHT,
+        { .datas = { DF_ENV_FIELDS } }
+    },
+#endif
+#if APP_DF_EXT_ENABLED
+    {
+        DF_EXT, &encode_to_ext, false, APP_DF_EXT_WEIGHT,
+        { .datas = { DF_ENV_FIELDS, DF_ACC_FIELDS, .motion = 1, .presence = 1 } }
+    },
+#endif
+    { DF_INVALID, NULL, false, 0U, { .bitfield = 0U } }
+};
+
+#define DF_REGISTRY_COUNT ((sizeof (m_registry) / sizeof (m_registry[0])) - 1U)
+
+/** @brief Index of format in registry, DF_REGISTRY_COUNT if not found. */
+static size_t registry_index (const app_dataformat_t format)
+{
+    size_t index = DF_REGISTRY_COUNT;
+
+    for (size_t ii = 0; (ii < DF_REGISTRY_COUNT) && (DF_REGISTRY_COUNT == index); ii++)
+    {
+        if (format == m_registry[ii].id)
+        {
+            index = ii;
+        }
+    }
+
+    return index;
+}
+
+const app_dataformat_desc_t * app_dataformat_desc_get (const app_dataformat_t format)
+{
+    const size_t index = registry_index (format);
+    return (DF_REGISTRY_COUNT > index) ? &m_registry[index] : NULL;
+}
+
+rd_sensor_data_fields_t app_dataformat_fields_get (const app_dataformats_t formats)
+{
+    rd_sensor_data_fields_t fields = { .bitfield = 0U };
+
+    for (size_t ii = 0; ii < DF_REGISTRY_COUNT; ii++)
+    {
+        if (0U != (formats.formats & m_registry[ii].id))
+        {
+            fields.bitfield |= m_registry[ii].required.bitfield;
+        }
+    }
+
+    return fields;
+}
+
+#define DF_WEIGHT_SLOTS (8U) //!< One weight per format bit, stored to flash as is.
+
+static uint8_t m_weights[DF_WEIGHT_SLOTS]; //!< Runtime weights by format bit.
+static bool m_weights_loaded;              //!< Runtime weights override registry.
+static uint8_t m_repeats;                  //!< Consecutive repeats of current format.
+
+/** @brief Bit position of format, DF_WEIGHT_SLOTS if format is not a single bit. */
+static size_t weight_slot (const app_dataformat_t format)
+{
+    size_t slot = DF_WEIGHT_SLOTS;
+
+    for (size_t ii = 0; (ii < DF_WEIGHT_SLOTS) && (DF_WEIGHT_SLOTS == slot); ii++)
+    {
+        if ( (uint32_t) format == (1U << ii))
+        {
+            slot = ii;
+        }
+    }
+
+    return slot;
+}
+
+static uint8_t weight_get (const app_dataformat_desc_t * const p_desc)
+{
+    return m_weights_loaded ? m_weights[weight_slot (p_desc->id)] : p_desc->weight;
+}
+
+rd_status_t app_dataformat_weights_init (void)
+{
+    // Missing record or flash is not an error, registry weights are used then.
+    m_weights_loaded = (RD_SUCCESS == rt_flash_load (APP_FLASH_DATAFORMAT_FILE,
+                        APP_FLASH_DATAFORMAT_WEIGHTS_RECORD, m_weights,
+                        sizeof (m_weights)));
+    m_repeats = 0U;
+    return RD_SUCCESS;
+}
+
+rd_status_t app_dataformat_weight_set (const app_dataformat_t format,
+                                       const uint8_t weight)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == app_dataformat_desc_get (format))
+    {
+        err_code |= RD_ERROR_NOT_FOUND;
+    }
+    else
+    {
+        uint8_t weights[DF_WEIGHT_SLOTS] = {0};
+
+        // Formats not compiled in keep weights stored by other firmware.
+        if (m_weights_loaded)
+        {
+            memcpy (weights, m_weights, sizeof (weights));
+        }
+        else
+        {
+            memset (weights, 1U, sizeof (weights));
+
+            for (size_t ii = 0; ii < DF_REGISTRY_COUNT; ii++)
+            {
+                weights[weight_slot (m_registry[ii].id)] = m_registry[ii].weight;
+            }
+        }
+
+        weights[weight_slot (format)] = weight;
+        err_code |= rt_flash_store (APP_FLASH_DATAFORMAT_FILE,
+                                    APP_FLASH_DATAFORMAT_WEIGHTS_RECORD, weights,
+                                    sizeof (weights));
+
+        // Weights which do not survive reboot would silently revert later.
+        if (RD_SUCCESS == err_code)
+        {
+            memcpy (m_weights, weights, sizeof (m_weights));
+            m_weights_loaded = true;
+        }
+    }
+
+    return err_code;
+}
+
+uint8_t app_dataformat_weight_get (const app_dataformat_t format)
+{
+    const app_dataformat_desc_t * const p_desc = app_dataformat_desc_get (format);
+    return (NULL == p_desc) ? 0U : weight_get (p_desc);
+}
+
+app_dataformat_t app_dataformat_next (const app_dataformats_t formats,
+                                      const app_dataformat_t state)
+{
+    const app_dataformat_desc_t * p_next = &m_registry[DF_REGISTRY_COUNT];
+    const size_t current = registry_index (state);
+    // Unknown state starts rotation from first format.
+    const size_t start = (DF_REGISTRY_COUNT > current) ? (current + 1U) : 0U;
+
+    // Current format is repeated until it has been sent weight times in a row.
+    if ( (DF_REGISTRY_COUNT > current) && (0U != (formats.formats & state))
+            && ( (m_repeats + 1U) < weight_get (&m_registry[current])))
+    {
+        m_repeats++;
+        p_next = &m_registry[current];
+    }
+    else
+    {
+        m_repeats = 0U;
+
+        // Formats of weight 0 are sent only if no weighted format is enabled.
+        for (size_t pass = 0; (pass < 2U) && (DF_INVALID == p_next->id); pass++)
+        {
+            // Only compiled-in formats are walked, at most one round.
+            for (size_t ii = 0; (ii < DF_REGISTRY_COUNT) && (DF_INVALID == p_next->id);
+                    ii++)
+            {
+                const size_t index = (start + ii) % DF_REGISTRY_COUNT;
+
+                if ( (0U != (formats.formats & m_registry[index].id))
+                        && ( (0U < pass) || (0U < weight_get (&m_registry[index]))))
+                {
+                    p_next = &m_registry[index];
+                }
+            }
+        }
+    }
+
+    ri_adv_enable_uuid (p_next->uuid);
+    return p_next->id;
+}
+
+rd_status_t app_dataformat_weights_handle (const ri_comm_xfer_fp_t reply_fp,
+        const uint8_t * const raw_message,
+        const uint16_t data_len)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == raw_message)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (data_len < RE_STANDARD_MESSAGE_LENGTH)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        const uint8_t * const p_payload = &raw_message[RE_STANDARD_PAYLOAD_START_INDEX];
+        const re_op_t op = (re_op_t) raw_message[RE_STANDARD_OPERATION_INDEX];
+        const app_dataformat_t format = (app_dataformat_t) p_payload[0];
+        rd_status_t op_code = RD_SUCCESS;
+
+        if (RE_STANDARD_VALUE_WRITE == op)
+        {
+            op_code |= app_dataformat_weight_set (format, p_payload[1]);
+        }
+        else
+        {
+            // Read replies current weight.
+        }
+
+        const uint8_t reply[] =
+        {
+            p_payload[0], app_dataformat_weight_get (format),
+            (RD_SUCCESS == op_code) ? 0U : 0xFFU
+        };
+        err_code |= endpoint_reply (reply_fp, raw_message, reply, sizeof (reply));
+        err_code |= op_code;
+    }
+
+    return err_code;
+}
+
+#ifdef CEEDLING
+void app_dataformat_reset (void)
+{
+#if (RE_8_ENABLED || RE_FA_ENABLED)
+    m_crypto_init = false;
+#endif
+    app_dataformat_key_stage_clear();
+    m_weights_loaded = false;
+    m_repeats = 0U;
+}
+#endif
+
+/** @brief Sensor field and its float in snapshot. */
+typedef struct
+{
+    rd_sensor_data_fields_t field; //!< Field in sensor data.
+    size_t offset;                 //!< Offset of value in snapshot.
+} snapshot_field_t;
+
+#define SNAPSHOT_FIELD(name, member) \
+    { { .datas = { .name = 1 } }, offsetof (app_dataformat_snapshot_t, member) }
+
+static const snapshot_field_t m_snapshot_fields[] =
+{
+    SNAPSHOT_FIELD (temperature_c, temperature_c),
+    SNAPSHOT_FIELD (humidity_rh, humidity_rh),
+    SNAPSHOT_FIELD (pressure_pa, pressure_pa),
+    SNAPSHOT_FIELD (acceleration_x_g, acceleration_x_g),
+    SNAPSHOT_FIELD (acceleration_y_g, acceleration_y_g),
+    SNAPSHOT_FIELD (acceleration_z_g, acceleration_z_g),
+    SNAPSHOT_FIELD (motion, motion),
+    SNAPSHOT_FIELD (presence, presence),
+    SNAPSHOT_FIELD (debug_tamb, debug_tamb)
+};
+
+#define SNAPSHOT_FIELD_COUNT (sizeof (m_snapshot_fields) / sizeof (m_snapshot_fields[0]))
+
+rd_status_t app_dataformat_snapshot_fill (app_dataformat_snapshot_t * const p_snapshot,
+        const rd_sensor_data_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_snapshot) || (NULL == p_data))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        // Fields which no compiled-in format encodes are left invalid.
+        const app_dataformats_t compiled = { .formats = UINT_MAX };
+        const uint32_t encoded = app_dataformat_fields_get (compiled).bitfield;
+        uint8_t * const p_base = (uint8_t *) p_snapshot;
+
+        for (size_t ii = 0; ii < SNAPSHOT_FIELD_COUNT; ii++)
+        {
+            const rd_sensor_data_fields_t field = m_snapshot_fields[ii].field;
+            float value = RD_FLOAT_INVALID;
+
+            if (0U != (encoded & field.bitfield))
+            {
+                value = rd_sensor_data_parse (p_data, field.datas);
+            }
+
+            * ( (float *) &p_base[m_snapshot_fields[ii].offset]) = value;
+        }
+
+        p_snapshot->battery_v = RD_FLOAT_INVALID;
+        p_snapshot->address = 0U;
+        p_snapshot->tx_power = 0;
+        p_snapshot->event_count = app_sensor_event_count_get();
+        p_snapshot->presence_count = app_sensor_presence_count_get();
+        err_code |= app_battery_vdd_get (&p_snapshot->battery_v);
+        err_code |= ri_radio_address_get (&p_snapshot->address);
+        err_code |= ri_adv_tx_power_get (&p_snapshot->tx_power);
+    }
+
+    return err_code;
+}
+
+static uint32_t fnv1a (uint32_t hash, const void * const p_data, const size_t length)
+{
+    const uint8_t * const p_bytes = (const uint8_t *) p_data;
+
+    for (size_t ii = 0; ii < length; ii++)
+    {
+        hash ^= p_bytes[ii];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+uint32_t app_dataformat_fingerprint (const rd_sensor_data_t * const p_data,
+                                     const size_t value_count)
+{
+    const uint32_t event_count = app_sensor_event_count_get();
+    const uint32_t presence_count = app_sensor_presence_count_get();
+    float battery_v = RD_FLOAT_INVALID;
+    uint64_t address = 0U;
+    int8_t tx_power = 0;
+    uint32_t hash = FNV_OFFSET_BASIS;
+    (void) app_battery_vdd_get (&battery_v);
+    (void) ri_radio_address_get (&address);
+    (void) ri_adv_tx_power_get (&tx_power);
+    hash = fnv1a (hash, &p_data->valid, sizeof (p_data->valid));
+    hash = fnv1a (hash, p_data->data, value_count * sizeof (float));
+    hash = fnv1a (hash, &event_count, sizeof (event_count));
+    hash = fnv1a (hash, &presence_count, sizeof (presence_count));
+    hash = fnv1a (hash, &battery_v, sizeof (battery_v));
+    hash = fnv1a (hash, &address, sizeof (address));
+    hash = fnv1a (hash, &tx_power, sizeof (tx_power));
+#if APP_DF_HISTORY_ENABLED || APP_DF_EXT_ENABLED
+    app_log_history_t history = {0};
+
+    // Logged samples change only with sequence of newest sample.
+    if (RD_SUCCESS == app_log_history_get (&history))
+    {
+        hash = fnv1a (hash, &history.sequence, sizeof (history.sequence));
+        hash = fnv1a (hash, &history.interval_s, sizeof (history.interval_s));
+        hash = fnv1a (hash, &history.num_samples, sizeof (history.num_samples));
+    }
+
+#endif
+#if APP_DF_EXT_ENABLED
+    app_battery_state_t battery = {0};
+
+    if (RD_SUCCESS == app_battery_state_get (&battery))
+    {
+        hash = fnv1a (hash, &battery.resistance_ohm, sizeof (battery.resistance_ohm));
+        hash = fnv1a (hash, &battery.remaining_days, sizeof (battery.remaining_days));
+    }
+
+#   if APP_VIBRATION_ENABLED
+    app_vibration_features_t features = {0};
+
+    if (RD_SUCCESS == app_vibration_loudest_get (&features))
+    {
+        hash = fnv1a (hash, &features, sizeof (features));
+    }
+
+#   endif
+#   if APP_OVERSAMPLE_ENABLED
+    app_oversample_stats_t stats = {0};
+
+    if (RD_SUCCESS == app_oversample_stats_get (RD_SENSOR_TEMP_FIELD, &stats))
+    {
+        hash = fnv1a (hash, &stats.min, sizeof (stats.min));
+        hash = fnv1a (hash, &stats.max, sizeof (stats.max));
+    }
+
+#   endif
+#endif
+    return hash;
+}
+
 rd_status_t app_dataformat_encode (uint8_t * const output,
                                    size_t * const output_length,
-                                   const rd_sensor_data_t * const p_data,
+                                   const app_dataformat_snapshot_t * const p_snapshot,
                                    const app_dataformat_t format)
 {
     rd_status_t err_code = RD_SUCCESS;
+    const app_dataformat_desc_t * const p_desc = app_dataformat_desc_get (format);
 
-    switch (format)
-    {
-#       if RE_3_ENABLED
-
-        case DF_3:
-            err_code |= encode_to_3 (output, output_length, p_data);
-            break;
-#       endif
-#       if RE_5_ENABLED
-
-        case DF_5:
-            err_code |= encode_to_5 (output, output_length, p_data);
-            break;
-#       endif
-#       if RE_7_ENABLED
-
-        case DF_7:
-            err_code |= encode_to_7 (output, output_length, p_data);
-            break;
-#       endif
-#       if RE_8_ENABLED
-
-        case DF_8:
-            err_code |= encode_to_8 (output, output_length, p_data);
-            break;
-#       endif
-#       if RE_C5_ENABLED
-
-        case DF_C5:
-            err_code |= encode_to_c5 (output, output_length, p_data);
-            break;
-#       endif
-#       if RE_FA_ENABLED
-
-        case DF_FA:
-            err_code |= encode_to_fa (output, output_length, p_data);
-            break;
-#       endif
-
-        default:
-            err_code |= RD_ERROR_NOT_ENABLED;
+    if (NULL == p_desc)
+    {
+        err_code |= RD_ERROR_NOT_ENABLED;
+    }
+    else
+    {
+        err_code |= p_desc->encode (output, output_length, p_snapshot);
     }
 
     return err_code;
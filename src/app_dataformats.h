@@ -20,6 +20,11 @@
 #include "ruuvi_endpoint_7.h"
 #include "ruuvi_endpoint_8.h"
 #include "ruuvi_endpoint_fa.h"
+#include "ruuvi_interface_communication.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 /**
  * Control inclusion of data format flags in transmission.
  * Default is disabled (0U). Define APP_DATAFORMAT_FLAGS_IN_TX as 1U
@@ -30,6 +35,9 @@
 #define APP_DATAFORMAT_FLAGS_IN_TX (0U)
 #endif
 
+/** @brief Length of AES-128 key of encrypted formats. */
+#define APP_DATAFORMAT_KEY_LENGTH (16U)
+
 typedef enum
 {
     DF_INVALID = 0U,
@@ -38,7 +46,9 @@ typedef enum
     DF_7       = (1U << 2U),
     DF_8       = (1U << 3U),
     DF_C5      = (1U << 4U),
-    DF_FA      = (1U << 5U)
+    DF_FA      = (1U << 5U),
+    DF_HISTORY = (1U << 6U),
+    DF_EXT     = (1U << 7U)
 } app_dataformat_t;
 
 typedef struct
@@ -46,10 +56,66 @@ typedef struct
     unsigned int formats; //!< Container for enabled data formats
 } app_dataformats_t;
 
+/**
+ * @brief Measurement and device state encoded by data formats.
+ *
+ * Filled once per measurement by @ref app_dataformat_snapshot_fill and shared
+ * by all encoders, so sensor data is not searched and device state is not
+ * queried again for each format. Values which are not available are
+ * RD_FLOAT_INVALID.
+ */
+typedef struct
+{
+    float temperature_c;    //!< Temperature, C.
+    float humidity_rh;      //!< Relative humidity, %.
+    float pressure_pa;      //!< Pressure, Pa.
+    float acceleration_x_g; //!< Acceleration along X, g.
+    float acceleration_y_g; //!< Acceleration along Y, g.
+    float acceleration_z_g; //!< Acceleration along Z, g.
+    float motion;           //!< Motion detected if > 0.5.
+    float presence;         //!< Presence detected if > 0.5.
+    float debug_tamb;       //!< Debug flag of ambient temperature.
+    float battery_v;        //!< Battery voltage, V.
+    uint64_t address;       //!< Radio address.
+    uint32_t event_count;   //!< Motion event count.
+    uint32_t presence_count; //!< Presence event count.
+    int8_t tx_power;        //!< Advertising TX power, dBm.
+} app_dataformat_snapshot_t;
+
+/**
+ * @brief Encode snapshot into output buffer.
+ *
+ * @param[out] output Buffer to which data is encoded.
+ * @param[in,out] output_length Input: Size of output buffer.
+ *                              Output: Size of encoded data.
+ * @param[in] p_snapshot Measurement to encode.
+ */
+typedef rd_status_t (*app_dataformat_encoder_t) (uint8_t * const output,
+        size_t * const output_length,
+        const app_dataformat_snapshot_t * const p_snapshot);
+
+/**
+ * @brief Descriptor of a data format in the registry.
+ *
+ * Registry has one descriptor per compiled-in format in rotation order,
+ * adding a format is a single entry in the registry.
+ */
+typedef struct
+{
+    app_dataformat_t id;              //!< Format flag.
+    app_dataformat_encoder_t encode;  //!< Encoder of format.
+    bool uuid;                        //!< Advertisement must carry service UUID.
+    uint8_t weight;                   //!< Default rotation weight, APP_DF_x_WEIGHT.
+    rd_sensor_data_fields_t required; //!< Sensor fields encoded by format.
+} app_dataformat_desc_t;
+
 
 /**
  * @brief Return next dataformat to send
  *
+ * Each format is returned as many times in a row as its rotation weight,
+ * see @ref app_dataformat_weight_set.
+ *
  * @param[in] formats Enabled formats
  * @param[in] state Current state of dataformat picker.
  * @return    Next dataformat to use in app. DF_INVALID if no formats are enabled.
@@ -58,21 +124,206 @@ app_dataformat_t app_dataformat_next (const app_dataformats_t formats,
                                       const app_dataformat_t state);
 
 /**
- * @brief Encode data into given buffer with given format.
+ * @brief Get descriptor of a data format.
+ *
+ * @param[in] format Format to look up.
+ * @return Descriptor of format, NULL if format is not compiled in.
+ */
+const app_dataformat_desc_t * app_dataformat_desc_get (const app_dataformat_t format);
+
+/**
+ * @brief Get sensor fields encoded by any of given formats.
+ *
+ * @ref app_dataformat_snapshot_fill copies only fields which some compiled-in
+ * format encodes.
+ *
+ * @param[in] formats Enabled formats.
+ * @return Union of fields required by formats.
+ */
+rd_sensor_data_fields_t app_dataformat_fields_get (const app_dataformats_t formats);
+
+/**
+ * @brief Fill snapshot from sensor data and device state.
+ *
+ * Each encoded field is parsed from sensor data once, battery voltage, radio
+ * address, TX power and motion event count are read once. Call once per
+ * measurement and encode all formats from the snapshot.
+ *
+ * @param[out] p_snapshot Snapshot to fill.
+ * @param[in] p_data Measured sensor data.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if either parameter is NULL.
+ * @return Error code of device state read, snapshot is filled regardless.
+ */
+rd_status_t app_dataformat_snapshot_fill (app_dataformat_snapshot_t * const p_snapshot,
+        const rd_sensor_data_t * const p_data);
+
+/**
+ * @brief Fingerprint every input which snapshot and encoders read.
+ *
+ * Hashes sensor data, device state of @ref app_dataformat_snapshot_fill and
+ * state read by history and extended formats: log status, battery health,
+ * vibration features and temperature range of oversampling. If fingerprint
+ * has not changed, payloads encoded from previous measurement are still
+ * valid apart from sequence counters.
+ *
+ * @param[in] p_data Measured data, values which are not read must be
+ *                   RD_FLOAT_INVALID.
+ * @param[in] value_count Number of values in p_data.
+ * @return Hash of encoded inputs.
+ */
+uint32_t app_dataformat_fingerprint (const rd_sensor_data_t * const p_data,
+                                     const size_t value_count);
+
+/**
+ * @brief Encode snapshot into given buffer with given format.
  *
  * A call to this function will increment measurement sequence counter
- * where applicable. Sensors are read to get latest data from board.
+ * where applicable.
  *
  * @param[out] output Buffer to which data is encoded.
  * @param[in,out] output_length Input: Size of output buffer.
  *                              Output: Size of encoded data.
- * @param[in] data Pointer to sensor data to encode.
+ * @param[in] p_snapshot Snapshot filled by @ref app_dataformat_snapshot_fill.
  * @param[in] format Format to encode data into.
  *
  */
 rd_status_t app_dataformat_encode (uint8_t * const output,
                                    size_t * const output_length,
-                                   const rd_sensor_data_t * const data,
+                                   const app_dataformat_snapshot_t * const p_snapshot,
                                    const app_dataformat_t format);
 
+/**
+ * @brief Derive keys of encrypted formats.
+ *
+ * Keys provisioned at runtime are loaded from flash, compile-time keys are
+ * used otherwise. Format 8 key is diversified with device ID. Call once at
+ * boot after flash is initialized, keys are derived on first encode otherwise.
+ *
+ * @retval RD_SUCCESS on success.
+ * @return Error code from reading device ID.
+ */
+rd_status_t app_dataformat_crypto_init (void);
+
+/**
+ * @brief Provision key of an encrypted format.
+ *
+ * Key is stored to flash and used as is from next encode on, also after reboot.
+ *
+ * @param[in] format DF_8 or DF_FA.
+ * @param[in] key Key to use, NULL to revert to compile-time key.
+ * @param[in] key_size Size of key, APP_DATAFORMAT_KEY_LENGTH.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NOT_FOUND if format is not an encrypted format compiled in.
+ * @retval RD_ERROR_INVALID_LENGTH if key_size is not APP_DATAFORMAT_KEY_LENGTH.
+ * @return Error code from flash, key is not changed on error.
+ */
+rd_status_t app_dataformat_key_set (const app_dataformat_t format,
+                                    const uint8_t * const key, const size_t key_size);
+
+/**
+ * @brief Check if format uses a key provisioned at runtime.
+ *
+ * @param[in] format Format to check.
+ * @return True if format has a provisioned key.
+ */
+bool app_dataformat_key_is_provisioned (const app_dataformat_t format);
+
+/**
+ * @brief Handle a message to APP_ENDPOINT_DATAFORMAT_KEY.
+ *
+ * First payload byte is format, second is offset of key bytes and following
+ * six bytes are key bytes at offset. Key is written in chunks at offsets 0, 6
+ * and 12 and is provisioned once all chunks are received. Offset 0xFF reverts
+ * format to compile-time key. Writes are accepted only on a connection with
+ * configuration unlocked.
+ *
+ * Reply echoes format and offset, third byte is 1 if format has a provisioned
+ * key and fourth byte is 0xFF if write failed. Keys are never replied.
+ *
+ * @param[in] reply_fp Function pointer to send reply to.
+ * @param[in] raw_message Standard Ruuvi Endpoint message.
+ * @param[in] data_len Length of raw_message.
+ *
+ * @retval RD_SUCCESS Message was handled.
+ * @retval RD_ERROR_NULL Raw message is NULL.
+ * @retval RD_ERROR_DATA_SIZE data_len is less than RE_STANDARD_MESSAGE_LENGTH.
+ * @return Error code of key write.
+ */
+rd_status_t app_dataformat_key_handle (const ri_comm_xfer_fp_t reply_fp,
+                                       const uint8_t * const raw_message,
+                                       const uint16_t data_len);
+
+/**
+ * @brief Discard chunks of a partially written key.
+ *
+ * Call on disconnection so that a key is never completed from chunks written
+ * over different connections.
+ */
+void app_dataformat_key_stage_clear (void);
+
+/**
+ * @brief Load rotation weights of data formats.
+ *
+ * Weights set at runtime are loaded from flash, registry weights are used
+ * otherwise. Call once at boot after flash is initialized.
+ *
+ * @retval RD_SUCCESS Weights are loaded or registry weights are used.
+ */
+rd_status_t app_dataformat_weights_init (void);
+
+/**
+ * @brief Set rotation weight of a data format.
+ *
+ * @ref app_dataformat_next sends format weight times in a row before rotating
+ * to next enabled format. Weight 0 leaves format out of rotation unless no
+ * format with a weight is enabled. Weight is stored to flash and is used from
+ * next rotation on, also after reboot.
+ *
+ * @param[in] format Format to set weight of.
+ * @param[in] weight Consecutive advertisements of format.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NOT_FOUND if format is not compiled in.
+ * @return Error code from flash, weight is not changed on error.
+ */
+rd_status_t app_dataformat_weight_set (const app_dataformat_t format,
+                                       const uint8_t weight);
+
+/**
+ * @brief Get rotation weight of a data format.
+ *
+ * @param[in] format Format to get weight of.
+ * @return Weight of format, 0 if format is not compiled in.
+ */
+uint8_t app_dataformat_weight_get (const app_dataformat_t format);
+
+/**
+ * @brief Handle a message to APP_ENDPOINT_DATAFORMAT_WEIGHTS.
+ *
+ * First payload byte is format and second byte is weight to write. Writes
+ * are accepted only on a connection with configuration unlocked.
+ *
+ * Reply echoes format, second byte is current weight of format and third byte
+ * is 0xFF if write failed.
+ *
+ * @param[in] reply_fp Function pointer to send reply to.
+ * @param[in] raw_message Standard Ruuvi Endpoint message.
+ * @param[in] data_len Length of raw_message.
+ *
+ * @retval RD_SUCCESS Message was handled.
+ * @retval RD_ERROR_NULL Raw message is NULL.
+ * @retval RD_ERROR_DATA_SIZE data_len is less than RE_STANDARD_MESSAGE_LENGTH.
+ * @return Error code of weight write.
+ */
+rd_status_t app_dataformat_weights_handle (const ri_comm_xfer_fp_t reply_fp,
+        const uint8_t * const raw_message,
+        const uint16_t data_len);
+
+#ifdef CEEDLING
+void app_dataformat_reset (void);
+#endif
+
 #endif // APP_DATAFORMATS_H
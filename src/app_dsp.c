@@ -0,0 +1,312 @@
+/**
+ * @addtogroup app_dsp
+ */
+/** @{ */
+/**
+ * @file app_dsp.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Software filtering of sensor samples.
+ */
+#include "app_config.h"
+#include "app_dsp.h"
+#include "app_testing.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <math.h>
+#include <string.h>
+
+/** @brief Filter channel of a single field. */
+typedef struct
+{
+    rd_sensor_data_fields_t field; //!< Field filtered by this channel.
+    app_dsp_config_t config;       //!< Filter configuration.
+    app_dsp_state_t state;         //!< Filter state.
+} app_dsp_channel_t;
+
+enum
+{
+    DSP_TEMPERATURE_INDEX,
+    DSP_HUMIDITY_INDEX,
+    DSP_PRESSURE_INDEX,
+    DSP_ACC_X_INDEX,
+    DSP_ACC_Y_INDEX,
+    DSP_ACC_Z_INDEX,
+    DSP_CHANNEL_COUNT
+};
+
+#define APP_DSP_ACC_DEFAULT_CFG        \
+{                                      \
+    .filter = APP_DSP_ACC_FILTER,      \
+    .parameter = APP_DSP_ACC_PARAM,    \
+    .outlier_limit = APP_DSP_ACC_OUTLIER \
+}
+
+TESTABLE_STATIC app_dsp_channel_t m_channels[DSP_CHANNEL_COUNT] =
+{
+    [DSP_TEMPERATURE_INDEX] =
+    {
+        .field.datas.temperature_c = 1,
+        .config =
+        {
+            .filter = APP_DSP_TEMPERATURE_FILTER,
+            .parameter = APP_DSP_TEMPERATURE_PARAM,
+            .outlier_limit = APP_DSP_TEMPERATURE_OUTLIER
+        }
+    },
+    [DSP_HUMIDITY_INDEX] =
+    {
+        .field.datas.humidity_rh = 1,
+        .config =
+        {
+            .filter = APP_DSP_HUMIDITY_FILTER,
+            .parameter = APP_DSP_HUMIDITY_PARAM,
+            .outlier_limit = APP_DSP_HUMIDITY_OUTLIER
+        }
+    },
+    [DSP_PRESSURE_INDEX] =
+    {
+        .field.datas.pressure_pa = 1,
+        .config =
+        {
+            .filter = APP_DSP_PRESSURE_FILTER,
+            .parameter = APP_DSP_PRESSURE_PARAM,
+            .outlier_limit = APP_DSP_PRESSURE_OUTLIER
+        }
+    },
+    [DSP_ACC_X_INDEX] =
+    {
+        .field.datas.acceleration_x_g = 1,
+        .config = APP_DSP_ACC_DEFAULT_CFG
+    },
+    [DSP_ACC_Y_INDEX] =
+    {
+        .field.datas.acceleration_y_g = 1,
+        .config = APP_DSP_ACC_DEFAULT_CFG
+    },
+    [DSP_ACC_Z_INDEX] =
+    {
+        .field.datas.acceleration_z_g = 1,
+        .config = APP_DSP_ACC_DEFAULT_CFG
+    }
+};
+
+static bool filter_is_windowed (const app_dsp_filter_t filter)
+{
+    return (APP_DSP_FILTER_MOVING_AVG == filter) || (APP_DSP_FILTER_MEDIAN == filter);
+}
+
+/** @brief Parameter of filter, at least 1. */
+static uint8_t filter_parameter (const app_dsp_config_t * const config)
+{
+    return (0U == config->parameter) ? 1U : config->parameter;
+}
+
+/** @brief Window length of windowed filter, clamped to state buffer. */
+static uint8_t window_length (const app_dsp_config_t * const config)
+{
+    uint8_t length = filter_parameter (config);
+
+    if (APP_DSP_WINDOW_MAX < length)
+    {
+        length = APP_DSP_WINDOW_MAX;
+    }
+
+    return length;
+}
+
+static void window_push (app_dsp_state_t * const state, const uint8_t length,
+                         const float sample)
+{
+    state->window[state->head] = sample;
+    state->head = (state->head + 1U) % length;
+
+    if (state->count < length)
+    {
+        state->count++;
+    }
+}
+
+static float window_mean (const app_dsp_state_t * const state)
+{
+    float sum = 0;
+
+    for (uint8_t ii = 0; ii < state->count; ii++)
+    {
+        sum += state->window[ii];
+    }
+
+    return sum / state->count;
+}
+
+static float window_median (const app_dsp_state_t * const state)
+{
+    float sorted[APP_DSP_WINDOW_MAX];
+    const uint8_t count = state->count;
+
+    // Insertion sort, window is at most a few samples.
+    for (uint8_t ii = 0; ii < count; ii++)
+    {
+        float value = state->window[ii];
+        uint8_t jj = ii;
+
+        while ( (jj > 0U) && (sorted[jj - 1U] > value))
+        {
+            sorted[jj] = sorted[jj - 1U];
+            jj--;
+        }
+
+        sorted[jj] = value;
+    }
+
+    float median = sorted[count / 2U];
+
+    if (0U == (count % 2U))
+    {
+        median = (median + sorted[ (count / 2U) - 1U]) / 2.0F;
+    }
+
+    return median;
+}
+
+static bool sample_is_outlier (app_dsp_state_t * const state,
+                               const app_dsp_config_t * const config,
+                               const float sample)
+{
+    bool outlier = false;
+
+    if ( (config->outlier_limit > 0.0F)
+            && (state->count > 0U)
+            && (fabsf (sample - state->estimate) > config->outlier_limit)
+            && (state->rejections < APP_DSP_OUTLIER_MAX_REJECTS))
+    {
+        // Repeated "outliers" are a real step in the signal, accept those eventually.
+        state->rejections++;
+        outlier = true;
+    }
+    else
+    {
+        state->rejections = 0;
+    }
+
+    return outlier;
+}
+
+float app_dsp_filter (app_dsp_state_t * const state,
+                      const app_dsp_config_t * const config,
+                      const float sample)
+{
+    float output = sample;
+
+    if ( (NULL != state) && (NULL != config) && !isnan (sample))
+    {
+        if (sample_is_outlier (state, config, sample))
+        {
+            output = state->estimate;
+        }
+        else
+        {
+            switch (config->filter)
+            {
+                case APP_DSP_FILTER_MOVING_AVG:
+                    window_push (state, window_length (config), sample);
+                    output = window_mean (state);
+                    break;
+
+                case APP_DSP_FILTER_MEDIAN:
+                    window_push (state, window_length (config), sample);
+                    output = window_median (state);
+                    break;
+
+                case APP_DSP_FILTER_IIR_LOW_PASS:
+                    if (0U == state->count)
+                    {
+                        state->count = 1U;
+                        output = sample;
+                    }
+                    else
+                    {
+                        output = state->estimate
+                                 + ( (sample - state->estimate) / filter_parameter (config));
+                    }
+
+                    break;
+
+                case APP_DSP_FILTER_NONE:
+                default:
+                    state->count = 1U;
+                    break;
+            }
+
+            state->estimate = output;
+        }
+    }
+
+    return output;
+}
+
+rd_status_t app_dsp_configure (const rd_sensor_data_bitfield_t field,
+                               const app_dsp_config_t * const config)
+{
+    rd_status_t err_code = RD_ERROR_NOT_FOUND;
+    const rd_sensor_data_fields_t target = { .datas = field };
+
+    if (NULL == config)
+    {
+        err_code = RD_ERROR_NULL;
+    }
+    else if ( (0U == config->parameter)
+              || (filter_is_windowed (config->filter)
+                  && (APP_DSP_WINDOW_MAX < config->parameter)))
+    {
+        err_code = RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < DSP_CHANNEL_COUNT; ii++)
+        {
+            if (target.bitfield == m_channels[ii].field.bitfield)
+            {
+                m_channels[ii].config = *config;
+                memset (&m_channels[ii].state, 0, sizeof (m_channels[ii].state));
+                err_code = RD_SUCCESS;
+            }
+        }
+    }
+
+    return err_code;
+}
+
+void app_dsp_process (rd_sensor_data_t * const data)
+{
+    if (NULL != data)
+    {
+        for (size_t ii = 0; ii < DSP_CHANNEL_COUNT; ii++)
+        {
+            app_dsp_channel_t * const channel = &m_channels[ii];
+            const bool active = (APP_DSP_FILTER_NONE != channel->config.filter)
+                                || (channel->config.outlier_limit > 0.0F);
+
+            if (active && (data->valid.bitfield & channel->field.bitfield))
+            {
+                const float sample = rd_sensor_data_parse (data, channel->field.datas);
+                const float filtered = app_dsp_filter (&channel->state, &channel->config,
+                                                       sample);
+                rd_sensor_data_set (data, channel->field.datas, filtered);
+            }
+        }
+    }
+}
+
+void app_dsp_reset (void)
+{
+    for (size_t ii = 0; ii < DSP_CHANNEL_COUNT; ii++)
+    {
+        memset (&m_channels[ii].state, 0, sizeof (m_channels[ii].state));
+    }
+}
+
+/** @} */
@@ -0,0 +1,130 @@
+#ifndef APP_DSP_H
+#define APP_DSP_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_dsp Application signal processing
+ * @brief Software filtering of sensor samples.
+ */
+/** @} */
+/**
+ * @addtogroup app_dsp
+ */
+/** @{ */
+/**
+ * @file app_dsp.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Filter sensor samples in software after @ref app_sensor_get and before
+ * the data is encoded or logged. Sensors only support the DSP functions
+ * their hardware implements, this module allows using cheaper low-resolution
+ * sensor modes while still advertising smooth values.
+ *
+ * Each filtered field has a channel with a fixed-size state, no memory
+ * is allocated at runtime.
+ *
+ * Typical usage:
+ * @code{.c}
+ * app_dsp_config_t cfg =
+ * {
+ *     .filter = APP_DSP_FILTER_MEDIAN,
+ *     .parameter = 5,
+ *     .outlier_limit = 2.0F
+ * };
+ * err_code |= app_dsp_configure (RD_SENSOR_TEMP_FIELD, &cfg);
+ * err_code |= app_sensor_get (&data); // Calls app_dsp_process internally.
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <stdint.h>
+
+/** @brief Maximum number of samples in moving average and median windows. */
+#ifndef APP_DSP_WINDOW_MAX
+#   define APP_DSP_WINDOW_MAX (8U)
+#endif
+
+/** @brief Maximum number of consecutive outliers rejected before accepting new level. */
+#ifndef APP_DSP_OUTLIER_MAX_REJECTS
+#   define APP_DSP_OUTLIER_MAX_REJECTS (3U)
+#endif
+
+/** @brief Filter applied to a field. */
+typedef enum
+{
+    APP_DSP_FILTER_NONE = 0,   //!< Pass sample through, outlier rejection still applies.
+    APP_DSP_FILTER_MOVING_AVG, //!< Mean of last parameter samples.
+    APP_DSP_FILTER_IIR_LOW_PASS, //!< y += (x - y) / parameter.
+    APP_DSP_FILTER_MEDIAN      //!< Median of last parameter samples.
+} app_dsp_filter_t;
+
+/** @brief Configuration of a single filtered field. */
+typedef struct
+{
+    app_dsp_filter_t filter; //!< Filter to apply.
+    uint8_t parameter;       //!< Window length or IIR divisor, 1 is pass-through.
+    float outlier_limit;     //!< Max absolute step from filtered value, 0 to disable.
+} app_dsp_config_t;
+
+/** @brief Fixed-size state of a single filtered field. */
+typedef struct
+{
+    float window[APP_DSP_WINDOW_MAX]; //!< Latest accepted samples.
+    float estimate;                   //!< Latest filter output.
+    uint8_t head;                     //!< Next slot to write in window.
+    uint8_t count;                    //!< Number of valid samples in window.
+    uint8_t rejections;               //!< Consecutive rejected outliers.
+} app_dsp_state_t;
+
+/**
+ * @brief Run one sample through a filter.
+ *
+ * Invalid (NaN) samples are returned as-is and do not modify the state.
+ *
+ * @param[in,out] state State of the filter. Zero-initialize before first sample.
+ * @param[in] config Filter configuration.
+ * @param[in] sample New sample.
+ * @return Filtered value.
+ */
+float app_dsp_filter (app_dsp_state_t * const state,
+                      const app_dsp_config_t * const config,
+                      const float sample);
+
+/**
+ * @brief Set filter for a field.
+ *
+ * Resets the state of the field.
+ *
+ * @param[in] field Field to filter, exactly one bit set.
+ * @param[in] config Configuration of filter.
+ *
+ * @retval RD_SUCCESS Filter was configured.
+ * @retval RD_ERROR_NULL Config was NULL.
+ * @retval RD_ERROR_INVALID_PARAM Parameter is 0 or larger than APP_DSP_WINDOW_MAX
+ *                                on windowed filter.
+ * @retval RD_ERROR_NOT_FOUND Field has no DSP channel.
+ */
+rd_status_t app_dsp_configure (const rd_sensor_data_bitfield_t field,
+                               const app_dsp_config_t * const config);
+
+/**
+ * @brief Filter all configured fields of data in place.
+ *
+ * @param[in,out] data Sensor data read by @ref app_sensor_get.
+ */
+void app_dsp_process (rd_sensor_data_t * const data);
+
+/**
+ * @brief Clear the state of all channels, keep configuration.
+ */
+void app_dsp_reset (void);
+
+/** @} */
+#endif // APP_DSP_H
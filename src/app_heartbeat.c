@@ -9,9 +9,17 @@
 #include "app_comms.h"
 #include "app_dataformats.h"
 #include "app_heartbeat.h"
+#include "app_jitter.h"
 #include "app_led.h"
 #include "app_log.h"
+#include "app_motion.h"
+#include "app_oversample.h"
+#include "app_profile.h"
+#include "app_radio.h"
 #include "app_sensor.h"
+#include "app_tasks.h"
+#include "app_testing.h"
+#include "app_vibration.h"
 #include "ruuvi_driver_error.h"
 #include "ruuvi_driver_sensor.h"
 #include "ruuvi_endpoint_5.h"
@@ -27,6 +35,9 @@
 #include "ruuvi_task_advertisement.h"
 #include "ruuvi_task_gatt.h"
 #include "ruuvi_task_nfc.h"
+
+#include <math.h>
+#include <string.h>
 #if DEBUG
 #include "ruuvi_interface_log.h"
 #include "ruuvi_driver_sensor_test.h"
@@ -37,12 +48,20 @@ static inline void LOG (const char * const msg)
 #endif
 
 #define U8_MASK (0xFFU)
+#if ((APP_HEARTBEAT_INTERVAL_MAX_MS + APP_HEARTBEAT_JITTER_MAX_MS) \
+    >= APP_HEARTBEAT_OVERDUE_INTERVAL_MS)
+#   error "Adaptive heartbeat interval would trigger overdue heartbeat."
+#endif
+#if APP_OVERSAMPLE_ENABLED && (APP_OVERSAMPLE_COUNT < 2U)
+#   error "Oversampling needs at least 2 reads per heartbeat."
+#endif
 #define APP_DF_3_ENABLED  RE_3_ENABLED
 #define APP_DF_5_ENABLED  RE_5_ENABLED
 #define APP_DF_7_ENABLED  RE_7_ENABLED
 #define APP_DF_8_ENABLED  RE_8_ENABLED
 #define APP_DF_C5_ENABLED RE_C5_ENABLED
 #define APP_DF_FA_ENABLED RE_FA_ENABLED
+#define HEARTBEAT_FORMAT_COUNT (8U) //!< Number of formats in app_dataformat_t.
 
 static ri_timer_id_t heart_timer; //!< Timer for updating data.
 
@@ -50,6 +69,46 @@ static uint64_t last_heartbeat_timestamp_ms; //!< Timestamp for heartbeat refres
 
 static app_dataformat_t m_dataformat_state; //!< State of heartbeat.
 
+static uint32_t m_heartbeat_interval_ms = APP_HEARTBEAT_INTERVAL_MS; //!< Interval now.
+
+/** @brief Data format encoded from latest measurement. */
+typedef struct
+{
+    uint8_t data[RI_COMM_MESSAGE_MAX_LENGTH]; //!< Encoded payload.
+    uint8_t length;                           //!< Length of payload.
+} heartbeat_payload_t;
+
+static heartbeat_payload_t m_payloads[HEARTBEAT_FORMAT_COUNT]; //!< Indexed by format bit.
+static uint32_t m_payloads_fingerprint; //!< Fingerprint of encoded measurement.
+static bool m_payloads_valid;           //!< Payloads are encoded.
+static uint64_t m_last_encode_ms;       //!< Time of latest encode.
+static uint64_t m_last_transmit_ms;     //!< Time of latest radio update.
+static uint64_t m_last_nfc_ms;          //!< Time of latest NFC update.
+static bool m_live;                     //!< Heartbeat runs at live rate.
+static uint32_t m_idle_interval_ms = APP_HEARTBEAT_INTERVAL_MS; //!< Restored after live.
+static bool m_payloads_changed;         //!< Payloads changed since last transmit.
+static bool m_sample_fresh;             //!< Sample taken since watchdog was fed.
+#if DEBUG && APP_PROFILE_ENABLED
+static uint32_t m_profile_heartbeats;   //!< Heartbeats since profile was printed.
+#endif
+#if APP_HEARTBEAT_JITTER_MAX_MS
+static uint64_t m_heartbeat_nominal_ms; //!< Time of next heartbeat without jitter.
+#endif
+
+#if APP_HEARTBEAT_ADAPTIVE_ENABLED || defined(CEEDLING)
+/** @brief State of adaptive heartbeat interval. */
+typedef struct
+{
+    float temperature_c;  //!< Reference temperature for change detection.
+    float humidity_rh;    //!< Reference humidity for change detection.
+    float pressure_pa;    //!< Reference pressure for change detection.
+    uint32_t event_count; //!< Motion events seen at previous heartbeat.
+    uint8_t stable_count; //!< Consecutive heartbeats without change.
+} adaptive_state_t;
+
+static adaptive_state_t m_adaptive = { NAN, NAN, NAN, 0, 0 };
+#endif
+
 static const app_dataformats_t m_dataformats_enabled =
 {
     .formats =
@@ -59,16 +118,45 @@ static const app_dataformats_t m_dataformats_enabled =
     + (APP_DF_8_ENABLED  ? DF_8  : 0)
     + (APP_DF_C5_ENABLED ? DF_C5 : 0)
     + (APP_DF_FA_ENABLED ? DF_FA : 0)
+    + (APP_DF_HISTORY_ENABLED ? DF_HISTORY : 0)
+    + (APP_DF_EXT_ENABLED ? DF_EXT : 0)
 };
 
+/**
+ * @brief Scale advertisement repeats to cover the current heartbeat interval.
+ *
+ * Repeat count is configured for APP_HEARTBEAT_INTERVAL_MS, the same data
+ * must be repeated more times when the interval is longer to avoid gaps
+ * in advertising.
+ */
+static uint8_t adv_repeats_scale (const uint8_t repeat_count)
+{
+    const uint32_t ratio = m_heartbeat_interval_ms / APP_HEARTBEAT_INTERVAL_MS;
+    uint32_t scaled = repeat_count;
+
+    if ( (APP_COMM_ADV_REPEAT_FOREVER != repeat_count) && (1U < ratio))
+    {
+        scaled *= ratio;
+
+        if (APP_COMM_ADV_REPEAT_FOREVER <= scaled)
+        {
+            scaled = APP_COMM_ADV_REPEAT_FOREVER - 1U;
+        }
+    }
+
+    return (uint8_t) (scaled & U8_MASK);
+}
+
 static rd_status_t send_adv (ri_comm_message_t * const p_msg)
 {
     rd_status_t err_code = RD_SUCCESS;
-    const uint8_t repeat_count = app_comms_bleadv_send_count_get();
+    const uint8_t repeat_count = adv_repeats_scale (app_comms_bleadv_send_count_get());
 
     if (APP_COMM_ADV_DISABLE != repeat_count)
     {
-        if (APP_COMM_ADV_REPEAT_FOREVER == repeat_count)
+        // Changed data replaces advertisement, repeat until then.
+        if ( (APP_COMM_ADV_REPEAT_FOREVER == repeat_count)
+                || APP_HEARTBEAT_CHANGE_DETECTION_ENABLED)
         {
             p_msg->repeat_count = RI_COMM_MSG_REPEAT_FOREVER;
         }
@@ -87,31 +175,340 @@ static rd_status_t send_adv (ri_comm_message_t * const p_msg)
     return err_code;
 }
 
+TESTABLE_STATIC void heartbeat_sample_task (void * p_event, uint16_t event_size);
+
 /**
- * @brief When timer triggers, schedule reading sensors and sending data.
+ * @brief Start next heartbeat period of given length.
  *
- * @param[in] p_context Always NULL.
+ * Timer must be stopped before restarting to apply the new interval.
  */
-#ifndef CEEDLING
-static
+static rd_status_t heart_period_start (const uint32_t period_ms)
+{
+    rd_status_t err_code = RD_SUCCESS;
+#if APP_TASKS_ENABLED
+    err_code |= app_tasks_period_set (&heartbeat_sample_task, period_ms);
+#else
+
+    if (NULL != heart_timer)
+    {
+        err_code |= ri_timer_stop (heart_timer);
+        err_code |= ri_timer_start (heart_timer, period_ms, NULL);
+    }
+
 #endif
-void heartbeat (void * p_event, uint16_t event_size)
+    return err_code;
+}
+
+/**
+ * @brief Restart heartbeat timer at given interval.
+ */
+static rd_status_t heart_timer_restart (const uint32_t interval_ms)
+{
+    m_heartbeat_interval_ms = interval_ms;
+    return heart_period_start (m_heartbeat_interval_ms);
+}
+
+#if APP_HEARTBEAT_JITTER_MAX_MS
+/**
+ * @brief Delay next heartbeat randomly to not stay in phase with other tags.
+ *
+ * Heartbeat interval is not changed, next period is restarted with jitter.
+ * Jitter is added to nominal schedule, so it does not accumulate and time
+ * spent in heartbeat does not lengthen the period.
+ */
+static void heartbeat_phase_jitter (void)
+{
+    const uint64_t now_ms = ri_rtc_millis();
+    const uint32_t jitter_ms = app_jitter_random_ms (APP_HEARTBEAT_JITTER_MAX_MS);
+    uint64_t next_ms = m_heartbeat_nominal_ms + m_heartbeat_interval_ms;
+
+    // Start schedule over on first heartbeat or if it was lost.
+    if ( (next_ms <= now_ms) || (next_ms > (now_ms + m_heartbeat_interval_ms)))
+    {
+        next_ms = now_ms + m_heartbeat_interval_ms;
+    }
+
+    m_heartbeat_nominal_ms = next_ms;
+    const uint32_t period_ms = (uint32_t) (next_ms - now_ms) + jitter_ms;
+    rd_status_t err_code = heart_period_start (period_ms);
+    RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+}
+#endif
+
+#if APP_HEARTBEAT_ADAPTIVE_ENABLED || defined(CEEDLING)
+static bool value_changed (float * const reference, const float value,
+                           const float threshold)
+{
+    bool changed = false;
+
+    if (isnan (value))
+    {
+        // Missing data is not a change.
+    }
+    else if (isnan (*reference) || (fabsf (value - *reference) > threshold))
+    {
+        *reference = value;
+        changed = true;
+    }
+    else
+    {
+        // Stable.
+    }
+
+    return changed;
+}
+
+/**
+ * @brief Check if environmental readings have changed since last change.
+ *
+ * @param[in] p_data Latest sensor data.
+ * @return True if any of temperature, humidity or pressure has moved more
+ *         than configured threshold from its reference.
+ */
+TESTABLE_STATIC bool adaptive_data_changed (const rd_sensor_data_t * const p_data)
+{
+    bool changed = false;
+    changed |= value_changed (&m_adaptive.temperature_c,
+                              rd_sensor_data_parse (p_data, RD_SENSOR_TEMP_FIELD),
+                              APP_HEARTBEAT_ADAPTIVE_TEMPERATURE_DELTA);
+    changed |= value_changed (&m_adaptive.humidity_rh,
+                              rd_sensor_data_parse (p_data, RD_SENSOR_HUMI_FIELD),
+                              APP_HEARTBEAT_ADAPTIVE_HUMIDITY_DELTA);
+    changed |= value_changed (&m_adaptive.pressure_pa,
+                              rd_sensor_data_parse (p_data, RD_SENSOR_PRES_FIELD),
+                              APP_HEARTBEAT_ADAPTIVE_PRESSURE_DELTA);
+    return changed;
+}
+
+/**
+ * @brief Calculate next heartbeat interval.
+ *
+ * Interval is doubled after APP_HEARTBEAT_ADAPTIVE_STABLE_COUNT heartbeats
+ * without activity up to APP_HEARTBEAT_INTERVAL_MAX_MS, and returns to
+ * APP_HEARTBEAT_INTERVAL_MIN_MS on activity.
+ *
+ * @param[in] interval_ms Current interval.
+ * @param[in] activity True if data changed or motion was detected.
+ * @return Next interval.
+ */
+TESTABLE_STATIC uint32_t adaptive_interval_next (const uint32_t interval_ms,
+        const bool activity)
+{
+    uint32_t next = interval_ms;
+
+    if (activity)
+    {
+        m_adaptive.stable_count = 0;
+        next = APP_HEARTBEAT_INTERVAL_MIN_MS;
+    }
+    else if (++m_adaptive.stable_count >= APP_HEARTBEAT_ADAPTIVE_STABLE_COUNT)
+    {
+        m_adaptive.stable_count = 0;
+        next = interval_ms * 2U;
+
+        if (next > APP_HEARTBEAT_INTERVAL_MAX_MS)
+        {
+            next = APP_HEARTBEAT_INTERVAL_MAX_MS;
+        }
+    }
+    else
+    {
+        // Keep current interval.
+    }
+
+    return next;
+}
+
+/**
+ * @brief Snap back to fast heartbeat on activity reported from interrupt.
+ */
+TESTABLE_STATIC void adaptive_activity_handler (void * p_event, uint16_t event_size)
+{
+    const uint32_t next = adaptive_interval_next (m_heartbeat_interval_ms, true);
+
+    // Live rate is kept until client disconnects.
+    if ( (next != m_heartbeat_interval_ms) && (!m_live))
+    {
+        rd_status_t err_code = heart_timer_restart (next);
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    }
+}
+#endif
+
+#if APP_HEARTBEAT_ADAPTIVE_ENABLED
+static void adaptive_update (const rd_sensor_data_t * const p_data)
+{
+    const uint32_t event_count = app_sensor_event_count_get();
+    bool activity = adaptive_data_changed (p_data);
+    activity |= (event_count != m_adaptive.event_count);
+    m_adaptive.event_count = event_count;
+    const uint32_t next = adaptive_interval_next (m_heartbeat_interval_ms, activity);
+
+    if ( (next != m_heartbeat_interval_ms) && (!m_live))
+    {
+        rd_status_t err_code = heart_timer_restart (next);
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    }
+}
+#endif
+
+/**
+ * @brief Read sensors into data.
+ *
+ * @param[in,out] p_data Data with fields and value storage set up.
+ * @param[in] value_count Number of values in p_data.
+ */
+static void heartbeat_measure (rd_sensor_data_t * const p_data, const size_t value_count)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    // Values of fields which are not read must not change fingerprint.
+    for (size_t ii = 0; ii < value_count; ii++)
+    {
+        p_data->data[ii] = RD_FLOAT_INVALID;
+    }
+
+#if APP_VIBRATION_ENABLED
+    // Drain accelerometer FIFO before sensor read pops a sample from it.
+    err_code |= app_vibration_sample();
+#endif
+#if APP_OVERSAMPLE_ENABLED
+    // Gated sensors are powered once for the whole burst of reads. Reads are raw,
+    // filters and calibration run once on the mean as on a single read.
+    err_code |= app_sensor_power_hold();
+
+    for (size_t ii = 1U; ii < APP_OVERSAMPLE_COUNT; ii++)
+    {
+        err_code |= app_oversample_sample();
+    }
+
+    err_code |= app_sensor_trigger (p_data->fields);
+    err_code |= app_sensor_get_raw (p_data);
+    app_sensor_power_release();
+    app_oversample_apply (p_data);
+    app_sensor_process (p_data);
+#else
+    err_code |= app_sensor_get (p_data);
+#endif
+#if APP_MOTION_ENABLED
+    // Period of classification is one heartbeat, not one sensor read.
+    app_motion_process (p_data);
+#endif
+    RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+}
+
+/**
+ * @brief Encode measurement into all enabled data formats.
+ *
+ * Snapshot and all formats are encoded only if some input of the encoders has
+ * changed since previous measurement, payloads of previous measurement are
+ * kept otherwise. Unchanged data is re-encoded every
+ * APP_HEARTBEAT_UNCHANGED_REFRESH_MS, so sequence counters advance only then.
+ *
+ * @param[in] p_data Measured data.
+ * @param[in] value_count Number of values in p_data.
+ * @retval true if payloads were encoded.
+ * @retval false if payloads of previous measurement are still valid.
+ */
+static bool heartbeat_encode (const rd_sensor_data_t * const p_data,
+                              const size_t value_count)
+{
+    const uint32_t fingerprint = app_dataformat_fingerprint (p_data, value_count);
+    const uint64_t now_ms = ri_rtc_millis();
+    const uint64_t elapsed_ms = now_ms - m_last_encode_ms;
+    const bool changed = (!m_payloads_valid) || (fingerprint != m_payloads_fingerprint)
+                         || (elapsed_ms >= APP_HEARTBEAT_UNCHANGED_REFRESH_MS);
+    const unsigned int formats = m_dataformats_enabled.formats;
+
+    if (changed)
+    {
+        app_dataformat_snapshot_t snapshot;
+        rd_status_t err_code = app_dataformat_snapshot_fill (&snapshot, p_data);
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+
+        for (size_t ii = 0; ii < HEARTBEAT_FORMAT_COUNT; ii++)
+        {
+            const app_dataformat_t format = (app_dataformat_t) (1U << ii);
+
+            if (0U != (format & formats))
+            {
+                size_t length = sizeof (m_payloads[ii].data);
+                err_code = app_dataformat_encode (m_payloads[ii].data, &length,
+                                                  &snapshot, format);
+                RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+                // Failed payload is left empty and skipped by transmit.
+                m_payloads[ii].length = (RD_SUCCESS == err_code) ? (uint8_t) length : 0U;
+            }
+        }
+
+        m_last_encode_ms = now_ms;
+    }
+
+    m_payloads_fingerprint = fingerprint;
+    m_payloads_valid = true;
+    return changed;
+}
+
+/**
+ * @brief Check if radio should be updated.
+ *
+ * @param[in] changed True if payloads were encoded from changed data.
+ * @param[in] now_ms Current time.
+ * @retval true if data changed or refresh interval has elapsed.
+ * @retval false if radio should keep sending previous data.
+ */
+TESTABLE_STATIC bool transmit_due (const bool changed, const uint64_t now_ms)
+{
+    const uint64_t elapsed_ms = now_ms - m_last_transmit_ms;
+    const bool due = changed || (elapsed_ms >= APP_HEARTBEAT_UNCHANGED_REFRESH_MS);
+
+    if (due)
+    {
+        m_last_transmit_ms = now_ms;
+    }
+
+    return due;
+}
+
+/**
+ * @brief Check if NFC should be updated.
+ *
+ * Reader gets fresh data while it is in field. Otherwise data is refreshed
+ * at APP_HEARTBEAT_NFC_IDLE_INTERVAL_MS to have recent data for next reader.
+ *
+ * @param[in] reader True if NFC reader is in field.
+ * @param[in] now_ms Current time.
+ * @retval true if NFC data should be updated.
+ */
+TESTABLE_STATIC bool nfc_due (const bool reader, const uint64_t now_ms)
+{
+    const uint64_t elapsed_ms = now_ms - m_last_nfc_ms;
+    const bool due = reader || (0U == m_last_nfc_ms)
+                     || (elapsed_ms >= APP_HEARTBEAT_NFC_IDLE_INTERVAL_MS);
+
+    if (due)
+    {
+        m_last_nfc_ms = now_ms;
+    }
+
+    return due;
+}
+
+/**
+ * @brief Send a payload over advertisements, GATT and NFC.
+ *
+ * @param[in] p_msg Payload to send, length is cut for GATT.
+ * @retval true if data was sent by any means.
+ * @retval false if data could not be sent.
+ */
+static bool heartbeat_payload_send (ri_comm_message_t * const p_msg)
 {
-    ri_comm_message_t msg = {0};
     rd_status_t err_code = RD_SUCCESS;
     bool heartbeat_ok = false;
-    rd_sensor_data_t data = { 0 };
-    size_t buffer_len = RI_COMM_MESSAGE_MAX_LENGTH;
-    data.fields = app_sensor_available_data();
-    float data_values[rd_sensor_data_fieldcount (&data)];
-    data.data = data_values;
-    app_sensor_get (&data);
-    // Sensor read takes a long while, indicate activity once data is read.
-    app_led_activity_signal (true);
-    m_dataformat_state = app_dataformat_next (m_dataformats_enabled, m_dataformat_state);
-    app_dataformat_encode (msg.data, &buffer_len, &data, m_dataformat_state);
-    msg.data_length = (uint8_t) buffer_len;
-    err_code = send_adv (&msg);
+    const uint8_t payload_length = p_msg->data_length;
+    uint32_t profile_start = app_profile_start();
+    err_code = send_adv (p_msg);
+    app_profile_stop (APP_PROFILE_ADV_UPDATE, profile_start);
     // Advertising should always be successful
     RD_ERROR_CHECK (err_code, RD_SUCCESS);
 
@@ -120,32 +517,144 @@ void heartbeat (void * p_event, uint16_t event_size)
         heartbeat_ok = true;
     }
 
-    // Cut endpoint data to fit into GATT msg.
-    msg.data_length = 18;
-    // Gatt Link layer takes care of delivery.
-    msg.repeat_count = 1;
-    err_code = rt_gatt_send_asynchronous (&msg);
+#if APP_HEARTBEAT_SUBSCRIBED_ONLY_ENABLED
+    const bool gatt_send = app_comms_gatt_subscribed();
+    const bool nfc_send = nfc_due (app_comms_nfc_connected(), ri_rtc_millis());
+#else
+    const bool gatt_send = true;
+    const bool nfc_send = true;
+#endif
+    profile_start = app_profile_start();
 
-    if (RD_SUCCESS == err_code)
+    if (gatt_send)
     {
-        heartbeat_ok = true;
+        // Cut endpoint data to fit into GATT msg.
+        p_msg->data_length = 18;
+        // Gatt Link layer takes care of delivery.
+        p_msg->repeat_count = 1;
+        err_code = rt_gatt_send_asynchronous (p_msg);
+
+        if (RD_SUCCESS == err_code)
+        {
+            heartbeat_ok = true;
+        }
+    }
+
+    if (nfc_send)
+    {
+        // Restore original message length for NFC
+        p_msg->data_length = payload_length;
+        err_code = rt_nfc_send (p_msg);
+
+        if (RD_SUCCESS == err_code)
+        {
+            heartbeat_ok = true;
+        }
     }
 
-    // Restore original message length for NFC
-    msg.data_length = (uint8_t) buffer_len;
-    err_code = rt_nfc_send (&msg);
+    app_profile_stop (APP_PROFILE_GATT_NFC_SEND, profile_start);
+    return heartbeat_ok;
+}
 
-    if (RD_SUCCESS == err_code)
+/**
+ * @brief Send next data format from encoded payloads.
+ *
+ * Formats whose encoding failed have an empty payload and are skipped in
+ * rotation rather than sent empty.
+ *
+ * @retval true if data was sent by any means.
+ * @retval false if data could not be sent or no payload is encoded.
+ */
+static bool heartbeat_transmit (void)
+{
+    ri_comm_message_t msg = {0};
+    bool heartbeat_ok = false;
+    app_dataformats_t sendable = m_dataformats_enabled;
+
+    for (size_t ii = 0; ii < HEARTBEAT_FORMAT_COUNT; ii++)
     {
-        heartbeat_ok = true;
+        if (0U == m_payloads[ii].length)
+        {
+            sendable.formats &= ~ (1U << ii);
+        }
     }
 
-    if (heartbeat_ok)
+    m_dataformat_state = app_dataformat_next (sendable, m_dataformat_state);
+
+    for (size_t ii = 0; ii < HEARTBEAT_FORMAT_COUNT; ii++)
+    {
+        if ( (1U << ii) == (uint32_t) m_dataformat_state)
+        {
+            memcpy (msg.data, m_payloads[ii].data, m_payloads[ii].length);
+            msg.data_length = m_payloads[ii].length;
+        }
+    }
+
+    if (0U < msg.data_length)
+    {
+        heartbeat_ok = heartbeat_payload_send (&msg);
+    }
+
+    return heartbeat_ok;
+}
+
+/**
+ * @brief Transmit encoded payloads and feed watchdog if successful.
+ *
+ * @param[in] changed True if payloads have changed since previous transmit.
+ * @param[in] fresh True if payloads are from a sample not yet transmitted.
+ *                  Watchdog is fed only for fresh samples so that a stuck
+ *                  sensor read can't be hidden by resending old data.
+ * @retval true if transmit was successful or not due.
+ * @retval false if transmit failed.
+ */
+static bool heartbeat_advertise (const bool changed, const bool fresh)
+{
+#if APP_HEARTBEAT_CHANGE_DETECTION_ENABLED
+    // Previous data is still on air if it is not due for an update.
+    const bool heartbeat_ok = transmit_due (changed, ri_rtc_millis()) ?
+                              heartbeat_transmit() : true;
+#else
+    (void) changed;
+    const bool heartbeat_ok = heartbeat_transmit();
+#endif
+
+    if (heartbeat_ok && fresh)
     {
         ri_watchdog_feed();
         last_heartbeat_timestamp_ms = ri_rtc_millis();
     }
 
+    return heartbeat_ok;
+}
+
+/**
+ * @brief Measure, encode and transmit data.
+ *
+ * One measurement is encoded into all enabled data formats and formats
+ * are sent in turns from the encoded payloads. With APP_TASKS_ENABLED
+ * payloads are sent by advertise task instead.
+ *
+ * @param[in] p_event Unused.
+ * @param[in] event_size Unused.
+ */
+#ifndef CEEDLING
+static
+#endif
+void heartbeat (void * p_event, uint16_t event_size)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    const uint32_t heartbeat_start = app_profile_start();
+    rd_sensor_data_t data = { 0 };
+    data.fields = app_sensor_available_data();
+    const size_t value_count = rd_sensor_data_fieldcount (&data);
+    float data_values[value_count];
+    data.data = data_values;
+    uint32_t profile_start = app_profile_start();
+    heartbeat_measure (&data, value_count);
+    app_profile_stop (APP_PROFILE_SENSOR_READ, profile_start);
+    // Sensor read takes a long while, indicate activity once data is read.
+    app_led_activity_signal (true);
 #if DEBUG
     // PoC - LED indication of presence / motion
     app_led_motion_signal (rd_sensor_data_parse (&data, RD_SENSOR_MOTION_FIELD) > 0.0f);
@@ -154,8 +663,37 @@ void heartbeat (void * p_event, uint16_t event_size)
 #endif
     // Turn LED off before starting lengthy flash operations
     app_led_activity_signal (false);
+    // Log first so that history format has this sample as its newest one.
+    profile_start = app_profile_start();
     err_code = app_log_process (&data);
+    app_profile_stop (APP_PROFILE_LOG_PROCESS, profile_start);
     RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    profile_start = app_profile_start();
+    const bool changed = heartbeat_encode (&data, value_count);
+    app_profile_stop (APP_PROFILE_ENCODE, profile_start);
+    m_sample_fresh = true;
+#if APP_TASKS_ENABLED
+    // Advertise task sends the payloads at its own rate.
+    m_payloads_changed |= changed;
+#else
+    (void) heartbeat_advertise (changed, true);
+#endif
+#if APP_HEARTBEAT_ADAPTIVE_ENABLED
+    adaptive_update (&data);
+#endif
+#if APP_HEARTBEAT_JITTER_MAX_MS
+    heartbeat_phase_jitter();
+#endif
+    app_profile_stop (APP_PROFILE_HEARTBEAT, heartbeat_start);
+#if DEBUG && APP_PROFILE_ENABLED
+
+    if (APP_PROFILE_PRINT_INTERVAL <= ++m_profile_heartbeats)
+    {
+        m_profile_heartbeats = 0;
+        app_profile_print (&LOG);
+    }
+
+#endif
 }
 
 /**
@@ -168,9 +706,41 @@ static
 #endif
 void schedule_heartbeat_isr (void * const p_context)
 {
+#if APP_RADIO_SYNC_ENABLED
+    // Read sensors and write flash while radio is idle.
+    app_radio_idle_run (&heartbeat);
+#else
     ri_scheduler_event_put (NULL, 0U, &heartbeat);
+#endif
+}
+
+/**
+ * @brief Periodic task of sampling sensors.
+ */
+TESTABLE_STATIC void heartbeat_sample_task (void * p_event, uint16_t event_size)
+{
+    schedule_heartbeat_isr (NULL);
 }
 
+#if APP_TASKS_ENABLED || defined(CEEDLING)
+/**
+ * @brief Periodic task of sending latest encoded data.
+ */
+TESTABLE_STATIC void heartbeat_advertise_task (void * p_event, uint16_t event_size)
+{
+    // Nothing to send before first measurement.
+    if (m_payloads_valid)
+    {
+        if (heartbeat_advertise (m_payloads_changed, m_sample_fresh))
+        {
+            m_sample_fresh = false;
+        }
+
+        m_payloads_changed = false;
+    }
+}
+#endif
+
 rd_status_t app_heartbeat_init (void)
 {
     rd_status_t err_code = RD_SUCCESS;
@@ -181,13 +751,30 @@ rd_status_t app_heartbeat_init (void)
     }
     else
     {
+        // Keys are derived once instead of on every encode.
+        err_code |= app_dataformat_crypto_init();
+        err_code |= app_dataformat_weights_init();
+#if APP_HEARTBEAT_JITTER_MAX_MS
+        uint64_t address = 0;
+        // Seed is unique to device, jitter of co-located tags differs.
+        (void) ri_radio_address_get (&address);
+        app_jitter_seed (address);
+#endif
+#if APP_TASKS_ENABLED
+        // Sample first to advertise fresh data when periods align.
+        err_code |= app_tasks_add (&heartbeat_sample_task, m_heartbeat_interval_ms);
+        err_code |= app_tasks_add (&heartbeat_advertise_task,
+                                   APP_TASKS_ADVERTISE_INTERVAL_MS);
+#else
         err_code |= ri_timer_create (&heart_timer, RI_TIMER_MODE_REPEATED,
                                      &schedule_heartbeat_isr);
 
         if (RD_SUCCESS == err_code)
         {
-            err_code |= ri_timer_start (heart_timer, APP_HEARTBEAT_INTERVAL_MS, NULL);
+            err_code |= ri_timer_start (heart_timer, m_heartbeat_interval_ms, NULL);
         }
+
+#endif
     }
 
     return err_code;
@@ -196,6 +783,11 @@ rd_status_t app_heartbeat_init (void)
 rd_status_t app_heartbeat_start (void)
 {
     rd_status_t err_code = RD_SUCCESS;
+#if APP_TASKS_ENABLED
+    app_heartbeat_payloads_invalidate();
+    // Runs all tasks now.
+    err_code |= app_tasks_start();
+#else
 
     if (NULL == heart_timer)
     {
@@ -203,16 +795,21 @@ rd_status_t app_heartbeat_start (void)
     }
     else
     {
+        app_heartbeat_payloads_invalidate();
         heartbeat (NULL, 0);
-        err_code |= ri_timer_start (heart_timer, APP_HEARTBEAT_INTERVAL_MS, NULL);
+        err_code |= ri_timer_start (heart_timer, m_heartbeat_interval_ms, NULL);
     }
 
+#endif
     return err_code;
 }
 
 rd_status_t app_heartbeat_stop (void)
 {
     rd_status_t err_code = RD_SUCCESS;
+#if APP_TASKS_ENABLED
+    err_code |= app_tasks_stop();
+#else
 
     if (NULL == heart_timer)
     {
@@ -223,9 +820,55 @@ rd_status_t app_heartbeat_stop (void)
         err_code |= ri_timer_stop (heart_timer);
     }
 
+#endif
+    return err_code;
+}
+
+void app_heartbeat_activity_isr (void)
+{
+#if APP_HEARTBEAT_ADAPTIVE_ENABLED
+    ri_scheduler_event_put (NULL, 0U, &adaptive_activity_handler);
+#endif
+}
+
+void app_heartbeat_refresh_isr (void)
+{
+    if (ri_rtc_millis() > (last_heartbeat_timestamp_ms +
+                           APP_HEARTBEAT_REFRESH_INTERVAL_MIN_MS))
+    {
+        schedule_heartbeat_isr (NULL);
+    }
+}
+
+void app_heartbeat_payloads_invalidate (void)
+{
+    m_payloads_valid = false;
+}
+
+rd_status_t app_heartbeat_live_set (const bool live)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (live != m_live)
+    {
+        if (live)
+        {
+            m_idle_interval_ms = m_heartbeat_interval_ms;
+        }
+
+        m_live = live;
+        err_code |= heart_timer_restart (live ? APP_HEARTBEAT_LIVE_INTERVAL_MS :
+                                         m_idle_interval_ms);
+    }
+
     return err_code;
 }
 
+uint32_t app_heartbeat_interval_get (void)
+{
+    return m_heartbeat_interval_ms;
+}
+
 bool app_heartbeat_overdue (void)
 {
     return ri_rtc_millis() > (last_heartbeat_timestamp_ms +
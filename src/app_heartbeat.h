@@ -58,6 +58,54 @@ rd_status_t app_heartbeat_start (void);
  */
 rd_status_t app_heartbeat_stop (void);
 
+/**
+ * @brief Signal activity which should return heartbeat to the fast rate.
+ *
+ * Safe to call from interrupt context, the interval is updated in scheduler.
+ * Has no effect unless APP_HEARTBEAT_ADAPTIVE_ENABLED is set.
+ */
+void app_heartbeat_activity_isr (void);
+
+/**
+ * @brief Refresh advertised data without waiting for next heartbeat.
+ *
+ * Safe to call from interrupt context. Schedules a heartbeat unless
+ * previous heartbeat was less than APP_HEARTBEAT_REFRESH_INTERVAL_MIN_MS ago.
+ * Regular heartbeat interval is not changed.
+ */
+void app_heartbeat_refresh_isr (void);
+
+/**
+ * @brief Run heartbeat at live rate for connected client.
+ *
+ * Adaptive interval is not applied while live. Interval returns to the
+ * interval before live rate when live rate ends.
+ *
+ * @param[in] live True to run at APP_HEARTBEAT_LIVE_INTERVAL_MS.
+ * @retval RD_SUCCESS on success.
+ * @return Error code from timer on error.
+ */
+rd_status_t app_heartbeat_live_set (const bool live);
+
+/**
+ * @brief Encode all data formats on next heartbeat.
+ *
+ * Heartbeat skips encoding if no input of the data formats has changed, call
+ * this after changing something which is not an input, such as encryption
+ * keys.
+ */
+void app_heartbeat_payloads_invalidate (void);
+
+/**
+ * @brief Get current heartbeat interval.
+ *
+ * Interval is APP_HEARTBEAT_INTERVAL_MS unless adaptive heartbeat has
+ * lengthened it.
+ *
+ * @return Current heartbeat interval in milliseconds.
+ */
+uint32_t app_heartbeat_interval_get (void);
+
 /**
  * @brief Check if hearbeats have been paused for too long.
  *
@@ -71,6 +119,13 @@ bool app_heartbeat_overdue (void);
 ri_timer_id_t * get_heart_timer (void);
 void schedule_heartbeat_isr (void * const p_context);
 void heartbeat (void * p_event, uint16_t event_size);
+bool adaptive_data_changed (const rd_sensor_data_t * const p_data);
+uint32_t adaptive_interval_next (const uint32_t interval_ms, const bool activity);
+void adaptive_activity_handler (void * p_event, uint16_t event_size);
+bool transmit_due (const bool changed, const uint64_t now_ms);
+bool nfc_due (const bool reader, const uint64_t now_ms);
+void heartbeat_sample_task (void * p_event, uint16_t event_size);
+void heartbeat_advertise_task (void * p_event, uint16_t event_size);
 #endif
 
 #endif // APP_HEARTBEAT_H
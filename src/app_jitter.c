@@ -0,0 +1,81 @@
+/**
+ * @addtogroup app_jitter
+ */
+/** @{ */
+/**
+ * @file app_jitter.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Per-device offsets and random jitter of transmissions.
+ */
+#include "app_config.h"
+#include "app_jitter.h"
+
+#define U32_SHIFT (32U)
+
+static uint32_t m_state = 1U; //!< Xorshift state, never 0.
+
+/** @brief Avalanche bits of x, neighbouring addresses get unrelated offsets. */
+static uint32_t mix32 (uint32_t x)
+{
+    x ^= x >> 16U;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15U;
+    x *= 0x846CA68BU;
+    x ^= x >> 16U;
+    return x;
+}
+
+static uint32_t fold64 (const uint64_t value)
+{
+    return (uint32_t) value ^ (uint32_t) (value >> U32_SHIFT);
+}
+
+uint32_t app_jitter_offset_ms (const uint64_t address, const uint32_t max_ms)
+{
+    uint32_t offset_ms = 0U;
+
+    if (UINT32_MAX == max_ms)
+    {
+        offset_ms = mix32 (fold64 (address));
+    }
+    else
+    {
+        offset_ms = mix32 (fold64 (address)) % (max_ms + 1U);
+    }
+
+    return offset_ms;
+}
+
+void app_jitter_seed (const uint64_t seed)
+{
+    m_state = mix32 (fold64 (seed));
+
+    if (0U == m_state)
+    {
+        m_state = 1U;
+    }
+}
+
+uint32_t app_jitter_random_ms (const uint32_t max_ms)
+{
+    uint32_t jitter_ms = 0U;
+    m_state ^= m_state << 13U;
+    m_state ^= m_state >> 17U;
+    m_state ^= m_state << 5U;
+
+    if (UINT32_MAX == max_ms)
+    {
+        jitter_ms = m_state;
+    }
+    else
+    {
+        jitter_ms = m_state % (max_ms + 1U);
+    }
+
+    return jitter_ms;
+}
+
+/** @} */
@@ -0,0 +1,73 @@
+#ifndef APP_JITTER_H
+#define APP_JITTER_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_jitter Transmission jitter
+ * @brief Spread advertisements of co-located tags in time.
+ */
+/** @} */
+/**
+ * @addtogroup app_jitter
+ */
+/** @{ */
+/**
+ * @file app_jitter.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Tags built with the same configuration advertise at the same interval.
+ * Two tags whose advertising events overlap keep overlapping on every event,
+ * and a gateway loses packets of both in bursts.
+ *
+ * Advertising interval is offset per device by a value derived from radio
+ * address, so the events of two tags drift past each other instead of
+ * staying aligned. Heartbeat phase can additionally be jittered randomly,
+ * so updates of data do not stay aligned either.
+ *
+ * scripts/adv_collision_sim.py uses the same offset to estimate delivery
+ * ratio against tag density.
+ *
+ * Typical usage:
+ * @code{.c}
+ * uint64_t address = 0;
+ * err_code |= ri_radio_address_get (&address);
+ * app_jitter_seed (address);
+ * interval_ms += app_jitter_offset_ms (address, APP_ADV_INTERVAL_OFFSET_MAX_MS);
+ * delay_ms = app_jitter_random_ms (APP_HEARTBEAT_JITTER_MAX_MS);
+ * @endcode
+ */
+
+#include "app_config.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Deterministic per-device offset.
+ *
+ * @param[in] address Radio address of device.
+ * @param[in] max_ms Largest offset.
+ * @return Offset in range [0, max_ms], same for the same address.
+ */
+uint32_t app_jitter_offset_ms (const uint64_t address, const uint32_t max_ms);
+
+/**
+ * @brief Seed random jitter.
+ *
+ * @param[in] seed Seed unique to device, for example radio address.
+ */
+void app_jitter_seed (const uint64_t seed);
+
+/**
+ * @brief Random jitter.
+ *
+ * @param[in] max_ms Largest jitter.
+ * @return Pseudo-random jitter in range [0, max_ms].
+ */
+uint32_t app_jitter_random_ms (const uint32_t max_ms);
+
+/** @} */
+#endif // APP_JITTER_H
@@ -59,6 +59,47 @@ TESTABLE_STATIC app_log_config_t m_log_config;          //!< Configuration for l
 TESTABLE_STATIC uint64_t
 m_last_sample_ms;      //!< Timestamp of last processed sample.
 
+static app_log_element_t m_log_tail[APP_LOG_HISTORY_LENGTH]; //!< End of stored block.
+static size_t m_log_tail_count;                               //!< Samples in tail.
+static uint32_t m_log_sequence;                               //!< Samples logged.
+
+/*
+ * Store sequence of latest sample, so that it continues over reboots instead of
+ * repeating numbers which were already advertised.
+ */
+static rd_status_t store_sequence (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    err_code |= rt_flash_store (APP_FLASH_LOG_FILE, APP_FLASH_LOG_SEQUENCE_RECORD,
+                                &m_log_sequence, sizeof (m_log_sequence));
+
+    while (rt_flash_busy()) { ri_yield(); }
+
+    return err_code;
+}
+
+/*
+ * Continue sequence from the one stored with last block. Samples of input block
+ * were lost on reboot, skip over as many numbers as input block can hold.
+ */
+static rd_status_t seed_sequence (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint32_t sequence = 0U;
+    err_code |= rt_flash_load (APP_FLASH_LOG_FILE, APP_FLASH_LOG_SEQUENCE_RECORD,
+                               &sequence, sizeof (sequence));
+
+    if (RD_SUCCESS == err_code)
+    {
+        m_log_sequence = sequence + APP_LOG_MAX_SAMPLES;
+    }
+
+    // Sequence is stored again in case of another reboot before next block.
+    err_code &= ~RD_ERROR_NOT_FOUND;
+    err_code |= store_sequence();
+    return err_code;
+}
+
 
 /*
  * Store given log record to flash. Keeps track of slots via state variables.
@@ -68,6 +109,11 @@ static rd_status_t store_block (const app_log_record_t * const p_record)
     rd_status_t err_code = RD_SUCCESS;
     uint8_t num_tries = 0;
     static uint8_t record_idx = 0;
+    // History continues from end of stored block while input block refills.
+    m_log_tail_count = (p_record->num_samples < APP_LOG_HISTORY_LENGTH) ?
+                       p_record->num_samples : APP_LOG_HISTORY_LENGTH;
+    memcpy (m_log_tail, &p_record->storage[p_record->num_samples - m_log_tail_count],
+            m_log_tail_count * sizeof (app_log_element_t));
 
     do
     {
@@ -103,6 +149,7 @@ static rd_status_t store_block (const app_log_record_t * const p_record)
         // Increment the record to the slot that was successful
         record_idx += num_tries;
         record_idx = record_idx % APP_FLASH_LOG_DATA_RECORDS_NUM;
+        err_code |= store_sequence();
     }
 
     return err_code;
@@ -183,6 +230,11 @@ rd_status_t app_log_init (void)
         err_code |= purge_logs();
     }
 
+    if (RD_SUCCESS == err_code)
+    {
+        err_code |= seed_sequence();
+    }
+
     // Boot count used to be incremented here,
     // but as boot counter is not used line is omitted
     // err_code |= app_log_increment_boot_count();
@@ -210,7 +262,10 @@ rd_status_t app_log_process (const rd_sensor_data_t * const sample)
         };
 
         if (APP_LOG_MAX_SAMPLES > m_log_input_block.num_samples)
-        { m_log_input_block.storage[m_log_input_block.num_samples++] = element; }
+        {
+            m_log_input_block.storage[m_log_input_block.num_samples++] = element;
+            m_log_sequence++;
+        }
 
         if (m_log_input_block.num_samples >= APP_LOG_MAX_SAMPLES)
         {
@@ -385,6 +440,39 @@ rd_status_t app_log_config_get (app_log_config_t * const configuration)
     return err_code;
 }
 
+rd_status_t app_log_history_get (app_log_history_t * const p_history)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_history)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        size_t count = 0;
+        memset (p_history, 0, sizeof (app_log_history_t));
+
+        for (size_t ii = m_log_input_block.num_samples;
+                (ii > 0U) && (count < APP_LOG_HISTORY_LENGTH); ii--)
+        {
+            p_history->samples[count++] = m_log_input_block.storage[ii - 1U];
+        }
+
+        for (size_t ii = m_log_tail_count; (ii > 0U) && (count < APP_LOG_HISTORY_LENGTH);
+                ii--)
+        {
+            p_history->samples[count++] = m_log_tail[ii - 1U];
+        }
+
+        p_history->num_samples = count;
+        p_history->sequence = m_log_sequence;
+        p_history->interval_s = m_log_config.interval_s;
+    }
+
+    return err_code;
+}
+
 void app_log_purge_flash (void)
 {
     ri_flash_purge();
@@ -413,6 +501,11 @@ rd_status_t app_log_read (rd_sensor_data_t * const sample,                     /
     return RD_ERROR_NOT_FOUND;
 }
 
+rd_status_t app_log_history_get (app_log_history_t * const p_history)          // dummy
+{
+    return RD_ERROR_NOT_SUPPORTED;
+}
+
 void app_log_purge_flash (void)                                                 // dummy
 {
     return;
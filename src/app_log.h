@@ -56,6 +56,15 @@ typedef struct
 } app_log_read_state_t; //!< Log read state.
 
 #define APP_LOG_MAX_SAMPLES (STORAGE_BLOCK_SIZE/sizeof(app_log_element_t))
+#define APP_LOG_HISTORY_LENGTH (4U) //!< Latest samples kept for advertising.
+
+typedef struct
+{
+    uint32_t sequence;    //!< Number of newest sample, continues over reboots.
+    uint16_t interval_s;  //!< Interval of logged samples.
+    size_t num_samples;   //!< Number of samples in history.
+    app_log_element_t samples[APP_LOG_HISTORY_LENGTH]; //!< Newest first.
+} app_log_history_t; //!< Latest logged samples.
 
 typedef struct
 {
@@ -72,6 +81,8 @@ typedef struct
  * After initialization flash driver is ready to store data.
  * If there is a logging configuration stored to flash, stored configuration is used.
  * If not, default configuration is used and stored to flash.
+ * Sample sequence continues from the one stored with last block written to flash,
+ * skipping over samples which were in RAM buffer at reboot.
  *
  * @retval RD_SUCCESS if logging was initialized or if logging is disabled in config.
  */
@@ -112,6 +123,21 @@ rd_status_t app_log_process (const rd_sensor_data_t * const sample);
 rd_status_t app_log_read (rd_sensor_data_t * const sample,
                           app_log_read_state_t * const p_read_state);
 
+/**
+ * @brief Get latest logged samples.
+ *
+ * Samples are taken from RAM buffer of log, samples of a buffer which was
+ * just written to flash are kept too. Flash is not read.
+ *
+ * @param[out] p_history Latest samples, newest first.
+ *
+ * @retval RD_SUCCESS on success, history may have less than
+ *                    APP_LOG_HISTORY_LENGTH samples.
+ * @retval RD_ERROR_NULL if p_history is NULL.
+ * @retval RD_ERROR_NOT_SUPPORTED if logging is not compiled in.
+ */
+rd_status_t app_log_history_get (app_log_history_t * const p_history);
+
 /**
  * @brief Configure logging.
  *
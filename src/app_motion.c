@@ -0,0 +1,252 @@
+/**
+ * @addtogroup app_motion
+ */
+/** @{ */
+/**
+ * @file app_motion.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Motion classification of accelerometer samples.
+ */
+#include "app_config.h"
+#include "app_motion.h"
+#include "app_sensor.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <math.h>
+#include <string.h>
+
+#define DEG_TO_RAD (0.01745329F)
+
+/** @brief Acceleration vector. */
+typedef struct
+{
+    float x;
+    float y;
+    float z;
+} motion_vector_t;
+
+/** @brief Statistics of current classification period. */
+typedef struct
+{
+    motion_vector_t sum;  //!< Sum of samples.
+    float magnitude_min;  //!< Smallest magnitude.
+    float magnitude_sum;  //!< Sum of magnitudes.
+    float magnitude_sq;   //!< Sum of squared magnitudes.
+    uint32_t count;       //!< Number of samples.
+} motion_period_t;
+
+static motion_period_t m_period;
+static motion_vector_t m_previous;  //!< Mean of previous period.
+static bool m_previous_valid;
+static motion_vector_t m_reference; //!< Orientation tilt is measured from.
+static bool m_reference_valid;
+static app_motion_state_t m_state;
+static app_motion_face_t m_face;
+
+static float vector_length (const motion_vector_t * const v)
+{
+    return sqrtf ( (v->x * v->x) + (v->y * v->y) + (v->z * v->z));
+}
+
+static float vector_distance (const motion_vector_t * const a,
+                              const motion_vector_t * const b)
+{
+    const motion_vector_t diff = { a->x - b->x, a->y - b->y, a->z - b->z };
+    return vector_length (&diff);
+}
+
+static bool is_tilted (const motion_vector_t * const mean)
+{
+    const float lengths = vector_length (mean) * vector_length (&m_reference);
+    bool tilted = false;
+
+    if (lengths > 0.0F)
+    {
+        const float cosine = ( (mean->x * m_reference.x) + (mean->y * m_reference.y)
+                               + (mean->z * m_reference.z)) / lengths;
+        tilted = cosine < cosf (APP_MOTION_TILT_DEG * DEG_TO_RAD);
+    }
+
+    return tilted;
+}
+
+static app_motion_face_t face_of (const motion_vector_t * const mean)
+{
+    const float ax = fabsf (mean->x);
+    const float ay = fabsf (mean->y);
+    const float az = fabsf (mean->z);
+    app_motion_face_t face = APP_MOTION_FACE_UNKNOWN;
+
+    if ( (ax >= ay) && (ax >= az) && (ax > APP_MOTION_FACE_G))
+    {
+        face = (mean->x > 0.0F) ? APP_MOTION_FACE_X_UP : APP_MOTION_FACE_X_DOWN;
+    }
+    else if ( (ay >= az) && (ay > APP_MOTION_FACE_G))
+    {
+        face = (mean->y > 0.0F) ? APP_MOTION_FACE_Y_UP : APP_MOTION_FACE_Y_DOWN;
+    }
+    else if (az > APP_MOTION_FACE_G)
+    {
+        face = (mean->z > 0.0F) ? APP_MOTION_FACE_Z_UP : APP_MOTION_FACE_Z_DOWN;
+    }
+    else
+    {
+        // Between faces, keep previous.
+    }
+
+    return face;
+}
+
+static void face_update (const motion_vector_t * const mean)
+{
+    const app_motion_face_t face = face_of (mean);
+
+    if (APP_MOTION_FACE_UNKNOWN != face)
+    {
+        if ( (APP_MOTION_FACE_UNKNOWN != m_face) && (face != m_face))
+        {
+            app_sensor_event_increment();
+        }
+
+        m_face = face;
+    }
+}
+
+static app_motion_state_t period_classify (const motion_vector_t * const mean)
+{
+    const float magnitude_mean = m_period.magnitude_sum / m_period.count;
+    const float variance = (m_period.magnitude_sq / m_period.count)
+                           - (magnitude_mean * magnitude_mean);
+    app_motion_state_t state = APP_MOTION_STILL;
+
+    if (m_period.magnitude_min < APP_MOTION_FREEFALL_G)
+    {
+        state = APP_MOTION_DROPPED;
+    }
+    else if (m_previous_valid
+             && (vector_distance (mean, &m_previous) > APP_MOTION_MOVING_G))
+    {
+        state = APP_MOTION_MOVING;
+    }
+    else if ( (variance > 0.0F) && (sqrtf (variance) > APP_MOTION_VIBRATION_G))
+    {
+        state = APP_MOTION_VIBRATING;
+    }
+    else if (!m_reference_valid)
+    {
+        m_reference = *mean;
+        m_reference_valid = true;
+    }
+    else if (is_tilted (mean))
+    {
+        state = APP_MOTION_TILTED;
+    }
+    else
+    {
+        // Still.
+    }
+
+    return state;
+}
+
+void app_motion_sample_push (const float x_g, const float y_g, const float z_g)
+{
+    if (!isnan (x_g) && !isnan (y_g) && !isnan (z_g))
+    {
+        const motion_vector_t sample = { x_g, y_g, z_g };
+        const float magnitude = vector_length (&sample);
+
+        if ( (0U == m_period.count) || (magnitude < m_period.magnitude_min))
+        {
+            m_period.magnitude_min = magnitude;
+        }
+
+        m_period.sum.x += x_g;
+        m_period.sum.y += y_g;
+        m_period.sum.z += z_g;
+        m_period.magnitude_sum += magnitude;
+        m_period.magnitude_sq += magnitude * magnitude;
+        m_period.count++;
+    }
+}
+
+app_motion_state_t app_motion_classify (void)
+{
+    if (0U < m_period.count)
+    {
+        const motion_vector_t mean =
+        {
+            m_period.sum.x / m_period.count,
+            m_period.sum.y / m_period.count,
+            m_period.sum.z / m_period.count
+        };
+        const app_motion_state_t state = period_classify (&mean);
+        const bool entered = (state != m_state);
+
+        if (entered && ( (APP_MOTION_MOVING == state) || (APP_MOTION_DROPPED == state)))
+        {
+            app_sensor_event_increment();
+        }
+
+        // Mean of moving or falling tag does not point to gravity.
+        if ( (APP_MOTION_MOVING != state) && (APP_MOTION_DROPPED != state))
+        {
+            face_update (&mean);
+        }
+
+        m_state = state;
+        m_previous = mean;
+        m_previous_valid = true;
+        memset (&m_period, 0, sizeof (m_period));
+    }
+
+    return m_state;
+}
+
+void app_motion_process (rd_sensor_data_t * const data)
+{
+    if (NULL != data)
+    {
+        app_motion_sample_push (rd_sensor_data_parse (data, RD_SENSOR_ACC_X_FIELD),
+                                rd_sensor_data_parse (data, RD_SENSOR_ACC_Y_FIELD),
+                                rd_sensor_data_parse (data, RD_SENSOR_ACC_Z_FIELD));
+        const app_motion_state_t state = app_motion_classify();
+
+        // Motion of a dedicated sensor, such as STHS34PF80, takes precedence.
+        if (data->fields.datas.motion && !data->valid.datas.motion)
+        {
+            rd_sensor_data_set (data, RD_SENSOR_MOTION_FIELD, (float) state);
+        }
+    }
+}
+
+app_motion_state_t app_motion_state_get (void)
+{
+    return m_state;
+}
+
+app_motion_face_t app_motion_face_get (void)
+{
+    return m_face;
+}
+
+void app_motion_reference_reset (void)
+{
+    m_reference_valid = false;
+}
+
+#ifdef CEEDLING
+void app_motion_reset (void)
+{
+    memset (&m_period, 0, sizeof (m_period));
+    m_previous_valid = false;
+    m_reference_valid = false;
+    m_state = APP_MOTION_STILL;
+    m_face = APP_MOTION_FACE_UNKNOWN;
+}
+#endif
+
+/** @} */
@@ -0,0 +1,119 @@
+#ifndef APP_MOTION_H
+#define APP_MOTION_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_motion Motion classification
+ * @brief Classify accelerometer samples into activity states.
+ */
+/** @} */
+/**
+ * @addtogroup app_motion
+ */
+/** @{ */
+/**
+ * @file app_motion.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Acceleration samples are collected over a classification period, usually
+ * one heartbeat. At the end of period the samples are classified:
+ *  - dropped: magnitude of any sample was below free-fall limit.
+ *  - moving: mean acceleration changed from previous period.
+ *  - vibrating: magnitude varied within period, mean did not change.
+ *  - tilted: mean acceleration turned from reference orientation.
+ *  - still: none of above.
+ *
+ * Reference orientation is learned on first still period. Orientation is also
+ * tracked as the face of the tag pointing up, a change of face counts as an event.
+ *
+ * Classified state is written into RD_SENSOR_MOTION_FIELD unless another
+ * sensor provides motion, and entering moving or dropped state increments
+ * the movement counter of @ref app_sensor_event_count_get.
+ *
+ * Vibrating is told apart from still by variation of samples within a period,
+ * so it needs several samples per period. Single read of heartbeat can't
+ * vibrate, enable APP_VIBRATION_ENABLED to push accelerometer FIFO samples
+ * into the period.
+ *
+ * Typical usage:
+ * @code{.c}
+ * // Called once per heartbeat.
+ * app_motion_process (&data);
+ * app_motion_state_t state = app_motion_state_get();
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Activity state, value of RD_SENSOR_MOTION_FIELD. */
+typedef enum
+{
+    APP_MOTION_STILL = 0, //!< No activity.
+    APP_MOTION_MOVING,    //!< Orientation or position is changing.
+    APP_MOTION_VIBRATING, //!< Vibrating in place.
+    APP_MOTION_TILTED,    //!< Still, but turned from reference orientation.
+    APP_MOTION_DROPPED    //!< Free-fall was detected.
+} app_motion_state_t;
+
+/** @brief Axis pointing up, opposite to gravity. */
+typedef enum
+{
+    APP_MOTION_FACE_UNKNOWN = 0,
+    APP_MOTION_FACE_X_UP,
+    APP_MOTION_FACE_X_DOWN,
+    APP_MOTION_FACE_Y_UP,
+    APP_MOTION_FACE_Y_DOWN,
+    APP_MOTION_FACE_Z_UP,
+    APP_MOTION_FACE_Z_DOWN
+} app_motion_face_t;
+
+/**
+ * @brief Add acceleration sample to current classification period.
+ *
+ * @param[in] x_g Acceleration along X, G.
+ * @param[in] y_g Acceleration along Y, G.
+ * @param[in] z_g Acceleration along Z, G.
+ */
+void app_motion_sample_push (const float x_g, const float y_g, const float z_g);
+
+/**
+ * @brief Classify samples of current period and start a new period.
+ *
+ * State is not changed if period has no samples.
+ *
+ * @return Classified state.
+ */
+app_motion_state_t app_motion_classify (void);
+
+/**
+ * @brief Add acceleration of data to period, classify and write motion field.
+ *
+ * Call once per heartbeat, every call ends a classification period.
+ *
+ * @param[in,out] data Sensor data read by @ref app_sensor_get.
+ */
+void app_motion_process (rd_sensor_data_t * const data);
+
+/** @brief Get latest classified state. */
+app_motion_state_t app_motion_state_get (void);
+
+/** @brief Get latest face pointing up. */
+app_motion_face_t app_motion_face_get (void);
+
+/** @brief Relearn reference orientation on next still period. */
+void app_motion_reference_reset (void);
+
+#ifdef CEEDLING
+void app_motion_reset (void);
+#endif
+
+/** @} */
+#endif // APP_MOTION_H
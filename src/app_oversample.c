@@ -0,0 +1,193 @@
+/**
+ * @addtogroup app_oversample
+ */
+/** @{ */
+/**
+ * @file app_oversample.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Aggregation of sensor reads between heartbeats.
+ */
+#include "app_config.h"
+#include "app_oversample.h"
+#include "app_sensor.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <math.h>
+
+/** @brief Samples of a single field. */
+typedef struct
+{
+    rd_sensor_data_fields_t field; //!< Field sampled by this channel.
+    float first;                   //!< First read, sums are relative to it.
+    float sum;                     //!< Sum of reads minus first read.
+    float min;                     //!< Smallest read.
+    float max;                     //!< Largest read.
+    uint16_t count;                //!< Number of reads.
+    app_oversample_stats_t stats;  //!< Statistics of latest applied interval.
+} app_oversample_channel_t;
+
+enum
+{
+    OVERSAMPLE_TEMPERATURE_INDEX,
+    OVERSAMPLE_HUMIDITY_INDEX,
+    OVERSAMPLE_PRESSURE_INDEX,
+    OVERSAMPLE_CHANNEL_COUNT
+};
+
+#define OVERSAMPLE_STATS_INVALID \
+{                                \
+    .mean = RD_FLOAT_INVALID,    \
+    .min = RD_FLOAT_INVALID,     \
+    .max = RD_FLOAT_INVALID,     \
+    .count = 0                   \
+}
+
+static app_oversample_channel_t m_channels[OVERSAMPLE_CHANNEL_COUNT] =
+{
+    [OVERSAMPLE_TEMPERATURE_INDEX] =
+    {
+        .field.datas.temperature_c = 1,
+        .stats = OVERSAMPLE_STATS_INVALID
+    },
+    [OVERSAMPLE_HUMIDITY_INDEX] =
+    {
+        .field.datas.humidity_rh = 1,
+        .stats = OVERSAMPLE_STATS_INVALID
+    },
+    [OVERSAMPLE_PRESSURE_INDEX] =
+    {
+        .field.datas.pressure_pa = 1,
+        .stats = OVERSAMPLE_STATS_INVALID
+    }
+};
+
+static void channel_add (app_oversample_channel_t * const channel, const float sample)
+{
+    if (0U == channel->count)
+    {
+        // Pressure is large compared to its noise, sum deviations to keep precision.
+        channel->first = sample;
+        channel->sum = 0.0F;
+        channel->min = sample;
+        channel->max = sample;
+    }
+    else
+    {
+        channel->sum += sample - channel->first;
+        channel->min = (sample < channel->min) ? sample : channel->min;
+        channel->max = (sample > channel->max) ? sample : channel->max;
+    }
+
+    if (UINT16_MAX > channel->count)
+    {
+        channel->count++;
+    }
+}
+
+void app_oversample_add (const rd_sensor_data_t * const p_data)
+{
+    if (NULL != p_data)
+    {
+        for (size_t ii = 0; ii < OVERSAMPLE_CHANNEL_COUNT; ii++)
+        {
+            app_oversample_channel_t * const channel = &m_channels[ii];
+            const float sample = rd_sensor_data_parse (p_data, channel->field.datas);
+
+            if (!isnan (sample))
+            {
+                channel_add (channel, sample);
+            }
+        }
+    }
+}
+
+rd_status_t app_oversample_sample (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    float values[OVERSAMPLE_CHANNEL_COUNT] = { 0 };
+    rd_sensor_data_t data = { 0 };
+    data.data = values;
+
+    for (size_t ii = 0; ii < OVERSAMPLE_CHANNEL_COUNT; ii++)
+    {
+        data.fields.bitfield |= m_channels[ii].field.bitfield;
+    }
+
+    // Read only oversampled fields to keep reads cheap. Reads are aggregated raw,
+    // the mean is processed once at heartbeat.
+    data.fields.bitfield &= app_sensor_available_data().bitfield;
+    err_code |= app_sensor_trigger (data.fields);
+    err_code |= app_sensor_get_raw (&data);
+    app_oversample_add (&data);
+    return err_code;
+}
+
+void app_oversample_apply (rd_sensor_data_t * const p_data)
+{
+    if (NULL != p_data)
+    {
+        app_oversample_add (p_data);
+
+        for (size_t ii = 0; ii < OVERSAMPLE_CHANNEL_COUNT; ii++)
+        {
+            app_oversample_channel_t * const channel = &m_channels[ii];
+            const app_oversample_stats_t invalid = OVERSAMPLE_STATS_INVALID;
+            channel->stats = invalid;
+
+            if (0U < channel->count)
+            {
+                channel->stats.mean = channel->first + (channel->sum / channel->count);
+                channel->stats.min = channel->min;
+                channel->stats.max = channel->max;
+                channel->stats.count = channel->count;
+                rd_sensor_data_set (p_data, channel->field.datas, channel->stats.mean);
+            }
+
+            channel->count = 0;
+        }
+    }
+}
+
+rd_status_t app_oversample_stats_get (const rd_sensor_data_bitfield_t field,
+                                      app_oversample_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_ERROR_NOT_FOUND;
+    const rd_sensor_data_fields_t target = { .datas = field };
+
+    if (NULL == p_stats)
+    {
+        err_code = RD_ERROR_NULL;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < OVERSAMPLE_CHANNEL_COUNT; ii++)
+        {
+            if (target.bitfield == m_channels[ii].field.bitfield)
+            {
+                *p_stats = m_channels[ii].stats;
+                err_code = RD_SUCCESS;
+            }
+        }
+    }
+
+    return err_code;
+}
+
+#ifdef CEEDLING
+void app_oversample_reset (void)
+{
+    const app_oversample_stats_t invalid = OVERSAMPLE_STATS_INVALID;
+
+    for (size_t ii = 0; ii < OVERSAMPLE_CHANNEL_COUNT; ii++)
+    {
+        m_channels[ii].count = 0;
+        m_channels[ii].stats = invalid;
+    }
+}
+#endif
+
+/** @} */
@@ -0,0 +1,110 @@
+#ifndef APP_OVERSAMPLE_H
+#define APP_OVERSAMPLE_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_oversample Oversampled heartbeat
+ * @brief Aggregate several sensor reads into one advertised value.
+ */
+/** @} */
+/**
+ * @addtogroup app_oversample
+ */
+/** @{ */
+/**
+ * @file app_oversample.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Heartbeat reads environmental sensors several times in a burst and
+ * advertises the mean of the reads. Noise of a single read does not reach
+ * the gateway, and advertising rate does not need to be raised to average it
+ * out. Gated sensors are powered up once for the whole burst, and sensors take
+ * a new sample before each read so that reads are not repeats of the same
+ * conversion.
+ *
+ * Temperature, humidity and pressure are oversampled. Minimum and maximum
+ * of the latest heartbeat are kept, temperature range is sent in
+ * @ref app_dataformat_ext.
+ *
+ * Typical usage:
+ * @code{.c}
+ * err_code |= app_sensor_power_hold();
+ * err_code |= app_oversample_sample(); // APP_OVERSAMPLE_COUNT - 1 times.
+ * err_code |= app_sensor_trigger (data.fields);
+ * err_code |= app_sensor_get_raw (&data);
+ * app_sensor_power_release();
+ * app_oversample_apply (&data);
+ * app_sensor_process (&data);
+ * err_code |= app_oversample_stats_get (RD_SENSOR_TEMP_FIELD, &stats);
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <stdint.h>
+
+/** @brief Statistics of one field over a heartbeat interval. */
+typedef struct
+{
+    float mean;     //!< Mean of reads, RD_FLOAT_INVALID if there were none.
+    float min;      //!< Smallest read, RD_FLOAT_INVALID if there were none.
+    float max;      //!< Largest read, RD_FLOAT_INVALID if there were none.
+    uint16_t count; //!< Number of valid reads.
+} app_oversample_stats_t;
+
+/**
+ * @brief Add a read to the samples of current interval.
+ *
+ * Invalid and missing fields are skipped.
+ *
+ * @param[in] p_data Sensor data.
+ */
+void app_oversample_add (const rd_sensor_data_t * const p_data);
+
+/**
+ * @brief Read oversampled fields from sensors and add them to samples.
+ *
+ * Sensors take a new sample with @ref app_sensor_trigger, reads are raw, see
+ * @ref app_sensor_get_raw. Sensors must be powered with
+ * @ref app_sensor_power_hold.
+ *
+ * @retval RD_SUCCESS on success.
+ * @return Error code from sensor driver on error.
+ */
+rd_status_t app_oversample_sample (void);
+
+/**
+ * @brief Add data to samples and replace oversampled fields with their means.
+ *
+ * Statistics of the interval are stored for @ref app_oversample_stats_get
+ * and a new interval is started. Fields without valid reads are not changed.
+ *
+ * @param[in,out] p_data Data read at heartbeat.
+ */
+void app_oversample_apply (rd_sensor_data_t * const p_data);
+
+/**
+ * @brief Get statistics of a field over the latest applied interval.
+ *
+ * @param[in] field Field to get, one of temperature, humidity or pressure.
+ * @param[out] p_stats Statistics of field.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ * @retval RD_ERROR_NOT_FOUND if field is not oversampled.
+ */
+rd_status_t app_oversample_stats_get (const rd_sensor_data_bitfield_t field,
+                                      app_oversample_stats_t * const p_stats);
+
+#ifdef CEEDLING
+void app_oversample_reset (void);
+#endif
+
+/** @} */
+#endif // APP_OVERSAMPLE_H
@@ -0,0 +1,317 @@
+/**
+ * @addtogroup app_profile
+ */
+/** @{ */
+/**
+ * @file app_profile.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Awake time statistics of heartbeat stages.
+ */
+#include "app_config.h"
+#include "app_profile.h"
+#include "app_comms.h"
+#include "app_testing.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_endpoints.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_rtc.h"
+
+#if APP_PROFILE_ENABLED && !defined(CEEDLING)
+#   include "nrf.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#define PROFILE_SUMMARY_PAGES (2U) //!< Pages before histogram bins.
+#define PROFILE_BINS_PER_PAGE (3U) //!< U16 bins after stage and page bytes.
+#define PROFILE_PAGE_COUNT (PROFILE_SUMMARY_PAGES + ((APP_PROFILE_BIN_COUNT \
+                            + PROFILE_BINS_PER_PAGE - 1U) / PROFILE_BINS_PER_PAGE))
+#if APP_PROFILE_ENABLED && !defined(CEEDLING)
+#   define PROFILE_CYCLES_PER_US (SystemCoreClock / 1000000UL)
+#else
+#   define PROFILE_CYCLES_PER_US (1U) //!< RTC ms are counted as us.
+#endif
+#define PROFILE_LINE_LENGTH (128U)
+
+static app_profile_stats_t m_stats[APP_PROFILE_STAGE_COUNT];
+
+static const char * const m_stage_names[APP_PROFILE_STAGE_COUNT] =
+{
+    [APP_PROFILE_SENSOR_READ] = "sensor",
+    [APP_PROFILE_ENCODE] = "encode",
+    [APP_PROFILE_ADV_UPDATE] = "adv",
+    [APP_PROFILE_GATT_NFC_SEND] = "gatt/nfc",
+    [APP_PROFILE_LOG_PROCESS] = "log",
+    [APP_PROFILE_HEARTBEAT] = "heartbeat"
+};
+
+/** @brief Histogram bin of a duration. */
+TESTABLE_STATIC size_t profile_bin (const uint32_t duration_us)
+{
+    size_t bin = 0;
+
+    while ( (bin < (APP_PROFILE_BIN_COUNT - 1U)) && ( (duration_us >> bin) > 0U))
+    {
+        bin++;
+    }
+
+    return bin;
+}
+
+TESTABLE_STATIC void profile_record (const app_profile_stage_t stage,
+                                     const uint32_t duration_us)
+{
+    if (APP_PROFILE_STAGE_COUNT > stage)
+    {
+        app_profile_stats_t * const p_stats = &m_stats[stage];
+
+        if (duration_us > p_stats->max_us)
+        {
+            p_stats->max_us = duration_us;
+        }
+
+        p_stats->count++;
+        p_stats->total_us += duration_us;
+        p_stats->bins[profile_bin (duration_us)]++;
+    }
+}
+
+#if APP_PROFILE_ENABLED
+/**
+ * @brief Read cycle counter, start it on first call.
+ *
+ * RTC has whole millisecond resolution, which would put nearly every stage
+ * into the first bin.
+ */
+static uint32_t profile_cycles (void)
+{
+#   ifdef CEEDLING
+    return (uint32_t) ri_rtc_millis();
+#   else
+
+    if (0U == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    return DWT->CYCCNT;
+#   endif
+}
+#endif
+
+uint32_t app_profile_start (void)
+{
+#if APP_PROFILE_ENABLED
+    return profile_cycles();
+#else
+    return 0U;
+#endif
+}
+
+void app_profile_stop (const app_profile_stage_t stage, const uint32_t start)
+{
+#if APP_PROFILE_ENABLED
+    // Unsigned difference is correct over one wrap of the counter.
+    const uint32_t cycles = profile_cycles() - start;
+    profile_record (stage, cycles / PROFILE_CYCLES_PER_US);
+#else
+    (void) stage;
+    (void) start;
+#endif
+}
+
+rd_status_t app_profile_stats_get (const app_profile_stage_t stage,
+                                   app_profile_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (APP_PROFILE_STAGE_COUNT <= stage)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        *p_stats = m_stats[stage];
+    }
+
+    return err_code;
+}
+
+void app_profile_reset (void)
+{
+    memset (m_stats, 0, sizeof (m_stats));
+}
+
+static uint32_t stats_mean_us (const app_profile_stats_t * const p_stats)
+{
+    return (0U == p_stats->count) ? 0U : (uint32_t) (p_stats->total_us / p_stats->count);
+}
+
+void app_profile_print (void (*const p_log) (const char * const))
+{
+    if (NULL != p_log)
+    {
+        for (size_t ii = 0; ii < APP_PROFILE_STAGE_COUNT; ii++)
+        {
+            const app_profile_stats_t * const p_stats = &m_stats[ii];
+            char line[PROFILE_LINE_LENGTH];
+            int written = 0;
+
+            if (0U < p_stats->count)
+            {
+                written = snprintf (line, sizeof (line),
+                                    "%s: n %lu, mean %lu us, max %lu us,",
+                                    m_stage_names[ii], (unsigned long) p_stats->count,
+                                    (unsigned long) stats_mean_us (p_stats),
+                                    (unsigned long) p_stats->max_us);
+
+                for (size_t jj = 0; (jj < APP_PROFILE_BIN_COUNT)
+                        && (0 < written) && (written < (int) sizeof (line)); jj++)
+                {
+                    written += snprintf (&line[written], sizeof (line) - (size_t) written,
+                                         " %lu", (unsigned long) p_stats->bins[jj]);
+                }
+
+                if ( (0 < written) && (written < (int) sizeof (line)))
+                {
+                    (void) snprintf (&line[written], sizeof (line) - (size_t) written,
+                                     "\r\n");
+                }
+
+                p_log (line);
+            }
+        }
+    }
+}
+
+static uint16_t saturate_u16 (const uint64_t value)
+{
+    return (value > UINT16_MAX) ? UINT16_MAX : (uint16_t) value;
+}
+
+static void u16_write (uint8_t * const p_dst, const uint16_t value)
+{
+    p_dst[0] = (uint8_t) (value >> 8U);
+    p_dst[1] = (uint8_t) (value & 0xFFU);
+}
+
+static void u32_write (uint8_t * const p_dst, const uint32_t value)
+{
+    u16_write (&p_dst[0], (uint16_t) (value >> 16U));
+    u16_write (&p_dst[2], (uint16_t) (value & 0xFFFFU));
+}
+
+TESTABLE_STATIC void profile_encode (uint8_t * const payload,
+                                     const app_profile_stage_t stage, const uint8_t page)
+{
+    const app_profile_stats_t * const p_stats = &m_stats[stage];
+    memset (payload, 0, RE_STANDARD_PAYLOAD_LENGTH);
+    payload[0] = (uint8_t) stage;
+    payload[1] = page;
+
+    if (0U == page)
+    {
+        u16_write (&payload[2], saturate_u16 (p_stats->count));
+        u32_write (&payload[4], p_stats->max_us);
+    }
+    else if (1U == page)
+    {
+        u32_write (&payload[2], stats_mean_us (p_stats));
+    }
+    else
+    {
+        const size_t first_bin = (page - PROFILE_SUMMARY_PAGES) * PROFILE_BINS_PER_PAGE;
+
+        for (size_t ii = 0; ii < PROFILE_BINS_PER_PAGE; ii++)
+        {
+            if ( (first_bin + ii) < APP_PROFILE_BIN_COUNT)
+            {
+                u16_write (&payload[2U + (2U * ii)],
+                           saturate_u16 (p_stats->bins[first_bin + ii]));
+            }
+        }
+    }
+}
+
+static rd_status_t profile_reply (const ri_comm_xfer_fp_t reply_fp,
+                                  const uint8_t * const raw_message,
+                                  const app_profile_stage_t stage,
+                                  const uint8_t page)
+{
+    ri_comm_message_t msg = {0};
+    msg.repeat_count = 1;
+    msg.data_length = RE_STANDARD_MESSAGE_LENGTH;
+    msg.data[RE_STANDARD_DESTINATION_INDEX] = raw_message[RE_STANDARD_SOURCE_INDEX];
+    msg.data[RE_STANDARD_SOURCE_INDEX] = raw_message[RE_STANDARD_DESTINATION_INDEX];
+    msg.data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+
+    if (APP_PROFILE_STAGE_COUNT > stage)
+    {
+        profile_encode (&msg.data[RE_STANDARD_PAYLOAD_START_INDEX], stage, page);
+    }
+    else
+    {
+        memset (&msg.data[RE_STANDARD_PAYLOAD_START_INDEX], 0xFF,
+                RE_STANDARD_PAYLOAD_LENGTH);
+    }
+
+    return app_comms_blocking_send (reply_fp, &msg);
+}
+
+rd_status_t app_profile_handle (const ri_comm_xfer_fp_t reply_fp,
+                                const uint8_t * const raw_message,
+                                const uint16_t data_len)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == raw_message)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (data_len < RE_STANDARD_MESSAGE_LENGTH)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        const re_op_t op = (re_op_t) raw_message[RE_STANDARD_OPERATION_INDEX];
+
+        if (RE_STANDARD_VALUE_READ == op)
+        {
+            for (size_t ii = 0; ii < APP_PROFILE_STAGE_COUNT; ii++)
+            {
+                for (uint8_t page = 0; (page < PROFILE_PAGE_COUNT)
+                        && (0U < m_stats[ii].count); page++)
+                {
+                    err_code |= profile_reply (reply_fp, raw_message,
+                                               (app_profile_stage_t) ii, page);
+                }
+            }
+        }
+        // Write clears statistics.
+        else if (RE_STANDARD_VALUE_WRITE == op)
+        {
+            app_profile_reset();
+        }
+        else
+        {
+            // No action needed, end of data is replied to unknown op.
+        }
+
+        err_code |= profile_reply (reply_fp, raw_message, APP_PROFILE_STAGE_COUNT, 0U);
+    }
+
+    return err_code;
+}
+
+/** @} */
@@ -0,0 +1,146 @@
+#ifndef APP_PROFILE_H
+#define APP_PROFILE_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_profile Heartbeat profiler
+ * @brief Measure how long each stage of heartbeat keeps CPU awake.
+ */
+/** @} */
+/**
+ * @addtogroup app_profile
+ */
+/** @{ */
+/**
+ * @file app_profile.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Duration of each heartbeat stage is recorded into a histogram with
+ * logarithmic bins, along with count, total and worst case. Statistics are
+ * readable at APP_ENDPOINT_HEARTBEAT_PROFILE and printed to log by debug
+ * builds, so regressions of awake time show up between releases.
+ *
+ * Durations are measured in microseconds with the DWT cycle counter of the
+ * Cortex-M4. The counter runs only while CPU is awake, so time a stage sleeps
+ * is not counted, and it wraps after a minute, longer stages are not
+ * profiled correctly. Unit tests count RTC milliseconds as microseconds.
+ * Nothing is measured unless APP_PROFILE_ENABLED is set.
+ *
+ * Typical usage:
+ * @code{.c}
+ * const uint32_t start = app_profile_start();
+ * err_code |= app_sensor_get (&data);
+ * app_profile_stop (APP_PROFILE_SENSOR_READ, start);
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+
+#include <stdint.h>
+
+/** @brief Number of histogram bins, last bin has all durations above the others. */
+#define APP_PROFILE_BIN_COUNT (20U)
+
+/** @brief Profiled stages of heartbeat. */
+typedef enum
+{
+    APP_PROFILE_SENSOR_READ = 0, //!< Sensor reads and processing.
+    APP_PROFILE_ENCODE,          //!< Encoding data formats.
+    APP_PROFILE_ADV_UPDATE,      //!< Updating advertisement data.
+    APP_PROFILE_GATT_NFC_SEND,   //!< Sending data to GATT and NFC.
+    APP_PROFILE_LOG_PROCESS,     //!< app_log_process.
+    APP_PROFILE_HEARTBEAT,       //!< Whole heartbeat.
+    APP_PROFILE_STAGE_COUNT      //!< Number of profiled stages.
+} app_profile_stage_t;
+
+/**
+ * @brief Duration statistics of one stage.
+ *
+ * Bin 0 counts durations under 1 us, bin n counts durations of
+ * [2^(n-1), 2^n) us and the last bin counts everything from 2^18 us, 262 ms.
+ */
+typedef struct
+{
+    uint32_t count;                       //!< Number of runs.
+    uint32_t max_us;                      //!< Longest run.
+    uint64_t total_us;                    //!< Sum of durations, divide by count for mean.
+    uint32_t bins[APP_PROFILE_BIN_COUNT]; //!< Histogram of durations.
+} app_profile_stats_t;
+
+/**
+ * @brief Timestamp start of a stage.
+ *
+ * @return Current cycle count, 0 if profiling is disabled.
+ */
+uint32_t app_profile_start (void);
+
+/**
+ * @brief Record a stage started at start.
+ *
+ * @param[in] stage Stage to record.
+ * @param[in] start Value returned by @ref app_profile_start.
+ */
+void app_profile_stop (const app_profile_stage_t stage, const uint32_t start);
+
+/**
+ * @brief Get duration statistics of a stage.
+ *
+ * @param[in] stage Stage to get.
+ * @param[out] p_stats Statistics of stage.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if stage is out of range.
+ */
+rd_status_t app_profile_stats_get (const app_profile_stage_t stage,
+                                   app_profile_stats_t * const p_stats);
+
+/** @brief Clear statistics of all stages. */
+void app_profile_reset (void);
+
+/**
+ * @brief Print statistics of stages which have run.
+ *
+ * One line per stage with count, mean, worst case and histogram bins.
+ *
+ * @param[in] p_log Function to print a line with, e.g. wrapper of ri_log.
+ */
+void app_profile_print (void (*const p_log) (const char * const));
+
+/**
+ * @brief Handle a query to APP_ENDPOINT_HEARTBEAT_PROFILE.
+ *
+ * Replies to read operation with messages for each stage which has run,
+ * followed by a message with payload of 0xFF. Write operation clears
+ * statistics. First byte of payload is stage and second byte is page.
+ * Page 0 has count as U16 and max us as U32, page 1 has mean us as U32,
+ * following pages have three histogram bins each as U16. Values saturate at
+ * the maximum of their field.
+ *
+ * @param[in] reply_fp Function pointer to send replies to.
+ * @param[in] raw_message Standard Ruuvi Endpoint message.
+ * @param[in] data_len Length of raw_message.
+ *
+ * @retval RD_SUCCESS Query was handled.
+ * @retval RD_ERROR_NULL Raw message is NULL.
+ * @retval RD_ERROR_DATA_SIZE data_len is less than RE_STANDARD_MESSAGE_LENGTH.
+ */
+rd_status_t app_profile_handle (const ri_comm_xfer_fp_t reply_fp,
+                                const uint8_t * const raw_message,
+                                const uint16_t data_len);
+
+#ifdef CEEDLING
+void profile_record (const app_profile_stage_t stage, const uint32_t duration_us);
+size_t profile_bin (const uint32_t duration_us);
+void profile_encode (uint8_t * const payload, const app_profile_stage_t stage,
+                     const uint8_t page);
+#endif
+
+/** @} */
+#endif // APP_PROFILE_H
@@ -0,0 +1,192 @@
+/**
+ * @addtogroup app_radio
+ */
+/** @{ */
+/**
+ * @file app_radio.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Radio notifications only report start and end of radio activity.
+ * Battery voltage under load is sampled at the end of TX, when the supply
+ * droop is deepest, and jobs are run after the radio event, when the radio is
+ * guaranteed to be idle for at least the advertising or connection interval.
+ * Battery voltage at rest is one of those jobs.
+ */
+#include "app_config.h"
+#include "app_radio.h"
+#include "app_sensor.h"
+#include "app_testing.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_atomic.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_scheduler.h"
+#include "ruuvi_interface_timer.h"
+
+#include <stdbool.h>
+
+TESTABLE_STATIC ri_timer_id_t m_idle_timer; //!< Fallback if radio is not active.
+static ri_scheduler_event_handler_t m_pending[APP_RADIO_IDLE_QUEUE_SIZE]; //!< Jobs.
+static volatile size_t m_pending_count; //!< Jobs waiting, scheduler context only.
+static ri_atomic_t m_jobs_pending; //!< Jobs are waiting, read by radio interrupt.
+static ri_atomic_t m_window_requested; //!< Idle window already scheduled.
+
+/**
+ * @brief Run all pending jobs.
+ *
+ * Runs in scheduler context. New jobs queued by the pending jobs are run
+ * on the next idle window.
+ */
+TESTABLE_STATIC void idle_window_handler (void * p_event, uint16_t event_size)
+{
+    ri_scheduler_event_handler_t jobs[APP_RADIO_IDLE_QUEUE_SIZE];
+    const size_t job_count = m_pending_count;
+
+    for (size_t ii = 0; ii < job_count; ii++)
+    {
+        jobs[ii] = m_pending[ii];
+    }
+
+    m_pending_count = 0;
+    (void) ri_atomic_flag (&m_jobs_pending, false);
+    (void) ri_atomic_flag (&m_window_requested, false);
+
+    if (0U < job_count)
+    {
+        (void) ri_timer_stop (m_idle_timer);
+    }
+
+    for (size_t ii = 0; ii < job_count; ii++)
+    {
+        jobs[ii] (NULL, 0);
+    }
+}
+
+/**
+ * @brief Schedule idle window unless it already is.
+ *
+ * Called from radio and timer interrupts of different priority, flag is
+ * taken atomically so only one of them schedules the window.
+ */
+static void idle_window_open (void)
+{
+    if (ri_atomic_flag (&m_window_requested, true))
+    {
+        rd_status_t err_code = ri_scheduler_event_put (NULL, 0U, &idle_window_handler);
+
+        if (RD_SUCCESS != err_code)
+        {
+            (void) ri_atomic_flag (&m_window_requested, false);
+        }
+    }
+}
+
+/**
+ * @brief Radio has been silent for too long, run the jobs anyway.
+ */
+TESTABLE_STATIC void idle_timeout_isr (void * const p_context)
+{
+    idle_window_open();
+}
+
+/**
+ * @brief Add job to pending jobs in scheduler context.
+ *
+ * @param[in] p_event Pointer to ri_scheduler_event_handler_t.
+ * @param[in] event_size Size of ri_scheduler_event_handler_t.
+ */
+TESTABLE_STATIC void idle_enqueue (void * p_event, uint16_t event_size)
+{
+    if ( (NULL != p_event) && (sizeof (ri_scheduler_event_handler_t) == event_size))
+    {
+        const ri_scheduler_event_handler_t handler =
+            * ( (ri_scheduler_event_handler_t *) p_event);
+        bool queued = false;
+
+        for (size_t ii = 0; ii < m_pending_count; ii++)
+        {
+            queued |= (handler == m_pending[ii]);
+        }
+
+        if (queued)
+        {
+            // Already waiting for the window.
+        }
+        else if (APP_RADIO_IDLE_QUEUE_SIZE > m_pending_count)
+        {
+            if (0U == m_pending_count)
+            {
+                rd_status_t err_code = ri_timer_start (m_idle_timer,
+                                                       APP_RADIO_IDLE_TIMEOUT_MS, NULL);
+                RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+            }
+
+            m_pending[m_pending_count] = handler;
+            m_pending_count++;
+            (void) ri_atomic_flag (&m_jobs_pending, true);
+        }
+        else
+        {
+            // No room to wait, do not drop the job.
+            handler (NULL, 0);
+        }
+    }
+}
+
+rd_status_t app_radio_init (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (!ri_timer_is_init()) || (!ri_scheduler_is_init()))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        m_pending_count = 0;
+        (void) ri_atomic_flag (&m_jobs_pending, false);
+        (void) ri_atomic_flag (&m_window_requested, false);
+        err_code |= ri_timer_create (&m_idle_timer, RI_TIMER_MODE_SINGLE_SHOT,
+                                     &idle_timeout_isr);
+    }
+
+    return err_code;
+}
+
+void app_radio_activity_isr (const ri_radio_activity_evt_t evt)
+{
+    app_sensor_vdd_measure_isr (evt);
+
+    if ( (RI_RADIO_AFTER == evt) && (0U != m_jobs_pending))
+    {
+        idle_window_open();
+    }
+}
+
+rd_status_t app_radio_idle_run (const ri_scheduler_event_handler_t handler)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == handler)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        err_code |= ri_scheduler_event_put (&handler, sizeof (handler), &idle_enqueue);
+    }
+
+    return err_code;
+}
+
+#ifdef CEEDLING
+void app_radio_reset (void)
+{
+    m_pending_count = 0;
+    (void) ri_atomic_flag (&m_jobs_pending, false);
+    (void) ri_atomic_flag (&m_window_requested, false);
+}
+#endif
+
+/** @} */
@@ -0,0 +1,83 @@
+#ifndef APP_RADIO_H
+#define APP_RADIO_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_radio Radio-aware scheduling
+ * @brief Align peripheral activity with radio events.
+ */
+/** @} */
+/**
+ * @addtogroup app_radio
+ */
+/** @{ */
+/**
+ * @file app_radio.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Run sensor bus transactions, flash writes and ADC conversions in the idle
+ * window right after a radio event, and sample battery voltage under radio load.
+ * Overlapping peripheral activity with radio TX causes current spikes and
+ * ADC noise.
+ *
+ * Typical usage:
+ * @code{.c}
+ * err_code |= app_radio_init();
+ * ri_radio_activity_callback_set (&app_radio_activity_isr);
+ * // In timer interrupt:
+ * err_code |= app_radio_idle_run (&heartbeat);
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_scheduler.h"
+
+/**
+ * @brief Initialize radio-aware scheduling.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_STATE if timers or scheduler is not initialized.
+ * @retval RD_ERROR_RESOURCES if fallback timer cannot be allocated.
+ */
+rd_status_t app_radio_init (void);
+
+/**
+ * @brief Handle radio activity notification.
+ *
+ * Samples battery voltage at the end of TX and opens the idle window for
+ * pending jobs after the radio event.
+ *
+ * @param[in] evt Type of radio event, RI_RADIO_BEFORE or RI_RADIO_AFTER.
+ */
+void app_radio_activity_isr (const ri_radio_activity_evt_t evt);
+
+/**
+ * @brief Run a job in next radio idle window.
+ *
+ * Safe to call from interrupt context. Job is run in scheduler context after
+ * next radio event, or after APP_RADIO_IDLE_TIMEOUT_MS if there is no radio
+ * activity. Queuing the same job again before it has run has no effect.
+ *
+ * @param[in] handler Job to run, called with NULL event and 0 size.
+ *
+ * @retval RD_SUCCESS if job was queued.
+ * @retval RD_ERROR_NULL if handler is NULL.
+ * @return Error code from scheduler if job could not be queued.
+ */
+rd_status_t app_radio_idle_run (const ri_scheduler_event_handler_t handler);
+
+#ifdef CEEDLING
+void idle_enqueue (void * p_event, uint16_t event_size);
+void idle_window_handler (void * p_event, uint16_t event_size);
+void idle_timeout_isr (void * const p_context);
+void app_radio_reset (void);
+#endif
+
+/** @} */
+#endif // APP_RADIO_H
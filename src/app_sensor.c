@@ -1,8 +1,11 @@
 #include "app_config.h"
 #include "app_sensor.h"
+#include "app_battery.h"
 #include "app_comms.h"
+#include "app_dsp.h"
 #include "app_heartbeat.h"
 #include "app_log.h"
+#include "app_radio.h"
 #include "ruuvi_boards.h"
 #include "ruuvi_driver_error.h"
 #include "ruuvi_driver_sensor.h"
@@ -64,8 +67,20 @@ static
 #endif
 rt_sensor_ctx_t * m_sensors[SENSOR_COUNT]; //!< Sensor APIs.
 static uint64_t vdd_update_time;              //!< timestamp of VDD update.
+static volatile bool m_vdd_rest_requested; //!< Rest sample waits for idle window.
+static volatile bool m_vdd_load_armed;     //!< ADC is prepared for sample under load.
 static uint32_t
 m_event_counter;              //!< Number of events registered in app_sensor.
+static uint32_t m_presence_counter; //!< Number of detected presences.
+#if APP_SENSOR_STATS_ENABLED || defined(CEEDLING)
+static app_sensor_stats_t m_stats[SENSOR_COUNT][APP_SENSOR_STATS_OP_COUNT];
+#endif
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+static rd_sensor_data_fields_t m_gated[SENSOR_COUNT]; //!< Data of powered off sensors.
+static bool m_acc_interrupt_enabled; //!< Accelerometer must stay powered.
+static const rt_sensor_ctx_t * m_presence_ctx; //!< Presence sensor must stay powered.
+static bool m_power_held; //!< Gated sensors stay powered between reads.
+#endif
 
 /**
  * @brief Sensor operation, such as read or configure.
@@ -170,6 +185,300 @@ m_sensors_init (void)
 #endif
 }
 
+#if APP_SENSOR_STATS_ENABLED || defined(CEEDLING)
+#ifndef CEEDLING
+static
+#endif
+void stats_update (const size_t sensor_idx, const app_sensor_stats_op_t op,
+                   const uint32_t duration_ms, const rd_status_t result)
+{
+    if ( (SENSOR_COUNT > sensor_idx) && (APP_SENSOR_STATS_OP_COUNT > op))
+    {
+        app_sensor_stats_t * const p_stats = &m_stats[sensor_idx][op];
+
+        if ( (0U == p_stats->count) || (duration_ms < p_stats->min_ms))
+        {
+            p_stats->min_ms = duration_ms;
+        }
+
+        if (duration_ms > p_stats->max_ms)
+        {
+            p_stats->max_ms = duration_ms;
+        }
+
+        p_stats->count++;
+        p_stats->total_ms += duration_ms;
+
+        if (RD_SUCCESS != result)
+        {
+            p_stats->errors++;
+        }
+    }
+}
+#endif
+
+/** @brief Timestamp start of a sensor operation if statistics are enabled. */
+static uint64_t stats_start (void)
+{
+#if APP_SENSOR_STATS_ENABLED
+    return ri_rtc_millis();
+#else
+    return 0U;
+#endif
+}
+
+/** @brief Record sensor operation started at start_ms if statistics are enabled. */
+static void stats_stop (const size_t sensor_idx, const app_sensor_stats_op_t op,
+                        const uint64_t start_ms, const rd_status_t result)
+{
+#if APP_SENSOR_STATS_ENABLED
+    stats_update (sensor_idx, op, (uint32_t) (ri_rtc_millis() - start_ms), result);
+#else
+    (void) sensor_idx;
+    (void) op;
+    (void) start_ms;
+    (void) result;
+#endif
+}
+
+static rd_status_t sensor_initialize (const size_t sensor_idx)
+{
+    const uint64_t start_ms = stats_start();
+    const rd_status_t err_code = rt_sensor_initialize (m_sensors[sensor_idx]);
+    stats_stop (sensor_idx, APP_SENSOR_STATS_INIT, start_ms, err_code);
+    return err_code;
+}
+
+static rd_status_t sensor_configure (const size_t sensor_idx)
+{
+    const uint64_t start_ms = stats_start();
+    const rd_status_t err_code = rt_sensor_configure (m_sensors[sensor_idx]);
+    stats_stop (sensor_idx, APP_SENSOR_STATS_CONFIGURE, start_ms, err_code);
+    return err_code;
+}
+
+static rd_status_t sensor_data_get (const size_t sensor_idx,
+                                    rd_sensor_data_t * const data)
+{
+    const uint64_t start_ms = stats_start();
+    const rd_status_t err_code = m_sensors[sensor_idx]->sensor.data_get (data);
+    stats_stop (sensor_idx, APP_SENSOR_STATS_READ, start_ms, err_code);
+    return err_code;
+}
+
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+static bool sensor_is_gated (const size_t sensor_idx)
+{
+    return (0U != m_gated[sensor_idx].bitfield);
+}
+
+/** @brief Check if sensor can be powered off until next sample. */
+static bool sensor_gate_allowed (const size_t sensor_idx)
+{
+    const rt_sensor_ctx_t * const p_ctx = m_sensors[sensor_idx];
+    bool allowed = (NULL != p_ctx) && (RI_GPIO_ID_UNUSED != p_ctx->pwr_pin);
+
+    if (allowed)
+    {
+        allowed = rd_sensor_is_init (& (p_ctx->sensor));
+    }
+
+    // Activity interrupt and vibration FIFO need accelerometer running.
+    if (allowed && (m_acc_interrupt_enabled || APP_VIBRATION_ENABLED))
+    {
+        allowed = !p_ctx->sensor.provides.datas.acceleration_x_g;
+    }
+
+    allowed = allowed && (p_ctx != m_presence_ctx);
+
+    return allowed;
+}
+
+/**
+ * @brief Uninitialize and power off sensors which can be gated.
+ *
+ * Provided data of powered off sensors is kept so that app_sensor_available_data
+ * does not change while sensors are off.
+ */
+#ifndef CEEDLING
+static
+#endif
+void sensors_power_down (void)
+{
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        if (sensor_gate_allowed (ii))
+        {
+            rt_sensor_ctx_t * const p_ctx = m_sensors[ii];
+            m_gated[ii] = p_ctx->sensor.provides;
+            (void) p_ctx->sensor.uninit (&p_ctx->sensor, p_ctx->bus, p_ctx->handle);
+            (void) ri_gpio_write (p_ctx->pwr_pin, !p_ctx->pwr_on);
+        }
+    }
+}
+
+/**
+ * @brief Power up gated sensors and restore their configuration.
+ *
+ * All gated sensors are powered up at once to wait for power lines to settle
+ * only once. Configuration is restored from sensor context, flash is not read.
+ * Sensors configured to continuous mode take a single sample so that
+ * fresh data is available immediately.
+ *
+ * @retval RD_SUCCESS if all gated sensors were restored.
+ * @return Error code from sensor driver if a sensor could not be restored,
+ *         sensor is powered off and retried on next sample.
+ */
+#ifndef CEEDLING
+static
+#endif
+rd_status_t sensors_power_up (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    bool powered = false;
+
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        if (sensor_is_gated (ii))
+        {
+            (void) ri_gpio_write (m_sensors[ii]->pwr_pin, m_sensors[ii]->pwr_on);
+            powered = true;
+        }
+    }
+
+    if (powered)
+    {
+        ri_delay_ms (POWERUP_DELAY_MS);
+    }
+
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        if (sensor_is_gated (ii))
+        {
+            rt_sensor_ctx_t * const p_ctx = m_sensors[ii];
+            rd_status_t restore_code = sensor_initialize (ii);
+
+            if (RD_SUCCESS == restore_code)
+            {
+                restore_code |= sensor_configure (ii);
+            }
+
+            if ( (RD_SUCCESS == restore_code)
+                    && (RD_SENSOR_CFG_CONTINUOUS == p_ctx->configuration.mode))
+            {
+                uint8_t mode = RD_SENSOR_CFG_SINGLE;
+                restore_code |= p_ctx->sensor.mode_set (&mode);
+            }
+
+            if (RD_SUCCESS == restore_code)
+            {
+                m_gated[ii].bitfield = 0U;
+            }
+            else
+            {
+                if (rd_sensor_is_init (&p_ctx->sensor))
+                {
+                    (void) p_ctx->sensor.uninit (&p_ctx->sensor, p_ctx->bus,
+                                                 p_ctx->handle);
+                }
+
+                (void) ri_gpio_write (p_ctx->pwr_pin, !p_ctx->pwr_on);
+                err_code |= restore_code;
+                char msg[64];
+                snprintf (msg, sizeof (msg), "Sensor %u not restored: 0x%lX\r\n",
+                          (unsigned int) ii, (unsigned long) restore_code);
+                LOG (msg);
+            }
+        }
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Restore gated sensors for access outside of sensor reads.
+ *
+ * Sensors are restored unless power is held. If a sensor cannot be restored
+ * all sensors are gated again, as a gated sensor must not be accessed.
+ *
+ * @retval RD_SUCCESS if gated sensors were restored or power is held.
+ * @retval RD_ERROR_INVALID_STATE if a gated sensor could not be restored.
+ */
+#ifndef CEEDLING
+static
+#endif
+rd_status_t sensors_access_begin (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (!m_power_held) && (RD_SUCCESS != sensors_power_up()))
+    {
+        sensors_power_down();
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+
+    return err_code;
+}
+
+/** @brief Gate sensors again after @ref sensors_access_begin. */
+#ifndef CEEDLING
+static
+#endif
+void sensors_access_end (void)
+{
+    if (!m_power_held)
+    {
+        sensors_power_down();
+    }
+}
+#endif
+
+static rd_status_t vdd_prepare (void)
+{
+    rd_sensor_configuration_t configuration =
+    {
+        .dsp_function = RD_SENSOR_CFG_DEFAULT,
+        .dsp_parameter = RD_SENSOR_CFG_DEFAULT,
+        .mode = RD_SENSOR_CFG_SINGLE,
+        .resolution = RD_SENSOR_CFG_DEFAULT,
+        .samplerate = RD_SENSOR_CFG_DEFAULT,
+        .scale = RD_SENSOR_CFG_DEFAULT
+    };
+    return rt_adc_vdd_prepare (&configuration);
+}
+
+/**
+ * @brief Sample battery at rest and prepare ADC for the sample under load.
+ *
+ * Run in radio idle window, so the conversions don't overlap TX.
+ */
+#ifndef CEEDLING
+static
+#endif
+void vdd_rest_sample (void * p_event, uint16_t event_size)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    float vdd = 0.0F;
+    err_code |= vdd_prepare();
+
+    if (RD_SUCCESS == err_code)
+    {
+        err_code |= rt_adc_vdd_sample();
+        err_code |= rt_adc_vdd_get (&vdd);
+
+        if (RD_SUCCESS == err_code)
+        {
+            app_battery_sample_isr (vdd, false);
+        }
+
+        err_code |= vdd_prepare();
+    }
+
+    m_vdd_load_armed = (RD_SUCCESS == err_code);
+    m_vdd_rest_requested = false;
+    RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+}
+
 void app_sensor_vdd_measure_isr (const ri_radio_activity_evt_t evt)
 {
     rd_status_t err_code = RD_SUCCESS;
@@ -178,25 +487,31 @@ void app_sensor_vdd_measure_isr (const ri_radio_activity_evt_t evt)
     {
         if (RI_RADIO_BEFORE == evt)
         {
-            rd_sensor_configuration_t configuration =
+            // Only latch the request, ADC is used in idle window.
+            if ( (!m_vdd_load_armed) && (!m_vdd_rest_requested))
             {
-                .dsp_function = RD_SENSOR_CFG_DEFAULT,
-                .dsp_parameter = RD_SENSOR_CFG_DEFAULT,
-                .mode = RD_SENSOR_CFG_SINGLE,
-                .resolution = RD_SENSOR_CFG_DEFAULT,
-                .samplerate = RD_SENSOR_CFG_DEFAULT,
-                .scale = RD_SENSOR_CFG_DEFAULT
-            };
-            err_code |= rt_adc_vdd_prepare (&configuration);
-            RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+                m_vdd_rest_requested = true;
+                err_code |= app_radio_idle_run (&vdd_rest_sample);
+                m_vdd_rest_requested = (RD_SUCCESS == err_code);
+                RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+            }
         }
         else
         {
-            if (true == rt_adc_is_init())
+            if (m_vdd_load_armed && (true == rt_adc_is_init()))
             {
+                float vdd = 0.0F;
+                m_vdd_load_armed = false;
                 vdd_update_time = ri_rtc_millis();
                 vdd_update_time += APP_BATTERY_SAMPLE_MS;
                 err_code |= rt_adc_vdd_sample();
+                err_code |= rt_adc_vdd_get (&vdd);
+
+                if (RD_SUCCESS == err_code)
+                {
+                    app_battery_sample_isr (vdd, true);
+                }
+
                 RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
             }
         }
@@ -212,10 +527,31 @@ on_accelerometer_isr (const ri_gpio_evt_t event)
     if (RI_GPIO_SLOPE_LOTOHI == event.slope)
     {
         LOG ("Movement \r\n");
+#if !APP_MOTION_ENABLED
+        // Motion classification counts events when enabled.
         app_sensor_event_increment();
+#endif
+        app_heartbeat_activity_isr();
     }
 }
 
+#ifndef CEEDLING
+static
+#endif
+void
+on_presence_isr (const ri_gpio_evt_t event)
+{
+    if (RI_GPIO_SLOPE_LOTOHI == event.slope)
+    {
+        LOG ("Presence \r\n");
+        m_presence_counter++;
+        app_heartbeat_activity_isr();
+    }
+
+    // Report also end of presence without waiting for heartbeat.
+    app_heartbeat_refresh_isr();
+}
+
 static ri_i2c_frequency_t rb_to_ri_i2c_freq (unsigned int rb_freq)
 {
     ri_i2c_frequency_t freq = RI_I2C_FREQUENCY_100k;
@@ -335,6 +671,12 @@ rd_status_t app_sensor_init (void)
 {
     rd_status_t err_code = RD_SUCCESS;
     m_sensors_init();
+#if APP_SENSOR_POWER_GATING_ENABLED
+    memset (m_gated, 0, sizeof (m_gated));
+#endif
+#if APP_SENSOR_DSP_ENABLED
+    app_dsp_reset();
+#endif
     ri_i2c_frequency_t i2c_freq = rb_to_ri_i2c_freq (RB_I2C_FREQ);
     // Initialize with slowest frequency supported by board to check all sensors
     err_code |= app_sensor_buses_init (i2c_freq);
@@ -364,7 +706,7 @@ rd_status_t app_sensor_init (void)
             // Some sensors, such as accelerometer may fail on user moving the board. Retry.
             do
             {
-                init_code = rt_sensor_initialize (m_sensors[ii]);
+                init_code = sensor_initialize (ii);
             } while ( (APP_SENSOR_SELFTEST_RETRIES > retries++)
                       && (RD_ERROR_SELFTEST == init_code));
 
@@ -376,12 +718,12 @@ rd_status_t app_sensor_init (void)
                 // Configuration found, use it.
                 if (RD_SUCCESS == init_code)
                 {
-                    init_code = rt_sensor_configure (m_sensors[ii]);
+                    init_code = sensor_configure (ii);
                 }
                 // Configuration not found, use defaults, store to flash.
                 else
                 {
-                    init_code = rt_sensor_configure (m_sensors[ii]);
+                    init_code = sensor_configure (ii);
                     rt_sensor_store (m_sensors[ii]);
                 }
 
@@ -428,6 +770,16 @@ rd_status_t app_sensor_uninit (void)
                 (void) ri_gpio_configure (m_sensors[ii]->pwr_pin, RI_GPIO_MODE_HIGH_Z);
             }
         }
+
+#if APP_SENSOR_POWER_GATING_ENABLED
+        // Gated sensor is already powered off.
+        else if ( (NULL != m_sensors[ii]) && sensor_is_gated (ii))
+        {
+            (void) ri_gpio_configure (m_sensors[ii]->pwr_pin, RI_GPIO_MODE_HIGH_Z);
+            m_gated[ii].bitfield = 0U;
+        }
+
+#endif
     }
 
     err_code |= app_sensor_buses_uninit();
@@ -446,12 +798,69 @@ rd_sensor_data_fields_t app_sensor_available_data (void)
         {
             available.bitfield |= m_sensors[ii]->sensor.provides.bitfield;
         }
+
+#if APP_SENSOR_POWER_GATING_ENABLED
+        available.bitfield |= m_gated[ii].bitfield;
+#endif
     }
 
+#if APP_MOTION_ENABLED
+    available.datas.motion |= available.datas.acceleration_x_g;
+#endif
     return available;
 }
 
+rd_status_t app_sensor_power_hold (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+    err_code |= sensors_power_up();
+    m_power_held = true;
+#endif
+    return err_code;
+}
+
+void app_sensor_power_release (void)
+{
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+    m_power_held = false;
+    sensors_power_down();
+#endif
+}
+
 rd_status_t app_sensor_get (rd_sensor_data_t * const data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+#if APP_SENSOR_POWER_GATING_ENABLED
+
+    if (!m_power_held)
+    {
+        err_code |= sensors_power_up();
+    }
+
+#endif
+
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        if ( (NULL != m_sensors[ii]) && rd_sensor_is_init (& (m_sensors[ii]->sensor)))
+        {
+            err_code |= sensor_data_get (ii, data);
+        }
+    }
+
+#if APP_SENSOR_POWER_GATING_ENABLED
+
+    if (!m_power_held)
+    {
+        sensors_power_down();
+    }
+
+#endif
+    app_sensor_process (data);
+    return err_code;
+}
+
+rd_status_t app_sensor_get_raw (rd_sensor_data_t * const data)
 {
     rd_status_t err_code = RD_SUCCESS;
 
@@ -466,6 +875,44 @@ rd_status_t app_sensor_get (rd_sensor_data_t * const data)
     return err_code;
 }
 
+rd_status_t app_sensor_trigger (const rd_sensor_data_fields_t fields)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint32_t pending = fields.bitfield;
+
+    for (size_t ii = 0; (ii < SENSOR_COUNT) && (0U != pending); ii++)
+    {
+        rt_sensor_ctx_t * const p_ctx = m_sensors[ii];
+
+        if ( (NULL != p_ctx) && rd_sensor_is_init (& (p_ctx->sensor))
+                && (0U != (p_ctx->sensor.provides.bitfield & pending))
+                && (!p_ctx->sensor.provides.datas.acceleration_x_g)
+                && (p_ctx != m_presence_ctx))
+        {
+            uint8_t mode = RD_SENSOR_CFG_SINGLE;
+            // Lower priority sensors would not be read for the same fields.
+            pending &= ~p_ctx->sensor.provides.bitfield;
+            err_code |= p_ctx->sensor.mode_set (&mode);
+
+            if (RD_SENSOR_CFG_CONTINUOUS == p_ctx->configuration.mode)
+            {
+                mode = RD_SENSOR_CFG_CONTINUOUS;
+                err_code |= p_ctx->sensor.mode_set (&mode);
+            }
+        }
+    }
+
+    return err_code;
+}
+
+void app_sensor_process (rd_sensor_data_t * const data)
+{
+#if APP_SENSOR_DSP_ENABLED
+    app_dsp_process (data);
+#endif
+    (void) data;
+}
+
 rd_sensor_t * app_sensor_find_provider (const rd_sensor_data_fields_t data)
 {
     rd_sensor_t * provider = NULL;
@@ -492,6 +939,11 @@ uint32_t app_sensor_event_count_get (void)
     return m_event_counter;
 }
 
+uint32_t app_sensor_presence_count_get (void)
+{
+    return m_presence_counter;
+}
+
 rd_status_t app_sensor_acc_thr_set (float * const threshold_g)
 {
     rd_status_t err_code = RD_SUCCESS;
@@ -501,9 +953,19 @@ rd_status_t app_sensor_acc_thr_set (float * const threshold_g)
         .datas.acceleration_y_g = 1,
         .datas.acceleration_z_g = 1
     };
+    rd_status_t access_code = RD_SUCCESS;
+#if APP_SENSOR_POWER_GATING_ENABLED
+    // Gated accelerometer is restored to configure the interrupt.
+    access_code |= sensors_access_begin();
+#endif
     const rd_sensor_t * const provider = app_sensor_find_provider (acceleration);
 
-    if (RI_GPIO_ID_UNUSED == RB_INT_LEVEL_PIN)
+    if (RD_SUCCESS != access_code)
+    {
+        // Accelerometer could not be restored, it is not accessed.
+        err_code |= access_code;
+    }
+    else if (RI_GPIO_ID_UNUSED == RB_INT_LEVEL_PIN)
     {
         err_code |= RD_ERROR_NOT_SUPPORTED;
     }
@@ -515,6 +977,9 @@ rd_status_t app_sensor_acc_thr_set (float * const threshold_g)
     {
         ri_gpio_interrupt_disable (RB_INT_LEVEL_PIN);
         err_code |= provider->level_interrupt_set (false, threshold_g);
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+        m_acc_interrupt_enabled = false;
+#endif
     }
     else if (0 > *threshold_g)
     {
@@ -527,8 +992,62 @@ rd_status_t app_sensor_acc_thr_set (float * const threshold_g)
                                               RI_GPIO_MODE_INPUT_NOPULL,
                                               &on_accelerometer_isr);
         err_code |= provider->level_interrupt_set (true, threshold_g);
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+        m_acc_interrupt_enabled = (RD_SUCCESS == err_code);
+#endif
+    }
+
+#if APP_SENSOR_POWER_GATING_ENABLED
+
+    if (RD_SUCCESS == access_code)
+    {
+        sensors_access_end();
+    }
+
+#endif
+    return err_code;
+}
+
+rd_status_t app_sensor_presence_int_set (const bool enable)
+{
+    rd_status_t err_code = RD_SUCCESS;
+#if APP_SENSOR_STHS34PF80_ENABLED
+    rt_sensor_ctx_t * const p_ctx = &sths34pf80;
+    float threshold = APP_SENSOR_STHS34PF80_PRESENCE_THRESHOLD;
+
+    if (RI_GPIO_ID_UNUSED == p_ctx->level_pin)
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+    else if ( (!rd_sensor_is_init (&p_ctx->sensor))
+              || (NULL == p_ctx->sensor.level_interrupt_set))
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+    else if (enable)
+    {
+        err_code |= ri_gpio_interrupt_enable (p_ctx->level_pin,
+                                              RI_GPIO_SLOPE_TOGGLE,
+                                              RI_GPIO_MODE_INPUT_NOPULL,
+                                              &on_presence_isr);
+        err_code |= p_ctx->sensor.level_interrupt_set (true, &threshold);
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+        m_presence_ctx = (RD_SUCCESS == err_code) ? p_ctx : NULL;
+#endif
+    }
+    else
+    {
+        ri_gpio_interrupt_disable (p_ctx->level_pin);
+        err_code |= p_ctx->sensor.level_interrupt_set (false, NULL);
+#if APP_SENSOR_POWER_GATING_ENABLED || defined(CEEDLING)
+        m_presence_ctx = NULL;
+#endif
     }
 
+#else
+    (void) enable;
+    err_code |= RD_ERROR_NOT_SUPPORTED;
+#endif
     return err_code;
 }
 
@@ -934,37 +1453,177 @@ rd_status_t app_sensor_handle (const ri_comm_xfer_fp_t reply_fp,
         rd_sensor_data_fields_t target_fields = re2rd_fields (type);
         // Parse desired operation.
         re_op_t op = (re_op_t) raw_message[RE_STANDARD_OPERATION_INDEX];
+        rd_status_t access_code = RD_SUCCESS;
+#if APP_SENSOR_POWER_GATING_ENABLED
+        // Request may arrive between heartbeats while sensors are gated.
+        access_code |= sensors_access_begin();
+#endif
+        err_code |= access_code;
 
-        // If target and op are valid, execute.
-        switch (op)
+        if (RD_SUCCESS == access_code)
         {
-            case RE_STANDARD_LOG_VALUE_READ:
-                err_code |= app_sensor_log_read (reply_fp,
-                                                 target_fields, raw_message);
-                break;
-
-            default:
-                // Reply with error on unknown op.
-                break;
+            // If target and op are valid, execute.
+            switch (op)
+            {
+                case RE_STANDARD_LOG_VALUE_READ:
+                    err_code |= app_sensor_log_read (reply_fp,
+                                                     target_fields, raw_message);
+                    break;
+
+                default:
+                    // Reply with error on unknown op.
+                    break;
+            }
+
+#if APP_SENSOR_POWER_GATING_ENABLED
+            sensors_access_end();
+#endif
         }
     }
 
     return err_code;
 }
 
-rd_status_t app_sensor_vdd_sample (void)
+rd_status_t app_sensor_stats_get (const size_t sensor_idx,
+                                  const app_sensor_stats_op_t op,
+                                  app_sensor_stats_t * const stats)
 {
     rd_status_t err_code = RD_SUCCESS;
-    rd_sensor_configuration_t configuration =
+
+    if (NULL == stats)
     {
-        .dsp_function = RD_SENSOR_CFG_DEFAULT,
-        .dsp_parameter = RD_SENSOR_CFG_DEFAULT,
-        .mode = RD_SENSOR_CFG_SINGLE,
-        .resolution = RD_SENSOR_CFG_DEFAULT,
-        .samplerate = RD_SENSOR_CFG_DEFAULT,
-        .scale = RD_SENSOR_CFG_DEFAULT
-    };
-    err_code |= rt_adc_vdd_prepare (&configuration);
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (SENSOR_COUNT <= sensor_idx) || (APP_SENSOR_STATS_OP_COUNT <= op))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+#if APP_SENSOR_STATS_ENABLED || defined(CEEDLING)
+        *stats = m_stats[sensor_idx][op];
+#else
+        memset (stats, 0, sizeof (app_sensor_stats_t));
+#endif
+    }
+
+    return err_code;
+}
+
+void app_sensor_stats_reset (void)
+{
+#if APP_SENSOR_STATS_ENABLED || defined(CEEDLING)
+    memset (m_stats, 0, sizeof (m_stats));
+#endif
+}
+
+static uint8_t saturate_u8 (const uint64_t value)
+{
+    return (value > UINT8_MAX) ? UINT8_MAX : (uint8_t) value;
+}
+
+#ifndef CEEDLING
+static
+#endif
+void stats_encode (uint8_t * const payload, const size_t sensor_idx,
+                   const app_sensor_stats_op_t op)
+{
+    app_sensor_stats_t stats = {0};
+    (void) app_sensor_stats_get (sensor_idx, op, &stats);
+    const uint16_t count = (stats.count > UINT16_MAX) ? UINT16_MAX :
+                           (uint16_t) stats.count;
+    const uint64_t mean_ms = (0U == stats.count) ? 0U : (stats.total_ms / stats.count);
+    payload[0] = (uint8_t) sensor_idx;
+    payload[1] = (uint8_t) op;
+    payload[2] = (uint8_t) (count >> 8U);
+    payload[3] = (uint8_t) (count & 0xFFU);
+    payload[4] = saturate_u8 (stats.errors);
+    payload[5] = saturate_u8 (stats.min_ms);
+    payload[6] = saturate_u8 (stats.max_ms);
+    payload[7] = saturate_u8 (mean_ms);
+}
+
+static rd_status_t stats_reply (const ri_comm_xfer_fp_t reply_fp,
+                                const uint8_t * const raw_message,
+                                const size_t sensor_idx,
+                                const app_sensor_stats_op_t op)
+{
+    ri_comm_message_t msg = {0};
+    msg.repeat_count = 1;
+    msg.data_length = RE_STANDARD_MESSAGE_LENGTH;
+    msg.data[RE_STANDARD_DESTINATION_INDEX] = raw_message[RE_STANDARD_SOURCE_INDEX];
+    msg.data[RE_STANDARD_SOURCE_INDEX] = raw_message[RE_STANDARD_DESTINATION_INDEX];
+    msg.data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+
+    if (SENSOR_COUNT > sensor_idx)
+    {
+        stats_encode (&msg.data[RE_STANDARD_PAYLOAD_START_INDEX], sensor_idx, op);
+    }
+    else
+    {
+        memset (&msg.data[RE_STANDARD_PAYLOAD_START_INDEX], 0xFF,
+                RE_STANDARD_PAYLOAD_LENGTH);
+    }
+
+    return app_comms_blocking_send (reply_fp, &msg);
+}
+
+rd_status_t app_sensor_stats_handle (const ri_comm_xfer_fp_t reply_fp,
+                                     const uint8_t * const raw_message,
+                                     const uint16_t data_len)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == raw_message)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (data_len < RE_STANDARD_MESSAGE_LENGTH)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        const re_op_t op = (re_op_t) raw_message[RE_STANDARD_OPERATION_INDEX];
+
+        if (RE_STANDARD_VALUE_READ == op)
+        {
+            for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+            {
+                for (size_t jj = 0; jj < APP_SENSOR_STATS_OP_COUNT; jj++)
+                {
+                    app_sensor_stats_t stats = {0};
+                    (void) app_sensor_stats_get (ii, (app_sensor_stats_op_t) jj, &stats);
+
+                    if (0U < stats.count)
+                    {
+                        err_code |= stats_reply (reply_fp, raw_message, ii,
+                                                 (app_sensor_stats_op_t) jj);
+                    }
+                }
+            }
+        }
+        // Write clears statistics.
+        else if (RE_STANDARD_VALUE_WRITE == op)
+        {
+            app_sensor_stats_reset();
+        }
+        else
+        {
+            // No action needed, end of data is replied to unknown op.
+        }
+
+        err_code |= stats_reply (reply_fp, raw_message, SENSOR_COUNT,
+                                 APP_SENSOR_STATS_OP_COUNT);
+    }
+
+    return err_code;
+}
+
+rd_status_t app_sensor_vdd_sample (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    err_code |= vdd_prepare();
     err_code |= rt_adc_vdd_sample();
     return err_code;
 }
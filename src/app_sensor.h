@@ -403,6 +403,61 @@ rd_sensor_data_fields_t app_sensor_available_data (void);
  */
 rd_status_t app_sensor_get (rd_sensor_data_t * const data);
 
+/**
+ * @brief Read sensors without processing the data.
+ *
+ * Like @ref app_sensor_get, but data is not filtered or calibrated, gated
+ * sensors are not powered up and reads are not counted in sensor statistics.
+ * Meant for bursts of reads within @ref app_sensor_power_hold whose aggregate
+ * is processed once with @ref app_sensor_process.
+ *
+ * @retval RD_SUCCESS on success, NOT_FOUND sensors are allowed.
+ * @return Error code from sensor driver on error.
+ */
+rd_status_t app_sensor_get_raw (rd_sensor_data_t * const data);
+
+/**
+ * @brief Take a new sample of sensors which provide given fields.
+ *
+ * Sensors in continuous mode convert at their own rate, BME280 at 1 Hz by
+ * default, so reads in a burst of @ref app_sensor_get_raw would return the same
+ * conversion. Each sensor which is first in priority for some of the fields
+ * takes a single sample, blocking until its data is ready, and returns to its
+ * configured mode. Accelerometer and presence sensor keep running for their
+ * interrupts and are not sampled.
+ *
+ * @param[in] fields Fields which next read must have fresh.
+ *
+ * @retval RD_SUCCESS on success.
+ * @return Error code from sensor driver on error.
+ */
+rd_status_t app_sensor_trigger (const rd_sensor_data_fields_t fields);
+
+/**
+ * @brief Filter and calibrate data as @ref app_sensor_get does after a read.
+ *
+ * @param[in,out] data Data read with @ref app_sensor_get_raw.
+ */
+void app_sensor_process (rd_sensor_data_t * const data);
+
+/**
+ * @brief Keep gated sensors powered over several reads.
+ *
+ * With APP_SENSOR_POWER_GATING_ENABLED @ref app_sensor_get powers gated sensors
+ * up and down on every call. Sensors are instead powered up once here and
+ * stay powered until @ref app_sensor_power_release. Does nothing without
+ * power gating.
+ *
+ * @retval RD_SUCCESS if all gated sensors were powered up.
+ * @return Error code from sensor driver if a sensor could not be restored.
+ */
+rd_status_t app_sensor_power_hold (void);
+
+/**
+ * @brief Power off gated sensors held by @ref app_sensor_power_hold.
+ */
+void app_sensor_power_release (void);
+
 /**
  * @brief Uninitialize sensors into low-power mode.
  *
@@ -447,6 +502,16 @@ void app_sensor_event_increment (void);
  */
 uint32_t app_sensor_event_count_get (void);
 
+/**
+ * @brief Get number of detected presences.
+ *
+ * Presence is counted separately from motion events, which data formats
+ * advertise as movement count.
+ *
+ * @return Number of presence events, rolls over at 2^32.
+ */
+uint32_t app_sensor_presence_count_get (void);
+
 /**
  * @brief Set threshold for accelerometer interrupts.
  *
@@ -498,9 +563,11 @@ rd_status_t app_sensor_handle (const ri_comm_xfer_fp_t ri_reply_fp,
 /**
  * @brief Synchronize VDD measurement to radio activity.
  *
- * Call this function before and after radio events to notify
- * the device that ADC should be prepared to sample the droop voltage
- * and to take the sample after heavy loading.
+ * Call this function before and after radio events. When a sample is due,
+ * radio event before TX queues a sample at rest into the next radio idle
+ * window, which also prepares ADC. The radio event after that takes the
+ * sample of droop voltage at the end of TX. The interrupt does no ADC work
+ * before TX.
  *
  * @param[in] evt Type of next radio event, RI_RADIO_BEFORE ot RI_RADIO_AFTER
  */
@@ -517,6 +584,82 @@ void app_sensor_vdd_measure_isr (const ri_radio_activity_evt_t evt);
  */
 rd_status_t app_sensor_vdd_sample (void);
 
+/**
+ * @brief Enable or disable presence interrupt of thermal presence sensor.
+ *
+ * On presence change advertised data is refreshed immediately and
+ * on detected presence counter of @ref app_sensor_presence_count_get is
+ * incremented. Presence threshold is APP_SENSOR_STHS34PF80_PRESENCE_THRESHOLD.
+ *
+ * @param[in] enable True to enable interrupt, false to disable.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NOT_SUPPORTED if board does not have presence sensor with
+ *                                interrupt line or sensor driver has no interrupt.
+ */
+rd_status_t app_sensor_presence_int_set (const bool enable);
+
+/** @brief Timed sensor operations. */
+typedef enum
+{
+    APP_SENSOR_STATS_INIT = 0,  //!< rt_sensor_initialize.
+    APP_SENSOR_STATS_CONFIGURE, //!< rt_sensor_configure.
+    APP_SENSOR_STATS_READ,      //!< data_get.
+    APP_SENSOR_STATS_OP_COUNT   //!< Number of timed operations.
+} app_sensor_stats_op_t;
+
+/** @brief Timing statistics of one operation on one sensor. */
+typedef struct
+{
+    uint32_t count;    //!< Number of calls.
+    uint32_t errors;   //!< Number of calls which did not return RD_SUCCESS.
+    uint32_t min_ms;   //!< Shortest call, 0 if there are no calls.
+    uint32_t max_ms;   //!< Longest call.
+    uint64_t total_ms; //!< Sum of call durations, divide by count for mean.
+} app_sensor_stats_t;
+
+/**
+ * @brief Get timing statistics of a sensor operation.
+ *
+ * Durations are measured with RTC and have resolution of RTC tick,
+ * calls shorter than a tick are recorded as 0 ms.
+ * Statistics are collected only if APP_SENSOR_STATS_ENABLED is set.
+ *
+ * @param[in] sensor_idx Index of sensor, less than SENSOR_COUNT.
+ * @param[in] op Operation to get.
+ * @param[out] stats Statistics of operation.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if stats is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if sensor_idx or op is out of range.
+ */
+rd_status_t app_sensor_stats_get (const size_t sensor_idx,
+                                  const app_sensor_stats_op_t op,
+                                  app_sensor_stats_t * const stats);
+
+/** @brief Clear timing statistics of all sensors. */
+void app_sensor_stats_reset (void);
+
+/**
+ * @brief Handle a query to APP_ENDPOINT_SENSOR_STATS.
+ *
+ * Replies to read operation with one message per timed sensor operation,
+ * followed by a message with payload of 0xFF. Payload of each message is
+ * sensor index, operation, count (U16), errors, min ms, max ms and mean ms.
+ * Values saturate at the maximum of their field.
+ *
+ * @param[in] reply_fp Function pointer to send replies to.
+ * @param[in] raw_message Standard Ruuvi Endpoint message.
+ * @param[in] data_len Length of raw_message.
+ *
+ * @retval RD_SUCCESS Query was handled.
+ * @retval RD_ERROR_NULL Raw message is NULL.
+ * @retval RD_ERROR_DATA_SIZE data_len is less than RE_STANDARD_MESSAGE_LENGTH.
+ */
+rd_status_t app_sensor_stats_handle (const ri_comm_xfer_fp_t reply_fp,
+                                     const uint8_t * const raw_message,
+                                     const uint16_t data_len);
+
 #ifdef RUUVI_RUN_TESTS
 void app_sensor_ctx_get (rt_sensor_ctx_t *** m_sensors, size_t * num_sensors);
 #endif
@@ -526,6 +669,16 @@ void app_sensor_ctx_get (rt_sensor_ctx_t *** m_sensors, size_t * num_sensors);
 #include "ruuvi_interface_gpio_interrupt.h"
 void on_radio_isr (const ri_radio_activity_evt_t evt);
 void on_accelerometer_isr (const ri_gpio_evt_t event);
+void on_presence_isr (const ri_gpio_evt_t event);
+void stats_update (const size_t sensor_idx, const app_sensor_stats_op_t op,
+                   const uint32_t duration_ms, const rd_status_t result);
+void stats_encode (uint8_t * const payload, const size_t sensor_idx,
+                   const app_sensor_stats_op_t op);
+void sensors_power_down (void);
+rd_status_t sensors_power_up (void);
+rd_status_t sensors_access_begin (void);
+void sensors_access_end (void);
+void vdd_rest_sample (void * p_event, uint16_t event_size);
 #endif
 
 #endif
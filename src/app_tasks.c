@@ -0,0 +1,245 @@
+/**
+ * @addtogroup app_tasks
+ */
+/** @{ */
+/**
+ * @file app_tasks.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Periodic tasks with coalesced wakeups.
+ */
+#include "app_config.h"
+#include "app_tasks.h"
+#include "app_testing.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_rtc.h"
+#include "ruuvi_interface_scheduler.h"
+#include "ruuvi_interface_timer.h"
+
+#include <stdbool.h>
+
+/** @brief Periodic task. */
+typedef struct
+{
+    ri_scheduler_event_handler_t task; //!< Function to run.
+    uint32_t period_ms;                //!< Interval of runs.
+    uint64_t next_ms;                  //!< Time of next run.
+} app_task_t;
+
+TESTABLE_STATIC ri_timer_id_t m_tasks_timer; //!< Wakes up to next due task.
+static app_task_t m_tasks[APP_TASKS_MAX];
+static size_t m_task_count;
+static bool m_running;
+
+static app_task_t * task_find (const ri_scheduler_event_handler_t task)
+{
+    app_task_t * p_task = NULL;
+
+    for (size_t ii = 0; ii < m_task_count; ii++)
+    {
+        if (task == m_tasks[ii].task)
+        {
+            p_task = &m_tasks[ii];
+        }
+    }
+
+    return p_task;
+}
+
+/**
+ * @brief Run tasks due now or within coalescing window.
+ *
+ * @param[in] now_ms Current time.
+ * @return Time to next due task, at least 1 ms.
+ */
+TESTABLE_STATIC uint32_t tasks_run_due (const uint64_t now_ms)
+{
+    uint64_t next_ms = UINT64_MAX;
+
+    for (size_t ii = 0; ii < m_task_count; ii++)
+    {
+        app_task_t * const p_task = &m_tasks[ii];
+
+        if (p_task->next_ms <= (now_ms + APP_TASKS_COALESCE_MS))
+        {
+            p_task->next_ms += p_task->period_ms;
+
+            // Do not catch up missed runs.
+            if (p_task->next_ms <= now_ms)
+            {
+                p_task->next_ms = now_ms + p_task->period_ms;
+            }
+
+            p_task->task (NULL, 0);
+        }
+    }
+
+    // Tasks may have changed periods, find next wakeup after all have run.
+    for (size_t ii = 0; ii < m_task_count; ii++)
+    {
+        if (m_tasks[ii].next_ms < next_ms)
+        {
+            next_ms = m_tasks[ii].next_ms;
+        }
+    }
+
+    uint64_t delay_ms = (next_ms > now_ms) ? (next_ms - now_ms) : 1U;
+
+    if (UINT32_MAX < delay_ms)
+    {
+        delay_ms = UINT32_MAX;
+    }
+
+    return (uint32_t) delay_ms;
+}
+
+/**
+ * @brief Run due tasks and start timer to next due task.
+ */
+TESTABLE_STATIC void tasks_handler (void * p_event, uint16_t event_size)
+{
+    if (m_running && (0U < m_task_count))
+    {
+        const uint32_t delay_ms = tasks_run_due (ri_rtc_millis());
+        rd_status_t err_code = ri_timer_stop (m_tasks_timer);
+        err_code |= ri_timer_start (m_tasks_timer, delay_ms, NULL);
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    }
+}
+
+TESTABLE_STATIC void tasks_timer_isr (void * const p_context)
+{
+    ri_scheduler_event_put (NULL, 0U, &tasks_handler);
+}
+
+rd_status_t app_tasks_init (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (!ri_timer_is_init()) || (!ri_scheduler_is_init()))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        m_task_count = 0;
+        m_running = false;
+
+        if (NULL == m_tasks_timer)
+        {
+            err_code |= ri_timer_create (&m_tasks_timer, RI_TIMER_MODE_SINGLE_SHOT,
+                                         &tasks_timer_isr);
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t app_tasks_add (const ri_scheduler_event_handler_t task,
+                           const uint32_t period_ms)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == task)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (0U == period_ms) || (NULL != task_find (task)))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (APP_TASKS_MAX <= m_task_count)
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+    else
+    {
+        m_tasks[m_task_count].task = task;
+        m_tasks[m_task_count].period_ms = period_ms;
+        m_tasks[m_task_count].next_ms = 0U;
+        m_task_count++;
+    }
+
+    return err_code;
+}
+
+rd_status_t app_tasks_period_set (const ri_scheduler_event_handler_t task,
+                                  const uint32_t period_ms)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    app_task_t * const p_task = task_find (task);
+
+    if (0U == period_ms)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (NULL == p_task)
+    {
+        err_code |= RD_ERROR_NOT_FOUND;
+    }
+    else
+    {
+        p_task->period_ms = period_ms;
+        p_task->next_ms = ri_rtc_millis() + period_ms;
+
+        // Timer may be running to a later wakeup, recalculate it.
+        if (m_running)
+        {
+            err_code |= ri_scheduler_event_put (NULL, 0U, &tasks_handler);
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t app_tasks_start (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == m_tasks_timer)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < m_task_count; ii++)
+        {
+            m_tasks[ii].next_ms = 0U;
+        }
+
+        m_running = true;
+        err_code |= ri_scheduler_event_put (NULL, 0U, &tasks_handler);
+    }
+
+    return err_code;
+}
+
+rd_status_t app_tasks_stop (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == m_tasks_timer)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        m_running = false;
+        err_code |= ri_timer_stop (m_tasks_timer);
+    }
+
+    return err_code;
+}
+
+#ifdef CEEDLING
+void app_tasks_reset (void)
+{
+    m_task_count = 0;
+    m_running = false;
+    m_tasks_timer = NULL;
+}
+#endif
+
+/** @} */
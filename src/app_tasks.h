@@ -0,0 +1,116 @@
+#ifndef APP_TASKS_H
+#define APP_TASKS_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_tasks Periodic tasks
+ * @brief Run periodic activities at independent rates from a single timer.
+ */
+/** @} */
+/**
+ * @addtogroup app_tasks
+ */
+/** @{ */
+/**
+ * @file app_tasks.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Cooperative task table on top of one single-shot timer. Each task has its
+ * own period. Timer is started to the next due task, and all tasks due within
+ * APP_TASKS_COALESCE_MS are run on the same wakeup, so tasks with aligned
+ * periods do not wake up the CPU separately.
+ *
+ * Tasks are run in scheduler context in the order they were added.
+ * A task which has missed its period is run once, missed runs are not
+ * caught up.
+ *
+ * Typical usage:
+ * @code{.c}
+ * err_code |= app_tasks_init();
+ * err_code |= app_tasks_add (&sample_task, 10U * 1000U);
+ * err_code |= app_tasks_add (&advertise_task, 1285U);
+ * err_code |= app_tasks_start();
+ * // Later
+ * err_code |= app_tasks_period_set (&sample_task, 60U * 1000U);
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_scheduler.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Initialize task table.
+ *
+ * Removes all tasks.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_STATE if timers or scheduler is not initialized.
+ * @retval RD_ERROR_RESOURCES if timer cannot be allocated.
+ */
+rd_status_t app_tasks_init (void);
+
+/**
+ * @brief Add a periodic task.
+ *
+ * Task is first run when tasks are started, or on next wakeup if tasks
+ * are already running.
+ *
+ * @param[in] task Task to run, called with NULL event and 0 size.
+ * @param[in] period_ms Interval of task.
+ *
+ * @retval RD_SUCCESS if task was added.
+ * @retval RD_ERROR_NULL if task is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if period is 0 or task was already added.
+ * @retval RD_ERROR_NO_MEM if there already are APP_TASKS_MAX tasks.
+ */
+rd_status_t app_tasks_add (const ri_scheduler_event_handler_t task,
+                           const uint32_t period_ms);
+
+/**
+ * @brief Change period of a task.
+ *
+ * Next run of task is one new period from now.
+ *
+ * @param[in] task Task added with @ref app_tasks_add.
+ * @param[in] period_ms New interval of task.
+ *
+ * @retval RD_SUCCESS if period was changed.
+ * @retval RD_ERROR_INVALID_PARAM if period is 0.
+ * @retval RD_ERROR_NOT_FOUND if task has not been added.
+ */
+rd_status_t app_tasks_period_set (const ri_scheduler_event_handler_t task,
+                                  const uint32_t period_ms);
+
+/**
+ * @brief Run all tasks now and then at their periods.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_STATE if tasks are not initialized.
+ * @return Error code from scheduler on error.
+ */
+rd_status_t app_tasks_start (void);
+
+/**
+ * @brief Stop running tasks.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_STATE if tasks are not initialized.
+ */
+rd_status_t app_tasks_stop (void);
+
+#ifdef CEEDLING
+uint32_t tasks_run_due (const uint64_t now_ms);
+void tasks_handler (void * p_event, uint16_t event_size);
+void tasks_timer_isr (void * const p_context);
+void app_tasks_reset (void);
+#endif
+
+/** @} */
+#endif // APP_TASKS_H
@@ -0,0 +1,456 @@
+/**
+ * @addtogroup app_vibration
+ */
+/** @{ */
+/**
+ * @file app_vibration.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Vibration features of accelerometer FIFO samples.
+ */
+#include "app_config.h"
+#include "app_vibration.h"
+#include "app_acc_calibration.h"
+#include "app_motion.h"
+#include "app_sensor.h"
+#include "app_testing.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VIBRATION_FIFO_DEPTH (32U) //!< Samples in LIS2DH12 FIFO.
+#define Q15_SHIFT (15U)
+#define MG_PER_G (1000.0F)
+#define DHZ_PER_HZ (10U)
+
+/**
+ * @brief Q15 sine of 2 * pi * i / APP_VIBRATION_WINDOW_MAX for first quarter.
+ *
+ * Other twiddles are mirrored from the quarter.
+ */
+static const int16_t m_sine_q15[ (APP_VIBRATION_WINDOW_MAX / 4U) + 1U] =
+{
+    0, 3212, 6393, 9512, 12540, 15447, 18205, 20788, 23170,
+    25330, 27246, 28899, 30274, 31357, 32138, 32610, 32767
+};
+
+static const rd_sensor_data_fields_t m_acceleration =
+{
+    .datas.acceleration_x_g = 1,
+    .datas.acceleration_y_g = 1,
+    .datas.acceleration_z_g = 1
+};
+
+static rd_sensor_t * m_provider; //!< Accelerometer with FIFO enabled.
+static float m_fifo_values[VIBRATION_FIFO_DEPTH][APP_VIBRATION_AXIS_COUNT];
+static rd_sensor_data_t m_fifo[VIBRATION_FIFO_DEPTH];
+static int16_t m_window[APP_VIBRATION_AXIS_COUNT][APP_VIBRATION_WINDOW];
+static size_t m_window_count;
+static app_vibration_features_t m_features[APP_VIBRATION_AXIS_COUNT];
+static bool m_features_valid;
+
+/** @brief Cosine and sine of -2 * pi * idx / APP_VIBRATION_WINDOW_MAX, idx < MAX / 2. */
+static void twiddle (const size_t idx, int16_t * const cos_q15, int16_t * const sin_q15)
+{
+    const size_t quarter = APP_VIBRATION_WINDOW_MAX / 4U;
+
+    if (idx <= quarter)
+    {
+        *sin_q15 = m_sine_q15[idx];
+        *cos_q15 = m_sine_q15[quarter - idx];
+    }
+    else
+    {
+        *sin_q15 = m_sine_q15[ (2U * quarter) - idx];
+        *cos_q15 = (int16_t) - m_sine_q15[idx - quarter];
+    }
+}
+
+/**
+ * @brief In-place radix-2 FFT in Q15.
+ *
+ * Every stage is scaled by 1/2 so that the result cannot overflow,
+ * output is the DFT divided by count.
+ */
+TESTABLE_STATIC void vibration_fft (int16_t * const re, int16_t * const im,
+                                    const size_t count)
+{
+    // Bit-reversal permutation.
+    for (size_t ii = 1U, jj = 0U; ii < count; ii++)
+    {
+        size_t bit = count >> 1U;
+
+        while (0U != (jj & bit))
+        {
+            jj ^= bit;
+            bit >>= 1U;
+        }
+
+        jj ^= bit;
+
+        if (ii < jj)
+        {
+            int16_t tmp = re[ii];
+            re[ii] = re[jj];
+            re[jj] = tmp;
+            tmp = im[ii];
+            im[ii] = im[jj];
+            im[jj] = tmp;
+        }
+    }
+
+    for (size_t len = 2U; len <= count; len <<= 1U)
+    {
+        const size_t half = len / 2U;
+        const size_t stride = APP_VIBRATION_WINDOW_MAX / len;
+
+        for (size_t start = 0U; start < count; start += len)
+        {
+            for (size_t kk = 0U; kk < half; kk++)
+            {
+                const size_t aa = start + kk;
+                const size_t bb = aa + half;
+                int16_t wr;
+                int16_t ws;
+                twiddle (kk * stride, &wr, &ws);
+                const int32_t tr = ( ( (int32_t) re[bb] * wr) + ( (int32_t) im[bb] * ws))
+                                   >> Q15_SHIFT;
+                const int32_t ti = ( ( (int32_t) im[bb] * wr) - ( (int32_t) re[bb] * ws))
+                                   >> Q15_SHIFT;
+                const int32_t ar = re[aa];
+                const int32_t ai = im[aa];
+                re[aa] = (int16_t) ( (ar + tr) >> 1);
+                im[aa] = (int16_t) ( (ai + ti) >> 1);
+                re[bb] = (int16_t) ( (ar - tr) >> 1);
+                im[bb] = (int16_t) ( (ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+static uint32_t isqrt (uint32_t value)
+{
+    uint32_t root = 0U;
+    uint32_t bit = 1UL << 30U;
+
+    while (bit > value)
+    {
+        bit >>= 2U;
+    }
+
+    while (0U != bit)
+    {
+        if (value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1U) + bit;
+        }
+        else
+        {
+            root >>= 1U;
+        }
+
+        bit >>= 2U;
+    }
+
+    return root;
+}
+
+static uint16_t saturate_u16 (const uint32_t value)
+{
+    return (value > UINT16_MAX) ? UINT16_MAX : (uint16_t) value;
+}
+
+static int16_t saturate_i16 (const int32_t value)
+{
+    int16_t result = (int16_t) value;
+
+    if (value > INT16_MAX)
+    {
+        result = INT16_MAX;
+    }
+    else if (value < INT16_MIN)
+    {
+        result = INT16_MIN;
+    }
+    else
+    {
+        // Value fits.
+    }
+
+    return result;
+}
+
+static bool count_is_valid (const size_t count)
+{
+    return (count >= 4U) && (count <= APP_VIBRATION_WINDOW_MAX)
+           && (0U == (count & (count - 1U)));
+}
+
+rd_status_t app_vibration_features_calculate (const int16_t * const samples,
+        const size_t count, const uint16_t rate_hz,
+        app_vibration_features_t * const features)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == samples) || (NULL == features))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!count_is_valid (count))
+    {
+        err_code |= RD_ERROR_INVALID_LENGTH;
+    }
+    else
+    {
+        int16_t re[APP_VIBRATION_WINDOW_MAX];
+        int16_t im[APP_VIBRATION_WINDOW_MAX] = {0};
+        int32_t sum = 0;
+        uint64_t square_sum = 0U;
+        uint32_t peak = 0U;
+
+        for (size_t ii = 0U; ii < count; ii++)
+        {
+            sum += samples[ii];
+        }
+
+        const int32_t mean = sum / (int32_t) count;
+
+        for (size_t ii = 0U; ii < count; ii++)
+        {
+            const int32_t deviation = samples[ii] - mean;
+            const uint32_t magnitude = (uint32_t) labs (deviation);
+            peak = (magnitude > peak) ? magnitude : peak;
+            square_sum += (uint64_t) ( (int64_t) deviation * deviation);
+            re[ii] = saturate_i16 (deviation);
+        }
+
+        const uint32_t rms = isqrt ( (uint32_t) (square_sum / count));
+        features->rms_mg = saturate_u16 (rms);
+        features->peak_mg = saturate_u16 (peak);
+        features->crest_x10 = (0U == rms) ? 0U :
+                              saturate_u16 ( ( (peak * 10U) + (rms / 2U)) / rms);
+        vibration_fft (re, im, count);
+        uint32_t strongest = 0U;
+        size_t strongest_bin = 0U;
+
+        // Bin 0 is the removed mean, stop at Nyquist.
+        for (size_t ii = 1U; ii <= (count / 2U); ii++)
+        {
+            const uint32_t power = (uint32_t) ( (int32_t) re[ii] * re[ii])
+                                   + (uint32_t) ( (int32_t) im[ii] * im[ii]);
+
+            if (power > strongest)
+            {
+                strongest = power;
+                strongest_bin = ii;
+            }
+        }
+
+        features->dominant_dhz = saturate_u16 ( (uint32_t) ( (strongest_bin * rate_hz
+                                                * DHZ_PER_HZ) / count));
+    }
+
+    return err_code;
+}
+
+/** @brief Calculate features over latest count samples of window and restart it. */
+static void window_complete (const size_t count)
+{
+    for (size_t ii = 0U; ii < APP_VIBRATION_AXIS_COUNT; ii++)
+    {
+        (void) app_vibration_features_calculate (&m_window[ii][m_window_count - count],
+                count, APP_VIBRATION_SAMPLERATE_HZ, &m_features[ii]);
+    }
+
+    m_features_valid = true;
+    m_window_count = 0U;
+}
+
+/**
+ * @brief Complete window with samples drained after FIFO overflow.
+ *
+ * Window longer than FIFO can't be filled if FIFO overflows between every
+ * drain, so features are calculated over the latest continuous samples,
+ * rounded down to a power of two.
+ */
+static void window_overflow_complete (void)
+{
+    size_t count = APP_VIBRATION_WINDOW;
+
+    while (count > m_window_count)
+    {
+        count >>= 1U;
+    }
+
+    if (4U <= count)
+    {
+        window_complete (count);
+    }
+}
+
+TESTABLE_STATIC void vibration_push (const int16_t x_mg, const int16_t y_mg,
+                                     const int16_t z_mg)
+{
+    m_window[APP_VIBRATION_AXIS_X][m_window_count] = x_mg;
+    m_window[APP_VIBRATION_AXIS_Y][m_window_count] = y_mg;
+    m_window[APP_VIBRATION_AXIS_Z][m_window_count] = z_mg;
+    m_window_count++;
+
+    if (APP_VIBRATION_WINDOW <= m_window_count)
+    {
+        window_complete (APP_VIBRATION_WINDOW);
+    }
+}
+
+static int16_t g_to_mg (const float value_g)
+{
+    return saturate_i16 ( (int32_t) lrintf (value_g * MG_PER_G));
+}
+
+rd_status_t app_vibration_init (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    rd_sensor_t * const provider = app_sensor_find_provider (m_acceleration);
+    m_provider = NULL;
+    m_window_count = 0U;
+    m_features_valid = false;
+
+    if ( (NULL == provider) || (NULL == provider->fifo_enable)
+            || (NULL == provider->fifo_read))
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+    else
+    {
+        for (size_t ii = 0U; ii < VIBRATION_FIFO_DEPTH; ii++)
+        {
+            m_fifo[ii].fields = m_acceleration;
+            m_fifo[ii].data = m_fifo_values[ii];
+        }
+
+        err_code |= provider->fifo_enable (true);
+
+        if (RD_SUCCESS == err_code)
+        {
+            m_provider = provider;
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t app_vibration_sample (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    size_t num_samples = VIBRATION_FIFO_DEPTH;
+    bool overflow = false;
+
+    if (NULL == m_provider)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        for (size_t ii = 0U; ii < VIBRATION_FIFO_DEPTH; ii++)
+        {
+            m_fifo[ii].valid.bitfield = 0U;
+        }
+
+        err_code |= m_provider->fifo_read (&num_samples, m_fifo);
+    }
+
+    if (RD_SUCCESS == err_code)
+    {
+        // Samples were dropped by full FIFO, window would not be continuous.
+        if (VIBRATION_FIFO_DEPTH <= num_samples)
+        {
+            m_window_count = 0U;
+            overflow = true;
+        }
+
+        for (size_t ii = 0U; (ii < num_samples) && (ii < VIBRATION_FIFO_DEPTH); ii++)
+        {
+            const float x = rd_sensor_data_parse (&m_fifo[ii], RD_SENSOR_ACC_X_FIELD);
+            const float y = rd_sensor_data_parse (&m_fifo[ii], RD_SENSOR_ACC_Y_FIELD);
+            const float z = rd_sensor_data_parse (&m_fifo[ii], RD_SENSOR_ACC_Z_FIELD);
+
+            if (!isnan (x) && !isnan (y) && !isnan (z))
+            {
+                vibration_push (g_to_mg (x), g_to_mg (y), g_to_mg (z));
+#if APP_MOTION_ENABLED
+                // FIFO rate is needed to catch free-fall.
+                app_motion_sample_push (x, y, z);
+#endif
+#if APP_ACC_CALIBRATION_ENABLED
+                // Noise floor of mounting is learned at FIFO rate.
+                app_acc_calibration_sample_push (x, y, z);
+#endif
+            }
+        }
+
+        if (overflow && (APP_VIBRATION_WINDOW > VIBRATION_FIFO_DEPTH))
+        {
+            window_overflow_complete();
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t app_vibration_features_get (const app_vibration_axis_t axis,
+                                        app_vibration_features_t * const features)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == features)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (APP_VIBRATION_AXIS_COUNT <= axis)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (!m_features_valid)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        *features = m_features[axis];
+    }
+
+    return err_code;
+}
+
+rd_status_t app_vibration_loudest_get (app_vibration_features_t * const features)
+{
+    size_t loudest = APP_VIBRATION_AXIS_X;
+
+    for (size_t ii = 1U; ii < APP_VIBRATION_AXIS_COUNT; ii++)
+    {
+        if (m_features[ii].rms_mg > m_features[loudest].rms_mg)
+        {
+            loudest = ii;
+        }
+    }
+
+    return app_vibration_features_get ( (app_vibration_axis_t) loudest, features);
+}
+
+#ifdef CEEDLING
+void app_vibration_reset (void)
+{
+    m_provider = NULL;
+    m_window_count = 0U;
+    m_features_valid = false;
+    memset (m_features, 0, sizeof (m_features));
+}
+#endif
+
+/** @} */
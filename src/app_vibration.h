@@ -0,0 +1,148 @@
+#ifndef APP_VIBRATION_H
+#define APP_VIBRATION_H
+/**
+ * @addtogroup app
+ */
+/** @{ */
+/**
+ * @defgroup app_vibration Vibration features
+ * @brief Summarize accelerometer FIFO samples into a few features per window.
+ */
+/** @} */
+/**
+ * @addtogroup app_vibration
+ */
+/** @{ */
+/**
+ * @file app_vibration.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Accelerometer is run with FIFO enabled and the FIFO is drained on every
+ * heartbeat. Samples are collected into a window of APP_VIBRATION_WINDOW
+ * samples per axis. When the window is full, RMS, peak and crest factor
+ * of the signal with mean removed and the dominant frequency of a
+ * fixed-point FFT are calculated for each axis.
+ *
+ * Single XYZ sample per heartbeat tells very little about a vibrating
+ * machine, so features of the axis with largest RMS are published in
+ * @ref app_dataformat_ext. Raw acceleration of other formats is not changed.
+ *
+ * Typical usage:
+ * @code{.c}
+ * err_code |= app_vibration_init();
+ * // On heartbeat.
+ * err_code |= app_vibration_sample();
+ * // In data format encoder.
+ * err_code |= app_vibration_loudest_get (&features);
+ * @endcode
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Largest supported window, size of the FFT twiddle table. */
+#define APP_VIBRATION_WINDOW_MAX (64U)
+
+#if ((APP_VIBRATION_WINDOW) < 4U) || ((APP_VIBRATION_WINDOW) > APP_VIBRATION_WINDOW_MAX) \
+    || (((APP_VIBRATION_WINDOW) & ((APP_VIBRATION_WINDOW) - 1U)) != 0U)
+#   error "APP_VIBRATION_WINDOW must be a power of two between 4 and 64."
+#endif
+
+/** @brief Accelerometer axes. */
+typedef enum
+{
+    APP_VIBRATION_AXIS_X = 0,
+    APP_VIBRATION_AXIS_Y,
+    APP_VIBRATION_AXIS_Z,
+    APP_VIBRATION_AXIS_COUNT
+} app_vibration_axis_t;
+
+/** @brief Features of one axis over one window. */
+typedef struct
+{
+    uint16_t rms_mg;         //!< RMS of samples with mean removed.
+    uint16_t peak_mg;        //!< Largest absolute deviation from mean.
+    uint16_t crest_x10;      //!< Crest factor, peak / RMS, in 0.1 units.
+    uint16_t dominant_dhz;   //!< Centre of strongest non-DC FFT bin, 0.1 Hz.
+} app_vibration_features_t;
+
+/**
+ * @brief Calculate features of one axis.
+ *
+ * @param[in] samples Samples in mg. Not modified.
+ * @param[in] count Number of samples, power of two between 4 and
+ *                  APP_VIBRATION_WINDOW_MAX.
+ * @param[in] rate_hz Sample rate of samples.
+ * @param[out] features Calculated features.
+ *
+ * @retval RD_SUCCESS Features were calculated.
+ * @retval RD_ERROR_NULL Samples or features was NULL.
+ * @retval RD_ERROR_INVALID_LENGTH Count is not supported.
+ */
+rd_status_t app_vibration_features_calculate (const int16_t * const samples,
+        const size_t count, const uint16_t rate_hz,
+        app_vibration_features_t * const features);
+
+/**
+ * @brief Enable FIFO of accelerometer and clear the window.
+ *
+ * @retval RD_SUCCESS FIFO was enabled.
+ * @retval RD_ERROR_NOT_SUPPORTED No initialized accelerometer with FIFO.
+ * @return Error code from sensor driver.
+ */
+rd_status_t app_vibration_init (void);
+
+/**
+ * @brief Drain accelerometer FIFO into window.
+ *
+ * Features are updated when window fills. If FIFO was full, older samples were
+ * lost and the partial window is discarded to keep the window continuous.
+ * If window is longer than FIFO, features are then calculated over the
+ * drained samples so that a tag which overflows FIFO on every heartbeat
+ * still publishes features.
+ *
+ * @retval RD_SUCCESS FIFO was read.
+ * @retval RD_ERROR_INVALID_STATE Module is not initialized.
+ * @return Error code from sensor driver.
+ */
+rd_status_t app_vibration_sample (void);
+
+/**
+ * @brief Get latest features of an axis.
+ *
+ * @param[in] axis Axis to get.
+ * @param[out] features Features of latest full window.
+ *
+ * @retval RD_SUCCESS Features were copied.
+ * @retval RD_ERROR_NULL Features was NULL.
+ * @retval RD_ERROR_INVALID_PARAM Axis is out of range.
+ * @retval RD_ERROR_INVALID_STATE No window has been completed yet.
+ */
+rd_status_t app_vibration_features_get (const app_vibration_axis_t axis,
+                                        app_vibration_features_t * const features);
+
+/**
+ * @brief Get latest features of the axis with largest RMS.
+ *
+ * @param[out] features Features of latest full window.
+ *
+ * @retval RD_SUCCESS Features were copied.
+ * @retval RD_ERROR_NULL Features was NULL.
+ * @retval RD_ERROR_INVALID_STATE No window has been completed yet.
+ */
+rd_status_t app_vibration_loudest_get (app_vibration_features_t * const features);
+
+#ifdef CEEDLING
+void vibration_fft (int16_t * const re, int16_t * const im, const size_t count);
+void vibration_push (const int16_t x_mg, const int16_t y_mg, const int16_t z_mg);
+void app_vibration_reset (void);
+#endif
+
+/** @} */
+#endif // APP_VIBRATION_H
@@ -38,6 +38,147 @@
 #   define APP_HEARTBEAT_OVERDUE_INTERVAL_MS (5U * 60U * 1000U)
 #endif
 
+/** @brief Minimum interval of heartbeats triggered by sensor events. */
+#ifndef APP_HEARTBEAT_REFRESH_INTERVAL_MIN_MS
+#   define APP_HEARTBEAT_REFRESH_INTERVAL_MIN_MS (1000U)
+#endif
+
+/**
+ * @brief Lengthen heartbeat interval while readings are stable and there is no motion.
+ *
+ * Interval doubles after APP_HEARTBEAT_ADAPTIVE_STABLE_COUNT stable heartbeats
+ * up to APP_HEARTBEAT_INTERVAL_MAX_MS. Change larger than given delta on
+ * any environmental reading or a motion event returns to
+ * APP_HEARTBEAT_INTERVAL_MIN_MS.
+ */
+#ifndef APP_HEARTBEAT_ADAPTIVE_ENABLED
+#   define APP_HEARTBEAT_ADAPTIVE_ENABLED (0U)
+#endif
+#ifndef APP_HEARTBEAT_INTERVAL_MIN_MS
+#   define APP_HEARTBEAT_INTERVAL_MIN_MS APP_HEARTBEAT_INTERVAL_MS
+#endif
+#ifndef APP_HEARTBEAT_INTERVAL_MAX_MS
+#   define APP_HEARTBEAT_INTERVAL_MAX_MS (APP_HEARTBEAT_INTERVAL_MIN_MS * 8U)
+#endif
+#ifndef APP_HEARTBEAT_ADAPTIVE_STABLE_COUNT
+#   define APP_HEARTBEAT_ADAPTIVE_STABLE_COUNT (3U)
+#endif
+#ifndef APP_HEARTBEAT_ADAPTIVE_TEMPERATURE_DELTA
+#   define APP_HEARTBEAT_ADAPTIVE_TEMPERATURE_DELTA (0.2F) //!< C
+#endif
+#ifndef APP_HEARTBEAT_ADAPTIVE_HUMIDITY_DELTA
+#   define APP_HEARTBEAT_ADAPTIVE_HUMIDITY_DELTA (1.0F) //!< RH-%
+#endif
+#ifndef APP_HEARTBEAT_ADAPTIVE_PRESSURE_DELTA
+#   define APP_HEARTBEAT_ADAPTIVE_PRESSURE_DELTA (20.0F) //!< Pa
+#endif
+
+/**
+ * @brief Update radio only when measured data changes.
+ *
+ * Advertisement is repeated until next update instead of configured repeat
+ * count. Change is detected from the inputs of the data formats, not from
+ * encoded payloads. If inputs do not change, payloads are re-encoded and
+ * advertisement, GATT and NFC are updated every
+ * APP_HEARTBEAT_UNCHANGED_REFRESH_MS, so sequence counters and rotation of
+ * data formats advance only then and listeners know the tag is alive.
+ */
+#ifndef APP_HEARTBEAT_CHANGE_DETECTION_ENABLED
+#   define APP_HEARTBEAT_CHANGE_DETECTION_ENABLED (0U)
+#endif
+#ifndef APP_HEARTBEAT_UNCHANGED_REFRESH_MS
+#   define APP_HEARTBEAT_UNCHANGED_REFRESH_MS (60U * 1000U)
+#endif
+
+/**
+ * @brief Send GATT heartbeats only to subscribed client.
+ *
+ * Heartbeat runs at APP_HEARTBEAT_LIVE_INTERVAL_MS while a GATT client is
+ * subscribed. NFC is updated on every heartbeat while a reader is in field
+ * and every APP_HEARTBEAT_NFC_IDLE_INTERVAL_MS otherwise.
+ */
+#ifndef APP_HEARTBEAT_SUBSCRIBED_ONLY_ENABLED
+#   define APP_HEARTBEAT_SUBSCRIBED_ONLY_ENABLED (0U)
+#endif
+#ifndef APP_HEARTBEAT_LIVE_INTERVAL_MS
+#   define APP_HEARTBEAT_LIVE_INTERVAL_MS (1000U)
+#endif
+#ifndef APP_HEARTBEAT_NFC_IDLE_INTERVAL_MS
+#   define APP_HEARTBEAT_NFC_IDLE_INTERVAL_MS (60U * 1000U)
+#endif
+
+/**
+ * @brief Spread transmissions of co-located tags.
+ *
+ * Advertising interval is lengthened by an offset of up to
+ * APP_ADV_INTERVAL_OFFSET_MAX_MS derived from radio address. Each heartbeat
+ * is delayed from its nominal time by a random jitter of up to
+ * APP_HEARTBEAT_JITTER_MAX_MS, 0 disables the jitter. Jitter does not
+ * accumulate, average heartbeat interval stays at the configured interval.
+ */
+#ifndef APP_ADV_INTERVAL_OFFSET_ENABLED
+#   define APP_ADV_INTERVAL_OFFSET_ENABLED (0U)
+#endif
+#ifndef APP_ADV_INTERVAL_OFFSET_MAX_MS
+#   define APP_ADV_INTERVAL_OFFSET_MAX_MS (20U)
+#endif
+#ifndef APP_HEARTBEAT_JITTER_MAX_MS
+#   define APP_HEARTBEAT_JITTER_MAX_MS (0U)
+#endif
+
+/**
+ * @brief Run heartbeat from periodic task table instead of a single timer.
+ *
+ * Sensors are sampled and data encoded at heartbeat interval, advertisement
+ * is refreshed from encoded data every APP_TASKS_ADVERTISE_INTERVAL_MS.
+ * Tasks due within APP_TASKS_COALESCE_MS of each other run on same wakeup.
+ */
+#ifndef APP_TASKS_ENABLED
+#   define APP_TASKS_ENABLED (0U)
+#endif
+#ifndef APP_TASKS_MAX
+#   define APP_TASKS_MAX (4U)
+#endif
+#ifndef APP_TASKS_COALESCE_MS
+#   define APP_TASKS_COALESCE_MS (50U)
+#endif
+#ifndef APP_TASKS_ADVERTISE_INTERVAL_MS
+#   define APP_TASKS_ADVERTISE_INTERVAL_MS APP_BLE_INTERVAL_MS
+#endif
+
+/**
+ * @brief Read environmental sensors several times per heartbeat.
+ *
+ * Heartbeat reads sensors APP_OVERSAMPLE_COUNT times back to back, powering
+ * gated sensors once and taking a single sample before each read, and
+ * advertises the mean of the reads. Minimum and maximum are available to data
+ * formats.
+ */
+#ifndef APP_OVERSAMPLE_ENABLED
+#   define APP_OVERSAMPLE_ENABLED (0U)
+#endif
+#ifndef APP_OVERSAMPLE_COUNT
+#   define APP_OVERSAMPLE_COUNT (4U) //!< Reads per heartbeat, including heartbeat.
+#endif
+
+/**
+ * @brief Run heartbeat in the idle window after a radio event.
+ *
+ * Sensor reads, flash writes and ADC conversions are delayed until the radio
+ * has finished TX, or until APP_RADIO_IDLE_TIMEOUT_MS has passed without radio
+ * activity. Disabled by default, as heartbeat may then be delayed by up to
+ * APP_RADIO_IDLE_TIMEOUT_MS.
+ */
+#ifndef APP_RADIO_SYNC_ENABLED
+#   define APP_RADIO_SYNC_ENABLED (0U)
+#endif
+#ifndef APP_RADIO_IDLE_TIMEOUT_MS
+#   define APP_RADIO_IDLE_TIMEOUT_MS (APP_BLE_INTERVAL_MS + 100U)
+#endif
+#ifndef APP_RADIO_IDLE_QUEUE_SIZE
+#   define APP_RADIO_IDLE_QUEUE_SIZE (4U) //!< Jobs waiting for idle window.
+#endif
+
 /** @brief If watchdog is not fed at this interval or faster, reboot */
 #ifndef APP_WDT_INTERVAL_MS
 #   define APP_WDT_INTERVAL_MS (APP_HEARTBEAT_OVERDUE_INTERVAL_MS + (1U*60U*1000U))
@@ -271,13 +412,17 @@
 #   define APP_SENSOR_STHS34PF80_RESOLUTION RD_SENSOR_CFG_DEFAULT //!< Only default supported
 #endif
 #ifndef APP_SENSOR_STHS34PF80_SAMPLERATE
-/** @note Presence/motion flags may be missed if polled slower than sensor ODR.
- *        Consider using interrupt-driven detection for reliable event capture. */
+/** @note Presence/motion flags may be missed if polled slower than sensor ODR
+ *        on boards which do not route sensor interrupt to MCU. */
 #   define APP_SENSOR_STHS34PF80_SAMPLERATE RD_SENSOR_CFG_CUSTOM_2 //!< 0.5 Hz (CUSTOM_2)
 #endif
 #ifndef APP_SENSOR_STHS34PF80_SCALE
 #   define APP_SENSOR_STHS34PF80_SCALE RD_SENSOR_CFG_DEFAULT //!< Only default is valid
 #endif
+#ifndef APP_SENSOR_STHS34PF80_PRESENCE_THRESHOLD
+/** @note Raw presence value of sensor, not a physical unit. Lower is more sensitive. */
+#   define APP_SENSOR_STHS34PF80_PRESENCE_THRESHOLD (200.0F) //!< Interrupt level.
+#endif
 #ifndef SHTS_DEBUG_DATA_IN_ACCELERATION
 #   define SHTS_DEBUG_DATA_IN_ACCELERATION (0U) //!< Enable to log raw data in acceleration format for easier debugging.
 #endif
@@ -287,6 +432,267 @@
 #   define RI_STHS34PF80_ENABLED APP_SENSOR_STHS34PF80_ENABLED
 #endif
 
+/**
+ * @brief Filter sensor samples in software before encoding and logging.
+ *
+ * Filters are configured per field, see app_dsp.h for filter types.
+ * Parameter is window length for moving average and median, divisor for IIR.
+ * Outlier limit is maximum accepted step from filtered value, 0 disables.
+ */
+#ifndef APP_SENSOR_DSP_ENABLED
+#   define APP_SENSOR_DSP_ENABLED (0U)
+#endif
+#ifndef APP_DSP_TEMPERATURE_FILTER
+#   define APP_DSP_TEMPERATURE_FILTER APP_DSP_FILTER_NONE
+#endif
+#ifndef APP_DSP_TEMPERATURE_PARAM
+#   define APP_DSP_TEMPERATURE_PARAM (1U)
+#endif
+#ifndef APP_DSP_TEMPERATURE_OUTLIER
+#   define APP_DSP_TEMPERATURE_OUTLIER (0.0F) //!< C
+#endif
+#ifndef APP_DSP_HUMIDITY_FILTER
+#   define APP_DSP_HUMIDITY_FILTER APP_DSP_FILTER_NONE
+#endif
+#ifndef APP_DSP_HUMIDITY_PARAM
+#   define APP_DSP_HUMIDITY_PARAM (1U)
+#endif
+#ifndef APP_DSP_HUMIDITY_OUTLIER
+#   define APP_DSP_HUMIDITY_OUTLIER (0.0F) //!< RH-%
+#endif
+#ifndef APP_DSP_PRESSURE_FILTER
+#   define APP_DSP_PRESSURE_FILTER APP_DSP_FILTER_NONE
+#endif
+#ifndef APP_DSP_PRESSURE_PARAM
+#   define APP_DSP_PRESSURE_PARAM (1U)
+#endif
+#ifndef APP_DSP_PRESSURE_OUTLIER
+#   define APP_DSP_PRESSURE_OUTLIER (0.0F) //!< Pa
+#endif
+#ifndef APP_DSP_ACC_FILTER
+#   define APP_DSP_ACC_FILTER APP_DSP_FILTER_NONE
+#endif
+#ifndef APP_DSP_ACC_PARAM
+#   define APP_DSP_ACC_PARAM (1U)
+#endif
+#ifndef APP_DSP_ACC_OUTLIER
+#   define APP_DSP_ACC_OUTLIER (0.0F) //!< G
+#endif
+
+/**
+ * @brief Power off sensors which have a power pin between samples.
+ *
+ * Sensors are powered up and re-initialized from configuration cached in RAM
+ * before next sample. Accelerometer stays powered while activity interrupt or
+ * vibration features are used.
+ */
+#ifndef APP_SENSOR_POWER_GATING_ENABLED
+#   define APP_SENSOR_POWER_GATING_ENABLED (0U)
+#endif
+
+/**
+ * @brief Battery model.
+ *
+ * TX current is the average supply current at the end of radio TX,
+ * cutoff voltage is the lowest voltage at which all sensors and MCU work.
+ */
+#ifndef APP_BATTERY_TX_CURRENT_A
+#   define APP_BATTERY_TX_CURRENT_A (0.008F)
+#endif
+#ifndef APP_BATTERY_CUTOFF_V
+#   define APP_BATTERY_CUTOFF_V (2.0F)
+#endif
+#ifndef APP_BATTERY_FILTER_DIVISOR
+#   define APP_BATTERY_FILTER_DIVISOR (8.0F) //!< IIR divisor of battery estimates.
+#endif
+// Worst droop decays with a time constant of this many pairs, hours at default rate.
+#ifndef APP_BATTERY_DROOP_DECAY_DIVISOR
+#   define APP_BATTERY_DROOP_DECAY_DIVISOR (256.0F)
+#endif
+// Rest sample is taken in radio idle window, sample under load at next TX.
+#ifndef APP_BATTERY_PAIR_WINDOW_MS
+#   define APP_BATTERY_PAIR_WINDOW_MS (APP_RADIO_IDLE_TIMEOUT_MS) //!< Max pair spread.
+#endif
+#ifndef APP_BATTERY_TREND_PERIOD_MS
+#   define APP_BATTERY_TREND_PERIOD_MS (6ULL * 60ULL * 60ULL * 1000ULL)
+#endif
+
+/**
+ * @brief Publish vibration features of accelerometer FIFO in extended data format.
+ *
+ * Window must be a power of two. Sample rate must match accelerometer sample rate.
+ */
+#ifndef APP_VIBRATION_ENABLED
+#   define APP_VIBRATION_ENABLED (0U)
+#endif
+#ifndef APP_VIBRATION_WINDOW
+#   define APP_VIBRATION_WINDOW (32U) //!< Samples per axis.
+#endif
+#ifndef APP_VIBRATION_SAMPLERATE_HZ
+#   define APP_VIBRATION_SAMPLERATE_HZ APP_SENSOR_LIS2DH12_SAMPLERATE
+#endif
+
+/**
+ * @brief Classify acceleration into still, moving, vibrating, tilted and dropped.
+ *
+ * Classified state is reported as motion and counts movement events instead
+ * of accelerometer activity interrupts. Vibrating state needs accelerometer
+ * FIFO of APP_VIBRATION_ENABLED, a single read per heartbeat is never vibrating.
+ */
+#ifndef APP_MOTION_ENABLED
+#   define APP_MOTION_ENABLED (0U)
+#endif
+#ifndef APP_MOTION_FREEFALL_G
+#   define APP_MOTION_FREEFALL_G (0.35F) //!< Magnitude below which tag is falling.
+#endif
+#ifndef APP_MOTION_MOVING_G
+#   define APP_MOTION_MOVING_G (0.10F) //!< Change of mean between periods.
+#endif
+#ifndef APP_MOTION_VIBRATION_G
+#   define APP_MOTION_VIBRATION_G (0.05F) //!< Standard deviation of magnitude.
+#endif
+#ifndef APP_MOTION_TILT_DEG
+#   define APP_MOTION_TILT_DEG (30.0F) //!< Angle from reference orientation.
+#endif
+#ifndef APP_MOTION_FACE_G
+#   define APP_MOTION_FACE_G (0.7F) //!< Gravity on axis to detect face up.
+#endif
+
+/**
+ * @brief Learn accelerometer activity threshold from noise floor.
+ *
+ * Threshold is multiplier times standard deviation of the noisiest axis over
+ * learning period, limited to min and max. Learned threshold is stored to flash
+ * and replaces APP_MOTION_THRESHOLD on following boots. Samples come from
+ * accelerometer FIFO of APP_VIBRATION_ENABLED. Writing to
+ * APP_ENDPOINT_ACC_CALIBRATION with configuration unlocked learns it again.
+ */
+#ifndef APP_ACC_CALIBRATION_ENABLED
+#   define APP_ACC_CALIBRATION_ENABLED (0U)
+#endif
+#ifndef APP_ACC_CALIBRATION_MULTIPLIER
+#   define APP_ACC_CALIBRATION_MULTIPLIER (4.0F)
+#endif
+#ifndef APP_ACC_CALIBRATION_MIN_G
+#   define APP_ACC_CALIBRATION_MIN_G (0.016F)
+#endif
+#ifndef APP_ACC_CALIBRATION_MAX_G
+#   define APP_ACC_CALIBRATION_MAX_G (0.5F)
+#endif
+#ifndef APP_ACC_CALIBRATION_PERIOD_MS
+#   define APP_ACC_CALIBRATION_PERIOD_MS (10U * 60U * 1000U)
+#endif
+#ifndef APP_ACC_CALIBRATION_MIN_SAMPLES
+#   define APP_ACC_CALIBRATION_MIN_SAMPLES (256U) //!< FIFO samples.
+#endif
+/** @brief Endpoint of threshold calibration, not allocated in ruuvi.endpoints. */
+#ifndef APP_ENDPOINT_ACC_CALIBRATION
+#   define APP_ENDPOINT_ACC_CALIBRATION (0xD4U)
+#endif
+
+/**
+ * @brief Time sensor initialization, configuration and reads.
+ *
+ * Per-sensor call counts, durations and errors are readable at
+ * APP_ENDPOINT_SENSOR_STATS.
+ */
+#ifndef APP_SENSOR_STATS_ENABLED
+#   if defined(RUUVI_RUN_TESTS)
+#       define APP_SENSOR_STATS_ENABLED (1U)
+#   else
+#       define APP_SENSOR_STATS_ENABLED (0U)
+#   endif
+#endif
+/** @brief Endpoint of sensor statistics, not allocated in ruuvi.endpoints. */
+#ifndef APP_ENDPOINT_SENSOR_STATS
+#   define APP_ENDPOINT_SENSOR_STATS (0xD0U)
+#endif
+
+/**
+ * @brief Profile awake time of heartbeat stages.
+ *
+ * Per-stage histograms and worst case are readable at
+ * APP_ENDPOINT_HEARTBEAT_PROFILE and printed to log by debug builds every
+ * APP_PROFILE_PRINT_INTERVAL heartbeats.
+ */
+#ifndef APP_PROFILE_ENABLED
+#   if DEBUG
+#       define APP_PROFILE_ENABLED (1U)
+#   else
+#       define APP_PROFILE_ENABLED (0U)
+#   endif
+#endif
+#ifndef APP_PROFILE_PRINT_INTERVAL
+#   define APP_PROFILE_PRINT_INTERVAL (60U)
+#endif
+/** @brief Endpoint of heartbeat profile, not allocated in ruuvi.endpoints. */
+#ifndef APP_ENDPOINT_HEARTBEAT_PROFILE
+#   define APP_ENDPOINT_HEARTBEAT_PROFILE (0xD1U)
+#endif
+
+/**
+ * @brief Endpoint to provision keys of encrypted data formats 8 and FA.
+ *
+ * Keys are written in chunks on a connection with configuration unlocked
+ * and stored to flash, compile-time APP_8_KEY and APP_FA_KEY are used until then.
+ */
+#ifndef APP_ENDPOINT_DATAFORMAT_KEY
+#   define APP_ENDPOINT_DATAFORMAT_KEY (0xD2U)
+#endif
+
+/**
+ * @brief Send extended data format in place of legacy formats.
+ *
+ * Requires S140 and ruuvi.drivers.c built with extended advertising, so that
+ * RI_COMM_MESSAGE_MAX_LENGTH fits APP_DF_EXT_DATA_LENGTH. Application has no
+ * control over PDU type or PHY, these come from the driver build. Extended data
+ * format then replaces rotation of legacy formats, which default to weight 0.
+ */
+#ifndef APP_ADV_EXTENDED_ENABLED
+#   define APP_ADV_EXTENDED_ENABLED (0U)
+#endif
+#if APP_ADV_EXTENDED_ENABLED
+#   define APP_DF_LEGACY_WEIGHT (0U)
+#else
+#   define APP_DF_LEGACY_WEIGHT (1U)
+#endif
+
+/**
+ * @brief Default share of advertisements of each data format.
+ *
+ * A format is sent this many times in a row before rotating to next enabled
+ * format, 0 leaves format out of rotation while other formats are enabled.
+ * Weights can be changed at runtime at APP_ENDPOINT_DATAFORMAT_WEIGHTS.
+ */
+#ifndef APP_DF_3_WEIGHT
+#   define APP_DF_3_WEIGHT APP_DF_LEGACY_WEIGHT
+#endif
+#ifndef APP_DF_5_WEIGHT
+#   define APP_DF_5_WEIGHT APP_DF_LEGACY_WEIGHT
+#endif
+#ifndef APP_DF_7_WEIGHT
+#   define APP_DF_7_WEIGHT APP_DF_LEGACY_WEIGHT
+#endif
+#ifndef APP_DF_8_WEIGHT
+#   define APP_DF_8_WEIGHT APP_DF_LEGACY_WEIGHT
+#endif
+#ifndef APP_DF_C5_WEIGHT
+#   define APP_DF_C5_WEIGHT APP_DF_LEGACY_WEIGHT
+#endif
+#ifndef APP_DF_FA_WEIGHT
+#   define APP_DF_FA_WEIGHT APP_DF_LEGACY_WEIGHT
+#endif
+#ifndef APP_DF_HISTORY_WEIGHT
+#   define APP_DF_HISTORY_WEIGHT APP_DF_LEGACY_WEIGHT
+#endif
+#ifndef APP_DF_EXT_WEIGHT
+#   define APP_DF_EXT_WEIGHT (1U)
+#endif
+/** @brief Endpoint of data format weights, not allocated in ruuvi.endpoints. */
+#ifndef APP_ENDPOINT_DATAFORMAT_WEIGHTS
+#   define APP_ENDPOINT_DATAFORMAT_WEIGHTS (0xD3U)
+#endif
+
 /** @brief Enable atomic operations */
 #ifndef RI_ATOMIC_ENABLED
 #   define RI_ATOMIC_ENABLED (1U)
@@ -379,12 +785,19 @@
 #define APP_FLASH_SENSOR_SHTCX_RECORD    (0xC3U)
 #define APP_FLASH_SENSOR_TMP117_RECORD   (0x17U)
 #define APP_FLASH_SENSOR_STHS34PF80_RECORD (0xC4U)
+#define APP_FLASH_SENSOR_ACC_THR_RECORD  (0xC5U) //!< Calibrated activity threshold.
+
+#define APP_FLASH_DATAFORMAT_FILE          (0xDFU)
+#define APP_FLASH_DATAFORMAT_8_KEY_RECORD  (0x08U) //!< Provisioned key of format 8.
+#define APP_FLASH_DATAFORMAT_FA_KEY_RECORD (0xFAU) //!< Provisioned key of format FA.
+#define APP_FLASH_DATAFORMAT_WEIGHTS_RECORD (0x01U) //!< Rotation weights of formats.
 
 
 
 #define APP_FLASH_LOG_FILE                (0xF0U)
 #define APP_FLASH_LOG_CONFIG_RECORD       (0x01U)
 #define APP_FLASH_LOG_BOOT_COUNTER_RECORD (0xEFU)
+#define APP_FLASH_LOG_SEQUENCE_RECORD     (0xEEU) //!< Log sequence at last stored block.
 #define APP_FLASH_LOG_DATA_RECORD_PREFIX  (0xF0U) //!< Prefix, append with U8 number
 
 
@@ -497,6 +910,25 @@
 #   define RE_FA_ENABLED (0U + ENABLE_ALL_DATAFORMATS)
 #endif
 
+/**
+ * @brief Enable dataformat with history of logged samples.
+ *
+ * Carries deltas of latest logged samples, requires logging to be enabled.
+ */
+#ifndef APP_DF_HISTORY_ENABLED
+#   define APP_DF_HISTORY_ENABLED (0U + ENABLE_ALL_DATAFORMATS)
+#endif
+
+/**
+ * @brief Enable dataformat with all measurements in one payload.
+ *
+ * Enabled with APP_ADV_EXTENDED_ENABLED. Payload does not fit legacy message
+ * length, where encoding fails and heartbeat skips the format.
+ */
+#ifndef APP_DF_EXT_ENABLED
+#   define APP_DF_EXT_ENABLED (APP_ADV_EXTENDED_ENABLED + ENABLE_ALL_DATAFORMATS)
+#endif
+
 /**
  * @brief Enable Ruuvi AES interface.
  *
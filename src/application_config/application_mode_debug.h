@@ -19,4 +19,6 @@
 
 #define APP_LOG_INTERVAL_S (1U) //!< Gets limited to heartbeat rate.
 
+#define APP_SENSOR_STATS_ENABLED (1U) //!< Time sensor operations.
+
 #endif // APPLICATION_MODE_DEBUG_H
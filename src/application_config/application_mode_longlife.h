@@ -7,8 +7,12 @@
 
 #define APP_NUM_REPEATS (1U) // ~9 s
 
+#define APP_HEARTBEAT_ADAPTIVE_ENABLED (1U) //!< Up to 8x interval while stable.
+
 #define APP_GATT_ENABLED (0U)
 
+#define APP_SENSOR_POWER_GATING_ENABLED (1U) //!< Power off sensors between heartbeats.
+
 #define RT_FLASH_ENABLED (0U)
 
 #define APP_SENSOR_LIS2DH12_SAMPLERATE (1U) //!< Hz
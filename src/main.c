@@ -10,13 +10,17 @@
  * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
  */
 #include "app_config.h"
+#include "app_acc_calibration.h"
 #include "app_button.h"
 #include "app_comms.h"
 #include "app_heartbeat.h"
 #include "app_led.h"
 #include "app_log.h"
 #include "app_power.h"
+#include "app_radio.h"
 #include "app_sensor.h"
+#include "app_tasks.h"
+#include "app_vibration.h"
 #include "main.h"
 #include "run_integration_tests.h"
 #include "ruuvi_interface_log.h"
@@ -112,10 +116,24 @@ void setup (void)
     err_code |= app_dc_dc_init();
     err_code |= app_sensor_init();
     err_code |= app_log_init();
+#if APP_ACC_CALIBRATION_ENABLED
+    // Use calibrated threshold if there is one, learn it otherwise.
+    err_code |= app_acc_calibration_init (&motion_threshold);
+#endif
     // Allow fail on boards which do not have accelerometer.
     (void) app_sensor_acc_thr_set (&motion_threshold);
+    // Allow fail on boards which do not have presence interrupt.
+    (void) app_sensor_presence_int_set (true);
+#if APP_VIBRATION_ENABLED
+    // Allow fail on boards which do not have accelerometer FIFO.
+    (void) app_vibration_init();
+#endif
+    err_code |= app_radio_init();
     err_code |= app_comms_init (APP_LOCKED_AT_BOOT);
     err_code |= app_sensor_vdd_sample();
+#if APP_TASKS_ENABLED
+    err_code |= app_tasks_init();
+#endif
     err_code |= app_heartbeat_init();
     err_code |= app_heartbeat_start();
 
@@ -29,6 +29,8 @@
 #include "ruuvi_task_gpio.h"
 #include "ruuvi_task_sensor.h"
 
+#include <stdio.h>
+
 /**
  * @addtogroup integration_test
  */
@@ -48,6 +50,7 @@ void app_sensor_ctx_get (rt_sensor_ctx_t *** m_sensors, size_t * num_sensors);
 #endif
 
 #define LOG_PRINT_DELAY_MS (10U)
+#define SENSOR_STATS_READS (10U) //!< Number of reads to time.
 
 void on_integration_test_wdt (void)
 {
@@ -92,6 +95,71 @@ static void integration_test_power (void)
     ri_power_run_integration_test (&LOG, regs);
 }
 
+static void integration_test_sensors_uninit (void)
+{
+    app_sensor_uninit();
+    ri_gpio_interrupt_uninit();
+    ri_gpio_uninit();
+    (void) ri_rtc_uninit();
+    rd_sensor_timestamp_function_set (NULL);
+}
+
+static void integration_test_sensor_op_stats (const size_t sensor_idx,
+        const app_sensor_stats_op_t op, const char * const op_name, const bool last)
+{
+    app_sensor_stats_t stats = {0};
+    char msg[128];
+    (void) app_sensor_stats_get (sensor_idx, op, &stats);
+    const uint64_t mean_ms = (0U == stats.count) ? 0U : (stats.total_ms / stats.count);
+    snprintf (msg, sizeof (msg),
+              "\"%s\": {\"count\": %lu, \"errors\": %lu, \"min_ms\": %lu, "
+              "\"max_ms\": %lu, \"mean_ms\": %lu}%s\r\n",
+              op_name, (unsigned long) stats.count, (unsigned long) stats.errors,
+              (unsigned long) stats.min_ms, (unsigned long) stats.max_ms,
+              (unsigned long) mean_ms, last ? "" : ",");
+    LOG (msg);
+}
+
+/** @brief Time initialization, configuration and reads of application sensors. */
+static void integration_test_sensor_stats (void)
+{
+    rt_sensor_ctx_t ** p_sensors;
+    size_t num_sensors = 0;
+    rd_sensor_data_t data = {0};
+    char msg[64];
+    LOG ("\"sensor_stats\": {\r\n");
+    app_sensor_stats_reset();
+    (void) rt_gpio_init();
+    (void) app_sensor_init();
+    app_sensor_ctx_get (&p_sensors, &num_sensors);
+    data.fields = app_sensor_available_data();
+    float data_values[rd_sensor_data_fieldcount (&data)];
+    data.data = data_values;
+
+    for (size_t ii = 0; ii < SENSOR_STATS_READS; ii++)
+    {
+        data.valid.bitfield = 0;
+        (void) app_sensor_get (&data);
+        ri_watchdog_feed();
+    }
+
+    for (size_t ii = 0; ii < num_sensors; ii++)
+    {
+        const char * const name = p_sensors[ii]->sensor.name;
+        snprintf (msg, sizeof (msg), "\"%u_%s\": {\r\n", (unsigned int) ii,
+                  (NULL != name) ? name : "UNKNOWN");
+        LOG (msg);
+        integration_test_sensor_op_stats (ii, APP_SENSOR_STATS_INIT, "init", false);
+        integration_test_sensor_op_stats (ii, APP_SENSOR_STATS_CONFIGURE, "configure",
+                                          false);
+        integration_test_sensor_op_stats (ii, APP_SENSOR_STATS_READ, "read", true);
+        LOG ( (ii < (num_sensors - 1)) ? "},\r\n" : "}\r\n");
+    }
+
+    integration_test_sensors_uninit();
+    LOG ("},\r\n");
+}
+
 static void integration_test_sensors (void)
 {
     rt_sensor_ctx_t ** p_sensors;
@@ -119,11 +187,7 @@ static void integration_test_sensors (void)
         ri_delay_ms (10);
     }
 
-    app_sensor_uninit();
-    ri_gpio_interrupt_uninit();
-    ri_gpio_uninit();
-    (void) ri_rtc_uninit();
-    rd_sensor_timestamp_function_set (NULL);
+    integration_test_sensors_uninit();
     LOG ("},\r\n");
 }
 
@@ -135,6 +199,7 @@ static void driver_integration_tests_run (void)
     ri_timer_integration_test_run (&LOG);
     ri_scheduler_run_integration_test (&LOG);
     ri_watchdog_feed();
+    integration_test_sensor_stats();
     integration_test_sensors();
     ri_communication_radio_run_integration_test (&LOG);
     ri_communication_ble_advertising_run_integration_test (&LOG, RI_RADIO_BLE_1MBPS);
@@ -0,0 +1,78 @@
+#ifndef APP_DATAFORMATS_H
+#define APP_DATAFORMATS_H
+
+/**
+ * @file app_dataformats.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2021-08-19
+ * @copyright Ruuvi Innovations Ltd, License BSD-3-Clause.
+ *
+ * Helper to encode data into various formats
+ *
+ */
+
+#include "app_config.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_endpoints.h"
+#include "ruuvi_endpoint_3.h"
+#include "ruuvi_endpoint_5.h"
+#include "ruuvi_endpoint_7.h"
+#include "ruuvi_endpoint_8.h"
+#include "ruuvi_endpoint_fa.h"
+/**
+ * Control inclusion of data format flags in transmission.
+ * Default is disabled (0U). Define APP_DATAFORMAT_FLAGS_IN_TX as 1U
+ * in a debug configuration (e.g. via build flags or app_config.h)
+ * to enable.
+ */
+#ifndef APP_DATAFORMAT_FLAGS_IN_TX
+#define APP_DATAFORMAT_FLAGS_IN_TX (0U)
+#endif
+
+typedef enum
+{
+    DF_INVALID = 0U,
+    DF_3       = (1U << 0U),
+    DF_5       = (1U << 1U),
+    DF_7       = (1U << 2U),
+    DF_8       = (1U << 3U),
+    DF_C5      = (1U << 4U),
+    DF_FA      = (1U << 5U)
+} app_dataformat_t;
+
+typedef struct
+{
+    unsigned int formats; //!< Container for enabled data formats
+} app_dataformats_t;
+
+
+/**
+ * @brief Return next dataformat to send
+ *
+ * @param[in] formats Enabled formats
+ * @param[in] state Current state of dataformat picker.
+ * @return    Next dataformat to use in app. DF_INVALID if no formats are enabled.
+ */
+app_dataformat_t app_dataformat_next (const app_dataformats_t formats,
+                                      const app_dataformat_t state);
+
+/**
+ * @brief Encode data into given buffer with given format.
+ *
+ * A call to this function will increment measurement sequence counter
+ * where applicable. Sensors are read to get latest data from board.
+ *
+ * @param[out] output Buffer to which data is encoded.
+ * @param[in,out] output_length Input: Size of output buffer.
+ *                              Output: Size of encoded data.
+ * @param[in] data Pointer to sensor data to encode.
+ * @param[in] format Format to encode data into.
+ *
+ */
+rd_status_t app_dataformat_encode (uint8_t * const output,
+                                   size_t * const output_length,
+                                   const rd_sensor_data_t * const data,
+                                   const app_dataformat_t format);
+
+#endif // APP_DATAFORMATS_H
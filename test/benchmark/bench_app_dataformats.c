@@ -0,0 +1,143 @@
+/**
+ * @file bench_app_dataformats.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Host benchmark of data format encoding, run with "make benchmark".
+ *
+ * "before" runs encoders of test/benchmark/baseline, copied from before
+ * snapshots, where every format parses its fields from sensor data and
+ * queries device state.
+ * "after" fills one snapshot per measurement and encodes all formats from it,
+ * cost of the fill is shown separately as it is paid once per heartbeat.
+ *
+ * Device state and AES are stubbed in bench_stubs.c, so numbers compare
+ * extraction cost rather than absolute encode time on target.
+ */
+#include "app_dataformats.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_interface_communication.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_ROUNDS (100000U)
+#define BENCH_FORMAT_COUNT (6U)
+
+static const struct
+{
+    app_dataformat_t format;
+    const char * name;
+} m_formats[BENCH_FORMAT_COUNT] =
+{
+    { DF_3, "3" }, { DF_5, "5" }, { DF_7, "7" }, { DF_8, "8" }, { DF_C5, "C5" },
+    { DF_FA, "FA" }
+};
+
+/**
+ * @brief Encoder of baseline, before snapshots.
+ *
+ * Built by "make benchmark" from app_dataformats.c of BENCH_BASELINE with
+ * app_dataformat_encode renamed, every format parses its fields from sensor
+ * data and queries device state itself.
+ */
+rd_status_t baseline_dataformat_encode (uint8_t * const output,
+                                        size_t * const output_length,
+                                        const rd_sensor_data_t * const p_data,
+                                        const app_dataformat_t format);
+
+static uint64_t now_ns (void)
+{
+    struct timespec ts;
+    (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ( (uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+/** @brief Sensor data with every field a RuuviTag provides, valid. */
+static void sample_setup (rd_sensor_data_t * const p_data, float * const p_values)
+{
+    const rd_sensor_data_bitfield_t fields[] =
+    {
+        RD_SENSOR_ACC_X_FIELD, RD_SENSOR_ACC_Y_FIELD, RD_SENSOR_ACC_Z_FIELD,
+        RD_SENSOR_HUMI_FIELD, RD_SENSOR_PRES_FIELD, RD_SENSOR_TEMP_FIELD,
+        RD_SENSOR_MOTION_FIELD, RD_SENSOR_PRESENCE_FIELD
+    };
+    const float values[] =
+    {
+        0.004F, -0.004F, 1.036F, 53.5F, 100044.0F, 24.3F, 0.0F, 1.0F
+    };
+    memset (p_data, 0, sizeof (*p_data));
+    p_data->data = p_values;
+
+    for (size_t ii = 0; ii < (sizeof (fields) / sizeof (fields[0])); ii++)
+    {
+        const rd_sensor_data_fields_t field = { .datas = fields[ii] };
+        p_data->fields.bitfield |= field.bitfield;
+    }
+
+    for (size_t ii = 0; ii < (sizeof (fields) / sizeof (fields[0])); ii++)
+    {
+        rd_sensor_data_set (p_data, fields[ii], values[ii]);
+    }
+}
+
+int main (int argc, char ** argv)
+{
+    const uint32_t rounds = (argc > 1) ? (uint32_t) strtoul (argv[1], NULL, 10)
+                            : BENCH_DEFAULT_ROUNDS;
+    float values[16] = {0};
+    rd_sensor_data_t data;
+    app_dataformat_snapshot_t snapshot;
+    uint8_t output[RI_COMM_MESSAGE_MAX_LENGTH];
+    uint64_t start_ns = 0;
+    uint64_t fill_ns = 0;
+    sample_setup (&data, values);
+    start_ns = now_ns();
+
+    for (uint32_t ii = 0; ii < rounds; ii++)
+    {
+        (void) app_dataformat_snapshot_fill (&snapshot, &data);
+    }
+
+    fill_ns = now_ns() - start_ns;
+    printf ("%" PRIu32 " rounds, snapshot fill %.1f ns once per heartbeat\n", rounds,
+            (double) fill_ns / rounds);
+    printf ("%-6s %12s %12s\n", "format", "before ns", "after ns");
+
+    for (size_t ff = 0; ff < BENCH_FORMAT_COUNT; ff++)
+    {
+        uint64_t before_ns = 0;
+        uint64_t after_ns = 0;
+        size_t length = 0;
+        start_ns = now_ns();
+
+        for (uint32_t ii = 0; ii < rounds; ii++)
+        {
+            length = sizeof (output);
+            (void) baseline_dataformat_encode (output, &length, &data,
+                                               m_formats[ff].format);
+        }
+
+        before_ns = now_ns() - start_ns;
+        (void) app_dataformat_snapshot_fill (&snapshot, &data);
+        start_ns = now_ns();
+
+        for (uint32_t ii = 0; ii < rounds; ii++)
+        {
+            length = sizeof (output);
+            (void) app_dataformat_encode (output, &length, &snapshot,
+                                          m_formats[ff].format);
+        }
+
+        after_ns = now_ns() - start_ns;
+        printf ("%-6s %12.1f %12.1f\n", m_formats[ff].name, (double) before_ns / rounds,
+                (double) after_ns / rounds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file bench_decoder.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Host benchmark of batch decoder, run with "make benchmark".
+ *
+ * Records are encoded by firmware encoders from synthetic snapshots, then
+ * decoded over and over as one format at a time and as a mix of all formats
+ * as a gateway would hear them. "batch" decodes a whole batch per call,
+ * "single" one record per call for comparison. Decoded format of every
+ * record must match the format it was encoded in, and temperature must match
+ * snapshot within resolution of format where it is in cleartext.
+ */
+#include "app_dataformat_decoder.h"
+#include "app_dataformats.h"
+#include "ruuvi_driver_error.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_BATCH         (4096U)
+#define BENCH_DEFAULT_ROUNDS (1000U) //!< Batches decoded per run.
+#define BENCH_STRIDE        (APP_DF_DECODER_RECORD_MAX) //!< Record slot.
+
+typedef struct
+{
+    app_dataformat_t format;
+    const char * name;
+} bench_format_t;
+
+static const bench_format_t m_formats[] =
+{
+    { DF_3, "3" }, { DF_5, "5" }, { DF_7, "7" }, { DF_8, "8" }, { DF_C5, "C5" },
+    { DF_FA, "FA" }, { DF_HISTORY, "hist" }, { DF_EXT, "ext" }
+};
+
+#define BENCH_FORMAT_COUNT (sizeof (m_formats) / sizeof (m_formats[0]))
+
+static uint8_t m_raw[BENCH_BATCH][BENCH_STRIDE];
+static uint8_t m_lengths[BENCH_BATCH];
+static app_dataformat_t m_encoded[BENCH_BATCH];
+static float m_encoded_temperature_c[BENCH_BATCH];
+static app_dataformat_t m_format[BENCH_BATCH];
+static float m_temperature_c[BENCH_BATCH];
+static float m_humidity_rh[BENCH_BATCH];
+static float m_pressure_pa[BENCH_BATCH];
+static float m_acceleration_x_g[BENCH_BATCH];
+static float m_acceleration_y_g[BENCH_BATCH];
+static float m_acceleration_z_g[BENCH_BATCH];
+static float m_battery_v[BENCH_BATCH];
+static float m_tx_power_dbm[BENCH_BATCH];
+static float m_battery_resistance_ohm[BENCH_BATCH];
+static float m_battery_remaining_days[BENCH_BATCH];
+static float m_vibration_rms_g[BENCH_BATCH];
+static float m_vibration_peak_g[BENCH_BATCH];
+static float m_vibration_crest[BENCH_BATCH];
+static float m_vibration_hz[BENCH_BATCH];
+static float m_temperature_min_c[BENCH_BATCH];
+static float m_temperature_max_c[BENCH_BATCH];
+static int32_t m_movement_count[BENCH_BATCH];
+static int32_t m_presence_count[BENCH_BATCH];
+static int32_t m_sequence[BENCH_BATCH];
+static uint64_t m_address[BENCH_BATCH];
+static uint8_t m_flags[BENCH_BATCH];
+static int32_t m_log_sequence[BENCH_BATCH];
+static uint16_t m_log_interval_s[BENCH_BATCH];
+static float m_logged_temperature_c[BENCH_BATCH * APP_DF_HISTORY_SAMPLES];
+static float m_logged_humidity_rh[BENCH_BATCH * APP_DF_HISTORY_SAMPLES];
+static float m_logged_pressure_pa[BENCH_BATCH * APP_DF_HISTORY_SAMPLES];
+
+static const app_dataformat_decoded_t m_out =
+{
+    .format = m_format,
+    .temperature_c = m_temperature_c,
+    .humidity_rh = m_humidity_rh,
+    .pressure_pa = m_pressure_pa,
+    .acceleration_x_g = m_acceleration_x_g,
+    .acceleration_y_g = m_acceleration_y_g,
+    .acceleration_z_g = m_acceleration_z_g,
+    .battery_v = m_battery_v,
+    .tx_power_dbm = m_tx_power_dbm,
+    .battery_resistance_ohm = m_battery_resistance_ohm,
+    .battery_remaining_days = m_battery_remaining_days,
+    .vibration_rms_g = m_vibration_rms_g,
+    .vibration_peak_g = m_vibration_peak_g,
+    .vibration_crest = m_vibration_crest,
+    .vibration_hz = m_vibration_hz,
+    .temperature_min_c = m_temperature_min_c,
+    .temperature_max_c = m_temperature_max_c,
+    .movement_count = m_movement_count,
+    .presence_count = m_presence_count,
+    .sequence = m_sequence,
+    .address = m_address,
+    .flags = m_flags,
+    .log_sequence = m_log_sequence,
+    .log_interval_s = m_log_interval_s,
+    .logged_temperature_c = m_logged_temperature_c,
+    .logged_humidity_rh = m_logged_humidity_rh,
+    .logged_pressure_pa = m_logged_pressure_pa
+};
+
+static uint64_t now_ns (void)
+{
+    struct timespec ts;
+    (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ( (uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+static uint32_t xorshift32 (uint32_t * const p_state)
+{
+    uint32_t x = *p_state;
+    x ^= x << 13U;
+    x ^= x >> 17U;
+    x ^= x << 5U;
+    *p_state = x;
+    return x;
+}
+
+static float uniform (uint32_t * const p_state, const float min, const float max)
+{
+    const float unit = (float) (xorshift32 (p_state) >> 8U) / (float) (1U << 24U);
+    return min + (unit * (max - min));
+}
+
+/** @brief Encode batch, every record in given format or a random one if DF_INVALID. */
+static void batch_encode (const app_dataformat_t format, uint32_t * const p_state)
+{
+    for (size_t ii = 0; ii < BENCH_BATCH; ii++)
+    {
+        const app_dataformat_snapshot_t snapshot =
+        {
+            .temperature_c = uniform (p_state, -40.0F, 85.0F),
+            .humidity_rh = uniform (p_state, 0.0F, 100.0F),
+            .pressure_pa = uniform (p_state, 90000.0F, 110000.0F),
+            .acceleration_x_g = uniform (p_state, -2.0F, 2.0F),
+            .acceleration_y_g = uniform (p_state, -2.0F, 2.0F),
+            .acceleration_z_g = uniform (p_state, -2.0F, 2.0F),
+            .battery_v = uniform (p_state, 2.0F, 3.6F),
+            .address = 0xC8A7B6D5E4F3ULL,
+            .event_count = xorshift32 (p_state),
+            .tx_power = 4
+        };
+        const app_dataformat_t encoded = (DF_INVALID != format) ? format :
+                                         m_formats[xorshift32 (p_state)
+                                                 % BENCH_FORMAT_COUNT].format;
+        size_t length = BENCH_STRIDE;
+        rd_status_t err_code = app_dataformat_encode (m_raw[ii], &length, &snapshot,
+                               encoded);
+        RD_ERROR_CHECK (err_code, RD_SUCCESS);
+        m_lengths[ii] = (uint8_t) length;
+        m_encoded[ii] = encoded;
+        m_encoded_temperature_c[ii] = snapshot.temperature_c;
+    }
+}
+
+static bool batch_check (void)
+{
+    bool ok = true;
+
+    for (size_t ii = 0; ii < BENCH_BATCH; ii++)
+    {
+        const bool cleartext = (0U == (m_encoded[ii] & (DF_7 | DF_8 | DF_FA)));
+        const float error = fabsf (m_temperature_c[ii] - m_encoded_temperature_c[ii]);
+        ok = ok && (m_format[ii] == m_encoded[ii]);
+        ok = ok && ( (!cleartext) || (0.01F >= error));
+    }
+
+    return ok;
+}
+
+/** @brief Decode batch rounds times, return ns per record. */
+static double batch_decode (const uint32_t rounds, const bool single)
+{
+    const uint64_t start = now_ns();
+
+    for (uint32_t rr = 0; rr < rounds; rr++)
+    {
+        if (single)
+        {
+            for (size_t ii = 0; ii < BENCH_BATCH; ii++)
+            {
+                app_dataformat_decoded_t out = m_out;
+                out.format += ii;
+                out.temperature_c += ii;
+                out.humidity_rh += ii;
+                out.pressure_pa += ii;
+                out.acceleration_x_g += ii;
+                out.acceleration_y_g += ii;
+                out.acceleration_z_g += ii;
+                out.battery_v += ii;
+                out.tx_power_dbm += ii;
+                out.battery_resistance_ohm += ii;
+                out.battery_remaining_days += ii;
+                out.vibration_rms_g += ii;
+                out.vibration_peak_g += ii;
+                out.vibration_crest += ii;
+                out.vibration_hz += ii;
+                out.temperature_min_c += ii;
+                out.temperature_max_c += ii;
+                out.movement_count += ii;
+                out.presence_count += ii;
+                out.sequence += ii;
+                out.address += ii;
+                out.flags += ii;
+                out.log_sequence += ii;
+                out.log_interval_s += ii;
+                out.logged_temperature_c += ii * APP_DF_HISTORY_SAMPLES;
+                out.logged_humidity_rh += ii * APP_DF_HISTORY_SAMPLES;
+                out.logged_pressure_pa += ii * APP_DF_HISTORY_SAMPLES;
+                (void) app_dataformat_decode (m_raw[ii], BENCH_STRIDE, &m_lengths[ii], 1U,
+                                              &out);
+            }
+        }
+        else
+        {
+            (void) app_dataformat_decode (&m_raw[0][0], BENCH_STRIDE, m_lengths,
+                                          BENCH_BATCH, &m_out);
+        }
+    }
+
+    return (double) (now_ns() - start) / ( (double) rounds * BENCH_BATCH);
+}
+
+static bool bench_run (const char * const name, const app_dataformat_t format,
+                       const uint32_t rounds, uint32_t * const p_state)
+{
+    batch_encode (format, p_state);
+    const double single_ns = batch_decode (rounds, true);
+    const double batch_ns = batch_decode (rounds, false);
+    const bool ok = batch_check();
+    printf ("%-6s %12.0f %10.2f %12.0f %10.2f %s\n", name, 1e9 / batch_ns, batch_ns,
+            1e9 / single_ns, single_ns, ok ? "" : "FAIL");
+    return ok;
+}
+
+int main (int argc, char ** argv)
+{
+    const uint32_t rounds = (argc > 1) ? (uint32_t) strtoul (argv[1], NULL, 10)
+                            : BENCH_DEFAULT_ROUNDS;
+    uint32_t state = 0x52757576U;
+    bool ok = true;
+    printf ("%u records per batch, %" PRIu32 " batches\n", (unsigned) BENCH_BATCH,
+            rounds);
+    printf ("%-6s %12s %10s %12s %10s\n", "format", "batch rec/s", "ns/rec",
+            "single rec/s", "ns/rec");
+
+    for (size_t ff = 0; ff < BENCH_FORMAT_COUNT; ff++)
+    {
+        ok = bench_run (m_formats[ff].name, m_formats[ff].format, rounds, &state) && ok;
+    }
+
+    ok = bench_run ("mixed", DF_INVALID, rounds, &state) && ok;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,911 @@
+/**
+ * @file bench_roundtrip.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Host round-trip benchmark of data format encoders, run with "make benchmark".
+ *
+ * Gateway decoder of @ref app_dataformat_decoder is first checked against
+ * golden vectors of format specifications. Then synthetic sensor data with
+ * typical, edge, out-of-range, infinite, NaN and missing values goes through
+ * snapshot fill and every compiled-in encoder, and is decoded again by the
+ * same decoder, so firmware and gateway side are tested as a pair. A decoded
+ * value must
+ * be within resolution of input, invalid if input was NaN, and clipped or
+ * invalid if input was out of range - never wrapped.
+ *
+ * Encodes per second are measured over a pool of snapshots without checks,
+ * worst single encode is timed in TSC cycles on x86 and in ns elsewhere.
+ * Formats 7, 8 and FA are timed only, as the decoder does not decode them
+ * yet. 8 and FA are encrypted with the stub AES of bench_stubs.c.
+ *
+ * Exits with failure if any vector or round trip fails.
+ */
+#include "app_dataformats.h"
+#include "app_dataformat_decoder.h"
+#include "app_dataformat_ext.h"
+#include "app_dataformat_history.h"
+#include "app_dataformat_official.h"
+#include "bench_stubs.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#   define BENCH_TICKS_UNIT "cycles"
+#else
+#   define BENCH_TICKS_UNIT "ns"
+#endif
+
+#define BENCH_DEFAULT_SAMPLES   (1000000U)
+#define BENCH_POOL_SIZE         (4096U) //!< Snapshots encoded for throughput.
+#define BENCH_THROUGHPUT_ROUNDS (100U)  //!< Passes over pool per format.
+#define BENCH_BUFFER_LENGTH     (64U)
+#define BENCH_FAILURES_PRINTED  (10U)
+
+#define ADDRESS_MASK        (0xFFFFFFFFFFFFULL)
+#define LOGGED_FIELDS       (3U) //!< Temperature, humidity and pressure.
+
+typedef enum
+{
+    F_TEMP, F_HUMI, F_PRES, F_ACC_X, F_ACC_Y, F_ACC_Z, F_BATT, F_TX, FIELD_COUNT
+} field_t;
+
+static const char * const m_field_names[FIELD_COUNT] =
+{
+    "temperature", "humidity", "pressure", "acc x", "acc y", "acc z", "battery", "tx"
+};
+
+/** @brief Fields only in extended format. */
+typedef enum
+{
+    E_RES, E_REMAINING, E_VIB_RMS, E_VIB_PEAK, E_VIB_CREST, E_VIB_HZ, E_TEMP_MIN,
+    E_TEMP_MAX, EXT_FIELD_COUNT
+} ext_field_t;
+
+static const char * const m_ext_field_names[EXT_FIELD_COUNT] =
+{
+    "resistance", "remaining", "vibration rms", "vibration peak", "crest",
+    "vibration hz", "temperature min", "temperature max"
+};
+
+/** @brief Values decoded from one packet, NAN or -1 if invalid. */
+typedef struct
+{
+    float values[FIELD_COUNT];
+    float ext_values[EXT_FIELD_COUNT]; //!< Fields only in extended format.
+    int32_t movement;
+    int32_t presence;
+    int32_t sequence;
+    uint64_t address;
+    uint8_t flags;            //!< Flags of extended format.
+    int32_t log_sequence;     //!< Newest logged sample of history and extended.
+    uint16_t log_interval_s;  //!< Interval of history and extended.
+    float logged[LOGGED_FIELDS][APP_DF_HISTORY_SAMPLES]; //!< Logged samples of history.
+} decoded_t;
+
+/** @brief Encodable range of a field, resolution 0 if field is not in format. */
+typedef struct
+{
+    float min;
+    float max;
+    float resolution;
+} range_t;
+
+/** @brief Format under test. */
+typedef struct
+{
+    app_dataformat_t format;
+    const char * name;
+    bool decoded;             //!< Fields are decoded, else format is only timed.
+    size_t length;            //!< Expected length of encoded data.
+    bool has_invalid;         //!< Format has invalid markers.
+    uint32_t movement_modulo; //!< 0 if format has no movement counter.
+    uint32_t sequence_modulo; //!< 0 if format has no measurement sequence.
+    bool address;             //!< Format has MAC address.
+    range_t ranges[FIELD_COUNT];
+} format_spec_t;
+
+/** @brief Synthetic measurement, and values encoders should see. */
+typedef struct
+{
+    rd_sensor_data_t data;
+    float data_values[FIELD_COUNT];
+    float expected[FIELD_COUNT]; //!< NAN if not provided.
+    float motion;
+    float presence;
+    uint32_t event_count;
+    uint32_t presence_count;
+    uint64_t address;
+    app_log_history_t history;
+} sample_t;
+
+/** @brief Decode one record by gateway decoder, return its format. */
+static app_dataformat_t record_decode (const uint8_t * const p_raw, const size_t length,
+                                       decoded_t * const p_out)
+{
+    app_dataformat_t format = DF_INVALID;
+    const uint8_t record_length = (uint8_t) length;
+    const app_dataformat_decoded_t out =
+    {
+        .format = &format,
+        .temperature_c = &p_out->values[F_TEMP],
+        .humidity_rh = &p_out->values[F_HUMI],
+        .pressure_pa = &p_out->values[F_PRES],
+        .acceleration_x_g = &p_out->values[F_ACC_X],
+        .acceleration_y_g = &p_out->values[F_ACC_Y],
+        .acceleration_z_g = &p_out->values[F_ACC_Z],
+        .battery_v = &p_out->values[F_BATT],
+        .tx_power_dbm = &p_out->values[F_TX],
+        .battery_resistance_ohm = &p_out->ext_values[E_RES],
+        .battery_remaining_days = &p_out->ext_values[E_REMAINING],
+        .vibration_rms_g = &p_out->ext_values[E_VIB_RMS],
+        .vibration_peak_g = &p_out->ext_values[E_VIB_PEAK],
+        .vibration_crest = &p_out->ext_values[E_VIB_CREST],
+        .vibration_hz = &p_out->ext_values[E_VIB_HZ],
+        .temperature_min_c = &p_out->ext_values[E_TEMP_MIN],
+        .temperature_max_c = &p_out->ext_values[E_TEMP_MAX],
+        .movement_count = &p_out->movement,
+        .presence_count = &p_out->presence,
+        .sequence = &p_out->sequence,
+        .address = &p_out->address,
+        .flags = &p_out->flags,
+        .log_sequence = &p_out->log_sequence,
+        .log_interval_s = &p_out->log_interval_s,
+        .logged_temperature_c = p_out->logged[0],
+        .logged_humidity_rh = p_out->logged[1],
+        .logged_pressure_pa = p_out->logged[2]
+    };
+    rd_status_t err_code = app_dataformat_decode (p_raw, length, &record_length, 1U,
+                           &out);
+    RD_ERROR_CHECK (err_code, RD_SUCCESS);
+    return format;
+}
+
+#define RANGE_TEMP_DF5 { -163.835F, 163.835F, 0.005F }
+#define RANGE_HUMI_DF5 { 0.0F, 163.835F, 0.0025F }
+#define RANGE_PRES_DF5 { 50000.0F, 115534.0F, 1.0F }
+#define RANGE_ACC      { -32.767F, 32.767F, 0.001F }
+#define RANGE_NONE     { 0.0F, 0.0F, 0.0F }
+
+static const format_spec_t m_formats[] =
+{
+    {
+        DF_3, "3", true, RE_3_DATA_LENGTH, false, 0U, 0U, false,
+        {
+            { -127.99F, 127.99F, 0.01F }, { 0.0F, 127.5F, 0.5F },
+            { 50000.0F, 115535.0F, 1.0F },
+            RANGE_ACC, RANGE_ACC, RANGE_ACC, { 0.0F, 65.535F, 0.001F }, RANGE_NONE
+        }
+    },
+    {
+        DF_5, "5", true, RE_5_DATA_LENGTH, true, APP_DF_5_MOVEMENT_INVALID,
+        APP_DF_5_SEQUENCE_INVALID, true,
+        {
+            RANGE_TEMP_DF5, RANGE_HUMI_DF5, RANGE_PRES_DF5,
+            RANGE_ACC, RANGE_ACC, RANGE_ACC,
+            { 1.6F, 3.646F, 0.001F }, { -40.0F, 20.0F, 2.0F }
+        }
+    },
+    { DF_7, "7", false, 0U, false, 0U, 0U, false, { RANGE_NONE } },
+    { DF_8, "8", false, 0U, false, 0U, 0U, false, { RANGE_NONE } },
+    {
+        DF_C5, "C5", true, RE_C5_DATA_LENGTH, true, APP_DF_C5_MOVEMENT_INVALID,
+        APP_DF_C5_SEQUENCE_INVALID, true,
+        {
+            RANGE_TEMP_DF5, RANGE_HUMI_DF5, RANGE_PRES_DF5,
+            RANGE_NONE, RANGE_NONE, RANGE_NONE,
+            { 1.6F, 3.646F, 0.001F }, { -40.0F, 20.0F, 2.0F }
+        }
+    },
+    { DF_FA, "FA", false, 0U, false, 0U, 0U, false, { RANGE_NONE } },
+    {
+        DF_HISTORY, "hist", true, APP_DF_HISTORY_DATA_LENGTH, true, 0U, 0U,
+        false,
+        {
+            RANGE_TEMP_DF5, RANGE_HUMI_DF5, RANGE_PRES_DF5,
+            RANGE_NONE, RANGE_NONE, RANGE_NONE,
+            RANGE_NONE, RANGE_NONE
+        }
+    },
+    {
+        DF_EXT, "ext", true, APP_DF_EXT_DATA_LENGTH, true, UINT16_MAX + 1U,
+        UINT16_MAX + 1U, true,
+        {
+            RANGE_TEMP_DF5, RANGE_HUMI_DF5, RANGE_PRES_DF5,
+            RANGE_ACC, RANGE_ACC, RANGE_ACC,
+            { 0.0F, 65.534F, 0.001F }, { -128.0F, 127.0F, 1.0F }
+        }
+    }
+};
+
+#define BENCH_FORMAT_COUNT (sizeof (m_formats) / sizeof (m_formats[0]))
+
+/** @brief Published test vector, or a vector of an in-tree format. */
+typedef struct
+{
+    const char * name;
+    app_dataformat_t format;
+    uint8_t raw[BENCH_BUFFER_LENGTH];
+    float values[FIELD_COUNT];
+    int32_t movement;
+    int32_t sequence;
+} golden_t;
+
+static const golden_t m_golden[] =
+{
+    {
+        "3 valid", DF_3,
+        {
+            0x03, 0x29, 0x1A, 0x1E, 0xCE, 0x1E, 0xFC, 0x18, 0xF9, 0x42, 0x02, 0xCA,
+            0x0B, 0x53
+        },
+        { 26.3F, 20.5F, 102766.0F, -1.0F, -1.726F, 0.714F, 2.899F, NAN }, -1, -1
+    },
+    {
+        "3 max", DF_3,
+        {
+            0x03, 0xFF, 0x7F, 0x63, 0xFF, 0xFF, 0x7F, 0xFF, 0x7F, 0xFF, 0x7F, 0xFF,
+            0xFF, 0xFF
+        },
+        { 127.99F, 127.5F, 115535.0F, 32.767F, 32.767F, 32.767F, 65.535F, NAN }, -1, -1
+    },
+    {
+        "3 min", DF_3,
+        {
+            0x03, 0x00, 0xFF, 0x63, 0x00, 0x00, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01,
+            0x00, 0x00
+        },
+        { -127.99F, 0.0F, 50000.0F, -32.767F, -32.767F, -32.767F, 0.0F, NAN }, -1, -1
+    },
+    {
+        "5 valid", DF_5,
+        {
+            0x05, 0x12, 0xFC, 0x53, 0x94, 0xC3, 0x7C, 0x00, 0x04, 0xFF, 0xFC, 0x04,
+            0x0C, 0xAC, 0x36, 0x42, 0x00, 0xCD, 0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F
+        },
+        { 24.3F, 53.49F, 100044.0F, 0.004F, -0.004F, 1.036F, 2.977F, 4.0F }, 66, 205
+    },
+    {
+        "5 max", DF_5,
+        {
+            0x05, 0x7F, 0xFF, 0xFF, 0xFE, 0xFF, 0xFE, 0x7F, 0xFF, 0x7F, 0xFF, 0x7F,
+            0xFF, 0xFF, 0xDE, 0xFE, 0xFF, 0xFE, 0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F
+        },
+        {
+            163.835F, 163.835F, 115534.0F, 32.767F, 32.767F, 32.767F, 3.646F, 20.0F
+        }, 254, 65534
+    },
+    {
+        "5 min", DF_5,
+        {
+            0x05, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x80, 0x01, 0x80,
+            0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F
+        },
+        {
+            -163.835F, 0.0F, 50000.0F, -32.767F, -32.767F, -32.767F, 1.6F, -40.0F
+        }, 0, 0
+    },
+    {
+        "5 invalid", DF_5,
+        {
+            0x05, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x80, 0x00, 0x80,
+            0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+        },
+        { NAN, NAN, NAN, NAN, NAN, NAN, NAN, NAN }, -1, -1
+    },
+    {
+        "C5 valid", DF_C5,
+        {
+            0xC5, 0x12, 0xFC, 0x53, 0x94, 0xC3, 0x7C, 0xAC, 0x36, 0x42, 0x00, 0xCD,
+            0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F
+        },
+        { 24.3F, 53.49F, 100044.0F, NAN, NAN, NAN, 2.977F, 4.0F }, 66, 205
+    },
+    {
+        "hist valid", DF_HISTORY,
+        {
+            0xC7, 0x12, 0xFC, 0x53, 0x98, 0xC3, 0x7C, 0x12, 0x34, 0x01, 0x2C, 0x02,
+            0xFE, 0x02, 0xFC, 0x07, 0xF9, 0x05, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+        },
+        { 24.3F, 53.5F, 100044.0F, NAN, NAN, NAN, NAN, NAN }, -1, -1
+    },
+    {
+        "ext valid", DF_EXT,
+        {
+            0xC8, 0x12, 0xFC, 0x53, 0x98, 0xC3, 0x7C, 0x00, 0x04, 0xFF, 0xFC, 0x04,
+            0x0C, 0x0B, 0xA1, 0xFC, 0x00, 0x00, 0xCD, 0x12, 0x34, 0x00, 0x00, 0x00,
+            0x00, 0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F, 0x04, 0xD2, 0x01, 0x90,
+            0x00, 0x7B, 0x01, 0xC8, 0x25, 0x00, 0x7D, 0x12, 0xD4, 0x13, 0x24,
+            0x01, 0x02
+        },
+        { 24.3F, 53.5F, 100044.0F, 0.004F, -0.004F, 1.036F, 2.977F, -4.0F }, 0x1234, 205
+    }
+};
+
+#define BENCH_GOLDEN_COUNT (sizeof (m_golden) / sizeof (m_golden[0]))
+
+static uint32_t m_failures;
+
+static void failure_report (const char * const format, const char * const what,
+                            const float input, const float decoded)
+{
+    if (BENCH_FAILURES_PRINTED > m_failures)
+    {
+        printf ("FAIL %s %s: input %g decoded %g\n", format, what, (double) input,
+                (double) decoded);
+    }
+
+    m_failures++;
+}
+
+static const format_spec_t * format_find (const app_dataformat_t format)
+{
+    const format_spec_t * p_spec = NULL;
+
+    for (size_t ii = 0; (ii < BENCH_FORMAT_COUNT) && (NULL == p_spec); ii++)
+    {
+        if (format == m_formats[ii].format)
+        {
+            p_spec = &m_formats[ii];
+        }
+    }
+
+    return p_spec;
+}
+
+static uint64_t now_ns (void)
+{
+    struct timespec ts;
+    (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ( (uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+static uint64_t now_ticks (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return now_ns();
+#endif
+}
+
+/** @brief Decoders against published vectors, in-tree encoders against own. */
+static void golden_check (void)
+{
+    for (size_t ii = 0; ii < BENCH_GOLDEN_COUNT; ii++)
+    {
+        const golden_t * const p_golden = &m_golden[ii];
+        const format_spec_t * const p_spec = format_find (p_golden->format);
+        decoded_t decoded;
+
+        if (p_golden->format != record_decode (p_golden->raw, p_spec->length, &decoded))
+        {
+            failure_report (p_golden->name, "format", 0.0F, 0.0F);
+        }
+
+        for (size_t ff = 0; ff < FIELD_COUNT; ff++)
+        {
+            const float expected = p_golden->values[ff];
+            const float value = decoded.values[ff];
+            const float tolerance = p_spec->ranges[ff].resolution / 2.0F;
+
+            if ( (isnan (expected) != isnan (value))
+                    || ( (!isnan (expected)) && (fabsf (expected - value) > tolerance)))
+            {
+                failure_report (p_golden->name, m_field_names[ff], expected, value);
+            }
+        }
+
+        if ( (p_golden->movement != decoded.movement)
+                || (p_golden->sequence != decoded.sequence))
+        {
+            failure_report (p_golden->name, "counters", (float) p_golden->sequence,
+                            (float) decoded.sequence);
+        }
+    }
+
+    // In-tree formats are pure functions of their input, so encoding is checked too.
+    uint8_t output[BENCH_BUFFER_LENGTH] = {0};
+    app_dataformat_history_t history =
+    {
+        .temperature_c = 24.3F, .humidity_rh = 53.5F, .pressure_pa = 100044.0F,
+        .sequence = 0x1234U, .interval_s = 300U, .num_samples = 2U,
+        .samples = { { 24.1F, 54.5F, 100004.0F }, { 25.0F, 50.0F, 100094.0F } }
+    };
+    app_dataformat_ext_t ext =
+    {
+        .temperature_c = 24.3F, .humidity_rh = 53.5F, .pressure_pa = 100044.0F,
+        .acceleration_x_g = 0.004F, .acceleration_y_g = -0.004F,
+        .acceleration_z_g = 1.036F, .battery_v = 2.977F,
+        .resistance_ohm = 12.34F, .remaining_days = 400.0F,
+        .vibration_rms_g = 0.123F, .vibration_peak_g = 0.456F,
+        .vibration_crest = 3.7F, .vibration_hz = 12.5F,
+        .temperature_min_c = 24.1F, .temperature_max_c = 24.5F,
+        .address = 0xCBB8334C884FULL, .sequence = 205U, .movement_count = 0x1234U,
+        .presence_count = 0x0102U, .tx_power = -4
+    };
+    (void) app_dataformat_history_encode (output, &history);
+
+    if (0 != memcmp (output, m_golden[8].raw, APP_DF_HISTORY_DATA_LENGTH))
+    {
+        failure_report ("hist valid", "encoded bytes", 0.0F, 0.0F);
+    }
+
+    (void) app_dataformat_ext_encode (output, &ext);
+
+    if (0 != memcmp (output, m_golden[9].raw, APP_DF_EXT_DATA_LENGTH))
+    {
+        failure_report ("ext valid", "encoded bytes", 0.0F, 0.0F);
+    }
+
+    const float ext_values[EXT_FIELD_COUNT] =
+    {
+        ext.resistance_ohm, ext.remaining_days, ext.vibration_rms_g,
+        ext.vibration_peak_g, ext.vibration_crest, ext.vibration_hz,
+        ext.temperature_min_c, ext.temperature_max_c
+    };
+    const float ext_resolutions[EXT_FIELD_COUNT] =
+    {
+        1.0F / APP_DF_EXT_RES_RATIO, 1.0F, 1.0F / APP_DF_EXT_ACC_RATIO,
+        1.0F / APP_DF_EXT_ACC_RATIO, 1.0F / APP_DF_EXT_CREST_RATIO,
+        1.0F / APP_DF_EXT_FREQ_RATIO, 1.0F / APP_DF_EXT_TEMP_RATIO,
+        1.0F / APP_DF_EXT_TEMP_RATIO
+    };
+    decoded_t decoded;
+    (void) record_decode (m_golden[9].raw, APP_DF_EXT_DATA_LENGTH, &decoded);
+
+    for (size_t ff = 0; ff < EXT_FIELD_COUNT; ff++)
+    {
+        const float error = fabsf (ext_values[ff] - decoded.ext_values[ff]);
+
+        if (isnan (error) || (error > (ext_resolutions[ff] / 2.0F)))
+        {
+            failure_report ("ext valid", m_ext_field_names[ff], ext_values[ff],
+                            decoded.ext_values[ff]);
+        }
+    }
+
+    if (ext.presence_count != decoded.presence)
+    {
+        failure_report ("ext valid", "presence", (float) ext.presence_count,
+                        (float) decoded.presence);
+    }
+}
+
+static uint32_t xorshift32 (uint32_t * const p_state)
+{
+    uint32_t x = *p_state;
+    x ^= x << 13U;
+    x ^= x >> 17U;
+    x ^= x << 5U;
+    *p_state = x;
+    return x;
+}
+
+static float uniform (uint32_t * const p_state, const float min, const float max)
+{
+    const float unit = (float) (xorshift32 (p_state) >> 8U) / (float) (1U << 24U);
+    return min + (unit * (max - min));
+}
+
+/** @brief Typical span of a field, a bit wider than widest format, and edges. */
+typedef struct
+{
+    float min;
+    float max;
+    float edges[8];
+} generator_t;
+
+#define EDGES_ACC { 0.0F, -32.767F, 32.767F, -32.768F, 32.768F, 1.0F, -1.0F, 0.0005F }
+
+static const generator_t m_generators[FIELD_COUNT - 1U] =
+{
+    {
+        -170.0F, 170.0F,
+        { -163.835F, 163.835F, -127.99F, 127.99F, 0.0F, -0.005F, 163.84F, -163.84F }
+    },
+    {
+        -5.0F, 170.0F,
+        { 0.0F, 0.0025F, 100.0F, 127.5F, 163.835F, 163.84F, -0.0025F, 50.0F }
+    },
+    {
+        49000.0F, 116000.0F,
+        {
+            50000.0F, 115534.0F, 115535.0F, 49999.0F, 100000.0F, 50000.5F, 115534.4F,
+            101325.0F
+        }
+    },
+    { -33.0F, 33.0F, EDGES_ACC },
+    { -33.0F, 33.0F, EDGES_ACC },
+    { -33.0F, 33.0F, EDGES_ACC },
+    { 0.0F, 4.0F, { 1.6F, 3.646F, 0.0F, 65.534F, 65.535F, 3.0F, 1.599F, 3.647F } }
+};
+
+static float value_generate (uint32_t * const p_state, const generator_t * const p_gen)
+{
+    const uint32_t pick = xorshift32 (p_state) % 16U;
+    float value = 0.0F;
+
+    if (0U == pick)
+    {
+        value = NAN;
+    }
+    else if (1U == pick)
+    {
+        value = INFINITY;
+    }
+    else if (2U == pick)
+    {
+        value = -INFINITY;
+    }
+    else if (3U == pick)
+    {
+        value = (0U != (xorshift32 (p_state) & 1U)) ? 1e30F : -1e30F;
+    }
+    else if (8U > pick)
+    {
+        value = p_gen->edges[xorshift32 (p_state) % 8U];
+    }
+    else
+    {
+        value = uniform (p_state, p_gen->min, p_gen->max);
+    }
+
+    return value;
+}
+
+static void sample_generate (uint32_t * const p_state, sample_t * const p_sample)
+{
+    const rd_sensor_data_bitfield_t fields[] =
+    {
+        RD_SENSOR_TEMP_FIELD, RD_SENSOR_HUMI_FIELD, RD_SENSOR_PRES_FIELD,
+        RD_SENSOR_ACC_X_FIELD, RD_SENSOR_ACC_Y_FIELD, RD_SENSOR_ACC_Z_FIELD
+    };
+    static const int8_t tx_powers[] = { -40, -20, -8, 0, 4, 8, 20, -128, 127, 3 };
+    rd_sensor_data_t * const p_data = &p_sample->data;
+    memset (p_data, 0, sizeof (*p_data));
+    p_data->data = p_sample->data_values;
+
+    for (size_t ii = 0; ii < (sizeof (fields) / sizeof (fields[0])); ii++)
+    {
+        const rd_sensor_data_fields_t field = { .datas = fields[ii] };
+        p_sample->expected[ii] = value_generate (p_state, &m_generators[ii]);
+
+        // Some fields are not provided at all.
+        if (0U != (xorshift32 (p_state) % 32U))
+        {
+            p_data->fields.bitfield |= field.bitfield;
+        }
+    }
+
+    for (size_t ii = 0; ii < (sizeof (fields) / sizeof (fields[0])); ii++)
+    {
+        const rd_sensor_data_fields_t field = { .datas = fields[ii] };
+
+        if (0U != (p_data->fields.bitfield & field.bitfield))
+        {
+            rd_sensor_data_set (p_data, fields[ii], p_sample->expected[ii]);
+        }
+        else
+        {
+            p_sample->expected[ii] = NAN;
+        }
+    }
+
+    p_sample->expected[F_BATT] = value_generate (p_state, &m_generators[F_BATT]);
+    p_sample->expected[F_TX] = (float) tx_powers[xorshift32 (p_state) % 10U];
+    p_sample->motion = (float) (xorshift32 (p_state) % 2U);
+    p_sample->presence = (float) (xorshift32 (p_state) % 2U);
+    p_sample->event_count = xorshift32 (p_state);
+    p_sample->presence_count = xorshift32 (p_state);
+    p_sample->address = ( (uint64_t) xorshift32 (p_state) << 32U) | xorshift32 (p_state);
+    memset (&p_sample->history, 0, sizeof (p_sample->history));
+    p_sample->history.num_samples = xorshift32 (p_state) % (APP_LOG_HISTORY_LENGTH + 1U);
+    p_sample->history.sequence = xorshift32 (p_state);
+    p_sample->history.interval_s = (uint16_t) xorshift32 (p_state);
+
+    // Mostly near latest reading so deltas fit, sometimes far or missing.
+    for (size_t ii = 0; ii < p_sample->history.num_samples; ii++)
+    {
+        const float spread = (0U == (xorshift32 (p_state) % 8U)) ? 1000.0F : 5.0F;
+        app_log_element_t * const p_element = &p_sample->history.samples[ii];
+        p_element->temperature_c = p_sample->expected[F_TEMP]
+                                   + uniform (p_state, -spread, spread);
+        p_element->humidity_rh = p_sample->expected[F_HUMI]
+                                 + uniform (p_state, -spread, spread);
+        p_element->pressure_pa = (0U == (xorshift32 (p_state) % 16U)) ? NAN :
+                                 p_sample->expected[F_PRES]
+                                 + (100.0F * uniform (p_state, -spread, spread));
+    }
+}
+
+/** @brief Set stubbed device state and fill snapshot as heartbeat does. */
+static void snapshot_prepare (const sample_t * const p_sample,
+                              app_dataformat_snapshot_t * const p_snapshot)
+{
+    bench_battery_v = p_sample->expected[F_BATT];
+    bench_tx_power = (int8_t) p_sample->expected[F_TX];
+    bench_event_count = p_sample->event_count;
+    bench_presence_count = p_sample->presence_count;
+    bench_address = p_sample->address;
+    bench_history = p_sample->history;
+    rd_status_t err_code = app_dataformat_snapshot_fill (p_snapshot, &p_sample->data);
+    RD_ERROR_CHECK (err_code, RD_SUCCESS);
+    // Motion and presence are not in sensor data of benchmark.
+    p_snapshot->motion = p_sample->motion;
+    p_snapshot->presence = p_sample->presence;
+}
+
+static bool value_check (const float input, const float decoded,
+                         const range_t * const p_range, const bool has_invalid)
+{
+    const float tolerance = p_range->resolution * 1.001F;
+    bool ok = true;
+
+    if (isnan (input))
+    {
+        ok = (!has_invalid) || isnan (decoded);
+    }
+    else if ( (input >= p_range->min) && (input <= p_range->max))
+    {
+        ok = (fabsf (decoded - input) <= tolerance);
+    }
+    else
+    {
+        // Out of range may be clipped or invalid, but never wrapped.
+        const float clipped = (input < p_range->min) ? p_range->min : p_range->max;
+        ok = isnan (decoded) || (fabsf (decoded - clipped) <= tolerance);
+    }
+
+    return ok;
+}
+
+static void history_verify (const format_spec_t * const p_spec,
+                            const sample_t * const p_sample,
+                            const decoded_t * const p_decoded)
+{
+    const app_log_history_t * const p_history = &p_sample->history;
+    const float ratios[LOGGED_FIELDS] =
+    {
+        APP_DF_HISTORY_DTEMP_RATIO, APP_DF_HISTORY_DHUMI_RATIO, APP_DF_HISTORY_DPRES_RATIO
+    };
+
+    if ( (0U < p_history->num_samples)
+            && ( (p_decoded->log_sequence != (int32_t) (p_history->sequence & 0xFFFFU))
+                 || (p_decoded->log_interval_s != p_history->interval_s)))
+    {
+        failure_report (p_spec->name, "log header", (float) p_history->sequence,
+                        (float) p_decoded->log_sequence);
+    }
+
+    for (size_t ii = 0; ii < APP_DF_HISTORY_SAMPLES; ii++)
+    {
+        const bool sent = (ii < p_history->num_samples);
+        const float logged[LOGGED_FIELDS] =
+        {
+            sent ? p_history->samples[ii].temperature_c : NAN,
+            sent ? p_history->samples[ii].humidity_rh : NAN,
+            sent ? p_history->samples[ii].pressure_pa : NAN
+        };
+
+        for (size_t ff = 0; ff < LOGGED_FIELDS; ff++)
+        {
+            const float latest = p_sample->expected[F_TEMP + ff];
+            const float decoded = p_decoded->logged[ff][ii];
+            const float steps = (logged[ff] - latest) * ratios[ff];
+            const float tolerance = (1.001F / ratios[ff])
+                                    + p_spec->ranges[F_TEMP + ff].resolution;
+            bool ok = true;
+
+            // Delta to a latest reading which was not sent can not be decoded.
+            if (isnan (p_decoded->values[F_TEMP + ff]) || isnan (steps)
+                    || (127.5F < fabsf (steps)))
+            {
+                ok = isnan (decoded);
+            }
+            else if (127.0F >= fabsf (steps))
+            {
+                ok = (fabsf (decoded - logged[ff]) <= tolerance);
+            }
+            else
+            {
+                // Rounds either to largest delta or to invalid.
+            }
+
+            if (!ok)
+            {
+                failure_report (p_spec->name, "logged sample", logged[ff], decoded);
+            }
+        }
+    }
+}
+
+static void ext_verify (const format_spec_t * const p_spec,
+                        const sample_t * const p_sample,
+                        const decoded_t * const p_decoded)
+{
+    const bool log = (0U < p_sample->history.num_samples);
+    uint8_t flags = 0U;
+    flags |= (p_sample->motion > 0.5F) ? APP_DF_EXT_FLAG_MOTION : 0U;
+    flags |= (p_sample->presence > 0.5F) ? APP_DF_EXT_FLAG_PRESENCE : 0U;
+    flags |= log ? APP_DF_EXT_FLAG_LOG : 0U;
+
+    if ( (flags != p_decoded->flags)
+            || (log && (p_decoded->log_sequence
+                        != (int32_t) (p_sample->history.sequence & 0xFFFFU))))
+    {
+        failure_report (p_spec->name, "flags or log", (float) flags,
+                        (float) p_decoded->flags);
+    }
+}
+
+static void sample_verify (const format_spec_t * const p_spec,
+                           const sample_t * const p_sample,
+                           const decoded_t * const p_decoded,
+                           int32_t * const p_sequence)
+{
+    for (size_t ff = 0; ff < FIELD_COUNT; ff++)
+    {
+        if ( (0.0F < p_spec->ranges[ff].resolution)
+                && (!value_check (p_sample->expected[ff], p_decoded->values[ff],
+                                  &p_spec->ranges[ff], p_spec->has_invalid)))
+        {
+            failure_report (p_spec->name, m_field_names[ff], p_sample->expected[ff],
+                            p_decoded->values[ff]);
+        }
+    }
+
+    if ( (0U < p_spec->movement_modulo)
+            && (p_decoded->movement
+                != (int32_t) (p_sample->event_count % p_spec->movement_modulo)))
+    {
+        failure_report (p_spec->name, "movement", (float) p_sample->event_count,
+                        (float) p_decoded->movement);
+    }
+
+    if ( (DF_EXT == p_spec->format)
+            && (p_decoded->presence != (int32_t) (p_sample->presence_count & UINT16_MAX)))
+    {
+        failure_report (p_spec->name, "presence", (float) p_sample->presence_count,
+                        (float) p_decoded->presence);
+    }
+
+    // Sequence starts wherever earlier encodes left it, then counts up by one.
+    if (0U < p_spec->sequence_modulo)
+    {
+        const uint32_t next = (uint32_t) (*p_sequence + 1) % p_spec->sequence_modulo;
+
+        if ( (0 <= *p_sequence) && (p_decoded->sequence != (int32_t) next))
+        {
+            failure_report (p_spec->name, "sequence", (float) (*p_sequence + 1),
+                            (float) p_decoded->sequence);
+        }
+
+        *p_sequence = p_decoded->sequence;
+    }
+
+    if (p_spec->address && (p_decoded->address != (p_sample->address & ADDRESS_MASK)))
+    {
+        failure_report (p_spec->name, "address", 0.0F, 0.0F);
+    }
+
+    if (DF_HISTORY == p_spec->format)
+    {
+        history_verify (p_spec, p_sample, p_decoded);
+    }
+    else if (DF_EXT == p_spec->format)
+    {
+        ext_verify (p_spec, p_sample, p_decoded);
+    }
+    else
+    {
+        // Official formats have no extra fields.
+    }
+}
+
+int main (int argc, char ** argv)
+{
+    const uint32_t samples = (argc > 1) ? (uint32_t) strtoul (argv[1], NULL, 10)
+                             : BENCH_DEFAULT_SAMPLES;
+    static app_dataformat_snapshot_t pool[BENCH_POOL_SIZE];
+    uint64_t worst_ticks[BENCH_FORMAT_COUNT] = {0};
+    uint64_t checked[BENCH_FORMAT_COUNT] = {0};
+    int32_t sequences[BENCH_FORMAT_COUNT];
+    uint32_t state = 0x52757576U;
+    sample_t sample;
+    app_dataformat_snapshot_t snapshot;
+    uint8_t output[BENCH_BUFFER_LENGTH];
+    golden_check();
+    printf ("%u golden vectors, %" PRIu32 " failures\n", (unsigned) BENCH_GOLDEN_COUNT,
+            m_failures);
+
+    for (size_t ff = 0; ff < BENCH_FORMAT_COUNT; ff++)
+    {
+        sequences[ff] = -1;
+    }
+
+    for (uint32_t ii = 0; ii < samples; ii++)
+    {
+        sample_generate (&state, &sample);
+        snapshot_prepare (&sample, &snapshot);
+
+        if (BENCH_POOL_SIZE > ii)
+        {
+            pool[ii] = snapshot;
+        }
+
+        for (size_t ff = 0; ff < BENCH_FORMAT_COUNT; ff++)
+        {
+            const format_spec_t * const p_spec = &m_formats[ff];
+            size_t length = sizeof (output);
+            const uint64_t start = now_ticks();
+            const rd_status_t err_code =
+                app_dataformat_encode (output, &length, &snapshot, p_spec->format);
+            const uint64_t ticks = now_ticks() - start;
+            worst_ticks[ff] = (ticks > worst_ticks[ff]) ? ticks : worst_ticks[ff];
+
+            if (RD_ERROR_NOT_ENABLED == err_code)
+            {
+                // Format is not compiled in.
+            }
+            else if ( (RD_SUCCESS != err_code)
+                      || (p_spec->decoded && (p_spec->length != length)))
+            {
+                failure_report (p_spec->name, "encode", (float) err_code, (float) length);
+            }
+            else if (p_spec->decoded)
+            {
+                decoded_t decoded;
+
+                if (p_spec->format != record_decode (output, length, &decoded))
+                {
+                    failure_report (p_spec->name, "format", 0.0F, 0.0F);
+                }
+
+                sample_verify (p_spec, &sample, &decoded, &sequences[ff]);
+                checked[ff]++;
+            }
+            else
+            {
+                // Timed only.
+            }
+        }
+    }
+
+    const uint32_t pool_size = (samples < BENCH_POOL_SIZE) ? samples : BENCH_POOL_SIZE;
+    printf ("%" PRIu32 " samples, %" PRIu32 " failures\n", samples, m_failures);
+    printf ("%-6s %14s %10s %14s %12s\n", "format", "encodes/s", "mean ns",
+            "worst " BENCH_TICKS_UNIT, "round trips");
+
+    for (size_t ff = 0; (ff < BENCH_FORMAT_COUNT) && (0U < pool_size); ff++)
+    {
+        const uint64_t start_ns = now_ns();
+
+        for (uint32_t rr = 0; rr < BENCH_THROUGHPUT_ROUNDS; rr++)
+        {
+            for (uint32_t ii = 0; ii < pool_size; ii++)
+            {
+                size_t length = sizeof (output);
+                (void) app_dataformat_encode (output, &length, &pool[ii],
+                                              m_formats[ff].format);
+            }
+        }
+
+        const double elapsed_ns = (double) (now_ns() - start_ns);
+        const double encodes = (double) BENCH_THROUGHPUT_ROUNDS * pool_size;
+        printf ("%-6s %14.0f %10.1f %14" PRIu64 " %12" PRIu64 "\n", m_formats[ff].name,
+                encodes * 1e9 / elapsed_ns, elapsed_ns / encodes, worst_ticks[ff],
+                checked[ff]);
+    }
+
+    return (0U == m_failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file bench_stubs.c
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Stubs of device state, flash, GATT and AES linked by app_dataformats.c.
+ * AES is a XOR with key, so encrypted formats cost less than on target.
+ */
+#include "bench_stubs.h"
+#include "app_battery.h"
+#include "app_comms.h"
+#include "app_sensor.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_aes.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_communication_ble_advertising.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_task_adc.h"
+#include "ruuvi_task_flash.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+volatile float bench_battery_v = 2.95F;
+volatile uint64_t bench_address = 0xC8A7B6D5E4F3ULL;
+volatile int8_t bench_tx_power = 4;
+volatile uint32_t bench_event_count = 7U;
+volatile uint32_t bench_presence_count = 3U;
+app_log_history_t bench_history;
+
+rd_status_t app_battery_vdd_get (float * const vdd)
+{
+    *vdd = bench_battery_v;
+    return RD_SUCCESS;
+}
+
+// No rest and load pairs on host, battery health is invalid.
+rd_status_t app_battery_state_get (app_battery_state_t * const state)
+{
+    memset (state, 0, sizeof (*state));
+    state->remaining_days = NAN;
+    return RD_ERROR_INVALID_STATE;
+}
+
+uint32_t app_sensor_event_count_get (void)
+{
+    return bench_event_count;
+}
+
+uint32_t app_sensor_presence_count_get (void)
+{
+    return bench_presence_count;
+}
+
+// Read by baseline encoders of bench_app_dataformats.
+rd_status_t rt_adc_vdd_get (float * const battery)
+{
+    *battery = bench_battery_v;
+    return RD_SUCCESS;
+}
+
+rd_status_t ri_radio_address_get (uint64_t * const address)
+{
+    *address = bench_address;
+    return RD_SUCCESS;
+}
+
+rd_status_t ri_adv_tx_power_get (int8_t * dbm)
+{
+    *dbm = bench_tx_power;
+    return RD_SUCCESS;
+}
+
+void ri_adv_enable_uuid (const bool enable_uuid)
+{
+    (void) enable_uuid;
+}
+
+rd_status_t ri_comm_id_get (uint64_t * const id)
+{
+    *id = bench_address;
+    return RD_SUCCESS;
+}
+
+rd_status_t ri_aes_ecb_128_encrypt (const uint8_t * const cleartext,
+                                    uint8_t * const ciphertext,
+                                    const uint8_t * const key,
+                                    const size_t data_length)
+{
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        ciphertext[ii] = cleartext[ii] ^ key[ii % 16U];
+    }
+
+    return RD_SUCCESS;
+}
+
+rd_status_t app_log_history_get (app_log_history_t * const p_history)
+{
+    *p_history = bench_history;
+    return (0U < bench_history.num_samples) ? RD_SUCCESS : RD_ERROR_NOT_SUPPORTED;
+}
+
+// Nothing is provisioned, compile-time keys and weights are used.
+rd_status_t rt_flash_load (const uint16_t file_id, const uint16_t record_id,
+                           void * const message, const size_t message_length)
+{
+    (void) file_id;
+    (void) record_id;
+    (void) message;
+    (void) message_length;
+    return RD_ERROR_NOT_FOUND;
+}
+
+rd_status_t rt_flash_store (const uint16_t file_id, const uint16_t record_id,
+                            const void * const message, const size_t message_length)
+{
+    (void) file_id;
+    (void) record_id;
+    (void) message;
+    (void) message_length;
+    return RD_SUCCESS;
+}
+
+rd_status_t rt_flash_free (const uint16_t file_id, const uint16_t record_id)
+{
+    (void) file_id;
+    (void) record_id;
+    return RD_SUCCESS;
+}
+
+rd_status_t app_comms_blocking_send (const ri_comm_xfer_fp_t reply_fp,
+                                     ri_comm_message_t * const msg)
+{
+    (void) reply_fp;
+    (void) msg;
+    return RD_SUCCESS;
+}
+
+void rd_error_check (const rd_status_t error, const rd_status_t non_fatal_mask,
+                     const char * file, const int line)
+{
+    if (0U != (error & ~non_fatal_mask))
+    {
+        fprintf (stderr, "Fatal error 0x%" PRIx32 " at %s:%d\n", error, file, line);
+        exit (EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef BENCH_STUBS_H
+#define BENCH_STUBS_H
+/**
+ * @file bench_stubs.h
+ * @author agent <agent@local>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Device state stubbed for host benchmarks of data formats. State is
+ * volatile to keep reads from being optimised out, benchmarks may change it
+ * between encodes.
+ */
+#include "app_log.h"
+
+#include <stdint.h>
+
+extern volatile float bench_battery_v;      //!< Returned by app_battery_vdd_get.
+extern volatile uint64_t bench_address;     //!< Radio address and device ID.
+extern volatile int8_t bench_tx_power;      //!< Returned by ri_adv_tx_power_get.
+extern volatile uint32_t bench_event_count; //!< Count of motion events.
+extern volatile uint32_t bench_presence_count; //!< Count of presences.
+extern app_log_history_t bench_history;     //!< Returned by app_log_history_get.
+
+#endif // BENCH_STUBS_H
@@ -0,0 +1,214 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_acc_calibration.h"
+#include "ruuvi_endpoints.h"
+
+#include "mock_app_comms.h"
+#include "mock_app_sensor.h"
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_interface_log.h"
+#include "mock_ruuvi_interface_rtc.h"
+#include "mock_ruuvi_task_flash.h"
+
+#include <math.h>
+
+/** @brief Push samples alternating +- amplitude on X on top of gravity on Z. */
+static void samples_push (const float amplitude_g, const uint32_t count,
+                          const uint64_t start_ms)
+{
+    for (uint32_t ii = 0; ii < count; ii++)
+    {
+        const float x_g = (ii % 2U) ? amplitude_g : -amplitude_g;
+        calibration_sample (x_g, 0.0F, 1.0F, start_ms + ii);
+    }
+}
+
+void setUp (void)
+{
+    rd_error_check_Ignore();
+    ri_log_Ignore();
+    app_acc_calibration_reset();
+}
+
+void tearDown (void)
+{
+}
+
+void test_app_acc_calibration_init_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_acc_calibration_init (NULL));
+}
+
+void test_app_acc_calibration_init_stored (void)
+{
+    float threshold = APP_MOTION_THRESHOLD;
+    float stored = 0.2F;
+    rt_flash_load_ExpectAndReturn (APP_FLASH_SENSOR_FILE, APP_FLASH_SENSOR_ACC_THR_RECORD,
+                                   NULL, sizeof (float), RD_SUCCESS);
+    rt_flash_load_IgnoreArg_message();
+    rt_flash_load_ReturnMemThruPtr_message (&stored, sizeof (stored));
+    TEST_ASSERT (RD_SUCCESS == app_acc_calibration_init (&threshold));
+    TEST_ASSERT_EQUAL_FLOAT (0.2F, threshold);
+    TEST_ASSERT_FALSE (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_init_not_found_learns (void)
+{
+    float threshold = APP_MOTION_THRESHOLD;
+    rt_flash_load_ExpectAndReturn (APP_FLASH_SENSOR_FILE, APP_FLASH_SENSOR_ACC_THR_RECORD,
+                                   NULL, sizeof (float), RD_ERROR_NOT_FOUND);
+    rt_flash_load_IgnoreArg_message();
+    TEST_ASSERT (RD_SUCCESS == app_acc_calibration_init (&threshold));
+    TEST_ASSERT_EQUAL_FLOAT (APP_MOTION_THRESHOLD, threshold);
+    TEST_ASSERT (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_init_invalid_stored_learns (void)
+{
+    float threshold = APP_MOTION_THRESHOLD;
+    float stored = APP_ACC_CALIBRATION_MAX_G * 2.0F;
+    rt_flash_load_ExpectAndReturn (APP_FLASH_SENSOR_FILE, APP_FLASH_SENSOR_ACC_THR_RECORD,
+                                   NULL, sizeof (float), RD_SUCCESS);
+    rt_flash_load_IgnoreArg_message();
+    rt_flash_load_ReturnMemThruPtr_message (&stored, sizeof (stored));
+    TEST_ASSERT (RD_SUCCESS == app_acc_calibration_init (&threshold));
+    TEST_ASSERT_EQUAL_FLOAT (APP_MOTION_THRESHOLD, threshold);
+    TEST_ASSERT (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_not_learning_ignores_samples (void)
+{
+    samples_push (0.1F, APP_ACC_CALIBRATION_MIN_SAMPLES, 0U);
+    calibration_sample (0.0F, 0.0F, 1.0F, APP_ACC_CALIBRATION_PERIOD_MS);
+    TEST_ASSERT_FALSE (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_threshold_multiple_of_noise (void)
+{
+    app_acc_calibration_start();
+    samples_push (0.05F, 2U * APP_ACC_CALIBRATION_MIN_SAMPLES, 0U);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.05F * APP_ACC_CALIBRATION_MULTIPLIER,
+                              calibration_threshold());
+}
+
+void test_app_acc_calibration_threshold_limits (void)
+{
+    app_acc_calibration_start();
+    samples_push (0.0F, APP_ACC_CALIBRATION_MIN_SAMPLES, 0U);
+    TEST_ASSERT_EQUAL_FLOAT (APP_ACC_CALIBRATION_MIN_G, calibration_threshold());
+    app_acc_calibration_start();
+    samples_push (1.0F, APP_ACC_CALIBRATION_MIN_SAMPLES, 0U);
+    TEST_ASSERT_EQUAL_FLOAT (APP_ACC_CALIBRATION_MAX_G, calibration_threshold());
+}
+
+void test_app_acc_calibration_completes_and_stores (void)
+{
+    app_acc_calibration_start();
+    samples_push (0.05F, APP_ACC_CALIBRATION_MIN_SAMPLES, 1000U);
+    TEST_ASSERT (app_acc_calibration_is_learning());
+    app_sensor_acc_thr_set_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_flash_store_ExpectAndReturn (APP_FLASH_SENSOR_FILE,
+                                    APP_FLASH_SENSOR_ACC_THR_RECORD,
+                                    NULL, sizeof (float), RD_SUCCESS);
+    rt_flash_store_IgnoreArg_message();
+    calibration_sample (0.0F, 0.0F, 1.0F, 1000U + APP_ACC_CALIBRATION_PERIOD_MS);
+    TEST_ASSERT_FALSE (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_not_stored_if_not_applied (void)
+{
+    app_acc_calibration_start();
+    samples_push (0.05F, APP_ACC_CALIBRATION_MIN_SAMPLES, 0U);
+    app_sensor_acc_thr_set_ExpectAnyArgsAndReturn (RD_ERROR_NOT_SUPPORTED);
+    calibration_sample (0.0F, 0.0F, 1.0F, APP_ACC_CALIBRATION_PERIOD_MS);
+    TEST_ASSERT_FALSE (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_needs_min_samples (void)
+{
+    app_acc_calibration_start();
+    calibration_sample (0.0F, 0.0F, 1.0F, 0U);
+    calibration_sample (0.0F, 0.0F, 1.0F, APP_ACC_CALIBRATION_PERIOD_MS);
+    TEST_ASSERT (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_sample_push (void)
+{
+    app_acc_calibration_start();
+    ri_rtc_millis_ExpectAndReturn (1000U);
+    app_acc_calibration_sample_push (0.0F, 0.0F, 1.0F);
+    TEST_ASSERT (app_acc_calibration_is_learning());
+}
+
+void test_app_acc_calibration_sample_push_not_learning (void)
+{
+    // Time is not read if sample is not used.
+    app_acc_calibration_sample_push (0.0F, 0.0F, 1.0F);
+    TEST_ASSERT_FALSE (app_acc_calibration_is_learning());
+}
+
+static ri_comm_message_t m_reply;
+
+static rd_status_t blocking_send_stub (const ri_comm_xfer_fp_t reply_fp,
+                                       ri_comm_message_t * const msg,
+                                       const int cmock_num_calls)
+{
+    m_reply = *msg;
+    return RD_SUCCESS;
+}
+
+static uint16_t reply_threshold_mg (void)
+{
+    const uint8_t * const p_reply = &m_reply.data[RE_STANDARD_PAYLOAD_START_INDEX];
+    return (uint16_t) ( (p_reply[APP_ACC_CALIBRATION_REPLY_THR] << 8U)
+                        | p_reply[APP_ACC_CALIBRATION_REPLY_THR + 1U]);
+}
+
+static rd_status_t dummy_reply (ri_comm_message_t * const msg)
+{
+    return RD_SUCCESS;
+}
+
+void test_app_acc_calibration_handle_write_restarts (void)
+{
+    float threshold = 0.2F;
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    rt_flash_load_ExpectAndReturn (APP_FLASH_SENSOR_FILE, APP_FLASH_SENSOR_ACC_THR_RECORD,
+                                   NULL, sizeof (float), RD_SUCCESS);
+    rt_flash_load_IgnoreArg_message();
+    rt_flash_load_ReturnMemThruPtr_message (&threshold, sizeof (threshold));
+    TEST_ASSERT (RD_SUCCESS == app_acc_calibration_init (&threshold));
+    TEST_ASSERT_FALSE (app_acc_calibration_is_learning());
+    message[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_ACC_CALIBRATION;
+    message[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    app_comms_blocking_send_StubWithCallback (&blocking_send_stub);
+    TEST_ASSERT (RD_SUCCESS == app_acc_calibration_handle (&dummy_reply, message,
+                 sizeof (message)));
+    TEST_ASSERT (app_acc_calibration_is_learning());
+    TEST_ASSERT (1U == m_reply.data[RE_STANDARD_PAYLOAD_START_INDEX
+                                    + APP_ACC_CALIBRATION_REPLY_LEARNING]);
+    // Stored threshold stays active until new one is learned.
+    TEST_ASSERT (200U == reply_threshold_mg());
+}
+
+void test_app_acc_calibration_handle_read (void)
+{
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    message[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_ACC_CALIBRATION;
+    message[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_READ;
+    app_comms_blocking_send_StubWithCallback (&blocking_send_stub);
+    TEST_ASSERT (RD_SUCCESS == app_acc_calibration_handle (&dummy_reply, message,
+                 sizeof (message)));
+    TEST_ASSERT_FALSE (app_acc_calibration_is_learning());
+    TEST_ASSERT (UINT16_MAX == reply_threshold_mg());
+}
+
+void test_app_acc_calibration_handle_short (void)
+{
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    TEST_ASSERT (RD_ERROR_NULL == app_acc_calibration_handle (&dummy_reply, NULL,
+                 sizeof (message)));
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == app_acc_calibration_handle (&dummy_reply, message,
+                 RE_STANDARD_MESSAGE_LENGTH - 1U));
+}
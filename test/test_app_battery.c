@@ -0,0 +1,213 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_battery.h"
+
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_interface_log.h"
+#include "mock_ruuvi_interface_rtc.h"
+#include "mock_ruuvi_interface_scheduler.h"
+#include "mock_ruuvi_task_adc.h"
+
+#include <math.h>
+#include <string.h>
+
+void setUp (void)
+{
+    rd_error_check_Ignore();
+    ri_log_Ignore();
+    app_battery_reset();
+}
+
+void tearDown (void)
+{
+}
+
+void test_app_battery_state_get_no_pairs (void)
+{
+    app_battery_state_t state;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_battery_state_get (&state));
+    TEST_ASSERT (0U == state.pairs);
+    TEST_ASSERT (isnan (state.remaining_days));
+}
+
+void test_app_battery_state_get_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_battery_state_get (NULL));
+}
+
+void test_app_battery_pair_resistance (void)
+{
+    app_battery_state_t state;
+    battery_process (3.00F, false, 1000U);
+    battery_process (2.92F, true, 1001U);
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    TEST_ASSERT (1U == state.pairs);
+    TEST_ASSERT_EQUAL_FLOAT (3.00F, state.idle_v);
+    TEST_ASSERT_EQUAL_FLOAT (2.92F, state.load_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.08F, state.droop_max_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.1F, 0.08F / APP_BATTERY_TX_CURRENT_A,
+                              state.resistance_ohm);
+    TEST_ASSERT (isnan (state.remaining_days));
+}
+
+void test_app_battery_unpaired_samples_ignored (void)
+{
+    app_battery_state_t state;
+    // Load sample without rest sample.
+    battery_process (2.92F, true, 1000U);
+    // Rest sample too long before load sample.
+    battery_process (3.00F, false, 2000U);
+    battery_process (2.92F, true, 2000U + APP_BATTERY_PAIR_WINDOW_MS + 1U);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_battery_state_get (&state));
+}
+
+void test_app_battery_filtered (void)
+{
+    app_battery_state_t state;
+    battery_process (3.00F, false, 1000U);
+    battery_process (2.90F, true, 1001U);
+    battery_process (3.08F, false, 2000U);
+    battery_process (2.90F, true, 2001U);
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 3.00F + (0.08F / APP_BATTERY_FILTER_DIVISOR),
+                              state.idle_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 2.90F, state.load_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 0.18F, state.droop_max_v);
+}
+
+void test_app_battery_droop_max_recovers (void)
+{
+    app_battery_state_t state;
+    const uint32_t pairs = 8U * (uint32_t) APP_BATTERY_DROOP_DECAY_DIVISOR;
+    battery_process (3.00F, false, 0U);
+    battery_process (2.92F, true, 1U);
+    // Transient droop, for example a brownout or a cold spell.
+    battery_process (3.00F, false, 1000U);
+    battery_process (2.70F, true, 1001U);
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 0.30F, state.droop_max_v);
+    battery_process (3.00F, false, 2000U);
+    battery_process (2.92F, true, 2001U);
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    // Worst droop is still remembered after one pair.
+    TEST_ASSERT (0.29F < state.droop_max_v);
+
+    for (uint32_t ii = 0U; ii < pairs; ii++)
+    {
+        battery_process (3.00F, false, (ii + 3U) * 1000U);
+        battery_process (2.92F, true, ( (ii + 3U) * 1000U) + 1U);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.08F, state.droop_max_v);
+}
+
+void test_app_battery_trend_predicts_remaining (void)
+{
+    app_battery_state_t state;
+    const uint64_t period = APP_BATTERY_TREND_PERIOD_MS;
+    battery_process (3.00F, false, 0U);
+    battery_process (2.90F, true, 1U);
+
+    // Idle voltage drops by 8 mV per trend period, load follows.
+    for (uint32_t ii = 1U; ii <= 4U; ii++)
+    {
+        const float idle = 3.00F - (0.008F * ii);
+        battery_process (idle, false, ii * period);
+        battery_process (idle - 0.1F, true, (ii * period) + 1U);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    TEST_ASSERT (0.0F > state.trend_v_per_day);
+    TEST_ASSERT (!isnan (state.remaining_days));
+    TEST_ASSERT (0.0F < state.remaining_days);
+}
+
+void test_app_battery_remaining_zero_at_cutoff (void)
+{
+    app_battery_state_t state;
+    const uint64_t period = APP_BATTERY_TREND_PERIOD_MS;
+    battery_process (APP_BATTERY_CUTOFF_V + 0.05F, false, 0U);
+    battery_process (APP_BATTERY_CUTOFF_V - 0.05F, true, 1U);
+    battery_process (APP_BATTERY_CUTOFF_V + 0.05F, false, period);
+    battery_process (APP_BATTERY_CUTOFF_V - 0.05F, true, period + 1U);
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, state.remaining_days);
+}
+
+void test_app_battery_vdd_get_fallback (void)
+{
+    float vdd = 0.0F;
+    float adc_vdd = 3.1F;
+    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ReturnThruPtr_vdd (&adc_vdd);
+    TEST_ASSERT (RD_SUCCESS == app_battery_vdd_get (&vdd));
+    TEST_ASSERT_EQUAL_FLOAT (3.1F, vdd);
+}
+
+void test_app_battery_vdd_get_under_load (void)
+{
+    float vdd = 0.0F;
+    battery_process (2.95F, true, 1U);
+    TEST_ASSERT (RD_SUCCESS == app_battery_vdd_get (&vdd));
+    TEST_ASSERT_EQUAL_FLOAT (2.95F, vdd);
+}
+
+void test_app_battery_vdd_get_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_battery_vdd_get (NULL));
+}
+
+static uint8_t m_event[64];
+static uint16_t m_event_size;
+
+static rd_status_t event_put_stub (const void * const p_event_data,
+                                   const uint16_t event_size,
+                                   const ri_scheduler_event_handler_t handler,
+                                   int cmock_num_calls)
+{
+    memcpy (m_event, p_event_data, event_size);
+    m_event_size = event_size;
+    return RD_SUCCESS;
+}
+
+void test_app_battery_sample_isr_schedules (void)
+{
+    ri_rtc_millis_ExpectAndReturn (1000U);
+    ri_rtc_millis_ExpectAndReturn (1001U);
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &battery_sample_handler, RD_SUCCESS);
+    ri_scheduler_event_put_IgnoreArg_p_event_data();
+    ri_scheduler_event_put_IgnoreArg_event_size();
+    // Rest sample is latched without scheduling.
+    app_battery_sample_isr (3.0F, false);
+    app_battery_sample_isr (2.9F, true);
+}
+
+void test_app_battery_sample_handler_pairs_latched (void)
+{
+    app_battery_state_t state;
+    ri_rtc_millis_ExpectAndReturn (1000U);
+    ri_rtc_millis_ExpectAndReturn (1001U);
+    ri_scheduler_event_put_StubWithCallback (&event_put_stub);
+    app_battery_sample_isr (3.00F, false);
+    app_battery_sample_isr (2.92F, true);
+    battery_sample_handler (m_event, m_event_size);
+    TEST_ASSERT (RD_SUCCESS == app_battery_state_get (&state));
+    TEST_ASSERT (1U == state.pairs);
+    TEST_ASSERT_EQUAL_FLOAT (3.00F, state.idle_v);
+    TEST_ASSERT_EQUAL_FLOAT (2.92F, state.load_v);
+}
+
+void test_app_battery_sample_handler_load_only (void)
+{
+    app_battery_state_t state;
+    float vdd = 0.0F;
+    ri_rtc_millis_ExpectAndReturn (1001U);
+    ri_scheduler_event_put_StubWithCallback (&event_put_stub);
+    app_battery_sample_isr (2.92F, true);
+    battery_sample_handler (m_event, m_event_size);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_battery_state_get (&state));
+    TEST_ASSERT (RD_SUCCESS == app_battery_vdd_get (&vdd));
+    TEST_ASSERT_EQUAL_FLOAT (2.92F, vdd);
+}
@@ -4,8 +4,12 @@
 #include "app_comms.h"
 #include "ruuvi_boards.h"
 #include "ruuvi_endpoints.h"
+#include "mock_app_acc_calibration.h"
+#include "mock_app_dataformats.h"
 #include "mock_app_heartbeat.h"
 #include "mock_app_led.h"
+#include "mock_app_profile.h"
+#include "mock_app_radio.h"
 #include "mock_app_sensor.h"
 #include "mock_ruuvi_driver_error.h"
 #include "mock_ruuvi_interface_communication_ble_advertising.h"
@@ -186,7 +190,7 @@ static void app_comms_ble_init_Expect (const bool secure, ri_comm_dis_init_t * p
     test_dis_init (p_dis, secure);
     adv_init_Expect();
     gatt_init_Expect (p_dis, secure);
-    ri_radio_activity_callback_set_Expect (&app_sensor_vdd_measure_isr);
+    ri_radio_activity_callback_set_Expect (&app_radio_activity_isr);
 }
 
 void test_app_comms_init_ok (void)
@@ -204,7 +208,7 @@ void test_app_comms_init_ok (void)
     adv_init_Expect();
     test_dis_init (&ble_dis, true);
     gatt_init_Expect (&ble_dis, true);
-    ri_radio_activity_callback_set_Expect (&app_sensor_vdd_measure_isr);
+    ri_radio_activity_callback_set_Expect (&app_radio_activity_isr);
     rd_status_t err_code = app_comms_init (true);
     TEST_ASSERT (RD_SUCCESS == err_code);
 }
@@ -237,6 +241,7 @@ static void connection_cleanup_Expect (void)
     app_comms_ble_uninit_Expect();
     app_comms_ble_init_Expect (true, &ble_dis);
     app_led_configuration_mode_Expect (false);
+    app_dataformat_key_stage_clear_Expect();
 }
 
 void test_app_comms_configure_next_enable_ok (void)
@@ -288,6 +293,14 @@ void test_on_gatt_disconnected_isr (void)
     on_gatt_disconnected_isr (NULL, 0);
 }
 
+void test_app_comms_gatt_subscribed (void)
+{
+    rt_gatt_nus_is_connected_ExpectAndReturn (true);
+    TEST_ASSERT (app_comms_gatt_subscribed());
+    rt_gatt_nus_is_connected_ExpectAndReturn (false);
+    TEST_ASSERT (!app_comms_gatt_subscribed());
+}
+
 void test_on_gatt_received_isr (void)
 {
     uint8_t data[RI_SCHEDULER_SIZE];
@@ -321,6 +334,117 @@ void test_handle_gatt_sensor_op_acc (void)
     handle_gatt_data (mock_data, sizeof (mock_data));
 }
 
+void test_handle_gatt_sensor_stats (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_SENSOR_STATS;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_READ;
+    app_heartbeat_stop_ExpectAndReturn (RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, (30 * 1000), RD_SUCCESS);
+    app_sensor_stats_handle_ExpectAndReturn (&rt_gatt_send_asynchronous, mock_data,
+            sizeof (mock_data), RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_LOW_POWER, 0, RD_SUCCESS);
+    app_heartbeat_start_ExpectAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
+void test_handle_gatt_heartbeat_profile (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_HEARTBEAT_PROFILE;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_READ;
+    app_heartbeat_stop_ExpectAndReturn (RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, (30 * 1000), RD_SUCCESS);
+    app_profile_handle_ExpectAndReturn (&rt_gatt_send_asynchronous, mock_data,
+                                        sizeof (mock_data), RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_LOW_POWER, 0, RD_SUCCESS);
+    app_heartbeat_start_ExpectAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
+void test_handle_gatt_dataformat_key (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_DATAFORMAT_KEY;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    m_config_enabled_on_curr_conn = true;
+    app_heartbeat_stop_ExpectAndReturn (RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, (30 * 1000), RD_SUCCESS);
+    app_dataformat_key_handle_ExpectAndReturn (&rt_gatt_send_asynchronous, mock_data,
+            sizeof (mock_data), RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_LOW_POWER, 0, RD_SUCCESS);
+    app_heartbeat_start_ExpectAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
+void test_handle_gatt_dataformat_key_locked (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_DATAFORMAT_KEY;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    // Key is not handed to data formats without unlocked configuration.
+    rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
+void test_handle_gatt_dataformat_weights (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_DATAFORMAT_WEIGHTS;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    m_config_enabled_on_curr_conn = true;
+    app_heartbeat_stop_ExpectAndReturn (RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, (30 * 1000), RD_SUCCESS);
+    app_dataformat_weights_handle_ExpectAndReturn (&rt_gatt_send_asynchronous,
+            mock_data, sizeof (mock_data), RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_LOW_POWER, 0, RD_SUCCESS);
+    app_heartbeat_start_ExpectAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
+void test_handle_gatt_dataformat_weights_locked (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_DATAFORMAT_WEIGHTS;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    // Rotation is not changed without unlocked configuration.
+    rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
+void test_handle_gatt_acc_calibration (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_ACC_CALIBRATION;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    m_config_enabled_on_curr_conn = true;
+    app_heartbeat_stop_ExpectAndReturn (RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, (30 * 1000), RD_SUCCESS);
+    app_acc_calibration_handle_ExpectAndReturn (&rt_gatt_send_asynchronous,
+            mock_data, sizeof (mock_data), RD_SUCCESS);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_LOW_POWER, 0, RD_SUCCESS);
+    app_heartbeat_start_ExpectAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
+void test_handle_gatt_acc_calibration_locked (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_ACC_CALIBRATION;
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    // Learning is not restarted without unlocked configuration.
+    rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    RD_ERROR_CHECK_EXPECT (RD_SUCCESS, ~RD_ERROR_FATAL);
+    handle_gatt_data (mock_data, sizeof (mock_data));
+}
+
 void test_handle_gatt_password_ok (void)
 {
     uint64_t password = 0x1122334455667788;
@@ -457,6 +581,16 @@ void test_handle_nfc_disconnected (void)
     TEST_ASSERT (m_mode_ops.disable_config);
 }
 
+void test_on_nfc_connected_isr_tracks_reader (void)
+{
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &handle_nfc_connected, RD_SUCCESS);
+    on_nfc_connected_isr (NULL, 0);
+    TEST_ASSERT (app_comms_nfc_connected());
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &handle_nfc_disconnected, RD_SUCCESS);
+    on_nfc_disconnected_isr (NULL, 0);
+    TEST_ASSERT (!app_comms_nfc_connected());
+}
+
 void test_on_nfc_received_isr (void)
 {
     uint8_t data[RI_SCHEDULER_SIZE];
@@ -0,0 +1,391 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_dataformat_decoder.h"
+#include "app_dataformat_ext.h"
+#include "app_dataformat_history.h"
+
+#include <math.h>
+#include <string.h>
+
+#define TEST_COUNT ((3U * APP_DF_DECODER_CHUNK) + 5U)
+
+// Test vectors of official formats from docs.ruuvi.com.
+static const uint8_t m_df5_valid[] =
+{
+    0x05, 0x12, 0xFC, 0x53, 0x94, 0xC3, 0x7C, 0x00, 0x04, 0xFF, 0xFC, 0x04,
+    0x0C, 0xAC, 0x36, 0x42, 0x00, 0xCD, 0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F
+};
+static const uint8_t m_df5_invalid[] =
+{
+    0x05, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x80, 0x00, 0x80,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+static const uint8_t m_df3_valid[] =
+{
+    0x03, 0x29, 0x1A, 0x1E, 0xCE, 0x1E, 0xFC, 0x18, 0xF9, 0x42, 0x02, 0xCA,
+    0x0B, 0x53
+};
+static const uint8_t m_dfc5_valid[] =
+{
+    0xC5, 0x12, 0xFC, 0x53, 0x94, 0xC3, 0x7C, 0xAC, 0x36, 0x42, 0x00, 0xCD,
+    0xCB, 0xB8, 0x33, 0x4C, 0x88, 0x4F
+};
+
+static uint8_t m_raw[TEST_COUNT][APP_DF_DECODER_RECORD_MAX];
+static uint8_t m_lengths[TEST_COUNT];
+static app_dataformat_t m_format[TEST_COUNT];
+static float m_temperature_c[TEST_COUNT];
+static float m_humidity_rh[TEST_COUNT];
+static float m_pressure_pa[TEST_COUNT];
+static float m_acceleration_x_g[TEST_COUNT];
+static float m_acceleration_y_g[TEST_COUNT];
+static float m_acceleration_z_g[TEST_COUNT];
+static float m_battery_v[TEST_COUNT];
+static float m_tx_power_dbm[TEST_COUNT];
+static float m_battery_resistance_ohm[TEST_COUNT];
+static float m_battery_remaining_days[TEST_COUNT];
+static float m_vibration_rms_g[TEST_COUNT];
+static float m_vibration_peak_g[TEST_COUNT];
+static float m_vibration_crest[TEST_COUNT];
+static float m_vibration_hz[TEST_COUNT];
+static float m_temperature_min_c[TEST_COUNT];
+static float m_temperature_max_c[TEST_COUNT];
+static int32_t m_movement_count[TEST_COUNT];
+static int32_t m_presence_count[TEST_COUNT];
+static int32_t m_sequence[TEST_COUNT];
+static uint64_t m_address[TEST_COUNT];
+static uint8_t m_flags[TEST_COUNT];
+static int32_t m_log_sequence[TEST_COUNT];
+static uint16_t m_log_interval_s[TEST_COUNT];
+static float m_logged_temperature_c[TEST_COUNT * APP_DF_HISTORY_SAMPLES];
+static float m_logged_humidity_rh[TEST_COUNT * APP_DF_HISTORY_SAMPLES];
+static float m_logged_pressure_pa[TEST_COUNT * APP_DF_HISTORY_SAMPLES];
+static app_dataformat_decoded_t m_out;
+
+void setUp (void)
+{
+    memset (m_raw, 0, sizeof (m_raw));
+    memset (m_lengths, 0, sizeof (m_lengths));
+    m_out.format = m_format;
+    m_out.temperature_c = m_temperature_c;
+    m_out.humidity_rh = m_humidity_rh;
+    m_out.pressure_pa = m_pressure_pa;
+    m_out.acceleration_x_g = m_acceleration_x_g;
+    m_out.acceleration_y_g = m_acceleration_y_g;
+    m_out.acceleration_z_g = m_acceleration_z_g;
+    m_out.battery_v = m_battery_v;
+    m_out.tx_power_dbm = m_tx_power_dbm;
+    m_out.battery_resistance_ohm = m_battery_resistance_ohm;
+    m_out.battery_remaining_days = m_battery_remaining_days;
+    m_out.vibration_rms_g = m_vibration_rms_g;
+    m_out.vibration_peak_g = m_vibration_peak_g;
+    m_out.vibration_crest = m_vibration_crest;
+    m_out.vibration_hz = m_vibration_hz;
+    m_out.temperature_min_c = m_temperature_min_c;
+    m_out.temperature_max_c = m_temperature_max_c;
+    m_out.movement_count = m_movement_count;
+    m_out.presence_count = m_presence_count;
+    m_out.sequence = m_sequence;
+    m_out.address = m_address;
+    m_out.flags = m_flags;
+    m_out.log_sequence = m_log_sequence;
+    m_out.log_interval_s = m_log_interval_s;
+    m_out.logged_temperature_c = m_logged_temperature_c;
+    m_out.logged_humidity_rh = m_logged_humidity_rh;
+    m_out.logged_pressure_pa = m_logged_pressure_pa;
+}
+
+void tearDown (void)
+{
+}
+
+static void record_set (const size_t index, const uint8_t * const p_raw,
+                        const size_t length)
+{
+    memcpy (m_raw[index], p_raw, length);
+    m_lengths[index] = (uint8_t) length;
+}
+
+static rd_status_t records_decode (const size_t count)
+{
+    return app_dataformat_decode (&m_raw[0][0], sizeof (m_raw[0]), m_lengths, count,
+                                  &m_out);
+}
+
+static void record_invalid_check (const size_t index)
+{
+    TEST_ASSERT (isnan (m_temperature_c[index]));
+    TEST_ASSERT (isnan (m_humidity_rh[index]));
+    TEST_ASSERT (isnan (m_pressure_pa[index]));
+    TEST_ASSERT (isnan (m_acceleration_x_g[index]));
+    TEST_ASSERT (isnan (m_acceleration_y_g[index]));
+    TEST_ASSERT (isnan (m_acceleration_z_g[index]));
+    TEST_ASSERT (isnan (m_battery_v[index]));
+    TEST_ASSERT (isnan (m_tx_power_dbm[index]));
+    TEST_ASSERT (isnan (m_battery_resistance_ohm[index]));
+    TEST_ASSERT (isnan (m_battery_remaining_days[index]));
+    TEST_ASSERT (isnan (m_vibration_rms_g[index]));
+    TEST_ASSERT (isnan (m_vibration_peak_g[index]));
+    TEST_ASSERT (isnan (m_vibration_crest[index]));
+    TEST_ASSERT (isnan (m_vibration_hz[index]));
+    TEST_ASSERT (isnan (m_temperature_min_c[index]));
+    TEST_ASSERT (isnan (m_temperature_max_c[index]));
+    TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_movement_count[index]);
+    TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_presence_count[index]);
+    TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_sequence[index]);
+    TEST_ASSERT (APP_DF_DECODER_ADDRESS_INVALID == m_address[index]);
+    TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_log_sequence[index]);
+}
+
+static void df5_valid_check (const size_t index)
+{
+    TEST_ASSERT (DF_5 == m_format[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 24.3F, m_temperature_c[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 53.49F, m_humidity_rh[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.1F, 100044.0F, m_pressure_pa[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 0.004F, m_acceleration_x_g[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, -0.004F, m_acceleration_y_g[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 1.036F, m_acceleration_z_g[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 2.977F, m_battery_v[index]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 4.0F, m_tx_power_dbm[index]);
+    TEST_ASSERT (66 == m_movement_count[index]);
+    TEST_ASSERT (205 == m_sequence[index]);
+    TEST_ASSERT (0xCBB8334C884FULL == m_address[index]);
+}
+
+void test_app_dataformat_decode_5 (void)
+{
+    record_set (0U, m_df5_valid, sizeof (m_df5_valid));
+    TEST_ASSERT (RD_SUCCESS == records_decode (1U));
+    df5_valid_check (0U);
+    TEST_ASSERT (0U == m_flags[0]);
+    TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_log_sequence[0]);
+    TEST_ASSERT (isnan (m_logged_temperature_c[0]));
+}
+
+void test_app_dataformat_decode_5_invalid (void)
+{
+    record_set (0U, m_df5_invalid, sizeof (m_df5_invalid));
+    TEST_ASSERT (RD_SUCCESS == records_decode (1U));
+    TEST_ASSERT (DF_5 == m_format[0]);
+    record_invalid_check (0U);
+}
+
+void test_app_dataformat_decode_3 (void)
+{
+    record_set (0U, m_df3_valid, sizeof (m_df3_valid));
+    TEST_ASSERT (RD_SUCCESS == records_decode (1U));
+    TEST_ASSERT (DF_3 == m_format[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 26.3F, m_temperature_c[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.5F, m_humidity_rh[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.1F, 102766.0F, m_pressure_pa[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, -1.0F, m_acceleration_x_g[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, -1.726F, m_acceleration_y_g[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 0.714F, m_acceleration_z_g[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 2.899F, m_battery_v[0]);
+    TEST_ASSERT (isnan (m_tx_power_dbm[0]));
+    TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_sequence[0]);
+    TEST_ASSERT (APP_DF_DECODER_ADDRESS_INVALID == m_address[0]);
+}
+
+void test_app_dataformat_decode_c5 (void)
+{
+    record_set (0U, m_dfc5_valid, sizeof (m_dfc5_valid));
+    m_lengths[0] = RE_C5_DATA_LENGTH;
+    TEST_ASSERT (RD_SUCCESS == records_decode (1U));
+    TEST_ASSERT (DF_C5 == m_format[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 24.3F, m_temperature_c[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 53.49F, m_humidity_rh[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.1F, 100044.0F, m_pressure_pa[0]);
+    TEST_ASSERT (isnan (m_acceleration_x_g[0]));
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 2.977F, m_battery_v[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 4.0F, m_tx_power_dbm[0]);
+    TEST_ASSERT (66 == m_movement_count[0]);
+    TEST_ASSERT (205 == m_sequence[0]);
+    TEST_ASSERT (0xCBB8334C884FULL == m_address[0]);
+}
+
+void test_app_dataformat_decode_history (void)
+{
+    app_dataformat_history_t history =
+    {
+        .temperature_c = 24.3F, .humidity_rh = 53.5F, .pressure_pa = 100044.0F,
+        .sequence = 0x1234U, .interval_s = 300U, .num_samples = 2U,
+        .samples = { { 24.1F, 54.5F, 100004.0F }, { 25.0F, NAN, 100094.0F } }
+    };
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_history_encode (m_raw[0], &history));
+    m_lengths[0] = APP_DF_HISTORY_DATA_LENGTH;
+    TEST_ASSERT (RD_SUCCESS == records_decode (1U));
+    TEST_ASSERT (DF_HISTORY == m_format[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 24.3F, m_temperature_c[0]);
+    TEST_ASSERT (0x1234 == m_log_sequence[0]);
+    TEST_ASSERT (300U == m_log_interval_s[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 24.1F, m_logged_temperature_c[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 54.5F, m_logged_humidity_rh[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.1F, 100004.0F, m_logged_pressure_pa[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 25.0F, m_logged_temperature_c[1]);
+    TEST_ASSERT (isnan (m_logged_humidity_rh[1]));
+    TEST_ASSERT_FLOAT_WITHIN (0.1F, 100094.0F, m_logged_pressure_pa[1]);
+
+    // Samples which were not sent are invalid.
+    for (size_t ii = 2U; ii < APP_DF_HISTORY_SAMPLES; ii++)
+    {
+        TEST_ASSERT (isnan (m_logged_temperature_c[ii]));
+        TEST_ASSERT (isnan (m_logged_humidity_rh[ii]));
+        TEST_ASSERT (isnan (m_logged_pressure_pa[ii]));
+    }
+}
+
+void test_app_dataformat_decode_ext (void)
+{
+    app_dataformat_ext_t ext =
+    {
+        .temperature_c = 24.3F, .humidity_rh = 53.5F, .pressure_pa = 100044.0F,
+        .acceleration_x_g = 0.004F, .acceleration_y_g = -0.004F,
+        .acceleration_z_g = 1.036F, .battery_v = 2.977F,
+        .resistance_ohm = 12.34F, .remaining_days = 400.0F,
+        .vibration_rms_g = 0.123F, .vibration_peak_g = 0.456F,
+        .vibration_crest = 3.7F, .vibration_hz = 12.5F,
+        .temperature_min_c = 24.1F, .temperature_max_c = 24.5F,
+        .address = 0xCBB8334C884FULL, .sequence = 205U, .movement_count = 0x1234U,
+        .presence_count = 0x0102U, .log_sequence = 0xABCDU, .log_interval_s = 300U,
+        .tx_power = -4, .motion = true, .log = true
+    };
+    const uint8_t flags = APP_DF_EXT_FLAG_MOTION | APP_DF_EXT_FLAG_LOG;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_ext_encode (m_raw[0], &ext));
+    m_lengths[0] = APP_DF_EXT_DATA_LENGTH;
+    TEST_ASSERT (RD_SUCCESS == records_decode (1U));
+    TEST_ASSERT (DF_EXT == m_format[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 24.3F, m_temperature_c[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 53.5F, m_humidity_rh[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.1F, 100044.0F, m_pressure_pa[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, -0.004F, m_acceleration_y_g[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 2.977F, m_battery_v[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, -4.0F, m_tx_power_dbm[0]);
+    TEST_ASSERT (flags == m_flags[0]);
+    TEST_ASSERT (205 == m_sequence[0]);
+    TEST_ASSERT (0x1234 == m_movement_count[0]);
+    TEST_ASSERT (0x0102 == m_presence_count[0]);
+    TEST_ASSERT (0xABCD == m_log_sequence[0]);
+    TEST_ASSERT (300U == m_log_interval_s[0]);
+    TEST_ASSERT (0xCBB8334C884FULL == m_address[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 12.34F, m_battery_resistance_ohm[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 400.0F, m_battery_remaining_days[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 0.123F, m_vibration_rms_g[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 0.456F, m_vibration_peak_g[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 3.7F, m_vibration_crest[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 12.5F, m_vibration_hz[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 24.1F, m_temperature_min_c[0]);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 24.5F, m_temperature_max_c[0]);
+}
+
+void test_app_dataformat_decode_ext_invalid (void)
+{
+    app_dataformat_ext_t ext =
+    {
+        .temperature_c = NAN, .humidity_rh = NAN, .pressure_pa = NAN,
+        .acceleration_x_g = NAN, .acceleration_y_g = NAN, .acceleration_z_g = NAN,
+        .battery_v = NAN, .resistance_ohm = NAN, .remaining_days = NAN,
+        .vibration_rms_g = NAN, .vibration_peak_g = NAN, .vibration_crest = NAN,
+        .vibration_hz = NAN, .temperature_min_c = NAN, .temperature_max_c = NAN
+    };
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_ext_encode (m_raw[0], &ext));
+    m_lengths[0] = APP_DF_EXT_DATA_LENGTH;
+    TEST_ASSERT (RD_SUCCESS == records_decode (1U));
+    TEST_ASSERT (DF_EXT == m_format[0]);
+    TEST_ASSERT (isnan (m_temperature_c[0]));
+    TEST_ASSERT (isnan (m_battery_v[0]));
+    TEST_ASSERT (isnan (m_battery_resistance_ohm[0]));
+    TEST_ASSERT (isnan (m_battery_remaining_days[0]));
+    TEST_ASSERT (isnan (m_vibration_rms_g[0]));
+    TEST_ASSERT (isnan (m_vibration_peak_g[0]));
+    TEST_ASSERT (isnan (m_vibration_crest[0]));
+    TEST_ASSERT (isnan (m_vibration_hz[0]));
+    TEST_ASSERT (isnan (m_temperature_min_c[0]));
+    TEST_ASSERT (isnan (m_temperature_max_c[0]));
+    TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_log_sequence[0]);
+}
+
+void test_app_dataformat_decode_unknown (void)
+{
+    const uint8_t unknown[] = { 0x42U, 0x00U, 0x01U };
+    record_set (0U, unknown, sizeof (unknown));
+    // Truncated record.
+    record_set (1U, m_df5_valid, sizeof (m_df5_valid) - 1U);
+    // Empty record.
+    m_lengths[2] = 0U;
+    TEST_ASSERT (RD_SUCCESS == records_decode (3U));
+
+    for (size_t ii = 0; ii < 3U; ii++)
+    {
+        TEST_ASSERT (DF_INVALID == m_format[ii]);
+        record_invalid_check (ii);
+    }
+}
+
+void test_app_dataformat_decode_encrypted (void)
+{
+    m_raw[0][0] = 0x08U;
+    m_lengths[0] = RE_8_DATA_LENGTH;
+    m_raw[1][0] = 0xFAU;
+    m_lengths[1] = RE_FA_DATA_LENGTH;
+    TEST_ASSERT (RD_SUCCESS == records_decode (2U));
+    TEST_ASSERT (DF_8 == m_format[0]);
+    TEST_ASSERT (DF_FA == m_format[1]);
+    record_invalid_check (0U);
+    record_invalid_check (1U);
+}
+
+void test_app_dataformat_decode_mixed_batch (void)
+{
+    // Formats interleaved over several chunks, with a partial chunk at the end.
+    for (size_t ii = 0; ii < TEST_COUNT; ii++)
+    {
+        if (0U == (ii % 3U))
+        {
+            record_set (ii, m_df5_valid, sizeof (m_df5_valid));
+        }
+        else if (1U == (ii % 3U))
+        {
+            record_set (ii, m_df3_valid, sizeof (m_df3_valid));
+        }
+        else
+        {
+            record_set (ii, m_df5_invalid, sizeof (m_df5_invalid));
+        }
+    }
+
+    TEST_ASSERT (RD_SUCCESS == records_decode (TEST_COUNT));
+
+    for (size_t ii = 0; ii < TEST_COUNT; ii++)
+    {
+        if (0U == (ii % 3U))
+        {
+            df5_valid_check (ii);
+        }
+        else if (1U == (ii % 3U))
+        {
+            TEST_ASSERT (DF_3 == m_format[ii]);
+            TEST_ASSERT_FLOAT_WITHIN (0.001F, 26.3F, m_temperature_c[ii]);
+            TEST_ASSERT (APP_DF_DECODER_COUNT_INVALID == m_sequence[ii]);
+        }
+        else
+        {
+            TEST_ASSERT (DF_5 == m_format[ii]);
+            record_invalid_check (ii);
+        }
+    }
+}
+
+void test_app_dataformat_decode_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_decode (NULL, sizeof (m_raw[0]),
+                 m_lengths, 1U, &m_out));
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_decode (&m_raw[0][0],
+                 sizeof (m_raw[0]), NULL, 1U, &m_out));
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_decode (&m_raw[0][0],
+                 sizeof (m_raw[0]), m_lengths, 1U, NULL));
+    m_out.logged_pressure_pa = NULL;
+    TEST_ASSERT (RD_ERROR_NULL == records_decode (1U));
+}
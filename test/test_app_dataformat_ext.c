@@ -0,0 +1,132 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_dataformat_ext.h"
+
+#include <math.h>
+#include <string.h>
+
+static app_dataformat_ext_t m_data;
+static uint8_t m_buffer[APP_DF_EXT_DATA_LENGTH];
+
+void setUp (void)
+{
+    memset (&m_data, 0, sizeof (m_data));
+    memset (m_buffer, 0, sizeof (m_buffer));
+    m_data.temperature_c = 24.3F;
+    m_data.humidity_rh = 53.5F;
+    m_data.pressure_pa = 100044.0F;
+    m_data.acceleration_x_g = 0.004F;
+    m_data.acceleration_y_g = -0.004F;
+    m_data.acceleration_z_g = 1.036F;
+    m_data.battery_v = 2.977F;
+    m_data.resistance_ohm = 12.34F;
+    m_data.remaining_days = 400.0F;
+    m_data.vibration_rms_g = 0.123F;
+    m_data.vibration_peak_g = 0.456F;
+    m_data.vibration_crest = 3.7F;
+    m_data.vibration_hz = 12.5F;
+    m_data.temperature_min_c = 24.1F;
+    m_data.temperature_max_c = 24.5F;
+    m_data.address = 0x0000CBB8334C884FULL;
+    m_data.sequence = 205U;
+    m_data.movement_count = 0x1234U;
+    m_data.presence_count = 0x0102U;
+    m_data.tx_power = -4;
+}
+
+void tearDown (void)
+{
+}
+
+static uint16_t u16_read (const size_t offset)
+{
+    return (uint16_t) ( (m_buffer[offset] << 8U) | m_buffer[offset + 1U]);
+}
+
+void test_app_dataformat_ext_encode_all (void)
+{
+    const uint8_t address[] = { 0xCBU, 0xB8U, 0x33U, 0x4CU, 0x88U, 0x4FU };
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_ext_encode (m_buffer, &m_data));
+    TEST_ASSERT (APP_DF_EXT_ID == m_buffer[APP_DF_EXT_OFFSET_HEADER]);
+    TEST_ASSERT (4860U == u16_read (APP_DF_EXT_OFFSET_TEMP));
+    TEST_ASSERT (21400U == u16_read (APP_DF_EXT_OFFSET_HUMI));
+    TEST_ASSERT (50044U == u16_read (APP_DF_EXT_OFFSET_PRES));
+    TEST_ASSERT (4 == (int16_t) u16_read (APP_DF_EXT_OFFSET_ACC_X));
+    TEST_ASSERT (-4 == (int16_t) u16_read (APP_DF_EXT_OFFSET_ACC_Y));
+    TEST_ASSERT (1036 == (int16_t) u16_read (APP_DF_EXT_OFFSET_ACC_Z));
+    TEST_ASSERT (2977U == u16_read (APP_DF_EXT_OFFSET_BATTERY));
+    TEST_ASSERT (-4 == (int8_t) m_buffer[APP_DF_EXT_OFFSET_TX_POWER]);
+    TEST_ASSERT (0U == m_buffer[APP_DF_EXT_OFFSET_FLAGS]);
+    TEST_ASSERT (205U == u16_read (APP_DF_EXT_OFFSET_SEQUENCE));
+    TEST_ASSERT (0x1234U == u16_read (APP_DF_EXT_OFFSET_MOVEMENT));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (address, &m_buffer[APP_DF_EXT_OFFSET_ADDRESS],
+                                   sizeof (address));
+    TEST_ASSERT (1234U == u16_read (APP_DF_EXT_OFFSET_RESISTANCE));
+    TEST_ASSERT (400U == u16_read (APP_DF_EXT_OFFSET_REMAINING));
+    TEST_ASSERT (123U == u16_read (APP_DF_EXT_OFFSET_VIB_RMS));
+    TEST_ASSERT (456U == u16_read (APP_DF_EXT_OFFSET_VIB_PEAK));
+    TEST_ASSERT (37U == m_buffer[APP_DF_EXT_OFFSET_VIB_CREST]);
+    TEST_ASSERT (125U == u16_read (APP_DF_EXT_OFFSET_VIB_FREQ));
+    TEST_ASSERT (4820U == u16_read (APP_DF_EXT_OFFSET_TEMP_MIN));
+    TEST_ASSERT (4900U == u16_read (APP_DF_EXT_OFFSET_TEMP_MAX));
+    TEST_ASSERT (0x0102U == u16_read (APP_DF_EXT_OFFSET_PRESENCE));
+}
+
+void test_app_dataformat_ext_encode_flags_and_log (void)
+{
+    m_data.motion = true;
+    m_data.presence = true;
+    m_data.log = true;
+    m_data.log_sequence = 0xABCDU;
+    m_data.log_interval_s = 300U;
+    const uint8_t flags = APP_DF_EXT_FLAG_MOTION | APP_DF_EXT_FLAG_PRESENCE
+                          | APP_DF_EXT_FLAG_LOG;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_ext_encode (m_buffer, &m_data));
+    TEST_ASSERT (flags == m_buffer[APP_DF_EXT_OFFSET_FLAGS]);
+    TEST_ASSERT (0xABCDU == u16_read (APP_DF_EXT_OFFSET_LOG_SEQUENCE));
+    TEST_ASSERT (300U == u16_read (APP_DF_EXT_OFFSET_LOG_INTERVAL));
+}
+
+void test_app_dataformat_ext_encode_log_invalid (void)
+{
+    m_data.log_sequence = 0xABCDU;
+    m_data.log_interval_s = 300U;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_ext_encode (m_buffer, &m_data));
+    TEST_ASSERT (0U == u16_read (APP_DF_EXT_OFFSET_LOG_SEQUENCE));
+    TEST_ASSERT (0U == u16_read (APP_DF_EXT_OFFSET_LOG_INTERVAL));
+}
+
+void test_app_dataformat_ext_encode_invalid_values (void)
+{
+    m_data.temperature_c = NAN;
+    m_data.humidity_rh = 170.0F;
+    m_data.pressure_pa = NAN;
+    m_data.acceleration_x_g = 40.0F;
+    m_data.acceleration_y_g = NAN;
+    m_data.battery_v = NAN;
+    m_data.resistance_ohm = NAN;
+    m_data.remaining_days = 70000.0F;
+    m_data.vibration_rms_g = NAN;
+    m_data.vibration_crest = 30.0F;
+    m_data.temperature_min_c = NAN;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_ext_encode (m_buffer, &m_data));
+    TEST_ASSERT (APP_DF_EXT_S16_INVALID == u16_read (APP_DF_EXT_OFFSET_TEMP));
+    TEST_ASSERT (APP_DF_EXT_U16_INVALID == u16_read (APP_DF_EXT_OFFSET_HUMI));
+    TEST_ASSERT (APP_DF_EXT_U16_INVALID == u16_read (APP_DF_EXT_OFFSET_PRES));
+    TEST_ASSERT (APP_DF_EXT_S16_INVALID == u16_read (APP_DF_EXT_OFFSET_ACC_X));
+    TEST_ASSERT (APP_DF_EXT_S16_INVALID == u16_read (APP_DF_EXT_OFFSET_ACC_Y));
+    TEST_ASSERT (1036 == (int16_t) u16_read (APP_DF_EXT_OFFSET_ACC_Z));
+    TEST_ASSERT (APP_DF_EXT_U16_INVALID == u16_read (APP_DF_EXT_OFFSET_BATTERY));
+    TEST_ASSERT (APP_DF_EXT_U16_INVALID == u16_read (APP_DF_EXT_OFFSET_RESISTANCE));
+    TEST_ASSERT (APP_DF_EXT_U16_INVALID == u16_read (APP_DF_EXT_OFFSET_REMAINING));
+    TEST_ASSERT (APP_DF_EXT_U16_INVALID == u16_read (APP_DF_EXT_OFFSET_VIB_RMS));
+    TEST_ASSERT (APP_DF_EXT_U8_INVALID == m_buffer[APP_DF_EXT_OFFSET_VIB_CREST]);
+    TEST_ASSERT (APP_DF_EXT_S16_INVALID == u16_read (APP_DF_EXT_OFFSET_TEMP_MIN));
+}
+
+void test_app_dataformat_ext_encode_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_ext_encode (NULL, &m_data));
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_ext_encode (m_buffer, NULL));
+}
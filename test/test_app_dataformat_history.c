@@ -0,0 +1,139 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_dataformat_history.h"
+
+#include <math.h>
+#include <string.h>
+
+static app_dataformat_history_t m_data;
+static uint8_t m_buffer[APP_DF_HISTORY_DATA_LENGTH];
+
+void setUp (void)
+{
+    memset (&m_data, 0, sizeof (m_data));
+    memset (m_buffer, 0, sizeof (m_buffer));
+    m_data.temperature_c = 24.3F;
+    m_data.humidity_rh = 53.5F;
+    m_data.pressure_pa = 100044.0F;
+    m_data.sequence = 0x1234U;
+    m_data.interval_s = 300U;
+}
+
+void tearDown (void)
+{
+}
+
+static uint16_t u16_read (const size_t offset)
+{
+    return (uint16_t) ( (m_buffer[offset] << 8U) | m_buffer[offset + 1U]);
+}
+
+static int8_t delta_read (const size_t sample, const size_t field)
+{
+    return (int8_t) m_buffer[APP_DF_HISTORY_OFFSET_DELTAS
+                             + (sample * APP_DF_HISTORY_DELTA_SIZE) + field];
+}
+
+void test_app_dataformat_history_encode_latest (void)
+{
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_history_encode (m_buffer, &m_data));
+    TEST_ASSERT (APP_DF_HISTORY_ID == m_buffer[APP_DF_HISTORY_OFFSET_HEADER]);
+    TEST_ASSERT (4860U == u16_read (APP_DF_HISTORY_OFFSET_TEMP));
+    TEST_ASSERT (21400U == u16_read (APP_DF_HISTORY_OFFSET_HUMI));
+    TEST_ASSERT (50044U == u16_read (APP_DF_HISTORY_OFFSET_PRES));
+    TEST_ASSERT (0x1234U == u16_read (APP_DF_HISTORY_OFFSET_SEQUENCE));
+    TEST_ASSERT (300U == u16_read (APP_DF_HISTORY_OFFSET_INTERVAL));
+    TEST_ASSERT (0U == m_buffer[APP_DF_HISTORY_OFFSET_COUNT]);
+
+    // Samples which are not sent are invalid.
+    for (size_t ii = APP_DF_HISTORY_OFFSET_DELTAS; ii < APP_DF_HISTORY_DATA_LENGTH; ii++)
+    {
+        TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == m_buffer[ii]);
+    }
+}
+
+void test_app_dataformat_history_encode_negative_temperature (void)
+{
+    m_data.temperature_c = -40.0F;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_history_encode (m_buffer, &m_data));
+    TEST_ASSERT (-8000 == (int16_t) u16_read (APP_DF_HISTORY_OFFSET_TEMP));
+}
+
+void test_app_dataformat_history_encode_deltas (void)
+{
+    m_data.num_samples = 2U;
+    m_data.samples[0].temperature_c = 24.1F;
+    m_data.samples[0].humidity_rh = 54.5F;
+    m_data.samples[0].pressure_pa = 100004.0F;
+    m_data.samples[1].temperature_c = 25.0F;
+    m_data.samples[1].humidity_rh = 50.0F;
+    m_data.samples[1].pressure_pa = 100094.0F;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_history_encode (m_buffer, &m_data));
+    TEST_ASSERT (2U == m_buffer[APP_DF_HISTORY_OFFSET_COUNT]);
+    TEST_ASSERT (-2 == delta_read (0U, 0U));
+    TEST_ASSERT (2 == delta_read (0U, 1U));
+    TEST_ASSERT (-4 == delta_read (0U, 2U));
+    TEST_ASSERT (7 == delta_read (1U, 0U));
+    TEST_ASSERT (-7 == delta_read (1U, 1U));
+    TEST_ASSERT (5 == delta_read (1U, 2U));
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == (uint8_t) delta_read (2U, 0U));
+}
+
+void test_app_dataformat_history_encode_delta_range (void)
+{
+    m_data.num_samples = 2U;
+    // 12.7 C is the largest delta, anything past it is invalid.
+    m_data.samples[0].temperature_c = m_data.temperature_c - 12.7F;
+    m_data.samples[0].humidity_rh = m_data.humidity_rh;
+    m_data.samples[0].pressure_pa = m_data.pressure_pa + 2000.0F;
+    m_data.samples[1].temperature_c = m_data.temperature_c + 13.0F;
+    m_data.samples[1].humidity_rh = NAN;
+    m_data.samples[1].pressure_pa = m_data.pressure_pa;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_history_encode (m_buffer, &m_data));
+    TEST_ASSERT (-127 == delta_read (0U, 0U));
+    TEST_ASSERT (0 == delta_read (0U, 1U));
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == (uint8_t) delta_read (0U, 2U));
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == (uint8_t) delta_read (1U, 0U));
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == (uint8_t) delta_read (1U, 1U));
+    TEST_ASSERT (0 == delta_read (1U, 2U));
+}
+
+void test_app_dataformat_history_encode_invalid_latest (void)
+{
+    m_data.temperature_c = NAN;
+    m_data.humidity_rh = NAN;
+    m_data.pressure_pa = 20000.0F;
+    m_data.num_samples = 1U;
+    m_data.samples[0].temperature_c = 24.1F;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_history_encode (m_buffer, &m_data));
+    TEST_ASSERT (APP_DF_HISTORY_TEMP_INVALID == u16_read (APP_DF_HISTORY_OFFSET_TEMP));
+    TEST_ASSERT (APP_DF_HISTORY_HUMI_INVALID == u16_read (APP_DF_HISTORY_OFFSET_HUMI));
+    TEST_ASSERT (APP_DF_HISTORY_PRES_INVALID == u16_read (APP_DF_HISTORY_OFFSET_PRES));
+    // Delta to an invalid reading can not be decoded.
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == (uint8_t) delta_read (0U, 0U));
+}
+
+void test_app_dataformat_history_encode_latest_out_of_range (void)
+{
+    m_data.temperature_c = 200.0F;
+    m_data.pressure_pa = 20000.0F;
+    m_data.num_samples = 1U;
+    m_data.samples[0].temperature_c = 199.5F;
+    m_data.samples[0].humidity_rh = 53.0F;
+    m_data.samples[0].pressure_pa = 20100.0F;
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_history_encode (m_buffer, &m_data));
+    // Deltas would be in range, but decoder has nothing to add them to.
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == (uint8_t) delta_read (0U, 0U));
+    TEST_ASSERT (-1 == delta_read (0U, 1U));
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == (uint8_t) delta_read (0U, 2U));
+}
+
+void test_app_dataformat_history_encode_errors (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_history_encode (NULL, &m_data));
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_history_encode (m_buffer, NULL));
+    m_data.num_samples = APP_DF_HISTORY_SAMPLES + 1U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_dataformat_history_encode (m_buffer,
+                 &m_data));
+}
@@ -3,9 +3,14 @@
 #include "unity.h"
 
 #include "app_dataformats.h"
+#include "app_dataformat_ext.h"
+#include "app_dataformat_history.h"
 #include <math.h>
 
 
+#include "mock_app_battery.h"
+#include "mock_app_comms.h"
+#include "mock_app_log.h"
 #include "mock_app_sensor.h"
 #include "mock_ruuvi_driver_error.h"
 #include "mock_ruuvi_driver_sensor.h"
@@ -20,11 +25,42 @@
 #include "mock_ruuvi_interface_communication_ble_advertising.h"
 #include "mock_ruuvi_interface_communication_radio.h"
 #include "mock_ruuvi_interface_communication.h"
-#include "mock_ruuvi_task_adc.h"
+#include "mock_ruuvi_task_flash.h"
+
+#include <string.h>
+
+static float m_parse_temperature_c; //!< Temperature returned by parse stub.
+static float m_parse_humidity_rh;   //!< Humidity returned by parse stub.
+static float m_parse_other;         //!< Other fields returned by parse stub.
+
+static float parse_stub (const rd_sensor_data_t * const provided,
+                         const rd_sensor_data_bitfield_t requested, int cmock_num_calls)
+{
+    float value = m_parse_other;
+
+    if (requested.temperature_c)
+    {
+        value = m_parse_temperature_c;
+    }
+    else if (requested.humidity_rh)
+    {
+        value = m_parse_humidity_rh;
+    }
+    else
+    {
+        // Other fields share a value.
+    }
+
+    return value;
+}
 
 void setUp (void)
 {
     rd_error_check_Ignore();
+    app_dataformat_reset();
+    m_parse_temperature_c = RD_FLOAT_INVALID;
+    m_parse_humidity_rh = RD_FLOAT_INVALID;
+    m_parse_other = RD_FLOAT_INVALID;
 }
 
 void tearDown (void)
@@ -58,25 +94,52 @@ rd_status_t app_dataformat_encode(uint8_t * const output,
                                   const app_dataformat_t format);
  */
 
+static app_dataformat_snapshot_t snapshot_get (void)
+{
+    app_dataformat_snapshot_t snapshot =
+    {
+        .temperature_c = 24.3F,
+        .humidity_rh = 53.5F,
+        .pressure_pa = 100044.0F,
+        .acceleration_x_g = 0.004F,
+        .acceleration_y_g = -0.004F,
+        .acceleration_z_g = 1.036F,
+        .motion = RD_FLOAT_INVALID,
+        .presence = RD_FLOAT_INVALID,
+        .debug_tamb = RD_FLOAT_INVALID,
+        .battery_v = 2.5F,
+        .address = 0x0000AABBCCDDEEFFULL,
+        .event_count = 1U,
+        .presence_count = 2U,
+        .tx_power = 4
+    };
+    return snapshot;
+}
+
+static void crypto_init_expect (void)
+{
+    // Nothing provisioned, compile-time keys are used.
+    rt_flash_load_ExpectAndReturn (APP_FLASH_DATAFORMAT_FILE,
+                                   APP_FLASH_DATAFORMAT_8_KEY_RECORD,
+                                   NULL, APP_DATAFORMAT_KEY_LENGTH, RD_ERROR_NOT_FOUND);
+    rt_flash_load_IgnoreArg_message();
+    ri_comm_id_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_flash_load_ExpectAndReturn (APP_FLASH_DATAFORMAT_FILE,
+                                   APP_FLASH_DATAFORMAT_FA_KEY_RECORD,
+                                   NULL, APP_DATAFORMAT_KEY_LENGTH, RD_ERROR_NOT_FOUND);
+    rt_flash_load_IgnoreArg_message();
+}
+
 void test_app_dataformat_encode_3_ok (void)
 {
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_3;
-    float voltage = 2.5F;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_3_encode_ExpectAndReturn (output, NULL, NAN, RE_SUCCESS);
     re_3_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_SUCCESS == status);
     TEST_ASSERT (RE_3_DATA_LENGTH == output_length);
 }
@@ -86,20 +149,11 @@ void test_app_dataformat_encode_3_error (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_3;
-    float voltage = 2.5F;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_3_encode_ExpectAndReturn (output, NULL, NAN, RE_ERROR_ENCODING);
     re_3_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_ERROR_INTERNAL == status);
 }
 
@@ -109,34 +163,12 @@ void test_app_dataformat_encode_5_ok (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_5;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
-    int8_t power = 4;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-#if APP_DATAFORMAT_FLAGS_IN_TX
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-#else
-    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_adv_tx_power_get_ReturnThruPtr_dbm (&power);
-#endif
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_5_encode_ExpectAndReturn (NULL, NULL, RE_SUCCESS);
     re_5_encode_IgnoreArg_buffer();
     re_5_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_SUCCESS == status);
     TEST_ASSERT (RE_5_DATA_LENGTH == output_length);
 }
@@ -146,34 +178,12 @@ void test_app_dataformat_encode_5_error (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_5;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
-    int8_t power = 4;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-#if APP_DATAFORMAT_FLAGS_IN_TX
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-#else
-    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_adv_tx_power_get_ReturnThruPtr_dbm (&power);
-#endif
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_5_encode_ExpectAndReturn (NULL, NULL, RE_ERROR_ENCODING);
     re_5_encode_IgnoreArg_buffer();
     re_5_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_ERROR_INTERNAL == status);
 }
 
@@ -182,23 +192,11 @@ void test_app_dataformat_encode_7_ok (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_7;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_7_encode_ExpectAndReturn (output, NULL, RE_SUCCESS);
     re_7_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_SUCCESS == status);
     TEST_ASSERT (RE_7_DATA_LENGTH == output_length);
 }
@@ -208,23 +206,11 @@ void test_app_dataformat_encode_7_error (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_7;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_7_encode_ExpectAndReturn (output, NULL, RE_ERROR_ENCODING);
     re_7_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_ERROR_INTERNAL == status);
 }
 
@@ -233,22 +219,9 @@ void test_app_dataformat_encode_8_ok (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_8;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
-    int8_t power = 4;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    ri_comm_id_get_ExpectAnyArgsAndReturn (RE_SUCCESS);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_adv_tx_power_get_ReturnThruPtr_dbm (&power);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    crypto_init_expect();
     re_8_encode_ExpectAndReturn (output,
                                  NULL, NULL, NULL,
                                  RE_8_CIPHERTEXT_LENGTH,
@@ -256,7 +229,7 @@ void test_app_dataformat_encode_8_ok (void)
     re_8_encode_IgnoreArg_cipher();
     re_8_encode_IgnoreArg_data();
     re_8_encode_IgnoreArg_key();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_SUCCESS == status);
     TEST_ASSERT (RE_8_DATA_LENGTH == output_length);
 }
@@ -266,22 +239,9 @@ void test_app_dataformat_encode_8_error (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_8;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
-    int8_t power = 4;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    ri_comm_id_get_ExpectAnyArgsAndReturn (RE_SUCCESS);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_adv_tx_power_get_ReturnThruPtr_dbm (&power);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    crypto_init_expect();
     re_8_encode_ExpectAndReturn (output,
                                  NULL, NULL, NULL,
                                  RE_8_CIPHERTEXT_LENGTH,
@@ -289,7 +249,7 @@ void test_app_dataformat_encode_8_error (void)
     re_8_encode_IgnoreArg_cipher();
     re_8_encode_IgnoreArg_data();
     re_8_encode_IgnoreArg_key();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_SUCCESS == status);
     TEST_ASSERT (RE_8_DATA_LENGTH == output_length);
 }
@@ -299,25 +259,12 @@ void test_app_dataformat_encode_c5_ok (void)
     uint8_t output[18] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_C5;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
-    int8_t power = 4;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_adv_tx_power_get_ReturnThruPtr_dbm (&power);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_c5_encode_ExpectAndReturn (NULL, NULL, RE_SUCCESS);
     re_c5_encode_IgnoreArg_buffer();
     re_c5_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_SUCCESS == status);
     TEST_ASSERT (RE_C5_DATA_LENGTH == output_length);
 }
@@ -327,25 +274,12 @@ void test_app_dataformat_encode_c5_error (void)
     uint8_t output[18] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_C5;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
-    int8_t power = 4;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    app_sensor_event_count_get_ExpectAndReturn (1);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
-    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_adv_tx_power_get_ReturnThruPtr_dbm (&power);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
     re_c5_encode_ExpectAndReturn (NULL, NULL, RE_ERROR_ENCODING);
     re_c5_encode_IgnoreArg_buffer();
     re_c5_encode_IgnoreArg_data();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_ERROR_INTERNAL == status);
 }
 
@@ -354,20 +288,9 @@ void test_app_dataformat_encode_fa_ok (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_FA;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    crypto_init_expect();
     re_fa_encode_ExpectAndReturn (output,
                                   NULL, NULL, NULL,
                                   RE_FA_CIPHERTEXT_LENGTH,
@@ -375,7 +298,7 @@ void test_app_dataformat_encode_fa_ok (void)
     re_fa_encode_IgnoreArg_data();
     re_fa_encode_IgnoreArg_cipher();
     re_fa_encode_IgnoreArg_key();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_ERROR_INTERNAL == status);
 }
 
@@ -384,20 +307,9 @@ void test_app_dataformat_encode_fa_error (void)
     uint8_t output[24] = {0};
     size_t output_length = sizeof (output);
     app_dataformat_t format = DF_FA;
-    float voltage = 2.5F;
-    uint64_t address = 0x0000AABBCCDDEEFF;
     rd_status_t status = RD_SUCCESS;
-    rd_sensor_data_t data = {0};
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
-    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    rt_adc_vdd_get_ReturnThruPtr_vdd (&voltage);
-    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
-    ri_radio_address_get_ReturnThruPtr_address (&address);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    crypto_init_expect();
     re_fa_encode_ExpectAndReturn (output,
                                   NULL, NULL, NULL,
                                   RE_FA_CIPHERTEXT_LENGTH,
@@ -405,10 +317,115 @@ void test_app_dataformat_encode_fa_error (void)
     re_fa_encode_IgnoreArg_data();
     re_fa_encode_IgnoreArg_cipher();
     re_fa_encode_IgnoreArg_key();
-    status = app_dataformat_encode (output, &output_length, &data, format);
+    status = app_dataformat_encode (output, &output_length, &snapshot, format);
     TEST_ASSERT (RD_ERROR_INTERNAL == status);
 }
 
+void test_app_dataformat_encode_history_ok (void)
+{
+    uint8_t output[APP_DF_HISTORY_DATA_LENGTH] = {0};
+    size_t output_length = sizeof (output);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    app_log_history_t history = {0};
+    history.sequence = 0x10203U;
+    history.interval_s = 300U;
+    history.num_samples = 2U;
+    history.samples[0].temperature_c = 24.1F;
+    history.samples[0].humidity_rh = 53.5F;
+    history.samples[0].pressure_pa = 100054.0F;
+    history.samples[1].temperature_c = 23.9F;
+    history.samples[1].humidity_rh = RD_FLOAT_INVALID;
+    history.samples[1].pressure_pa = 100044.0F;
+    app_log_history_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_log_history_get_ReturnThruPtr_p_history (&history);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_encode (output, &output_length, &snapshot,
+                 DF_HISTORY));
+    TEST_ASSERT (APP_DF_HISTORY_DATA_LENGTH == output_length);
+    TEST_ASSERT (APP_DF_HISTORY_ID == output[APP_DF_HISTORY_OFFSET_HEADER]);
+    // Sequence is truncated to 16 bits.
+    TEST_ASSERT (0x02U == output[APP_DF_HISTORY_OFFSET_SEQUENCE]);
+    TEST_ASSERT (0x03U == output[APP_DF_HISTORY_OFFSET_SEQUENCE + 1U]);
+    TEST_ASSERT (2U == output[APP_DF_HISTORY_OFFSET_COUNT]);
+    TEST_ASSERT (-2 == (int8_t) output[APP_DF_HISTORY_OFFSET_DELTAS]);
+    TEST_ASSERT (1 == (int8_t) output[APP_DF_HISTORY_OFFSET_DELTAS + 2U]);
+    // Humidity of second sample is missing.
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID
+                 == output[APP_DF_HISTORY_OFFSET_DELTAS + 4U]);
+}
+
+void test_app_dataformat_encode_history_no_log (void)
+{
+    uint8_t output[APP_DF_HISTORY_DATA_LENGTH] = {0};
+    size_t output_length = sizeof (output);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    app_log_history_get_ExpectAnyArgsAndReturn (RD_ERROR_NOT_SUPPORTED);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_encode (output, &output_length, &snapshot,
+                 DF_HISTORY));
+    TEST_ASSERT (0U == output[APP_DF_HISTORY_OFFSET_COUNT]);
+    TEST_ASSERT (APP_DF_HISTORY_DELTA_INVALID == output[APP_DF_HISTORY_OFFSET_DELTAS]);
+}
+
+void test_app_dataformat_encode_ext_ok (void)
+{
+    uint8_t output[APP_DF_EXT_DATA_LENGTH] = {0};
+    size_t output_length = sizeof (output);
+    app_dataformat_snapshot_t snapshot = snapshot_get();
+    app_log_history_t history = {0};
+    snapshot.motion = 1.0F;
+    history.sequence = 0x10203U;
+    history.interval_s = 300U;
+    app_battery_state_t battery = {0};
+    battery.resistance_ohm = 12.0F;
+    battery.remaining_days = 400.0F;
+    battery.pairs = 1U;
+    app_log_history_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_log_history_get_ReturnThruPtr_p_history (&history);
+    app_battery_state_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_battery_state_get_ReturnThruPtr_state (&battery);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_encode (output, &output_length, &snapshot,
+                 DF_EXT));
+    TEST_ASSERT (APP_DF_EXT_DATA_LENGTH == output_length);
+    TEST_ASSERT (APP_DF_EXT_ID == output[APP_DF_EXT_OFFSET_HEADER]);
+    TEST_ASSERT ( (APP_DF_EXT_FLAG_MOTION | APP_DF_EXT_FLAG_LOG)
+                  == output[APP_DF_EXT_OFFSET_FLAGS]);
+    TEST_ASSERT (1U == output[APP_DF_EXT_OFFSET_MOVEMENT + 1U]);
+    TEST_ASSERT (2U == output[APP_DF_EXT_OFFSET_PRESENCE + 1U]);
+    TEST_ASSERT (0x02U == output[APP_DF_EXT_OFFSET_LOG_SEQUENCE]);
+    TEST_ASSERT (0x03U == output[APP_DF_EXT_OFFSET_LOG_SEQUENCE + 1U]);
+    TEST_ASSERT (0xAAU == output[APP_DF_EXT_OFFSET_ADDRESS]);
+    TEST_ASSERT (0x04U == output[APP_DF_EXT_OFFSET_RESISTANCE]);
+    TEST_ASSERT (0xB0U == output[APP_DF_EXT_OFFSET_RESISTANCE + 1U]);
+    TEST_ASSERT (0x01U == output[APP_DF_EXT_OFFSET_REMAINING]);
+    TEST_ASSERT (0x90U == output[APP_DF_EXT_OFFSET_REMAINING + 1U]);
+}
+
+void test_app_dataformat_encode_ext_no_log (void)
+{
+    uint8_t output[APP_DF_EXT_DATA_LENGTH] = {0};
+    size_t output_length = sizeof (output);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    app_log_history_get_ExpectAnyArgsAndReturn (RD_ERROR_NOT_SUPPORTED);
+    app_battery_state_get_ExpectAnyArgsAndReturn (RD_ERROR_INVALID_STATE);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_encode (output, &output_length, &snapshot,
+                 DF_EXT));
+    TEST_ASSERT (0U == output[APP_DF_EXT_OFFSET_FLAGS]);
+    TEST_ASSERT (0xFFU == output[APP_DF_EXT_OFFSET_RESISTANCE]);
+    TEST_ASSERT (0xFFU == output[APP_DF_EXT_OFFSET_REMAINING]);
+    TEST_ASSERT (0xFFU == output[APP_DF_EXT_OFFSET_VIB_RMS]);
+    TEST_ASSERT (APP_DF_EXT_U8_INVALID == output[APP_DF_EXT_OFFSET_VIB_CREST]);
+    TEST_ASSERT (0x80U == output[APP_DF_EXT_OFFSET_TEMP_MIN]);
+}
+
+void test_app_dataformat_encode_ext_buffer_small (void)
+{
+    uint8_t output[APP_DF_EXT_DATA_LENGTH] = {0};
+    size_t output_length = APP_DF_EXT_DATA_LENGTH - 1U;
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == app_dataformat_encode (output, &output_length,
+                 &snapshot, DF_EXT));
+    TEST_ASSERT (0U == output[APP_DF_EXT_OFFSET_HEADER]);
+}
+
 void test_app_dataformat_next_all (void)
 {
     const app_dataformats_t formats = { DF_3 | DF_5 | DF_7 | DF_8 | DF_C5 | DF_FA };
@@ -472,4 +489,491 @@ void test_app_dataformat_next_two (void)
     TEST_ASSERT (format == DF_5);
 }
 
+void test_app_dataformat_next_unknown_format (void)
+{
+    // Bit without a registered format must not be rotated to.
+    const app_dataformats_t formats = { (1U << 8U) };
+    app_dataformat_t format = DF_5;
+    ri_adv_enable_uuid_Expect (false);
+    format = app_dataformat_next (formats, format);
+    TEST_ASSERT (format == DF_INVALID);
+}
+
+void test_app_dataformat_desc_get (void)
+{
+    const app_dataformat_desc_t * p_desc = app_dataformat_desc_get (DF_C5);
+    TEST_ASSERT_NOT_NULL (p_desc);
+    TEST_ASSERT (DF_C5 == p_desc->id);
+    TEST_ASSERT (p_desc->uuid);
+    TEST_ASSERT (0U < p_desc->weight);
+    TEST_ASSERT_NULL (app_dataformat_desc_get (DF_INVALID));
+}
+
+void test_app_dataformat_fields_get (void)
+{
+    const app_dataformats_t env_only = { DF_8 | DF_C5 };
+    const app_dataformats_t with_acc = { DF_C5 | DF_FA };
+    rd_sensor_data_fields_t fields = app_dataformat_fields_get (env_only);
+    TEST_ASSERT (fields.datas.temperature_c);
+    TEST_ASSERT (fields.datas.pressure_pa);
+    TEST_ASSERT (!fields.datas.acceleration_x_g);
+    fields = app_dataformat_fields_get (with_acc);
+    TEST_ASSERT (fields.datas.acceleration_x_g);
+    TEST_ASSERT (!fields.datas.motion);
+}
+
+void test_app_dataformat_fields_get_df5_flags (void)
+{
+    const app_dataformats_t df5 = { DF_5 };
+    const rd_sensor_data_fields_t fields = app_dataformat_fields_get (df5);
+    TEST_ASSERT (fields.datas.acceleration_x_g);
+    TEST_ASSERT (APP_DATAFORMAT_FLAGS_IN_TX == fields.datas.motion);
+    TEST_ASSERT (APP_DATAFORMAT_FLAGS_IN_TX == fields.datas.presence);
+    TEST_ASSERT (APP_DATAFORMAT_FLAGS_IN_TX == fields.datas.debug_tamb);
+}
+
+void test_app_dataformat_encode_invalid (void)
+{
+    uint8_t output[RE_5_DATA_LENGTH] = {0};
+    size_t output_length = sizeof (output);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    TEST_ASSERT (RD_ERROR_NOT_ENABLED == app_dataformat_encode (output, &output_length,
+                 &snapshot, DF_INVALID));
+}
+
+static void device_state_expect (void)
+{
+    float voltage = 2.5F;
+    uint64_t address = 0x0000AABBCCDDEEFFULL;
+    int8_t power = 4;
+    app_sensor_event_count_get_ExpectAndReturn (3U);
+    app_sensor_presence_count_get_ExpectAndReturn (5U);
+    app_battery_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_battery_vdd_get_ReturnThruPtr_vdd (&voltage);
+    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_radio_address_get_ReturnThruPtr_address (&address);
+    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_adv_tx_power_get_ReturnThruPtr_dbm (&power);
+}
+
+void test_app_dataformat_snapshot_fill (void)
+{
+    rd_sensor_data_t data = {0};
+    app_dataformat_snapshot_t snapshot = {0};
+    m_parse_temperature_c = 24.3F;
+    m_parse_humidity_rh = 53.5F;
+    rd_sensor_data_parse_StubWithCallback (&parse_stub);
+    device_state_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_snapshot_fill (&snapshot, &data));
+    TEST_ASSERT_EQUAL_FLOAT (53.5F, snapshot.humidity_rh);
+    TEST_ASSERT_EQUAL_FLOAT (24.3F, snapshot.temperature_c);
+    TEST_ASSERT (isnan (snapshot.pressure_pa));
+    TEST_ASSERT (isnan (snapshot.acceleration_x_g));
+    TEST_ASSERT_EQUAL_FLOAT (2.5F, snapshot.battery_v);
+    TEST_ASSERT (0x0000AABBCCDDEEFFULL == snapshot.address);
+    TEST_ASSERT (4 == snapshot.tx_power);
+    TEST_ASSERT (3U == snapshot.event_count);
+    TEST_ASSERT (5U == snapshot.presence_count);
+}
+
+void test_app_dataformat_snapshot_fill_invalid_value (void)
+{
+    rd_sensor_data_t data = {0};
+    app_dataformat_snapshot_t snapshot = {0};
+    rd_sensor_data_parse_StubWithCallback (&parse_stub);
+    device_state_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_snapshot_fill (&snapshot, &data));
+    TEST_ASSERT (isnan (snapshot.temperature_c));
+}
+
+void test_app_dataformat_snapshot_fill_not_encoded (void)
+{
+    rd_sensor_data_t data = {0};
+    app_dataformat_snapshot_t snapshot = {0};
+    m_parse_other = 1.0F;
+    rd_sensor_data_parse_StubWithCallback (&parse_stub);
+    device_state_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_snapshot_fill (&snapshot, &data));
+    // Only DF_5 with flags in TX power encodes the debug flag.
+    TEST_ASSERT (APP_DATAFORMAT_FLAGS_IN_TX == !isnan (snapshot.debug_tamb));
+}
+
+void test_app_dataformat_snapshot_fill_null (void)
+{
+    app_dataformat_snapshot_t snapshot = {0};
+    rd_sensor_data_t data = {0};
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_snapshot_fill (NULL, &data));
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_snapshot_fill (&snapshot, NULL));
+}
+
+static uint32_t fingerprint_get (const uint32_t presence_count,
+                                 const float resistance_ohm)
+{
+    float values[] = { 24.3F, 53.5F };
+    rd_sensor_data_t data = { .data = values };
+    app_log_history_t history = {0};
+    app_battery_state_t battery = {0};
+    history.sequence = 7U;
+    battery.resistance_ohm = resistance_ohm;
+    app_sensor_event_count_get_ExpectAndReturn (3U);
+    app_sensor_presence_count_get_ExpectAndReturn (presence_count);
+    app_battery_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_radio_address_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_adv_tx_power_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_log_history_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_log_history_get_ReturnThruPtr_p_history (&history);
+    app_battery_state_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_battery_state_get_ReturnThruPtr_state (&battery);
+    return app_dataformat_fingerprint (&data, 2U);
+}
+
+void test_app_dataformat_fingerprint_stable (void)
+{
+    TEST_ASSERT (fingerprint_get (5U, 10.0F) == fingerprint_get (5U, 10.0F));
+}
+
+void test_app_dataformat_fingerprint_presence_count (void)
+{
+    TEST_ASSERT (fingerprint_get (5U, 10.0F) != fingerprint_get (6U, 10.0F));
+}
+
+void test_app_dataformat_fingerprint_battery_health (void)
+{
+    TEST_ASSERT (fingerprint_get (5U, 10.0F) != fingerprint_get (5U, 12.0F));
+}
+
+static uint8_t m_used_key[APP_DATAFORMAT_KEY_LENGTH]; //!< Key given to encoder.
+
+static re_status_t re_8_encode_stub (uint8_t * const buffer,
+                                     const re_8_data_t * data,
+                                     re_8_encrypt_fp cipher,
+                                     const uint8_t * const key,
+                                     const size_t key_size,
+                                     int cmock_num_calls)
+{
+    memcpy (m_used_key, key, sizeof (m_used_key));
+    return RE_SUCCESS;
+}
+
+static void encode_8 (void)
+{
+    uint8_t output[24] = {0};
+    size_t output_length = sizeof (output);
+    const app_dataformat_snapshot_t snapshot = snapshot_get();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_encode (output, &output_length, &snapshot,
+                 DF_8));
+}
+
+void test_app_dataformat_crypto_init_once (void)
+{
+    uint8_t first_key[APP_DATAFORMAT_KEY_LENGTH] = {0};
+    crypto_init_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_crypto_init());
+    re_8_encode_StubWithCallback (&re_8_encode_stub);
+    // Device ID is not read again.
+    encode_8();
+    memcpy (first_key, m_used_key, sizeof (first_key));
+    encode_8();
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (first_key, m_used_key, sizeof (first_key));
+    TEST_ASSERT_FALSE (app_dataformat_key_is_provisioned (DF_8));
+}
+
+void test_app_dataformat_crypto_init_provisioned (void)
+{
+    uint8_t stored[APP_DATAFORMAT_KEY_LENGTH] = {0};
+    memset (stored, 0xA5, sizeof (stored));
+    rt_flash_load_ExpectAndReturn (APP_FLASH_DATAFORMAT_FILE,
+                                   APP_FLASH_DATAFORMAT_8_KEY_RECORD,
+                                   NULL, APP_DATAFORMAT_KEY_LENGTH, RD_SUCCESS);
+    rt_flash_load_IgnoreArg_message();
+    rt_flash_load_ReturnMemThruPtr_message (stored, sizeof (stored));
+    rt_flash_load_ExpectAndReturn (APP_FLASH_DATAFORMAT_FILE,
+                                   APP_FLASH_DATAFORMAT_FA_KEY_RECORD,
+                                   NULL, APP_DATAFORMAT_KEY_LENGTH, RD_ERROR_NOT_FOUND);
+    rt_flash_load_IgnoreArg_message();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_crypto_init());
+    re_8_encode_StubWithCallback (&re_8_encode_stub);
+    encode_8();
+    // Provisioned key is not diversified with device ID.
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (stored, m_used_key, sizeof (stored));
+    TEST_ASSERT (app_dataformat_key_is_provisioned (DF_8));
+    TEST_ASSERT_FALSE (app_dataformat_key_is_provisioned (DF_FA));
+}
+
+void test_app_dataformat_key_set (void)
+{
+    uint8_t key[APP_DATAFORMAT_KEY_LENGTH] = {0};
+    memset (key, 0x3C, sizeof (key));
+    crypto_init_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_crypto_init());
+    rt_flash_store_ExpectWithArrayAndReturn (APP_FLASH_DATAFORMAT_FILE,
+            APP_FLASH_DATAFORMAT_8_KEY_RECORD, key, sizeof (key), sizeof (key),
+            RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_key_set (DF_8, key, sizeof (key)));
+    re_8_encode_StubWithCallback (&re_8_encode_stub);
+    encode_8();
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (key, m_used_key, sizeof (key));
+    TEST_ASSERT (app_dataformat_key_is_provisioned (DF_8));
+}
+
+void test_app_dataformat_key_set_flash_error (void)
+{
+    uint8_t key[APP_DATAFORMAT_KEY_LENGTH] = {0};
+    crypto_init_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_crypto_init());
+    rt_flash_store_ExpectAnyArgsAndReturn (RD_ERROR_NO_MEM);
+    TEST_ASSERT (RD_ERROR_NO_MEM == app_dataformat_key_set (DF_FA, key, sizeof (key)));
+    TEST_ASSERT_FALSE (app_dataformat_key_is_provisioned (DF_FA));
+}
+
+void test_app_dataformat_key_set_clear (void)
+{
+    crypto_init_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_crypto_init());
+    rt_flash_free_ExpectAndReturn (APP_FLASH_DATAFORMAT_FILE,
+                                   APP_FLASH_DATAFORMAT_8_KEY_RECORD, RD_SUCCESS);
+    rt_flash_load_ExpectAndReturn (APP_FLASH_DATAFORMAT_FILE,
+                                   APP_FLASH_DATAFORMAT_8_KEY_RECORD,
+                                   NULL, APP_DATAFORMAT_KEY_LENGTH, RD_ERROR_NOT_FOUND);
+    rt_flash_load_IgnoreArg_message();
+    ri_comm_id_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_key_set (DF_8, NULL, 0));
+    TEST_ASSERT_FALSE (app_dataformat_key_is_provisioned (DF_8));
+}
+
+void test_app_dataformat_key_set_invalid (void)
+{
+    uint8_t key[APP_DATAFORMAT_KEY_LENGTH] = {0};
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == app_dataformat_key_set (DF_5, key, sizeof (key)));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == app_dataformat_key_set (DF_8, key,
+                 sizeof (key) - 1U));
+}
+
+static uint8_t m_reply[RE_STANDARD_PAYLOAD_LENGTH]; //!< Payload of latest reply.
+
+static rd_status_t mock_reply (ri_comm_message_t * const msg)
+{
+    return RD_SUCCESS;
+}
+
+static rd_status_t mock_blocking_send (const ri_comm_xfer_fp_t reply_fp,
+                                       ri_comm_message_t * const msg, int cmock_num_calls)
+{
+    memcpy (m_reply, &msg->data[RE_STANDARD_PAYLOAD_START_INDEX], sizeof (m_reply));
+    return RD_SUCCESS;
+}
+
+static rd_status_t key_write (const uint8_t format, const uint8_t offset,
+                              const uint8_t * const p_key)
+{
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    message[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_DATAFORMAT_KEY;
+    message[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    message[RE_STANDARD_PAYLOAD_START_INDEX] = format;
+    message[RE_STANDARD_PAYLOAD_START_INDEX + 1U] = offset;
+
+    for (size_t ii = 0; (ii < 6U) && ( (offset + ii) < APP_DATAFORMAT_KEY_LENGTH); ii++)
+    {
+        message[RE_STANDARD_PAYLOAD_START_INDEX + 2U + ii] = p_key[offset + ii];
+    }
+
+    return app_dataformat_key_handle (&mock_reply, message, sizeof (message));
+}
+
+void test_app_dataformat_key_handle_chunks (void)
+{
+    uint8_t key[APP_DATAFORMAT_KEY_LENGTH] = {0};
+
+    for (size_t ii = 0; ii < sizeof (key); ii++)
+    {
+        key[ii] = (uint8_t) (ii + 1U);
+    }
+
+    crypto_init_expect();
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_crypto_init());
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    TEST_ASSERT (RD_SUCCESS == key_write (DF_FA, 12U, key));
+    TEST_ASSERT (RD_SUCCESS == key_write (DF_FA, 0U, key));
+    TEST_ASSERT (0U == m_reply[2]);
+    // Key is stored once all chunks are received, in any order.
+    rt_flash_store_ExpectWithArrayAndReturn (APP_FLASH_DATAFORMAT_FILE,
+            APP_FLASH_DATAFORMAT_FA_KEY_RECORD, key, sizeof (key), sizeof (key),
+            RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == key_write (DF_FA, 6U, key));
+    TEST_ASSERT (DF_FA == m_reply[0]);
+    TEST_ASSERT (6U == m_reply[1]);
+    TEST_ASSERT (1U == m_reply[2]);
+    TEST_ASSERT (0U == m_reply[3]);
+}
+
+void test_app_dataformat_key_stage_clear (void)
+{
+    uint8_t key[APP_DATAFORMAT_KEY_LENGTH] = {0};
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    TEST_ASSERT (RD_SUCCESS == key_write (DF_FA, 0U, key));
+    TEST_ASSERT (RD_SUCCESS == key_write (DF_FA, 12U, key));
+    app_dataformat_key_stage_clear();
+    // Last chunk does not complete chunks staged before clear, nothing is stored.
+    TEST_ASSERT (RD_SUCCESS == key_write (DF_FA, 6U, key));
+    TEST_ASSERT (0U == m_reply[2]);
+}
+
+void test_app_dataformat_key_handle_invalid_offset (void)
+{
+    uint8_t key[APP_DATAFORMAT_KEY_LENGTH] = {0};
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == key_write (DF_8, 3U, key));
+    TEST_ASSERT (0xFFU == m_reply[3]);
+}
+
+void test_app_dataformat_key_handle_read (void)
+{
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    message[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_READ;
+    message[RE_STANDARD_PAYLOAD_START_INDEX] = DF_8;
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_key_handle (&mock_reply, message,
+                 sizeof (message)));
+    TEST_ASSERT (DF_8 == m_reply[0]);
+    TEST_ASSERT (0U == m_reply[2]);
+}
+
+void test_app_dataformat_key_handle_errors (void)
+{
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_key_handle (&mock_reply, NULL,
+                 sizeof (message)));
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == app_dataformat_key_handle (&mock_reply, message,
+                 sizeof (message) - 1U));
+}
+
+/** @brief Set weight of format expecting it stored with registry defaults of others. */
+static void weight_set_expect (const app_dataformat_t format, const uint8_t weight)
+{
+    uint8_t weights[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+    weights[__builtin_ctz (format)] = weight;
+    rt_flash_store_ExpectWithArrayAndReturn (APP_FLASH_DATAFORMAT_FILE,
+            APP_FLASH_DATAFORMAT_WEIGHTS_RECORD, weights, sizeof (weights),
+            sizeof (weights), RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_weight_set (format, weight));
+}
+
+void test_app_dataformat_next_weighted (void)
+{
+    const app_dataformats_t formats = { DF_5 | DF_8 };
+    app_dataformat_t format = DF_INVALID;
+    weight_set_expect (DF_5, 9U);
+
+    // Format 5 on 9 of 10 advertisements, twice around.
+    for (size_t round = 0; round < 2U; round++)
+    {
+        for (size_t ii = 0; ii < 9U; ii++)
+        {
+            ri_adv_enable_uuid_Expect (false);
+            format = app_dataformat_next (formats, format);
+            TEST_ASSERT (format == DF_5);
+        }
+
+        ri_adv_enable_uuid_Expect (true);
+        format = app_dataformat_next (formats, format);
+        TEST_ASSERT (format == DF_8);
+    }
+}
+
+void test_app_dataformat_next_weight_zero (void)
+{
+    const app_dataformats_t formats = { DF_5 | DF_C5 };
+    app_dataformat_t format = DF_INVALID;
+    weight_set_expect (DF_C5, 0U);
+    ri_adv_enable_uuid_Expect (false);
+    format = app_dataformat_next (formats, format);
+    TEST_ASSERT (format == DF_5);
+    ri_adv_enable_uuid_Expect (false);
+    format = app_dataformat_next (formats, format);
+    TEST_ASSERT (format == DF_5);
+}
+
+void test_app_dataformat_next_weight_zero_only (void)
+{
+    // Format is sent if it is the only one enabled, regardless of weight.
+    const app_dataformats_t formats = { DF_C5 };
+    app_dataformat_t format = DF_INVALID;
+    weight_set_expect (DF_C5, 0U);
+    ri_adv_enable_uuid_Expect (true);
+    format = app_dataformat_next (formats, format);
+    TEST_ASSERT (format == DF_C5);
+}
+
+void test_app_dataformat_weights_init (void)
+{
+    uint8_t stored[8] = {2, 3, 4, 5, 6, 7, 0, 0};
+    rt_flash_load_ExpectAndReturn (APP_FLASH_DATAFORMAT_FILE,
+                                   APP_FLASH_DATAFORMAT_WEIGHTS_RECORD,
+                                   NULL, sizeof (stored), RD_SUCCESS);
+    rt_flash_load_IgnoreArg_message();
+    rt_flash_load_ReturnMemThruPtr_message (stored, sizeof (stored));
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_weights_init());
+    TEST_ASSERT (3U == app_dataformat_weight_get (DF_5));
+    TEST_ASSERT (7U == app_dataformat_weight_get (DF_FA));
+}
+
+void test_app_dataformat_weights_init_not_found (void)
+{
+    const uint8_t default_weight = app_dataformat_desc_get (DF_5)->weight;
+    rt_flash_load_ExpectAnyArgsAndReturn (RD_ERROR_NOT_FOUND);
+    TEST_ASSERT (RD_SUCCESS == app_dataformat_weights_init());
+    TEST_ASSERT (default_weight == app_dataformat_weight_get (DF_5));
+}
+
+void test_app_dataformat_weight_set_errors (void)
+{
+    const uint8_t default_weight = app_dataformat_desc_get (DF_5)->weight;
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == app_dataformat_weight_set (DF_INVALID, 2U));
+    TEST_ASSERT (0U == app_dataformat_weight_get (DF_INVALID));
+    rt_flash_store_ExpectAnyArgsAndReturn (RD_ERROR_NO_MEM);
+    TEST_ASSERT (RD_ERROR_NO_MEM == app_dataformat_weight_set (DF_5, 9U));
+    TEST_ASSERT (default_weight == app_dataformat_weight_get (DF_5));
+}
+
+static rd_status_t weight_message (const re_op_t op, const uint8_t format,
+                                   const uint8_t weight)
+{
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    message[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_DATAFORMAT_WEIGHTS;
+    message[RE_STANDARD_OPERATION_INDEX] = op;
+    message[RE_STANDARD_PAYLOAD_START_INDEX] = format;
+    message[RE_STANDARD_PAYLOAD_START_INDEX + 1U] = weight;
+    return app_dataformat_weights_handle (&mock_reply, message, sizeof (message));
+}
+
+void test_app_dataformat_weights_handle_write (void)
+{
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    rt_flash_store_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == weight_message (RE_STANDARD_VALUE_WRITE, DF_5, 9U));
+    TEST_ASSERT (DF_5 == m_reply[0]);
+    TEST_ASSERT (9U == m_reply[1]);
+    TEST_ASSERT (0U == m_reply[2]);
+    TEST_ASSERT (RD_SUCCESS == weight_message (RE_STANDARD_VALUE_READ, DF_5, 0U));
+    TEST_ASSERT (9U == m_reply[1]);
+}
+
+void test_app_dataformat_weights_handle_invalid_format (void)
+{
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == weight_message (RE_STANDARD_VALUE_WRITE,
+                 DF_3 | DF_5, 2U));
+    TEST_ASSERT (0U == m_reply[1]);
+    TEST_ASSERT (0xFFU == m_reply[2]);
+}
+
+void test_app_dataformat_weights_handle_errors (void)
+{
+    uint8_t message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    TEST_ASSERT (RD_ERROR_NULL == app_dataformat_weights_handle (&mock_reply, NULL,
+                 sizeof (message)));
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == app_dataformat_weights_handle (&mock_reply,
+                 message, sizeof (message) - 1U));
+}
+
 #endif // TEST
@@ -0,0 +1,171 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_dsp.h"
+
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_driver_sensor.h"
+
+#include <math.h>
+#include <string.h>
+
+static app_dsp_state_t m_state;
+
+void setUp (void)
+{
+    memset (&m_state, 0, sizeof (m_state));
+    app_dsp_reset();
+}
+
+void tearDown (void)
+{
+    const app_dsp_config_t none =
+    {
+        .filter = APP_DSP_FILTER_NONE,
+        .parameter = 1,
+        .outlier_limit = 0.0F
+    };
+    (void) app_dsp_configure (RD_SENSOR_TEMP_FIELD, &none);
+}
+
+void test_app_dsp_filter_none_passes_through (void)
+{
+    const app_dsp_config_t cfg = { .filter = APP_DSP_FILTER_NONE, .parameter = 1 };
+    TEST_ASSERT_EQUAL_FLOAT (1.5F, app_dsp_filter (&m_state, &cfg, 1.5F));
+    TEST_ASSERT_EQUAL_FLOAT (-3.0F, app_dsp_filter (&m_state, &cfg, -3.0F));
+}
+
+void test_app_dsp_filter_moving_average (void)
+{
+    const app_dsp_config_t cfg = { .filter = APP_DSP_FILTER_MOVING_AVG, .parameter = 4 };
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, app_dsp_filter (&m_state, &cfg, 1.0F));
+    TEST_ASSERT_EQUAL_FLOAT (1.5F, app_dsp_filter (&m_state, &cfg, 2.0F));
+    TEST_ASSERT_EQUAL_FLOAT (2.0F, app_dsp_filter (&m_state, &cfg, 3.0F));
+    TEST_ASSERT_EQUAL_FLOAT (2.5F, app_dsp_filter (&m_state, &cfg, 4.0F));
+    // Oldest sample drops out of window.
+    TEST_ASSERT_EQUAL_FLOAT (3.5F, app_dsp_filter (&m_state, &cfg, 5.0F));
+}
+
+void test_app_dsp_filter_iir (void)
+{
+    const app_dsp_config_t cfg =
+    {
+        .filter = APP_DSP_FILTER_IIR_LOW_PASS,
+        .parameter = 4
+    };
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, app_dsp_filter (&m_state, &cfg, 0.0F));
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, app_dsp_filter (&m_state, &cfg, 4.0F));
+    TEST_ASSERT_EQUAL_FLOAT (1.75F, app_dsp_filter (&m_state, &cfg, 4.0F));
+}
+
+void test_app_dsp_filter_iir_longer_than_window (void)
+{
+    const app_dsp_config_t cfg =
+    {
+        .filter = APP_DSP_FILTER_IIR_LOW_PASS,
+        .parameter = 16
+    };
+    TEST_ASSERT_EQUAL_FLOAT (0.0F, app_dsp_filter (&m_state, &cfg, 0.0F));
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, app_dsp_filter (&m_state, &cfg, 16.0F));
+}
+
+void test_app_dsp_filter_median_rejects_spike (void)
+{
+    const app_dsp_config_t cfg = { .filter = APP_DSP_FILTER_MEDIAN, .parameter = 3 };
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, app_dsp_filter (&m_state, &cfg, 20.0F));
+    TEST_ASSERT_EQUAL_FLOAT (20.5F, app_dsp_filter (&m_state, &cfg, 21.0F));
+    TEST_ASSERT_EQUAL_FLOAT (21.0F, app_dsp_filter (&m_state, &cfg, 100.0F));
+    TEST_ASSERT_EQUAL_FLOAT (22.0F, app_dsp_filter (&m_state, &cfg, 22.0F));
+}
+
+void test_app_dsp_filter_outlier_rejected_then_accepted (void)
+{
+    const app_dsp_config_t cfg =
+    {
+        .filter = APP_DSP_FILTER_NONE,
+        .parameter = 1,
+        .outlier_limit = 5.0F
+    };
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, app_dsp_filter (&m_state, &cfg, 20.0F));
+
+    for (size_t ii = 0; ii < APP_DSP_OUTLIER_MAX_REJECTS; ii++)
+    {
+        TEST_ASSERT_EQUAL_FLOAT (20.0F, app_dsp_filter (&m_state, &cfg, 50.0F));
+    }
+
+    // Persistent step is accepted as a new level.
+    TEST_ASSERT_EQUAL_FLOAT (50.0F, app_dsp_filter (&m_state, &cfg, 50.0F));
+    TEST_ASSERT_EQUAL_FLOAT (51.0F, app_dsp_filter (&m_state, &cfg, 51.0F));
+}
+
+void test_app_dsp_filter_nan_does_not_modify_state (void)
+{
+    const app_dsp_config_t cfg = { .filter = APP_DSP_FILTER_MOVING_AVG, .parameter = 2 };
+    TEST_ASSERT_EQUAL_FLOAT (2.0F, app_dsp_filter (&m_state, &cfg, 2.0F));
+    TEST_ASSERT (isnan (app_dsp_filter (&m_state, &cfg, NAN)));
+    TEST_ASSERT_EQUAL_FLOAT (3.0F, app_dsp_filter (&m_state, &cfg, 4.0F));
+}
+
+void test_app_dsp_configure_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_dsp_configure (RD_SENSOR_TEMP_FIELD, NULL));
+}
+
+void test_app_dsp_configure_window_too_long (void)
+{
+    const app_dsp_config_t cfg =
+    {
+        .filter = APP_DSP_FILTER_MEDIAN,
+        .parameter = APP_DSP_WINDOW_MAX + 1
+    };
+    rd_status_t err_code = app_dsp_configure (RD_SENSOR_TEMP_FIELD, &cfg);
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == err_code);
+}
+
+void test_app_dsp_configure_unknown_field (void)
+{
+    const app_dsp_config_t cfg = { .filter = APP_DSP_FILTER_MEDIAN, .parameter = 3 };
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == app_dsp_configure (RD_SENSOR_MOTION_FIELD, &cfg));
+}
+
+void test_app_dsp_process_filters_configured_field (void)
+{
+    float values[2] = {0};
+    rd_sensor_data_t data = {0};
+    data.data = values;
+    data.fields.datas.temperature_c = 1;
+    data.fields.datas.humidity_rh = 1;
+    data.valid = data.fields;
+    const app_dsp_config_t cfg =
+    {
+        .filter = APP_DSP_FILTER_IIR_LOW_PASS,
+        .parameter = 2
+    };
+    TEST_ASSERT (RD_SUCCESS == app_dsp_configure (RD_SENSOR_TEMP_FIELD, &cfg));
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_TEMP_FIELD, 10.0F);
+    rd_sensor_data_set_Expect (&data, RD_SENSOR_TEMP_FIELD, 10.0F);
+    app_dsp_process (&data);
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_TEMP_FIELD, 20.0F);
+    rd_sensor_data_set_Expect (&data, RD_SENSOR_TEMP_FIELD, 15.0F);
+    app_dsp_process (&data);
+}
+
+void test_app_dsp_process_skips_invalid_field (void)
+{
+    float values[1] = {0};
+    rd_sensor_data_t data = {0};
+    data.data = values;
+    data.fields.datas.temperature_c = 1;
+    const app_dsp_config_t cfg =
+    {
+        .filter = APP_DSP_FILTER_IIR_LOW_PASS,
+        .parameter = 2
+    };
+    TEST_ASSERT (RD_SUCCESS == app_dsp_configure (RD_SENSOR_TEMP_FIELD, &cfg));
+    app_dsp_process (&data);
+}
+
+void test_app_dsp_process_null (void)
+{
+    app_dsp_process (NULL);
+}
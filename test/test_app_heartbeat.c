@@ -6,6 +6,8 @@
 #include "mock_app_dataformats.h"
 #include "mock_app_led.h"
 #include "mock_app_log.h"
+#include "mock_app_profile.h"
+#include "mock_app_radio.h"
 #include "mock_app_sensor.h"
 #include "mock_ruuvi_driver_error.h"
 #include "mock_ruuvi_driver_sensor.h"
@@ -22,6 +24,8 @@
 #include "mock_ruuvi_task_gatt.h"
 #include "mock_ruuvi_task_nfc.h"
 
+#include <math.h>
+
 #include "application_mode_default.h" //!< Ceedling doesn't follow includes by default.
 
 static unsigned int mock_tid = 0xAA; //!< Mock timer ID to be returned, size system int.
@@ -34,6 +38,9 @@ void setUp (void)
     ri_log_init_IgnoreAndReturn (RD_SUCCESS);
     ri_log_Ignore();
     rd_error_check_Ignore();
+    app_profile_start_IgnoreAndReturn (0);
+    app_profile_stop_Ignore();
+    app_heartbeat_payloads_invalidate();
 }
 
 void tearDown (void)
@@ -42,10 +49,66 @@ void tearDown (void)
 
 void resetTest (void); //!< Clears test memory.
 
+static void app_fingerprint_expect (const uint32_t fingerprint)
+{
+    app_dataformat_fingerprint_ExpectAnyArgsAndReturn (fingerprint);
+    ri_rtc_millis_ExpectAndReturn (next_rtc_sim);
+}
+
 static void app_encode_expect (void)
 {
+    app_fingerprint_expect (0);
+    app_dataformat_snapshot_fill_ExpectAnyArgsAndReturn (RD_SUCCESS);
+
+    // All formats are enabled in test.
+    for (size_t ii = 0; ii < 8U; ii++)
+    {
+        app_dataformat_encode_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    }
+
     app_dataformat_next_ExpectAnyArgsAndReturn (DF_5);
-    app_dataformat_encode_ExpectAnyArgsAndReturn (RD_SUCCESS);
+}
+
+static rd_status_t encode_format_stub (uint8_t * const output,
+                                       size_t * const output_length,
+                                       const app_dataformat_snapshot_t * const p_snapshot,
+                                       const app_dataformat_t format,
+                                       int cmock_num_calls)
+{
+    output[0] = (uint8_t) format;
+    *output_length = (size_t) format;
+    return RD_SUCCESS;
+}
+
+static app_dataformat_t m_sent_format; //!< Format encoded into sent advertisement.
+
+static rd_status_t adv_send_stub (ri_comm_message_t * const p_msg, int cmock_num_calls)
+{
+    TEST_ASSERT ( (uint8_t) p_msg->data_length == p_msg->data[0]);
+    m_sent_format = (app_dataformat_t) p_msg->data[0];
+    return RD_SUCCESS;
+}
+
+static void heartbeat_measure_expect (void)
+{
+    static rd_sensor_data_fields_t fields = {0}; //!< Gets ignored in test.
+    app_sensor_available_data_ExpectAndReturn (fields);
+    rd_sensor_data_fieldcount_ExpectAnyArgsAndReturn (7);
+    app_sensor_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_led_activity_signal_Expect (true);
+}
+
+static void heartbeat_send_expect (const app_dataformat_t format)
+{
+    app_dataformat_next_ExpectAnyArgsAndReturn (format);
+    app_comms_bleadv_send_count_get_ExpectAndReturn (1);
+    rt_adv_send_data_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_nfc_send_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_watchdog_feed_ExpectAndReturn (RD_SUCCESS);
+    ri_rtc_millis_ExpectAndReturn (next_rtc_sim);
+    app_led_activity_signal_Expect (false);
+    app_log_process_ExpectAnyArgsAndReturn (RD_SUCCESS);
 }
 
 static void heartbeat_all_ok_Expect (void)
@@ -82,6 +145,8 @@ void test_app_heartbeat_init (void)
     ri_timer_id_t * p_heart_timer = get_heart_timer();
     ri_timer_is_init_ExpectAndReturn (true);
     ri_scheduler_is_init_ExpectAndReturn (true);
+    app_dataformat_crypto_init_ExpectAndReturn (RD_SUCCESS);
+    app_dataformat_weights_init_ExpectAndReturn (RD_SUCCESS);
     ri_timer_create_ExpectAndReturn (p_heart_timer, RI_TIMER_MODE_REPEATED,
                                      &schedule_heartbeat_isr, RD_SUCCESS);
     ri_timer_create_ReturnArrayThruPtr_p_timer_id (&p_mock_tid, 1);
@@ -113,6 +178,8 @@ void test_app_heartbeat_init_timer_alloc_fail (void)
     ri_timer_id_t * p_heart_timer = get_heart_timer();
     ri_timer_is_init_ExpectAndReturn (true);
     ri_scheduler_is_init_ExpectAndReturn (true);
+    app_dataformat_crypto_init_ExpectAndReturn (RD_SUCCESS);
+    app_dataformat_weights_init_ExpectAndReturn (RD_SUCCESS);
     ri_timer_create_ExpectAndReturn (p_heart_timer, RI_TIMER_MODE_REPEATED,
                                      &schedule_heartbeat_isr, RD_ERROR_RESOURCES);
     err_code = app_heartbeat_init();
@@ -122,10 +189,31 @@ void test_app_heartbeat_init_timer_alloc_fail (void)
 
 void test_schedule_heartbeat_isr (void)
 {
+#if APP_RADIO_SYNC_ENABLED
+    app_radio_idle_run_ExpectAndReturn (&heartbeat, RD_SUCCESS);
+#else
     ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &heartbeat, RD_SUCCESS);
+#endif
     schedule_heartbeat_isr (NULL);
 }
 
+void test_app_heartbeat_refresh_isr (void)
+{
+    ri_rtc_millis_ExpectAndReturn (UINT32_MAX);
+#if APP_RADIO_SYNC_ENABLED
+    app_radio_idle_run_ExpectAndReturn (&heartbeat, RD_SUCCESS);
+#else
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &heartbeat, RD_SUCCESS);
+#endif
+    app_heartbeat_refresh_isr();
+}
+
+void test_app_heartbeat_refresh_isr_too_soon (void)
+{
+    ri_rtc_millis_ExpectAndReturn (0);
+    app_heartbeat_refresh_isr();
+}
+
 void test_app_heartbeat_stop (void)
 {
     rd_status_t err_code = RD_SUCCESS;
@@ -225,6 +313,158 @@ void test_heartbeat_none_ok (void)
     heartbeat (NULL, 0);
 }
 
+static unsigned int m_encoded_formats; //!< Formats encoded since last reset.
+
+static rd_status_t encode_record_stub (uint8_t * const output,
+                                       size_t * const output_length,
+                                       const app_dataformat_snapshot_t * const p_snapshot,
+                                       const app_dataformat_t format,
+                                       int cmock_num_calls)
+{
+    m_encoded_formats |= format;
+    return encode_format_stub (output, output_length, p_snapshot, format,
+                               cmock_num_calls);
+}
+
+void test_heartbeat_unchanged_skips_encode (void)
+{
+    heartbeat_all_ok_Expect();
+    heartbeat (NULL, 0);
+    heartbeat_measure_expect();
+    app_fingerprint_expect (0);
+    m_encoded_formats = 0;
+    app_dataformat_encode_StubWithCallback (&encode_record_stub);
+    heartbeat_send_expect (DF_3);
+    heartbeat (NULL, 0);
+    // Snapshot is not filled and no format is encoded.
+    TEST_ASSERT (0U == m_encoded_formats);
+}
+
+void test_heartbeat_unchanged_refresh_encodes (void)
+{
+    heartbeat_all_ok_Expect();
+    heartbeat (NULL, 0);
+    heartbeat_measure_expect();
+    app_dataformat_fingerprint_ExpectAnyArgsAndReturn (0);
+    ri_rtc_millis_ExpectAndReturn (next_rtc_sim + APP_HEARTBEAT_UNCHANGED_REFRESH_MS);
+    app_dataformat_snapshot_fill_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    m_encoded_formats = 0;
+    app_dataformat_encode_StubWithCallback (&encode_record_stub);
+    heartbeat_send_expect (DF_3);
+    heartbeat (NULL, 0);
+    // Sequence counters of unchanged data advance on refresh.
+    TEST_ASSERT (0xFFU == m_encoded_formats);
+}
+
+void test_heartbeat_changed_encodes (void)
+{
+    heartbeat_all_ok_Expect();
+    heartbeat (NULL, 0);
+    heartbeat_measure_expect();
+    app_fingerprint_expect (1);
+    app_dataformat_snapshot_fill_ExpectAnyArgsAndReturn (RD_SUCCESS);
+
+    for (size_t ii = 0; ii < 8U; ii++)
+    {
+        app_dataformat_encode_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    }
+
+    heartbeat_send_expect (DF_3);
+    heartbeat (NULL, 0);
+}
+
+void test_heartbeat_rotates_cached_payloads (void)
+{
+    const app_dataformat_t formats[] = { DF_3, DF_5, DF_C5 };
+    app_dataformat_snapshot_fill_IgnoreAndReturn (RD_SUCCESS);
+    app_dataformat_encode_StubWithCallback (&encode_format_stub);
+    rt_adv_send_data_StubWithCallback (&adv_send_stub);
+
+    for (size_t ii = 0; ii < (sizeof (formats) / sizeof (formats[0])); ii++)
+    {
+        heartbeat_measure_expect();
+        app_fingerprint_expect (0);
+        app_dataformat_next_ExpectAnyArgsAndReturn (formats[ii]);
+        app_comms_bleadv_send_count_get_ExpectAndReturn (1);
+        rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+        rt_nfc_send_ExpectAnyArgsAndReturn (RD_SUCCESS);
+        ri_watchdog_feed_ExpectAndReturn (RD_SUCCESS);
+        ri_rtc_millis_ExpectAndReturn (next_rtc_sim);
+        app_led_activity_signal_Expect (false);
+        app_log_process_ExpectAnyArgsAndReturn (RD_SUCCESS);
+        heartbeat (NULL, 0);
+        TEST_ASSERT (formats[ii] == m_sent_format);
+    }
+}
+
+static unsigned int m_next_formats; //!< Formats offered to rotation.
+
+static app_dataformat_t next_record_stub (const app_dataformats_t formats,
+        const app_dataformat_t state, int cmock_num_calls)
+{
+    m_next_formats = formats.formats;
+    return DF_3;
+}
+
+static rd_status_t encode_fail_df5_stub (uint8_t * const output,
+        size_t * const output_length,
+        const app_dataformat_snapshot_t * const p_snapshot,
+        const app_dataformat_t format,
+        int cmock_num_calls)
+{
+    rd_status_t err_code = encode_format_stub (output, output_length, p_snapshot, format,
+                           cmock_num_calls);
+
+    if (DF_5 == format)
+    {
+        err_code = RD_ERROR_DATA_SIZE;
+    }
+
+    return err_code;
+}
+
+static rd_status_t encode_fail_stub (uint8_t * const output,
+                                     size_t * const output_length,
+                                     const app_dataformat_snapshot_t * const p_snapshot,
+                                     const app_dataformat_t format,
+                                     int cmock_num_calls)
+{
+    return RD_ERROR_DATA_SIZE;
+}
+
+void test_heartbeat_encode_error_skips_format (void)
+{
+    heartbeat_measure_expect();
+    app_fingerprint_expect (0);
+    app_dataformat_snapshot_fill_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_dataformat_encode_StubWithCallback (&encode_fail_df5_stub);
+    app_dataformat_next_StubWithCallback (&next_record_stub);
+    app_comms_bleadv_send_count_get_ExpectAndReturn (1);
+    rt_adv_send_data_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_nfc_send_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_watchdog_feed_ExpectAndReturn (RD_SUCCESS);
+    ri_rtc_millis_ExpectAndReturn (next_rtc_sim);
+    app_led_activity_signal_Expect (false);
+    app_log_process_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    heartbeat (NULL, 0);
+    TEST_ASSERT (0U == (m_next_formats & DF_5));
+    TEST_ASSERT (0U != (m_next_formats & DF_3));
+}
+
+void test_heartbeat_encode_error_all_not_sent (void)
+{
+    heartbeat_measure_expect();
+    app_fingerprint_expect (0);
+    app_dataformat_snapshot_fill_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    app_dataformat_encode_StubWithCallback (&encode_fail_stub);
+    app_dataformat_next_ExpectAnyArgsAndReturn (DF_INVALID);
+    app_led_activity_signal_Expect (false);
+    app_log_process_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    // Nothing is sent and watchdog is not fed.
+    heartbeat (NULL, 0);
+}
+
 void test_app_heartbeat_overdue_no (void)
 {
     next_rtc_sim = 1;
@@ -239,4 +479,180 @@ void test_app_heartbeat_overdue_yes (void)
     test_heartbeat_all_ok();
     ri_rtc_millis_ExpectAndReturn (APP_HEARTBEAT_OVERDUE_INTERVAL_MS);
     TEST_ASSERT (!app_heartbeat_overdue());
-}
\ No newline at end of file
+}
+void test_adaptive_interval_next_lengthens_when_stable (void)
+{
+    uint32_t interval = adaptive_interval_next (APP_HEARTBEAT_INTERVAL_MIN_MS, true);
+    TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MIN_MS == interval);
+
+    for (size_t ii = 1; ii < APP_HEARTBEAT_ADAPTIVE_STABLE_COUNT; ii++)
+    {
+        interval = adaptive_interval_next (interval, false);
+        TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MIN_MS == interval);
+    }
+
+    interval = adaptive_interval_next (interval, false);
+    TEST_ASSERT ( (2U * APP_HEARTBEAT_INTERVAL_MIN_MS) == interval);
+}
+
+void test_adaptive_interval_next_max (void)
+{
+    uint32_t interval = adaptive_interval_next (APP_HEARTBEAT_INTERVAL_MAX_MS, true);
+
+    for (size_t ii = 0; ii < (10U * APP_HEARTBEAT_ADAPTIVE_STABLE_COUNT); ii++)
+    {
+        interval = adaptive_interval_next (interval, false);
+        TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MAX_MS >= interval);
+    }
+
+    TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MAX_MS == interval);
+}
+
+void test_adaptive_interval_next_snaps_back_on_activity (void)
+{
+    uint32_t interval = adaptive_interval_next (APP_HEARTBEAT_INTERVAL_MAX_MS, true);
+    TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MIN_MS == interval);
+}
+
+void test_adaptive_data_changed (void)
+{
+    rd_sensor_data_t data = {0};
+    // First reading sets the reference.
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (20.0F);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (50.0F);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (100000.0F);
+    (void) adaptive_data_changed (&data);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (20.0F);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (50.0F);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (100000.0F);
+    TEST_ASSERT (!adaptive_data_changed (&data));
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (20.0F
+            + (2.0F * APP_HEARTBEAT_ADAPTIVE_TEMPERATURE_DELTA));
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (50.0F);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (100000.0F);
+    TEST_ASSERT (adaptive_data_changed (&data));
+}
+
+void test_adaptive_data_changed_nan_is_stable (void)
+{
+    rd_sensor_data_t data = {0};
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (20.0F);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (50.0F);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (100000.0F);
+    (void) adaptive_data_changed (&data);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (NAN);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (NAN);
+    rd_sensor_data_parse_ExpectAnyArgsAndReturn (NAN);
+    TEST_ASSERT (!adaptive_data_changed (&data));
+}
+
+void test_app_heartbeat_interval_get_default (void)
+{
+    TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MS == app_heartbeat_interval_get());
+}
+
+void test_transmit_due_changed (void)
+{
+    TEST_ASSERT (transmit_due (true, 1000U));
+    TEST_ASSERT (transmit_due (true, 1001U));
+}
+
+void test_transmit_due_unchanged_refresh (void)
+{
+    const uint64_t start_ms = 1000U;
+    const uint64_t refresh_ms = start_ms + APP_HEARTBEAT_UNCHANGED_REFRESH_MS;
+    TEST_ASSERT (transmit_due (true, start_ms));
+    TEST_ASSERT (!transmit_due (false, refresh_ms - 1U));
+    TEST_ASSERT (transmit_due (false, refresh_ms));
+    // Refresh restarts refresh interval.
+    TEST_ASSERT (!transmit_due (false, refresh_ms + 1U));
+}
+
+void test_nfc_due_reader_in_field (void)
+{
+    TEST_ASSERT (nfc_due (true, 1000U));
+    TEST_ASSERT (nfc_due (true, 1001U));
+}
+
+void test_nfc_due_idle_interval (void)
+{
+    const uint64_t start_ms = 1000U;
+    const uint64_t refresh_ms = start_ms + APP_HEARTBEAT_NFC_IDLE_INTERVAL_MS;
+    TEST_ASSERT (nfc_due (true, start_ms));
+    TEST_ASSERT (!nfc_due (false, refresh_ms - 1U));
+    TEST_ASSERT (nfc_due (false, refresh_ms));
+}
+
+void test_app_heartbeat_live_set (void)
+{
+    ri_timer_id_t * p_heart_timer = get_heart_timer();
+    *p_heart_timer = &mock_tid;
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_HEARTBEAT_LIVE_INTERVAL_MS, NULL,
+                                    RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_heartbeat_live_set (true));
+    TEST_ASSERT (APP_HEARTBEAT_LIVE_INTERVAL_MS == app_heartbeat_interval_get());
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_HEARTBEAT_INTERVAL_MS, NULL,
+                                    RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_heartbeat_live_set (false));
+    TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MS == app_heartbeat_interval_get());
+}
+
+void test_app_heartbeat_live_set_twice_restores_idle (void)
+{
+    ri_timer_id_t * p_heart_timer = get_heart_timer();
+    *p_heart_timer = &mock_tid;
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_HEARTBEAT_LIVE_INTERVAL_MS, NULL,
+                                    RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_heartbeat_live_set (true));
+    // Already live, idle interval must not be overwritten by live interval.
+    TEST_ASSERT (RD_SUCCESS == app_heartbeat_live_set (true));
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_HEARTBEAT_INTERVAL_MS, NULL,
+                                    RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_heartbeat_live_set (false));
+    TEST_ASSERT (APP_HEARTBEAT_INTERVAL_MS == app_heartbeat_interval_get());
+}
+
+void test_heartbeat_sample_task (void)
+{
+#if APP_RADIO_SYNC_ENABLED
+    app_radio_idle_run_ExpectAndReturn (&heartbeat, RD_SUCCESS);
+#else
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &heartbeat, RD_SUCCESS);
+#endif
+    heartbeat_sample_task (NULL, 0);
+}
+
+void test_heartbeat_advertise_task_no_data (void)
+{
+    heartbeat_advertise_task (NULL, 0);
+}
+
+void test_heartbeat_advertise_task_sends_cached (void)
+{
+    heartbeat_all_ok_Expect();
+    heartbeat (NULL, 0);
+    app_dataformat_next_ExpectAnyArgsAndReturn (DF_3);
+    app_comms_bleadv_send_count_get_ExpectAndReturn (1);
+    rt_adv_send_data_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_nfc_send_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_watchdog_feed_ExpectAndReturn (RD_SUCCESS);
+    ri_rtc_millis_ExpectAndReturn (next_rtc_sim);
+    heartbeat_advertise_task (NULL, 0);
+}
+
+void test_heartbeat_advertise_task_stale_no_feed (void)
+{
+    test_heartbeat_advertise_task_sends_cached();
+    // Same sample is sent again, watchdog is fed only after next sample.
+    app_dataformat_next_ExpectAnyArgsAndReturn (DF_3);
+    app_comms_bleadv_send_count_get_ExpectAndReturn (1);
+    rt_adv_send_data_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_gatt_send_asynchronous_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_nfc_send_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    heartbeat_advertise_task (NULL, 0);
+}
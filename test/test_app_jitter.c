@@ -0,0 +1,96 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_jitter.h"
+
+void setUp (void)
+{
+    app_jitter_seed (0xC0FFEEU);
+}
+
+void tearDown (void)
+{
+}
+
+void test_app_jitter_offset_deterministic (void)
+{
+    const uint64_t address = 0xE5D1A2B3C4D5ULL;
+    TEST_ASSERT_EQUAL_UINT32 (app_jitter_offset_ms (address, 20U),
+                              app_jitter_offset_ms (address, 20U));
+}
+
+void test_app_jitter_offset_range (void)
+{
+    for (uint64_t address = 0; address < 1000U; address++)
+    {
+        TEST_ASSERT (20U >= app_jitter_offset_ms (address, 20U));
+        TEST_ASSERT (0U == app_jitter_offset_ms (address, 0U));
+    }
+}
+
+void test_app_jitter_offset_spread (void)
+{
+    uint32_t histogram[21] = {0};
+
+    // Consecutive addresses of a production batch.
+    for (uint64_t address = 0xE5D100000000ULL; address < 0xE5D100000000ULL + 2100U;
+            address++)
+    {
+        histogram[app_jitter_offset_ms (address, 20U)]++;
+    }
+
+    for (size_t ii = 0; ii < 21U; ii++)
+    {
+        TEST_ASSERT_UINT32_WITHIN (50U, 100U, histogram[ii]);
+    }
+}
+
+void test_app_jitter_random_range (void)
+{
+    for (size_t ii = 0; ii < 1000U; ii++)
+    {
+        TEST_ASSERT (100U >= app_jitter_random_ms (100U));
+    }
+
+    TEST_ASSERT (0U == app_jitter_random_ms (0U));
+}
+
+void test_app_jitter_random_varies (void)
+{
+    const uint32_t first = app_jitter_random_ms (1000U);
+    bool varies = false;
+
+    for (size_t ii = 0; ii < 10U; ii++)
+    {
+        varies |= (first != app_jitter_random_ms (1000U));
+    }
+
+    TEST_ASSERT (varies);
+}
+
+void test_app_jitter_seed_differs_per_device (void)
+{
+    uint32_t a[4];
+    bool differs = false;
+    app_jitter_seed (0xE5D1A2B3C4D5ULL);
+
+    for (size_t ii = 0; ii < 4U; ii++)
+    {
+        a[ii] = app_jitter_random_ms (UINT32_MAX);
+    }
+
+    app_jitter_seed (0xE5D1A2B3C4D6ULL);
+
+    for (size_t ii = 0; ii < 4U; ii++)
+    {
+        differs |= (a[ii] != app_jitter_random_ms (UINT32_MAX));
+    }
+
+    TEST_ASSERT (differs);
+}
+
+void test_app_jitter_seed_zero (void)
+{
+    app_jitter_seed (0U);
+    TEST_ASSERT (0U != app_jitter_random_ms (UINT32_MAX));
+}
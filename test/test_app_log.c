@@ -320,6 +320,28 @@ static void sample_read_expect (rd_sensor_data_t * const sample,
     }
 }
 
+static void store_sequence_expect (const bool block_flash)
+{
+    rt_flash_store_ExpectAndReturn (APP_FLASH_LOG_FILE, APP_FLASH_LOG_SEQUENCE_RECORD,
+                                    NULL, sizeof (uint32_t), RD_SUCCESS);
+    rt_flash_store_IgnoreArg_message();
+    rt_flash_busy_ExpectAndReturn (block_flash);
+
+    if (block_flash)
+    {
+        ri_yield_ExpectAndReturn (RD_SUCCESS);
+        rt_flash_busy_ExpectAndReturn (false);
+    }
+}
+
+static void seed_sequence_Expect (const rd_status_t load_status)
+{
+    rt_flash_load_ExpectAndReturn (APP_FLASH_LOG_FILE, APP_FLASH_LOG_SEQUENCE_RECORD,
+                                   NULL, sizeof (uint32_t), load_status);
+    rt_flash_load_IgnoreArg_message();
+    store_sequence_expect (false);
+}
+
 static void store_block_expect (const uint8_t record_idx, const bool block_flash)
 {
     rt_flash_free_ExpectAndReturn (APP_FLASH_LOG_FILE,
@@ -365,6 +387,8 @@ static void store_block_expect (const uint8_t record_idx, const bool block_flash
         ri_yield_ExpectAndReturn (RD_SUCCESS);
         rt_flash_busy_ExpectAndReturn (false);
     }
+
+    store_sequence_expect (block_flash);
 }
 
 static void store_block_expect_nomem (const uint8_t record_idx)
@@ -453,6 +477,7 @@ void test_app_log_init_nostored (void)
     rt_flash_store_IgnoreArg_message();
 #endif
     log_purge_Expect();
+    seed_sequence_Expect (RD_ERROR_NOT_FOUND);
     err_code |= app_log_init();
     TEST_ASSERT (RD_SUCCESS == err_code);
     TEST_ASSERT (!memcmp (&defaults, &m_log_config, sizeof (m_log_config)));
@@ -479,12 +504,35 @@ void test_app_log_init_stored (void)
     rt_flash_load_IgnoreArg_message();
     rt_flash_load_ReturnMemThruPtr_message (&stored, sizeof (stored));
     log_purge_Expect();
+    seed_sequence_Expect (RD_ERROR_NOT_FOUND);
     err_code |= app_log_init();
     TEST_ASSERT (RD_SUCCESS == err_code);
     TEST_ASSERT (!memcmp (&stored, &m_log_config, sizeof (m_log_config)));
 }
 #endif
 
+void test_app_log_init_sequence_continues (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    app_log_history_t history = {0};
+    uint32_t stored = 1000U;
+#if APP_FLASH_LOG_CONFIG_NVM_ENABLED
+    rt_flash_load_ExpectAnyArgsAndReturn (RD_ERROR_NOT_FOUND);
+    rt_flash_store_ExpectAnyArgsAndReturn (RD_SUCCESS);
+#endif
+    log_purge_Expect();
+    rt_flash_load_ExpectAndReturn (APP_FLASH_LOG_FILE, APP_FLASH_LOG_SEQUENCE_RECORD,
+                                   NULL, sizeof (stored), RD_SUCCESS);
+    rt_flash_load_IgnoreArg_message();
+    rt_flash_load_ReturnMemThruPtr_message (&stored, sizeof (stored));
+    store_sequence_expect (false);
+    err_code |= app_log_init();
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    // Samples which were in RAM at reboot are skipped over.
+    TEST_ASSERT (RD_SUCCESS == app_log_history_get (&history));
+    TEST_ASSERT ( (stored + APP_LOG_MAX_SAMPLES) == history.sequence);
+}
+
 void test_app_log_init_noflash (void)
 {
     rd_status_t err_code = RD_SUCCESS;
@@ -530,6 +578,7 @@ void test_app_log_init_nostored_nocounter (void)
     rt_flash_store_IgnoreArg_message();
 #endif
     log_purge_Expect();
+    seed_sequence_Expect (RD_ERROR_NOT_FOUND);
     err_code |= app_log_init();
     TEST_ASSERT (RD_SUCCESS == err_code);
     TEST_ASSERT (!memcmp (&defaults, &m_log_config, sizeof (m_log_config)));
@@ -556,6 +605,7 @@ void test_app_log_init_stored_nocounter (void)
     rt_flash_load_IgnoreArg_message();
     rt_flash_load_ReturnMemThruPtr_message (&stored, sizeof (stored));
     log_purge_Expect();
+    seed_sequence_Expect (RD_ERROR_NOT_FOUND);
     err_code |= app_log_init();
     TEST_ASSERT (RD_SUCCESS == err_code);
     TEST_ASSERT (!memcmp (&stored, &m_log_config, sizeof (m_log_config)));
@@ -799,6 +849,81 @@ void test_app_log_process_nomem_block (void)
     TEST_ASSERT (RD_SUCCESS == err_code);
 }
 
+void test_app_log_history_get_input_block (void)
+{
+    app_log_history_t history = {0};
+    memset (&m_log_input_block, 0, sizeof (m_log_input_block));
+    m_log_config.interval_s = 300U;
+
+    for (size_t ii = 0; ii < (APP_LOG_HISTORY_LENGTH + 1U); ii++)
+    {
+        m_log_input_block.storage[ii].timestamp_s = ii;
+        m_log_input_block.num_samples++;
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_log_history_get (&history));
+    TEST_ASSERT (APP_LOG_HISTORY_LENGTH == history.num_samples);
+    TEST_ASSERT (300U == history.interval_s);
+    TEST_ASSERT (APP_LOG_HISTORY_LENGTH == history.samples[0].timestamp_s);
+    TEST_ASSERT (1U == history.samples[APP_LOG_HISTORY_LENGTH - 1U].timestamp_s);
+}
+
+void test_app_log_history_get_after_store (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    app_log_history_t before = {0};
+    app_log_history_t history = {0};
+    float samples[4] = {0}; //!< number of fields to mock-store.
+    rd_sensor_data_t sample =
+    {
+        .timestamp_ms = (APP_LOG_MAX_SAMPLES + 1U) * 1000U,
+        .fields = {
+            .datas.temperature_c = 1,
+            .datas.humidity_rh = 1,
+            .datas.pressure_pa = 1,
+            .datas.voltage_v = 1
+        },
+        .valid = {
+            .datas.temperature_c = 1,
+            .datas.humidity_rh = 1,
+            .datas.pressure_pa = 1,
+            .datas.voltage_v = 1
+        },
+        .data = samples
+    };
+    m_last_sample_ms = 0;
+    memset (&m_log_input_block, 0, sizeof (m_log_input_block));
+
+    for (size_t ii = 0; ii < (APP_LOG_MAX_SAMPLES - 1U); ii++)
+    {
+        m_log_input_block.storage[ii].timestamp_s = ii;
+        m_log_input_block.num_samples++;
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_log_history_get (&before));
+
+    for (size_t ii = 0; ii < STORED_FIELDS; ii++)
+    {
+        rd_sensor_data_parse_ExpectAnyArgsAndReturn (0);
+    }
+
+    store_block_expect (IGNORE_RECORD_IDX, false);
+    err_code |= app_log_process (&sample);
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    TEST_ASSERT (0U == m_log_input_block.num_samples);
+    // Samples of stored block are kept until input block refills.
+    TEST_ASSERT (RD_SUCCESS == app_log_history_get (&history));
+    TEST_ASSERT (APP_LOG_HISTORY_LENGTH == history.num_samples);
+    TEST_ASSERT ( (before.sequence + 1U) == history.sequence);
+    TEST_ASSERT ( (APP_LOG_MAX_SAMPLES + 1U) == history.samples[0].timestamp_s);
+    TEST_ASSERT ( (APP_LOG_MAX_SAMPLES - 2U) == history.samples[1].timestamp_s);
+}
+
+void test_app_log_history_get_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_log_history_get (NULL));
+}
+
 /**
  * @brief Configure logging.
  *
@@ -0,0 +1,171 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_motion.h"
+
+#include "mock_app_sensor.h"
+#include "mock_ruuvi_driver_sensor.h"
+
+#include <math.h>
+
+static void period_push (const float x_g, const float y_g, const float z_g)
+{
+    for (size_t ii = 0; ii < 4; ii++)
+    {
+        app_motion_sample_push (x_g, y_g, z_g);
+    }
+}
+
+static void rotate_to (const float degrees)
+{
+    const float rad = degrees * 0.01745329F;
+    period_push (sinf (rad), 0.0F, cosf (rad));
+}
+
+void setUp (void)
+{
+    app_motion_reset();
+}
+
+void tearDown (void)
+{
+}
+
+void test_app_motion_still (void)
+{
+    period_push (0.0F, 0.0F, 1.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+    TEST_ASSERT (APP_MOTION_FACE_Z_UP == app_motion_face_get());
+    period_push (0.01F, 0.0F, 1.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+}
+
+void test_app_motion_no_samples_keeps_state (void)
+{
+    app_sensor_event_increment_Expect();
+    app_motion_sample_push (0.0F, 0.0F, 0.1F);
+    TEST_ASSERT (APP_MOTION_DROPPED == app_motion_classify());
+    TEST_ASSERT (APP_MOTION_DROPPED == app_motion_classify());
+    TEST_ASSERT (APP_MOTION_DROPPED == app_motion_state_get());
+}
+
+void test_app_motion_nan_ignored (void)
+{
+    app_motion_sample_push (NAN, 0.0F, 1.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+    TEST_ASSERT (APP_MOTION_FACE_UNKNOWN == app_motion_face_get());
+}
+
+void test_app_motion_dropped (void)
+{
+    app_motion_sample_push (0.0F, 0.0F, 1.0F);
+    app_motion_sample_push (0.0F, 0.1F, 0.1F);
+    app_motion_sample_push (0.0F, 0.0F, 1.0F);
+    app_sensor_event_increment_Expect();
+    TEST_ASSERT (APP_MOTION_DROPPED == app_motion_classify());
+}
+
+void test_app_motion_moving_counts_once (void)
+{
+    period_push (0.0F, 0.0F, 1.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+    app_sensor_event_increment_Expect();
+    period_push (0.5F, 0.0F, 0.87F);
+    TEST_ASSERT (APP_MOTION_MOVING == app_motion_classify());
+    period_push (0.0F, 0.5F, 0.87F);
+    TEST_ASSERT (APP_MOTION_MOVING == app_motion_classify());
+}
+
+void test_app_motion_vibrating (void)
+{
+    period_push (0.0F, 0.0F, 1.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+
+    for (size_t ii = 0; ii < 8; ii++)
+    {
+        app_motion_sample_push (0.0F, 0.0F, (ii % 2U) ? 1.2F : 0.8F);
+    }
+
+    TEST_ASSERT (APP_MOTION_VIBRATING == app_motion_classify());
+}
+
+void test_app_motion_tilted_slowly (void)
+{
+    rotate_to (0.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+
+    float angle = 4.0F;
+
+    // Each step is too small to count as moving.
+    for (; angle < APP_MOTION_TILT_DEG; angle += 4.0F)
+    {
+        rotate_to (angle);
+        TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+    }
+
+    rotate_to (angle);
+    TEST_ASSERT (APP_MOTION_TILTED == app_motion_classify());
+    TEST_ASSERT (APP_MOTION_FACE_Z_UP == app_motion_face_get());
+}
+
+void test_app_motion_reference_reset (void)
+{
+    rotate_to (0.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+    app_sensor_event_increment_Expect();
+    rotate_to (40.0F);
+    TEST_ASSERT (APP_MOTION_MOVING == app_motion_classify());
+    rotate_to (40.0F);
+    TEST_ASSERT (APP_MOTION_TILTED == app_motion_classify());
+    app_motion_reference_reset();
+    rotate_to (40.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+}
+
+void test_app_motion_orientation_change_counts (void)
+{
+    period_push (0.0F, 0.0F, 1.0F);
+    TEST_ASSERT (APP_MOTION_STILL == app_motion_classify());
+    // Moving into new orientation.
+    app_sensor_event_increment_Expect();
+    period_push (1.0F, 0.0F, 0.0F);
+    TEST_ASSERT (APP_MOTION_MOVING == app_motion_classify());
+    TEST_ASSERT (APP_MOTION_FACE_Z_UP == app_motion_face_get());
+    // Settled on new face.
+    app_sensor_event_increment_Expect();
+    period_push (1.0F, 0.0F, 0.0F);
+    TEST_ASSERT (APP_MOTION_TILTED == app_motion_classify());
+    TEST_ASSERT (APP_MOTION_FACE_X_UP == app_motion_face_get());
+}
+
+void test_app_motion_process_sets_motion (void)
+{
+    float values[4] = {0};
+    rd_sensor_data_t data = {0};
+    data.data = values;
+    data.fields.datas.acceleration_x_g = 1;
+    data.fields.datas.acceleration_y_g = 1;
+    data.fields.datas.acceleration_z_g = 1;
+    data.fields.datas.motion = 1;
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_ACC_X_FIELD, 0.0F);
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_ACC_Y_FIELD, 0.0F);
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_ACC_Z_FIELD, 1.0F);
+    rd_sensor_data_set_Expect (&data, RD_SENSOR_MOTION_FIELD, (float) APP_MOTION_STILL);
+    app_motion_process (&data);
+}
+
+void test_app_motion_process_keeps_sensor_motion (void)
+{
+    float values[4] = {0};
+    rd_sensor_data_t data = {0};
+    data.data = values;
+    data.fields.datas.acceleration_x_g = 1;
+    data.fields.datas.acceleration_y_g = 1;
+    data.fields.datas.acceleration_z_g = 1;
+    data.fields.datas.motion = 1;
+    data.valid.datas.motion = 1;
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_ACC_X_FIELD, 0.0F);
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_ACC_Y_FIELD, 0.0F);
+    rd_sensor_data_parse_ExpectAndReturn (&data, RD_SENSOR_ACC_Z_FIELD, 1.0F);
+    app_motion_process (&data);
+}
@@ -0,0 +1,176 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_oversample.h"
+
+#include "mock_app_sensor.h"
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_driver_sensor.h"
+
+#include <math.h>
+#include <string.h>
+
+#define TEST_FIELD_COUNT (3U)
+
+static float m_read[TEST_FIELD_COUNT]; //!< Values returned by next sensor read.
+
+static size_t field_index (const rd_sensor_data_bitfield_t field)
+{
+    size_t index = TEST_FIELD_COUNT;
+
+    if (field.temperature_c)
+    {
+        index = 0;
+    }
+    else if (field.humidity_rh)
+    {
+        index = 1;
+    }
+    else if (field.pressure_pa)
+    {
+        index = 2;
+    }
+    else
+    {
+        // Not oversampled.
+    }
+
+    return index;
+}
+
+// Test data stores temperature, humidity and pressure in this order.
+static float mock_parse (const rd_sensor_data_t * const provided,
+                         const rd_sensor_data_bitfield_t requested, int cmock_num_calls)
+{
+    const size_t index = field_index (requested);
+    return (TEST_FIELD_COUNT > index) ? provided->data[index] : RD_FLOAT_INVALID;
+}
+
+static void mock_set (rd_sensor_data_t * const target,
+                      const rd_sensor_data_bitfield_t field, const float value,
+                      int cmock_num_calls)
+{
+    target->data[field_index (field)] = value;
+}
+
+static rd_status_t mock_sensor_get (rd_sensor_data_t * const data, int cmock_num_calls)
+{
+    memcpy (data->data, m_read, sizeof (m_read));
+    return RD_SUCCESS;
+}
+
+static void read_add (const float temperature, const float humidity,
+                      const float pressure)
+{
+    float values[TEST_FIELD_COUNT] = { temperature, humidity, pressure };
+    rd_sensor_data_t data = { .data = values };
+    app_oversample_add (&data);
+}
+
+void setUp (void)
+{
+    app_oversample_reset();
+    rd_sensor_data_parse_StubWithCallback (&mock_parse);
+    rd_sensor_data_set_StubWithCallback (&mock_set);
+}
+
+void tearDown (void)
+{
+}
+
+void test_app_oversample_apply_mean (void)
+{
+    float values[TEST_FIELD_COUNT] = { 23.0F, 50.0F, 100003.0F };
+    rd_sensor_data_t data = { .data = values };
+    read_add (20.0F, 40.0F, 100000.0F);
+    read_add (21.0F, 44.0F, 100001.0F);
+    read_add (22.0F, 46.0F, 100002.0F);
+    app_oversample_apply (&data);
+    TEST_ASSERT_EQUAL_FLOAT (21.5F, values[0]);
+    TEST_ASSERT_EQUAL_FLOAT (45.0F, values[1]);
+    TEST_ASSERT_EQUAL_FLOAT (100001.5F, values[2]);
+}
+
+void test_app_oversample_stats (void)
+{
+    app_oversample_stats_t stats = { 0 };
+    float values[TEST_FIELD_COUNT] = { 19.0F, 50.0F, 100000.0F };
+    rd_sensor_data_t data = { .data = values };
+    read_add (20.0F, 40.0F, 100000.0F);
+    read_add (24.0F, 44.0F, 100001.0F);
+    app_oversample_apply (&data);
+    TEST_ASSERT (RD_SUCCESS == app_oversample_stats_get (RD_SENSOR_TEMP_FIELD, &stats));
+    TEST_ASSERT_EQUAL_FLOAT (21.0F, stats.mean);
+    TEST_ASSERT_EQUAL_FLOAT (19.0F, stats.min);
+    TEST_ASSERT_EQUAL_FLOAT (24.0F, stats.max);
+    TEST_ASSERT_EQUAL (3, stats.count);
+}
+
+void test_app_oversample_skips_invalid (void)
+{
+    app_oversample_stats_t stats = { 0 };
+    float values[TEST_FIELD_COUNT] = { 22.0F, RD_FLOAT_INVALID, 100000.0F };
+    rd_sensor_data_t data = { .data = values };
+    read_add (RD_FLOAT_INVALID, RD_FLOAT_INVALID, RD_FLOAT_INVALID);
+    read_add (20.0F, RD_FLOAT_INVALID, 100002.0F);
+    app_oversample_apply (&data);
+    TEST_ASSERT_EQUAL_FLOAT (21.0F, values[0]);
+    // Field without reads is left untouched.
+    TEST_ASSERT (isnan (values[1]));
+    TEST_ASSERT_EQUAL_FLOAT (100001.0F, values[2]);
+    TEST_ASSERT (RD_SUCCESS == app_oversample_stats_get (RD_SENSOR_HUMI_FIELD, &stats));
+    TEST_ASSERT (0 == stats.count);
+    TEST_ASSERT (isnan (stats.mean));
+}
+
+void test_app_oversample_apply_starts_new_interval (void)
+{
+    app_oversample_stats_t stats = { 0 };
+    float values[TEST_FIELD_COUNT] = { 20.0F, 40.0F, 100000.0F };
+    rd_sensor_data_t data = { .data = values };
+    read_add (30.0F, 60.0F, 100010.0F);
+    app_oversample_apply (&data);
+    values[0] = 10.0F;
+    app_oversample_apply (&data);
+    TEST_ASSERT_EQUAL_FLOAT (10.0F, values[0]);
+    TEST_ASSERT (RD_SUCCESS == app_oversample_stats_get (RD_SENSOR_TEMP_FIELD, &stats));
+    TEST_ASSERT (1 == stats.count);
+}
+
+void test_app_oversample_sample_reads_sensors (void)
+{
+    rd_sensor_data_fields_t available = { 0 };
+    app_oversample_stats_t stats = { 0 };
+    float values[TEST_FIELD_COUNT] = { 26.0F, 50.0F, 100000.0F };
+    rd_sensor_data_t data = { .data = values };
+    available.datas.temperature_c = 1;
+    available.datas.humidity_rh = 1;
+    available.datas.pressure_pa = 1;
+    app_sensor_trigger_ExpectAndReturn (available, RD_SUCCESS);
+    app_sensor_get_raw_StubWithCallback (&mock_sensor_get);
+    app_sensor_available_data_IgnoreAndReturn (available);
+    m_read[0] = 24.0F;
+    m_read[1] = 40.0F;
+    m_read[2] = 100002.0F;
+    TEST_ASSERT (RD_SUCCESS == app_oversample_sample());
+    app_oversample_apply (&data);
+    TEST_ASSERT_EQUAL_FLOAT (25.0F, values[0]);
+    TEST_ASSERT_EQUAL_FLOAT (45.0F, values[1]);
+    TEST_ASSERT_EQUAL_FLOAT (100001.0F, values[2]);
+    TEST_ASSERT (RD_SUCCESS == app_oversample_stats_get (RD_SENSOR_PRES_FIELD, &stats));
+    TEST_ASSERT (2 == stats.count);
+}
+
+void test_app_oversample_stats_get_errors (void)
+{
+    app_oversample_stats_t stats = { 0 };
+    TEST_ASSERT (RD_ERROR_NULL == app_oversample_stats_get (RD_SENSOR_TEMP_FIELD, NULL));
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == app_oversample_stats_get (RD_SENSOR_ACC_X_FIELD,
+                 &stats));
+}
+
+void test_app_oversample_apply_null (void)
+{
+    app_oversample_apply (NULL);
+    app_oversample_add (NULL);
+}
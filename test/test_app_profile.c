@@ -0,0 +1,189 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_profile.h"
+
+#include "mock_app_comms.h"
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_interface_rtc.h"
+#include "ruuvi_endpoints.h"
+
+#include <string.h>
+
+static char m_log[512];
+static size_t m_replies;
+static uint8_t m_last_payload[RE_STANDARD_PAYLOAD_LENGTH];
+
+static void mock_log (const char * const msg)
+{
+    strncat (m_log, msg, sizeof (m_log) - strlen (m_log) - 1U);
+}
+
+static rd_status_t mock_reply (ri_comm_message_t * const msg)
+{
+    return RD_SUCCESS;
+}
+
+static rd_status_t mock_blocking_send (const ri_comm_xfer_fp_t reply_fp,
+                                       ri_comm_message_t * const msg, int cmock_num_calls)
+{
+    memcpy (m_last_payload, &msg->data[RE_STANDARD_PAYLOAD_START_INDEX],
+            sizeof (m_last_payload));
+    m_replies++;
+    return RD_SUCCESS;
+}
+
+void setUp (void)
+{
+    app_profile_reset();
+    memset (m_log, 0, sizeof (m_log));
+    m_replies = 0;
+}
+
+void tearDown (void)
+{
+}
+
+void test_profile_bin (void)
+{
+    TEST_ASSERT (0U == profile_bin (0U));
+    TEST_ASSERT (1U == profile_bin (1U));
+    TEST_ASSERT (2U == profile_bin (2U));
+    TEST_ASSERT (2U == profile_bin (3U));
+    TEST_ASSERT (3U == profile_bin (4U));
+    TEST_ASSERT (7U == profile_bin (127U));
+    TEST_ASSERT (11U == profile_bin (1500U));
+    TEST_ASSERT ( (APP_PROFILE_BIN_COUNT - 2U) == profile_bin ( (1UL << 18U) - 1U));
+    TEST_ASSERT ( (APP_PROFILE_BIN_COUNT - 1U) == profile_bin (1UL << 18U));
+    TEST_ASSERT ( (APP_PROFILE_BIN_COUNT - 1U) == profile_bin (UINT32_MAX));
+}
+
+void test_profile_record_get (void)
+{
+    app_profile_stats_t stats = {0};
+    profile_record (APP_PROFILE_ENCODE, 0U);
+    profile_record (APP_PROFILE_ENCODE, 3U);
+    profile_record (APP_PROFILE_ENCODE, 12U);
+    TEST_ASSERT (RD_SUCCESS == app_profile_stats_get (APP_PROFILE_ENCODE, &stats));
+    TEST_ASSERT (3U == stats.count);
+    TEST_ASSERT (12U == stats.max_us);
+    TEST_ASSERT (15U == stats.total_us);
+    TEST_ASSERT (1U == stats.bins[0]);
+    TEST_ASSERT (1U == stats.bins[2]);
+    TEST_ASSERT (1U == stats.bins[4]);
+    TEST_ASSERT (RD_SUCCESS == app_profile_stats_get (APP_PROFILE_SENSOR_READ, &stats));
+    TEST_ASSERT (0U == stats.count);
+}
+
+void test_profile_record_invalid_stage (void)
+{
+    app_profile_stats_t stats = {0};
+    profile_record (APP_PROFILE_STAGE_COUNT, 5U);
+
+    for (size_t ii = 0; ii < APP_PROFILE_STAGE_COUNT; ii++)
+    {
+        TEST_ASSERT (RD_SUCCESS == app_profile_stats_get ( (app_profile_stage_t) ii,
+                     &stats));
+        TEST_ASSERT (0U == stats.count);
+    }
+}
+
+void test_app_profile_stats_get_errors (void)
+{
+    app_profile_stats_t stats = {0};
+    TEST_ASSERT (RD_ERROR_NULL == app_profile_stats_get (APP_PROFILE_ENCODE, NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_profile_stats_get (APP_PROFILE_STAGE_COUNT,
+                 &stats));
+}
+
+void test_profile_encode_summary (void)
+{
+    uint8_t payload[RE_STANDARD_PAYLOAD_LENGTH] = {0};
+    profile_record (APP_PROFILE_LOG_PROCESS, 100U);
+    profile_record (APP_PROFILE_LOG_PROCESS, 70000U);
+    profile_encode (payload, APP_PROFILE_LOG_PROCESS, 0U);
+    TEST_ASSERT (APP_PROFILE_LOG_PROCESS == payload[0]);
+    TEST_ASSERT (0U == payload[1]);
+    TEST_ASSERT (2U == ( (payload[2] << 8U) | payload[3]));
+    // Durations over 65 ms do not saturate.
+    TEST_ASSERT (0x00011170UL == ( ( (uint32_t) payload[4] << 24U)
+                                   | ( (uint32_t) payload[5] << 16U)
+                                   | ( (uint32_t) payload[6] << 8U) | payload[7]));
+    profile_encode (payload, APP_PROFILE_LOG_PROCESS, 1U);
+    TEST_ASSERT (1U == payload[1]);
+    TEST_ASSERT (35050UL == ( ( (uint32_t) payload[2] << 24U)
+                              | ( (uint32_t) payload[3] << 16U)
+                              | ( (uint32_t) payload[4] << 8U) | payload[5]));
+}
+
+void test_profile_encode_bins (void)
+{
+    uint8_t payload[RE_STANDARD_PAYLOAD_LENGTH] = {0};
+    profile_record (APP_PROFILE_LOG_PROCESS, 4U);
+    profile_record (APP_PROFILE_LOG_PROCESS, 5U);
+    profile_record (APP_PROFILE_LOG_PROCESS, 200U);
+    profile_record (APP_PROFILE_LOG_PROCESS, 1UL << 18U);
+    // Bins 3, 4 and 5.
+    profile_encode (payload, APP_PROFILE_LOG_PROCESS, 3U);
+    TEST_ASSERT (3U == payload[1]);
+    TEST_ASSERT (2U == ( (payload[2] << 8U) | payload[3]));
+    TEST_ASSERT (0U == ( (payload[4] << 8U) | payload[5]));
+    // Bins 6, 7 and 8.
+    profile_encode (payload, APP_PROFILE_LOG_PROCESS, 4U);
+    TEST_ASSERT (1U == ( (payload[6] << 8U) | payload[7]));
+    // Last page has only bins 18 and 19.
+    profile_encode (payload, APP_PROFILE_LOG_PROCESS, 8U);
+    TEST_ASSERT (0U == ( (payload[2] << 8U) | payload[3]));
+    TEST_ASSERT (1U == ( (payload[4] << 8U) | payload[5]));
+    TEST_ASSERT (0U == ( (payload[6] << 8U) | payload[7]));
+}
+
+void test_app_profile_handle_read (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_READ;
+    profile_record (APP_PROFILE_HEARTBEAT, 20U);
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    TEST_ASSERT (RD_SUCCESS == app_profile_handle (&mock_reply, mock_data,
+                 sizeof (mock_data)));
+    // Two summary and seven bin pages of one stage, then end of data.
+    TEST_ASSERT (10U == m_replies);
+    TEST_ASSERT (0xFFU == m_last_payload[0]);
+}
+
+void test_app_profile_handle_write_clears (void)
+{
+    app_profile_stats_t stats = {0};
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    mock_data[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    profile_record (APP_PROFILE_HEARTBEAT, 20U);
+    app_comms_blocking_send_StubWithCallback (&mock_blocking_send);
+    TEST_ASSERT (RD_SUCCESS == app_profile_handle (&mock_reply, mock_data,
+                 sizeof (mock_data)));
+    TEST_ASSERT (1U == m_replies);
+    TEST_ASSERT (RD_SUCCESS == app_profile_stats_get (APP_PROFILE_HEARTBEAT, &stats));
+    TEST_ASSERT (0U == stats.count);
+}
+
+void test_app_profile_handle_errors (void)
+{
+    uint8_t mock_data[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    TEST_ASSERT (RD_ERROR_NULL == app_profile_handle (&mock_reply, NULL,
+                 sizeof (mock_data)));
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == app_profile_handle (&mock_reply, mock_data,
+                 sizeof (mock_data) - 1U));
+}
+
+void test_app_profile_print (void)
+{
+    profile_record (APP_PROFILE_SENSOR_READ, 6U);
+    profile_record (APP_PROFILE_SENSOR_READ, 10U);
+    app_profile_print (&mock_log);
+    TEST_ASSERT_EQUAL_STRING ("sensor: n 2, mean 8 us, max 10 us, "
+                              "0 0 0 1 1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\r\n", m_log);
+}
+
+void test_app_profile_print_null (void)
+{
+    app_profile_print (NULL);
+}
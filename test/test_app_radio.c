@@ -0,0 +1,203 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_radio.h"
+
+#include "mock_app_sensor.h"
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_interface_atomic.h"
+#include "mock_ruuvi_interface_communication_radio.h"
+#include "mock_ruuvi_interface_scheduler.h"
+#include "mock_ruuvi_interface_timer.h"
+
+extern ri_timer_id_t m_idle_timer;
+static unsigned int mock_tid = 0xAA; //!< Mock timer ID to be returned, size system int.
+static void * p_mock_tid = &mock_tid; //!< Pointer to mock ID.
+static uint8_t m_job_runs;
+static uint8_t m_other_job_runs;
+
+static void job (void * p_event, uint16_t event_size)
+{
+    m_job_runs++;
+}
+
+static void other_job (void * p_event, uint16_t event_size)
+{
+    m_other_job_runs++;
+}
+
+static void job_a (void * p_event, uint16_t event_size)
+{
+}
+
+static void job_b (void * p_event, uint16_t event_size)
+{
+}
+
+static void job_c (void * p_event, uint16_t event_size)
+{
+}
+
+static void job_d (void * p_event, uint16_t event_size)
+{
+}
+
+static bool atomic_flag_stub (ri_atomic_t * const flag, const bool set,
+                              const int cmock_num_calls)
+{
+    const bool changed = ( (0U != *flag) != set);
+    *flag = set ? 1U : 0U;
+    return changed;
+}
+
+static void enqueue (ri_scheduler_event_handler_t handler)
+{
+    idle_enqueue (&handler, sizeof (handler));
+}
+
+void setUp (void)
+{
+    rd_error_check_Ignore();
+    ri_atomic_flag_StubWithCallback (&atomic_flag_stub);
+    app_radio_reset();
+    m_idle_timer = &mock_tid;
+    m_job_runs = 0;
+    m_other_job_runs = 0;
+}
+
+void tearDown (void)
+{
+}
+
+void test_app_radio_init_ok (void)
+{
+    ri_timer_is_init_ExpectAndReturn (true);
+    ri_scheduler_is_init_ExpectAndReturn (true);
+    ri_timer_create_ExpectAndReturn (&m_idle_timer, RI_TIMER_MODE_SINGLE_SHOT,
+                                     &idle_timeout_isr, RD_SUCCESS);
+    ri_timer_create_ReturnArrayThruPtr_p_timer_id (&p_mock_tid, 1);
+    TEST_ASSERT (RD_SUCCESS == app_radio_init());
+}
+
+void test_app_radio_init_notimer (void)
+{
+    ri_timer_is_init_ExpectAndReturn (false);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_radio_init());
+}
+
+void test_app_radio_idle_run_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_radio_idle_run (NULL));
+}
+
+void test_app_radio_idle_run_schedules_enqueue (void)
+{
+    ri_scheduler_event_put_ExpectAndReturn (NULL, sizeof (ri_scheduler_event_handler_t),
+                                            &idle_enqueue, RD_SUCCESS);
+    ri_scheduler_event_put_IgnoreArg_p_event_data();
+    TEST_ASSERT (RD_SUCCESS == app_radio_idle_run (&job));
+}
+
+void test_app_radio_job_runs_after_radio (void)
+{
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_RADIO_IDLE_TIMEOUT_MS, NULL,
+                                    RD_SUCCESS);
+    enqueue (&job);
+    // Before TX prepares ADC only.
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_BEFORE);
+    app_radio_activity_isr (RI_RADIO_BEFORE);
+    TEST_ASSERT (0 == m_job_runs);
+    // After TX opens idle window.
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_AFTER);
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &idle_window_handler, RD_SUCCESS);
+    app_radio_activity_isr (RI_RADIO_AFTER);
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    idle_window_handler (NULL, 0);
+    TEST_ASSERT (1 == m_job_runs);
+}
+
+void test_app_radio_no_window_without_jobs (void)
+{
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_AFTER);
+    app_radio_activity_isr (RI_RADIO_AFTER);
+}
+
+void test_app_radio_no_window_after_jobs_ran (void)
+{
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_RADIO_IDLE_TIMEOUT_MS, NULL,
+                                    RD_SUCCESS);
+    enqueue (&job);
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    idle_window_handler (NULL, 0);
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_AFTER);
+    app_radio_activity_isr (RI_RADIO_AFTER);
+    TEST_ASSERT (1 == m_job_runs);
+}
+
+void test_app_radio_window_scheduled_once (void)
+{
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_RADIO_IDLE_TIMEOUT_MS, NULL,
+                                    RD_SUCCESS);
+    enqueue (&job);
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_AFTER);
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &idle_window_handler, RD_SUCCESS);
+    app_radio_activity_isr (RI_RADIO_AFTER);
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_AFTER);
+    app_radio_activity_isr (RI_RADIO_AFTER);
+}
+
+void test_app_radio_window_retried_if_not_scheduled (void)
+{
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_RADIO_IDLE_TIMEOUT_MS, NULL,
+                                    RD_SUCCESS);
+    enqueue (&job);
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_AFTER);
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &idle_window_handler,
+                                            RD_ERROR_NO_MEM);
+    app_radio_activity_isr (RI_RADIO_AFTER);
+    app_sensor_vdd_measure_isr_Expect (RI_RADIO_AFTER);
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &idle_window_handler, RD_SUCCESS);
+    app_radio_activity_isr (RI_RADIO_AFTER);
+}
+
+void test_app_radio_duplicate_job_runs_once (void)
+{
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_RADIO_IDLE_TIMEOUT_MS, NULL,
+                                    RD_SUCCESS);
+    enqueue (&job);
+    enqueue (&job);
+    enqueue (&other_job);
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    idle_window_handler (NULL, 0);
+    TEST_ASSERT (1 == m_job_runs);
+    TEST_ASSERT (1 == m_other_job_runs);
+}
+
+void test_app_radio_timeout_runs_jobs (void)
+{
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_RADIO_IDLE_TIMEOUT_MS, NULL,
+                                    RD_SUCCESS);
+    enqueue (&job);
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &idle_window_handler, RD_SUCCESS);
+    idle_timeout_isr (NULL);
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    idle_window_handler (NULL, 0);
+    TEST_ASSERT (1 == m_job_runs);
+}
+
+void test_app_radio_full_queue_runs_immediately (void)
+{
+    const ri_scheduler_event_handler_t jobs[] = {&job_a, &job_b, &job_c, &job_d};
+    TEST_ASSERT (APP_RADIO_IDLE_QUEUE_SIZE <= (sizeof (jobs) / sizeof (jobs[0])));
+    ri_timer_start_ExpectAndReturn (&mock_tid, APP_RADIO_IDLE_TIMEOUT_MS, NULL,
+                                    RD_SUCCESS);
+
+    for (size_t ii = 0; ii < APP_RADIO_IDLE_QUEUE_SIZE; ii++)
+    {
+        enqueue (jobs[ii]);
+    }
+
+    // Queue is full, job is not dropped.
+    enqueue (&job);
+    TEST_ASSERT (1 == m_job_runs);
+}
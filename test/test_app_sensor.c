@@ -3,9 +3,11 @@
 #include "app_config.h"
 #include "app_sensor.h"
 
+#include "mock_app_battery.h"
 #include "mock_app_comms.h"
 #include "mock_app_heartbeat.h"
 #include "mock_app_log.h"
+#include "mock_app_radio.h"
 #include "mock_ruuvi_driver_error.h"
 #include "mock_ruuvi_driver_sensor.h"
 #include "mock_ruuvi_endpoints.h"
@@ -362,31 +364,72 @@ void test_app_sensor_uninit_ok (void)
     TEST_ASSERT (RD_SUCCESS == err_code);
 }
 
+static rd_sensor_configuration_t m_vdd_configuration =
+{
+    .dsp_function  = RD_SENSOR_CFG_DEFAULT,
+    .dsp_parameter = RD_SENSOR_CFG_DEFAULT,
+    .mode          = RD_SENSOR_CFG_SINGLE,
+    .resolution    = RD_SENSOR_CFG_DEFAULT,
+    .samplerate    = RD_SENSOR_CFG_DEFAULT,
+    .scale         = RD_SENSOR_CFG_DEFAULT
+};
+
 void test_app_sensor_on_radio_before_ok (void)
 {
-    static rd_sensor_configuration_t configuration =
-    {
-        .dsp_function  = RD_SENSOR_CFG_DEFAULT,
-        .dsp_parameter = RD_SENSOR_CFG_DEFAULT,
-        .mode          = RD_SENSOR_CFG_SINGLE,
-        .resolution    = RD_SENSOR_CFG_DEFAULT,
-        .samplerate    = RD_SENSOR_CFG_DEFAULT,
-        .scale         = RD_SENSOR_CFG_DEFAULT
-    };
     static uint64_t time = 1ULL;
+    float rest_vdd = 3.0F;
+    float load_vdd = 2.9F;
+    // Before TX only queues rest sample, ADC is not touched in interrupt.
+    ri_rtc_millis_ExpectAndReturn (time);
+    app_radio_idle_run_ExpectAndReturn (&vdd_rest_sample, RD_SUCCESS);
+    app_sensor_vdd_measure_isr (RI_RADIO_BEFORE);
+    // Rest sample is queued only once.
     ri_rtc_millis_ExpectAndReturn (time);
-    rt_adc_vdd_prepare_ExpectWithArrayAndReturn (&configuration, 1, RD_SUCCESS);
     app_sensor_vdd_measure_isr (RI_RADIO_BEFORE);
+    // Sample at rest in idle window and prepare for sample under load.
+    rt_adc_vdd_prepare_ExpectWithArrayAndReturn (&m_vdd_configuration, 1, RD_SUCCESS);
+    rt_adc_vdd_sample_ExpectAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ReturnThruPtr_vdd (&rest_vdd);
+    app_battery_sample_isr_Expect (rest_vdd, false);
+    rt_adc_vdd_prepare_ExpectWithArrayAndReturn (&m_vdd_configuration, 1, RD_SUCCESS);
+    vdd_rest_sample (NULL, 0);
+    // Prepared ADC is not touched before TX.
+    ri_rtc_millis_ExpectAndReturn (time);
+    app_sensor_vdd_measure_isr (RI_RADIO_BEFORE);
+    ri_rtc_millis_ExpectAndReturn (time);
+    rt_adc_is_init_ExpectAndReturn (true);
+    ri_rtc_millis_ExpectAndReturn (time);
+    rt_adc_vdd_sample_ExpectAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ReturnThruPtr_vdd (&load_vdd);
+    app_battery_sample_isr_Expect (load_vdd, true);
+    app_sensor_vdd_measure_isr (RI_RADIO_AFTER);
 }
 
-void test_app_sensor_on_radio_after_ok (void)
+void test_app_sensor_on_radio_after_not_prepared (void)
 {
-    static uint64_t time = 1ULL;
+    static uint64_t time = (2ULL * APP_BATTERY_SAMPLE_MS) + 2ULL;
+    // No sample under load without rest sample first.
     ri_rtc_millis_ExpectAndReturn (time);
-    rt_adc_is_init_ExpectAndReturn (true);
+    app_sensor_vdd_measure_isr (RI_RADIO_AFTER);
+}
+
+void test_app_sensor_vdd_rest_sample_error (void)
+{
+    static uint64_t time = (2ULL * APP_BATTERY_SAMPLE_MS) + 2ULL;
+    rt_adc_vdd_prepare_ExpectWithArrayAndReturn (&m_vdd_configuration, 1,
+            RD_ERROR_INVALID_STATE);
+    vdd_rest_sample (NULL, 0);
+    // Failed rest sample is requested again and load is not sampled.
     ri_rtc_millis_ExpectAndReturn (time);
-    rt_adc_vdd_sample_ExpectAndReturn (RD_SUCCESS);
     app_sensor_vdd_measure_isr (RI_RADIO_AFTER);
+    ri_rtc_millis_ExpectAndReturn (time);
+    app_radio_idle_run_ExpectAndReturn (&vdd_rest_sample, RD_SUCCESS);
+    app_sensor_vdd_measure_isr (RI_RADIO_BEFORE);
+    rt_adc_vdd_prepare_ExpectWithArrayAndReturn (&m_vdd_configuration, 1,
+            RD_ERROR_INVALID_STATE);
+    vdd_rest_sample (NULL, 0);
 }
 
 /**
@@ -499,6 +542,76 @@ void test_app_sensor_get (void)
                           sizeof (fields_expected.bitfield)));
 }
 
+void test_app_sensor_get_raw (void)
+{
+    rd_sensor_data_t data = {0};
+    data.fields.bitfield |= fields_expected.bitfield;
+    data_get_calls = 0;
+
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        m_sensors[ii]->sensor.data_get = &mock_data_get;
+        rd_sensor_is_init_ExpectAndReturn (& (m_sensors[ii]->sensor), true);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_sensor_get_raw (&data));
+    TEST_ASSERT (!memcmp (&data.valid.bitfield, &fields_expected.bitfield,
+                          sizeof (fields_expected.bitfield)));
+}
+
+static float m_conversion_c; //!< Temperature of latest conversion of mock sensor.
+
+static rd_status_t mock_mode_set_convert (uint8_t * const mode)
+{
+    // Like BME280 at 1 Hz, data changes only on a new conversion.
+    if (RD_SENSOR_CFG_SINGLE == *mode)
+    {
+        m_conversion_c += 0.01F;
+    }
+
+    return RD_SUCCESS;
+}
+
+static rd_status_t mock_data_get_conversion (rd_sensor_data_t * const data)
+{
+    data->data[0] = m_conversion_c;
+    data->valid.datas.temperature_c = 1;
+    return RD_SUCCESS;
+}
+
+static float trigger_read (const rd_sensor_data_fields_t fields)
+{
+    float value = 0.0F;
+    rd_sensor_data_t data = { .fields = fields, .data = &value };
+
+    for (size_t ii = 0; ii <= BME280_INDEX; ii++)
+    {
+        rd_sensor_is_init_ExpectAndReturn (& (m_sensors[ii]->sensor), BME280_INDEX == ii);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_sensor_trigger (fields));
+
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        rd_sensor_is_init_ExpectAndReturn (& (m_sensors[ii]->sensor), BME280_INDEX == ii);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_sensor_get_raw (&data));
+    return value;
+}
+
+void test_app_sensor_trigger_consecutive_reads_differ (void)
+{
+    rd_sensor_data_fields_t fields = {0};
+    fields.datas.temperature_c = 1;
+    m_sensors[BME280_INDEX]->sensor.provides = fields_bme;
+    m_sensors[BME280_INDEX]->sensor.mode_set = &mock_mode_set_convert;
+    m_sensors[BME280_INDEX]->sensor.data_get = &mock_data_get_conversion;
+    const float first = trigger_read (fields);
+    const float second = trigger_read (fields);
+    TEST_ASSERT (first != second);
+}
+
 /**
  * @brief Find and return a sensor which can provide requested data.
  *
@@ -652,12 +765,15 @@ void test_app_sensor_find_provider_null (void)
  */
 static uint32_t level_interrupt_set_enabled = 0;
 static uint32_t level_interrupt_set_disabled = 0;
+static float level_interrupt_set_limit = 0;
 static rd_status_t mock_level_interrupt_set (const bool enable,
         float * limit_g)
 {
     if (enable)
     {
         level_interrupt_set_enabled++;
+        TEST_ASSERT (NULL != limit_g);
+        level_interrupt_set_limit = *limit_g;
     }
     else
     {
@@ -783,6 +899,7 @@ void test_app_sensor_accelerometer_isr (void)
     ri_gpio_evt_t evt;
     evt.slope = RI_GPIO_SLOPE_LOTOHI;
     uint32_t orig_cnt = app_sensor_event_count_get ();
+    app_heartbeat_activity_isr_Expect();
     on_accelerometer_isr (evt);
     uint32_t incremented_cnt = app_sensor_event_count_get ();
     TEST_ASSERT ( (orig_cnt + 1) == incremented_cnt);
@@ -792,6 +909,53 @@ void test_app_sensor_accelerometer_isr (void)
     TEST_ASSERT ( (orig_cnt + 1) == incremented_cnt);
 }
 
+void test_app_sensor_presence_isr (void)
+{
+    ri_gpio_evt_t evt;
+    evt.slope = RI_GPIO_SLOPE_LOTOHI;
+    const uint32_t orig_cnt = app_sensor_presence_count_get ();
+    const uint32_t orig_events = app_sensor_event_count_get ();
+    app_heartbeat_activity_isr_Expect();
+    app_heartbeat_refresh_isr_Expect();
+    on_presence_isr (evt);
+    TEST_ASSERT ( (orig_cnt + 1) == app_sensor_presence_count_get ());
+    // Presence is not advertised as movement.
+    TEST_ASSERT (orig_events == app_sensor_event_count_get ());
+    // End of presence is advertised but not counted.
+    evt.slope = RI_GPIO_SLOPE_HITOLO;
+    app_heartbeat_refresh_isr_Expect();
+    on_presence_isr (evt);
+    TEST_ASSERT ( (orig_cnt + 1) == app_sensor_presence_count_get ());
+}
+
+void test_app_sensor_presence_int_set_ok (void)
+{
+    const ri_gpio_id_t pin = 7U;
+    rt_sensor_ctx_t * const p_ctx = m_sensors[STHS34PF80_INDEX];
+    const ri_gpio_id_t orig_pin = p_ctx->level_pin;
+    p_ctx->level_pin = pin;
+    p_ctx->sensor.level_interrupt_set = &mock_level_interrupt_set;
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_interrupt_enable_ExpectAndReturn (pin, RI_GPIO_SLOPE_TOGGLE,
+            RI_GPIO_MODE_INPUT_NOPULL, &on_presence_isr, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_sensor_presence_int_set (true));
+    TEST_ASSERT (APP_SENSOR_STHS34PF80_PRESENCE_THRESHOLD == level_interrupt_set_limit);
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_interrupt_disable_ExpectAndReturn (pin, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_sensor_presence_int_set (false));
+    p_ctx->level_pin = orig_pin;
+}
+
+void test_app_sensor_presence_int_set_not_init (void)
+{
+    const ri_gpio_id_t pin = 7U;
+    rt_sensor_ctx_t * const p_ctx = m_sensors[STHS34PF80_INDEX];
+    const ri_gpio_id_t orig_pin = p_ctx->level_pin;
+    p_ctx->level_pin = pin;
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, false);
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == app_sensor_presence_int_set (true));
+    p_ctx->level_pin = orig_pin;
+}
 
 static void app_sensor_encode_log_Expect (const uint8_t source)
 {
@@ -1242,3 +1406,224 @@ void test_app_sensor_vdd_sample_ok (void)
     err_code |= app_sensor_vdd_sample();
     TEST_ASSERT (RD_SUCCESS == err_code);
 }
+
+void test_app_sensor_stats_update_get (void)
+{
+    app_sensor_stats_t stats = {0};
+    app_sensor_stats_reset();
+    stats_update (0, APP_SENSOR_STATS_READ, 5U, RD_SUCCESS);
+    stats_update (0, APP_SENSOR_STATS_READ, 3U, RD_ERROR_INTERNAL);
+    stats_update (0, APP_SENSOR_STATS_READ, 10U, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_sensor_stats_get (0, APP_SENSOR_STATS_READ, &stats));
+    TEST_ASSERT (3U == stats.count);
+    TEST_ASSERT (1U == stats.errors);
+    TEST_ASSERT (3U == stats.min_ms);
+    TEST_ASSERT (10U == stats.max_ms);
+    TEST_ASSERT (18U == stats.total_ms);
+    TEST_ASSERT (RD_SUCCESS == app_sensor_stats_get (0, APP_SENSOR_STATS_INIT, &stats));
+    TEST_ASSERT (0U == stats.count);
+    TEST_ASSERT (0U == stats.min_ms);
+}
+
+void test_app_sensor_stats_get_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_sensor_stats_get (0, APP_SENSOR_STATS_READ, NULL));
+}
+
+void test_app_sensor_stats_get_invalid (void)
+{
+    app_sensor_stats_t stats = {0};
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_sensor_stats_get (SENSOR_COUNT,
+                 APP_SENSOR_STATS_READ, &stats));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_sensor_stats_get (0,
+                 APP_SENSOR_STATS_OP_COUNT, &stats));
+}
+
+void test_app_sensor_stats_encode_saturates (void)
+{
+    uint8_t payload[RE_STANDARD_PAYLOAD_LENGTH] = {0};
+    const uint8_t expect[RE_STANDARD_PAYLOAD_LENGTH] =
+    {
+        0x00, APP_SENSOR_STATS_CONFIGURE, 0x00, 0x02, 0x00, 0x02, 0xFF, 0xA7
+    };
+    app_sensor_stats_reset();
+    stats_update (0, APP_SENSOR_STATS_CONFIGURE, 2U, RD_SUCCESS);
+    stats_update (0, APP_SENSOR_STATS_CONFIGURE, 333U, RD_SUCCESS);
+    stats_encode (payload, 0, APP_SENSOR_STATS_CONFIGURE);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (expect, payload, sizeof (expect));
+}
+
+void test_app_sensor_stats_handle_read (void)
+{
+    uint8_t raw_message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    raw_message[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_SENSOR_STATS;
+    raw_message[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_READ;
+    m_expect_sends = 0;
+    app_sensor_stats_reset();
+    stats_update (0, APP_SENSOR_STATS_INIT, 1U, RD_SUCCESS);
+    stats_update (0, APP_SENSOR_STATS_READ, 1U, RD_SUCCESS);
+    // One message per timed operation and end of data.
+    app_sensor_blocking_send_Expect (&dummy_comm);
+    app_sensor_blocking_send_Expect (&dummy_comm);
+    app_sensor_blocking_send_Expect (&dummy_comm);
+    rd_status_t err_code = app_sensor_stats_handle (&dummy_comm, raw_message,
+                           sizeof (raw_message));
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    TEST_ASSERT (3 == m_expect_sends);
+}
+
+void test_app_sensor_stats_handle_write_resets (void)
+{
+    app_sensor_stats_t stats = {0};
+    uint8_t raw_message[RE_STANDARD_MESSAGE_LENGTH] = {0};
+    raw_message[RE_STANDARD_DESTINATION_INDEX] = APP_ENDPOINT_SENSOR_STATS;
+    raw_message[RE_STANDARD_OPERATION_INDEX] = RE_STANDARD_VALUE_WRITE;
+    stats_update (0, APP_SENSOR_STATS_READ, 1U, RD_SUCCESS);
+    app_sensor_blocking_send_Expect (&dummy_comm);
+    rd_status_t err_code = app_sensor_stats_handle (&dummy_comm, raw_message,
+                           sizeof (raw_message));
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    (void) app_sensor_stats_get (0, APP_SENSOR_STATS_READ, &stats);
+    TEST_ASSERT (0U == stats.count);
+}
+
+void test_app_sensor_stats_handle_short (void)
+{
+    uint8_t raw_message[RE_STANDARD_HEADER_LENGTH] = {0};
+    rd_status_t err_code = app_sensor_stats_handle (&dummy_comm, raw_message,
+                           sizeof (raw_message));
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == err_code);
+}
+
+static ri_gpio_id_t m_pwr_pins[SENSOR_COUNT];
+static uint8_t m_mode_set;
+
+static rd_status_t mock_mode_set (uint8_t * const mode)
+{
+    m_mode_set = *mode;
+    return RD_SUCCESS;
+}
+
+/** @brief Leave power pin only to given sensor. */
+static void power_pin_only (const size_t sensor_idx, const ri_gpio_id_t pin)
+{
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        m_pwr_pins[ii] = m_sensors[ii]->pwr_pin;
+        m_sensors[ii]->pwr_pin = (sensor_idx == ii) ? pin : RI_GPIO_ID_UNUSED;
+    }
+}
+
+static void power_pins_restore (void)
+{
+    for (size_t ii = 0; ii < SENSOR_COUNT; ii++)
+    {
+        m_sensors[ii]->pwr_pin = m_pwr_pins[ii];
+    }
+}
+
+void test_app_sensor_power_gating_cycle (void)
+{
+    const ri_gpio_id_t pin = 5U;
+    rt_sensor_ctx_t * const p_ctx = m_sensors[BME280_INDEX];
+    power_pin_only (BME280_INDEX, pin);
+    p_ctx->sensor.uninit = &mock_uninit;
+    p_ctx->sensor.mode_set = &mock_mode_set;
+    p_ctx->sensor.provides.datas.temperature_c = 1;
+    m_mode_set = 0;
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    sensors_power_down();
+    // Repower and restore cached configuration.
+    ri_gpio_write_ExpectAndReturn (pin, p_ctx->pwr_on, RD_SUCCESS);
+    ri_delay_ms_ExpectAndReturn (POWERUP_DELAY_MS, RD_SUCCESS);
+    rt_sensor_initialize_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    rt_sensor_configure_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == sensors_power_up());
+    TEST_ASSERT (RD_SENSOR_CFG_SINGLE == m_mode_set);
+    // Nothing left to power up.
+    TEST_ASSERT (RD_SUCCESS == sensors_power_up());
+    power_pins_restore();
+}
+
+void test_app_sensor_power_gating_restore_fail (void)
+{
+    const ri_gpio_id_t pin = 5U;
+    rt_sensor_ctx_t * const p_ctx = m_sensors[BME280_INDEX];
+    power_pin_only (BME280_INDEX, pin);
+    p_ctx->sensor.uninit = &mock_uninit;
+    p_ctx->sensor.mode_set = &mock_mode_set;
+    p_ctx->sensor.provides.datas.temperature_c = 1;
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    sensors_power_down();
+    // Sensor does not respond, it is powered off again.
+    ri_gpio_write_ExpectAndReturn (pin, p_ctx->pwr_on, RD_SUCCESS);
+    ri_delay_ms_ExpectAndReturn (POWERUP_DELAY_MS, RD_SUCCESS);
+    rt_sensor_initialize_ExpectWithArrayAndReturn (p_ctx, 1, RD_ERROR_NOT_FOUND);
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, false);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == sensors_power_up());
+    // Retried on next sample.
+    ri_gpio_write_ExpectAndReturn (pin, p_ctx->pwr_on, RD_SUCCESS);
+    ri_delay_ms_ExpectAndReturn (POWERUP_DELAY_MS, RD_SUCCESS);
+    rt_sensor_initialize_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    rt_sensor_configure_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == sensors_power_up());
+    power_pins_restore();
+}
+
+void test_app_sensor_access_restore_fail (void)
+{
+    const ri_gpio_id_t pin = 5U;
+    rt_sensor_ctx_t * const p_ctx = m_sensors[BME280_INDEX];
+    power_pin_only (BME280_INDEX, pin);
+    p_ctx->sensor.uninit = &mock_uninit;
+    p_ctx->sensor.mode_set = &mock_mode_set;
+    p_ctx->sensor.provides.datas.temperature_c = 1;
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    sensors_power_down();
+    // Sensor is not accessed if it cannot be restored.
+    ri_gpio_write_ExpectAndReturn (pin, p_ctx->pwr_on, RD_SUCCESS);
+    ri_delay_ms_ExpectAndReturn (POWERUP_DELAY_MS, RD_SUCCESS);
+    rt_sensor_initialize_ExpectWithArrayAndReturn (p_ctx, 1, RD_ERROR_NOT_FOUND);
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, false);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, false);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == sensors_access_begin());
+    // Sensor stays gated and is restored on next access.
+    ri_gpio_write_ExpectAndReturn (pin, p_ctx->pwr_on, RD_SUCCESS);
+    ri_delay_ms_ExpectAndReturn (POWERUP_DELAY_MS, RD_SUCCESS);
+    rt_sensor_initialize_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    rt_sensor_configure_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == sensors_access_begin());
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    sensors_access_end();
+    power_pins_restore();
+}
+
+void test_app_sensor_power_hold_release (void)
+{
+    const ri_gpio_id_t pin = 5U;
+    rt_sensor_ctx_t * const p_ctx = m_sensors[BME280_INDEX];
+    power_pin_only (BME280_INDEX, pin);
+    p_ctx->sensor.uninit = &mock_uninit;
+    p_ctx->sensor.mode_set = &mock_mode_set;
+    p_ctx->sensor.provides.datas.temperature_c = 1;
+    TEST_ASSERT (RD_SUCCESS == app_sensor_power_hold());
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    app_sensor_power_release();
+    // Held sensors are powered up once.
+    ri_gpio_write_ExpectAndReturn (pin, p_ctx->pwr_on, RD_SUCCESS);
+    ri_delay_ms_ExpectAndReturn (POWERUP_DELAY_MS, RD_SUCCESS);
+    rt_sensor_initialize_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    rt_sensor_configure_ExpectWithArrayAndReturn (p_ctx, 1, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_sensor_power_hold());
+    rd_sensor_is_init_ExpectAndReturn (&p_ctx->sensor, true);
+    ri_gpio_write_ExpectAndReturn (pin, !p_ctx->pwr_on, RD_SUCCESS);
+    app_sensor_power_release();
+    power_pins_restore();
+}
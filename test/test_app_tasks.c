@@ -0,0 +1,185 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_tasks.h"
+
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_interface_rtc.h"
+#include "mock_ruuvi_interface_scheduler.h"
+#include "mock_ruuvi_interface_timer.h"
+
+extern ri_timer_id_t m_tasks_timer;
+static unsigned int mock_tid = 0xAA; //!< Mock timer ID to be returned, size system int.
+static void * p_mock_tid = &mock_tid; //!< Pointer to mock ID.
+static uint8_t m_fast_runs;
+static uint8_t m_slow_runs;
+
+static void fast_task (void * p_event, uint16_t event_size)
+{
+    m_fast_runs++;
+}
+
+static void slow_task (void * p_event, uint16_t event_size)
+{
+    m_slow_runs++;
+}
+
+static void task_a (void * p_event, uint16_t event_size)
+{
+}
+
+static void task_b (void * p_event, uint16_t event_size)
+{
+}
+
+static void task_c (void * p_event, uint16_t event_size)
+{
+}
+
+static void task_d (void * p_event, uint16_t event_size)
+{
+}
+
+static void task_e (void * p_event, uint16_t event_size)
+{
+}
+
+void setUp (void)
+{
+    rd_error_check_Ignore();
+    app_tasks_reset();
+    m_fast_runs = 0;
+    m_slow_runs = 0;
+}
+
+void tearDown (void)
+{
+}
+
+static void tasks_started (void)
+{
+    m_tasks_timer = &mock_tid;
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &tasks_handler, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_tasks_start());
+}
+
+void test_app_tasks_init_ok (void)
+{
+    ri_timer_is_init_ExpectAndReturn (true);
+    ri_scheduler_is_init_ExpectAndReturn (true);
+    ri_timer_create_ExpectAndReturn (&m_tasks_timer, RI_TIMER_MODE_SINGLE_SHOT,
+                                     &tasks_timer_isr, RD_SUCCESS);
+    ri_timer_create_ReturnArrayThruPtr_p_timer_id (&p_mock_tid, 1);
+    TEST_ASSERT (RD_SUCCESS == app_tasks_init());
+}
+
+void test_app_tasks_init_notimer (void)
+{
+    ri_timer_is_init_ExpectAndReturn (false);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_tasks_init());
+}
+
+void test_app_tasks_start_notinit (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_tasks_start());
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_tasks_stop());
+}
+
+void test_app_tasks_add_invalid (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == app_tasks_add (NULL, 1000U));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_tasks_add (&fast_task, 0U));
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&fast_task, 1000U));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_tasks_add (&fast_task, 1000U));
+}
+
+void test_app_tasks_add_full (void)
+{
+    const ri_scheduler_event_handler_t tasks[] =
+    {
+        task_a, task_b, task_c, task_d, task_e
+    };
+
+    for (size_t ii = 0; ii < APP_TASKS_MAX; ii++)
+    {
+        TEST_ASSERT (RD_SUCCESS == app_tasks_add (tasks[ii], 1000U));
+    }
+
+    TEST_ASSERT (RD_ERROR_NO_MEM == app_tasks_add (tasks[APP_TASKS_MAX], 1000U));
+}
+
+void test_app_tasks_run_independent_periods (void)
+{
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&slow_task, 10000U));
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&fast_task, 1285U));
+    tasks_started();
+    // Everything runs on start.
+    TEST_ASSERT (1285U == tasks_run_due (0U));
+    TEST_ASSERT (1U == m_fast_runs);
+    TEST_ASSERT (1U == m_slow_runs);
+    TEST_ASSERT (1285U == tasks_run_due (1285U));
+    TEST_ASSERT (2U == m_fast_runs);
+    TEST_ASSERT (1U == m_slow_runs);
+}
+
+void test_app_tasks_run_coalesces (void)
+{
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&slow_task, 1000U + APP_TASKS_COALESCE_MS));
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&fast_task, 1000U));
+    tasks_started();
+    (void) tasks_run_due (0U);
+    // Slow task is due within coalescing window of fast task, run both.
+    TEST_ASSERT (1000U == tasks_run_due (1000U));
+    TEST_ASSERT (2U == m_fast_runs);
+    TEST_ASSERT (2U == m_slow_runs);
+}
+
+void test_app_tasks_run_no_catch_up (void)
+{
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&fast_task, 1000U));
+    tasks_started();
+    (void) tasks_run_due (0U);
+    TEST_ASSERT (1000U == tasks_run_due (10000U));
+    TEST_ASSERT (2U == m_fast_runs);
+}
+
+void test_app_tasks_handler_starts_timer (void)
+{
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&fast_task, 1000U));
+    tasks_started();
+    ri_rtc_millis_ExpectAndReturn (5000U);
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    ri_timer_start_ExpectAndReturn (&mock_tid, 1000U, NULL, RD_SUCCESS);
+    tasks_handler (NULL, 0);
+    TEST_ASSERT (1U == m_fast_runs);
+}
+
+void test_app_tasks_handler_stopped (void)
+{
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&fast_task, 1000U));
+    tasks_started();
+    ri_timer_stop_ExpectAndReturn (&mock_tid, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_tasks_stop());
+    tasks_handler (NULL, 0);
+    TEST_ASSERT (0U == m_fast_runs);
+}
+
+void test_app_tasks_period_set (void)
+{
+    TEST_ASSERT (RD_SUCCESS == app_tasks_add (&fast_task, 1000U));
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == app_tasks_period_set (&slow_task, 1000U));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_tasks_period_set (&fast_task, 0U));
+    tasks_started();
+    (void) tasks_run_due (0U);
+    ri_rtc_millis_ExpectAndReturn (500U);
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &tasks_handler, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == app_tasks_period_set (&fast_task, 4000U));
+    TEST_ASSERT (4000U == tasks_run_due (500U));
+    TEST_ASSERT (1U == m_fast_runs);
+}
+
+void test_tasks_timer_isr (void)
+{
+    ri_scheduler_event_put_ExpectAndReturn (NULL, 0, &tasks_handler, RD_SUCCESS);
+    tasks_timer_isr (NULL);
+}
@@ -0,0 +1,284 @@
+#include "unity.h"
+
+#include "app_config.h"
+#include "app_vibration.h"
+
+#include "mock_app_sensor.h"
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_driver_sensor.h"
+
+#include <math.h>
+#include <string.h>
+
+#define TEST_FIFO_DEPTH (32U)
+
+static rd_sensor_t m_acc;
+static bool m_fifo_enabled;
+static size_t m_fifo_samples;
+static float m_fifo_value_g;
+
+static rd_status_t mock_fifo_enable (const bool enable)
+{
+    m_fifo_enabled = enable;
+    return RD_SUCCESS;
+}
+
+static rd_status_t mock_fifo_read (size_t * const num_elements,
+                                   rd_sensor_data_t * const data)
+{
+    TEST_ASSERT (TEST_FIFO_DEPTH <= *num_elements);
+    *num_elements = m_fifo_samples;
+    return RD_SUCCESS;
+}
+
+static float mock_parse (const rd_sensor_data_t * const provided,
+                         const rd_sensor_data_bitfield_t requested, int cmock_num_calls)
+{
+    return m_fifo_value_g;
+}
+
+static void sine_fill (int16_t * const samples, const size_t count, const size_t bin,
+                       const float amplitude)
+{
+    for (size_t ii = 0; ii < count; ii++)
+    {
+        samples[ii] = (int16_t) lrintf (amplitude * sinf (2.0F * (float) M_PI * bin * ii
+                                        / count));
+    }
+}
+
+static void window_fill (void)
+{
+    for (size_t ii = 0; ii < APP_VIBRATION_WINDOW; ii++)
+    {
+        const int16_t sign = (0U == ( (ii / 2U) % 2U)) ? 1 : -1;
+        vibration_push (sign * 100, sign * 300, 1000);
+    }
+}
+
+void setUp (void)
+{
+    rd_error_check_Ignore();
+    app_vibration_reset();
+    memset (&m_acc, 0, sizeof (m_acc));
+    m_acc.fifo_enable = &mock_fifo_enable;
+    m_acc.fifo_read = &mock_fifo_read;
+    m_fifo_enabled = false;
+    m_fifo_samples = 0;
+    m_fifo_value_g = 0.0F;
+}
+
+void tearDown (void)
+{
+}
+
+void test_app_vibration_calculate_null (void)
+{
+    int16_t samples[8] = {0};
+    app_vibration_features_t features;
+    TEST_ASSERT (RD_ERROR_NULL == app_vibration_features_calculate (NULL, 8, 10,
+                 &features));
+    TEST_ASSERT (RD_ERROR_NULL == app_vibration_features_calculate (samples, 8, 10,
+                 NULL));
+}
+
+void test_app_vibration_calculate_invalid_length (void)
+{
+    int16_t samples[APP_VIBRATION_WINDOW_MAX * 2] = {0};
+    app_vibration_features_t features;
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == app_vibration_features_calculate (samples,
+                 2, 10, &features));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == app_vibration_features_calculate (samples,
+                 12, 10, &features));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == app_vibration_features_calculate (samples,
+                 APP_VIBRATION_WINDOW_MAX * 2, 10, &features));
+}
+
+void test_app_vibration_calculate_constant (void)
+{
+    int16_t samples[32];
+    app_vibration_features_t features;
+
+    for (size_t ii = 0; ii < 32; ii++)
+    {
+        samples[ii] = 1000;
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_calculate (samples, 32, 10,
+                 &features));
+    TEST_ASSERT (0U == features.rms_mg);
+    TEST_ASSERT (0U == features.peak_mg);
+    TEST_ASSERT (0U == features.crest_x10);
+    TEST_ASSERT (0U == features.dominant_dhz);
+}
+
+void test_app_vibration_calculate_square (void)
+{
+    int16_t samples[32];
+    app_vibration_features_t features;
+
+    // Period of 4 samples, 10 Hz at 40 Hz sample rate, on top of gravity.
+    for (size_t ii = 0; ii < 32; ii++)
+    {
+        samples[ii] = (0U == ( (ii / 2U) % 2U)) ? 1100 : 900;
+    }
+
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_calculate (samples, 32, 40,
+                 &features));
+    TEST_ASSERT (100U == features.rms_mg);
+    TEST_ASSERT (100U == features.peak_mg);
+    TEST_ASSERT (10U == features.crest_x10);
+    TEST_ASSERT (100U == features.dominant_dhz);
+}
+
+void test_app_vibration_calculate_sine (void)
+{
+    int16_t samples[64];
+    app_vibration_features_t features;
+    sine_fill (samples, 64, 7, 500.0F);
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_calculate (samples, 64, 100,
+                 &features));
+    TEST_ASSERT_UINT16_WITHIN (2, 354, features.rms_mg);
+    TEST_ASSERT_UINT16_WITHIN (2, 500, features.peak_mg);
+    TEST_ASSERT_UINT16_WITHIN (1, 14, features.crest_x10);
+    // Bin 7 of 64 at 100 Hz.
+    TEST_ASSERT (109U == features.dominant_dhz);
+}
+
+void test_app_vibration_calculate_does_not_modify_samples (void)
+{
+    int16_t samples[16];
+    int16_t original[16];
+    app_vibration_features_t features;
+    sine_fill (samples, 16, 3, 1000.0F);
+    memcpy (original, samples, sizeof (samples));
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_calculate (samples, 16, 10,
+                 &features));
+    TEST_ASSERT_EQUAL_INT16_ARRAY (original, samples, 16);
+}
+
+void test_app_vibration_fft_cosine (void)
+{
+    int16_t re[32];
+    int16_t im[32] = {0};
+
+    for (size_t ii = 0; ii < 32; ii++)
+    {
+        re[ii] = (int16_t) lrintf (8000.0F * cosf (2.0F * (float) M_PI * 3.0F * ii / 32));
+    }
+
+    vibration_fft (re, im, 32);
+
+    // Scaled DFT of cosine has half of amplitude at bin and its mirror.
+    for (size_t ii = 0; ii < 32; ii++)
+    {
+        const int16_t expected = ( (3U == ii) || (29U == ii)) ? 4000 : 0;
+        TEST_ASSERT_INT16_WITHIN (8, expected, re[ii]);
+        TEST_ASSERT_INT16_WITHIN (8, 0, im[ii]);
+    }
+}
+
+void test_app_vibration_features_get_no_window (void)
+{
+    app_vibration_features_t features;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_vibration_features_get (
+                     APP_VIBRATION_AXIS_X, &features));
+}
+
+void test_app_vibration_features_get_invalid (void)
+{
+    app_vibration_features_t features;
+    TEST_ASSERT (RD_ERROR_NULL == app_vibration_features_get (APP_VIBRATION_AXIS_X,
+                 NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == app_vibration_features_get (
+                     APP_VIBRATION_AXIS_COUNT, &features));
+}
+
+void test_app_vibration_window_complete (void)
+{
+    app_vibration_features_t features;
+    window_fill();
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_get (APP_VIBRATION_AXIS_X,
+                 &features));
+    TEST_ASSERT (100U == features.rms_mg);
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_get (APP_VIBRATION_AXIS_Y,
+                 &features));
+    TEST_ASSERT (300U == features.rms_mg);
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_get (APP_VIBRATION_AXIS_Z,
+                 &features));
+    TEST_ASSERT (0U == features.rms_mg);
+}
+
+void test_app_vibration_loudest_get_ok (void)
+{
+    app_vibration_features_t loudest;
+    app_vibration_features_t y;
+    window_fill();
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_get (APP_VIBRATION_AXIS_Y, &y));
+    TEST_ASSERT (RD_SUCCESS == app_vibration_loudest_get (&loudest));
+    TEST_ASSERT_EQUAL_MEMORY (&y, &loudest, sizeof (loudest));
+}
+
+void test_app_vibration_loudest_get_no_window (void)
+{
+    app_vibration_features_t loudest;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_vibration_loudest_get (&loudest));
+    TEST_ASSERT (RD_ERROR_NULL == app_vibration_loudest_get (NULL));
+}
+
+void test_app_vibration_init_ok (void)
+{
+    app_sensor_find_provider_ExpectAnyArgsAndReturn (&m_acc);
+    TEST_ASSERT (RD_SUCCESS == app_vibration_init());
+    TEST_ASSERT (m_fifo_enabled);
+}
+
+void test_app_vibration_init_no_fifo (void)
+{
+    m_acc.fifo_read = NULL;
+    app_sensor_find_provider_ExpectAnyArgsAndReturn (&m_acc);
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == app_vibration_init());
+    app_sensor_find_provider_ExpectAnyArgsAndReturn (NULL);
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == app_vibration_init());
+}
+
+void test_app_vibration_sample_not_init (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_vibration_sample());
+}
+
+void test_app_vibration_sample_fills_window (void)
+{
+    app_vibration_features_t features;
+    app_sensor_find_provider_ExpectAnyArgsAndReturn (&m_acc);
+    TEST_ASSERT (RD_SUCCESS == app_vibration_init());
+    rd_sensor_data_parse_StubWithCallback (&mock_parse);
+    m_fifo_value_g = 1.0F;
+    m_fifo_samples = APP_VIBRATION_WINDOW - 1U;
+    TEST_ASSERT (RD_SUCCESS == app_vibration_sample());
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == app_vibration_features_get (
+                     APP_VIBRATION_AXIS_X, &features));
+    m_fifo_samples = 1U;
+    TEST_ASSERT (RD_SUCCESS == app_vibration_sample());
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_get (APP_VIBRATION_AXIS_X,
+                 &features));
+    TEST_ASSERT (0U == features.rms_mg);
+}
+
+void test_app_vibration_sample_full_fifo_restarts_window (void)
+{
+    app_vibration_features_t features;
+    app_sensor_find_provider_ExpectAnyArgsAndReturn (&m_acc);
+    TEST_ASSERT (RD_SUCCESS == app_vibration_init());
+    rd_sensor_data_parse_StubWithCallback (&mock_parse);
+    m_fifo_value_g = 0.0F;
+    m_fifo_samples = APP_VIBRATION_WINDOW - 1U;
+    TEST_ASSERT (RD_SUCCESS == app_vibration_sample());
+    // Full FIFO has dropped samples, partial window is discarded.
+    m_fifo_value_g = 1.0F;
+    m_fifo_samples = TEST_FIFO_DEPTH;
+    TEST_ASSERT (RD_SUCCESS == app_vibration_sample());
+    TEST_ASSERT (RD_SUCCESS == app_vibration_features_get (APP_VIBRATION_AXIS_X,
+                 &features));
+    TEST_ASSERT (0U == features.rms_mg);
+}
@@ -31,6 +31,7 @@
 #include "mock_app_led.h"
 #include "mock_app_log.h"
 #include "mock_app_power.h"
+#include "mock_app_radio.h"
 #include "mock_app_sensor.h"
 #include "mock_ruuvi_driver_error.h"
 #include "mock_ruuvi_task_flash.h"
@@ -113,6 +114,8 @@ void test_main_ok (void)
     app_sensor_init_ExpectAndReturn (RD_SUCCESS);
     app_log_init_ExpectAndReturn (RD_SUCCESS);
     app_sensor_acc_thr_set_ExpectWithArrayAndReturn (&motion_threshold, 1, RD_SUCCESS);
+    app_sensor_presence_int_set_ExpectAndReturn (true, RD_SUCCESS);
+    app_radio_init_ExpectAndReturn (RD_SUCCESS);
     app_comms_init_ExpectAndReturn (true, RD_SUCCESS);
     app_sensor_vdd_sample_ExpectAndReturn (RD_SUCCESS);
     app_heartbeat_init_ExpectAndReturn (RD_SUCCESS);
@@ -147,6 +150,8 @@ void test_main_error (void)
     app_sensor_init_ExpectAndReturn (RD_SUCCESS);
     app_log_init_ExpectAndReturn (RD_SUCCESS);
     app_sensor_acc_thr_set_ExpectWithArrayAndReturn (&motion_threshold, 1, RD_SUCCESS);
+    app_sensor_presence_int_set_ExpectAndReturn (true, RD_SUCCESS);
+    app_radio_init_ExpectAndReturn (RD_SUCCESS);
     app_comms_init_ExpectAndReturn (true, RD_SUCCESS);
     app_sensor_vdd_sample_ExpectAndReturn (RD_SUCCESS);
     app_heartbeat_init_ExpectAndReturn (RD_ERROR_INTERNAL);